@@ -0,0 +1,76 @@
+
+#
+# Copyright (C) 1994-2020 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+#
+
+AC_DEFUN([PBS_AC_WITH_LIBLZ4],
+[
+  AC_ARG_WITH([liblz4],
+    AS_HELP_STRING([--with-liblz4=DIR],
+      [Specify the directory where liblz4 is installed to enable lz4 TPP compression.]
+    )
+  )
+  AC_MSG_CHECKING([for liblz4])
+  AS_IF([test "x$with_liblz4" = "xno" -o "x$with_liblz4" = "x"],
+    AC_MSG_RESULT([no]),
+    AS_IF([test "x$with_liblz4" = "xyes"],
+      liblz4_dir=["/usr"],
+      liblz4_dir=["$with_liblz4"]
+    )
+    AS_IF([test -r "$liblz4_dir/include/lz4frame.h"],
+      [],
+      AC_MSG_ERROR([liblz4 headers not found.])
+    )
+    AS_IF([test "$liblz4_dir" = "/usr"],
+      [liblz4_lib="-llz4"; liblz4_inc=""],
+      AS_IF([test -r "${liblz4_dir}/lib64/liblz4.a"],
+        [liblz4_lib="${liblz4_dir}/lib64/liblz4.a"],
+        AS_IF([test -r "${liblz4_dir}/lib/liblz4.a"],
+          [liblz4_lib="${liblz4_dir}/lib/liblz4.a"],
+          AC_MSG_ERROR([liblz4 not found.])
+        )
+      )
+      liblz4_inc="-I$liblz4_dir/include"
+    )
+    AC_MSG_RESULT([$liblz4_dir])
+    AC_DEFINE([PBS_COMPRESSION_LZ4], [], [Defined when liblz4 is available])
+  )
+  AC_SUBST(liblz4_inc)
+  AC_SUBST(liblz4_lib)
+])
@@ -58,6 +58,316 @@
 #include <pbs_config.h>   /* the master config generated by configure */
 #include <pbs_version.h>
 
+#define MAX_TIME_DELAY_LEN 32
+
+/* delete requests kept in flight on one server connection */
+#define QDEL_INFLIGHT_MAX 64
+
+struct qdel_inflight {
+	int reqid;				/* request id of the delete */
+	char job_id[PBS_MAXCLTJOBID];	/* job being deleted */
+};
+
+static struct qdel_inflight inflight[QDEL_INFLIGHT_MAX];
+static int num_inflight = 0;
+static int pipelined = TRUE;	/* FALSE once a server refuses request ids */
+
+static int any_failed = 0;
+static int num_deleted = 0;
+static int mails_suppressed = FALSE;
+static int dfltmail = 0;
+static int dfltmailflg = FALSE;
+
+/* -W no longer supports a time delay */
+/* max length is "nomailforcedeletehist" plus terminating '\0' */
+static char warg[MAX_TIME_DELAY_LEN+1];
+static char warg1[MAX_TIME_DELAY_LEN+7];
+
+/**
+ * @brief
+ *	Retrieve the default suppress_email value from the server's
+ *	default_qdel_arguments.
+ *
+ * @param[in] connect - server connection
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	!0	the server could not be queried, error reported
+ */
+static int
+get_dfltmail(int connect)
+{
+	struct attrl *attr;
+	struct batch_status *ss = NULL;
+	char *keystr, *valuestr;
+	char *errmsg;
+
+	ss = pbs_statserver(connect, NULL, NULL);
+	if (ss == NULL && pbs_errno != PBSE_NONE) {
+		any_failed = pbs_errno;
+		if ((errmsg = pbs_geterrmsg(connect)) != NULL)
+			fprintf(stderr, "qdel: %s\n", errmsg);
+		else
+			fprintf(stderr, "qdel: Error %d\n", pbs_errno);
+		return any_failed;
+	}
+
+	while (ss != NULL && dfltmailflg != TRUE) {
+		attr = ss->attribs;
+		while (attr != NULL) {
+			if (strcmp(attr->name, ATTR_dfltqdelargs) == 0) {
+				if (attr->value != NULL && dfltmailflg != TRUE) {
+					if (parse_equal_string(attr->value, &keystr, &valuestr)) {
+						if (strcmp(keystr, "-Wsuppress_email") == 0) {
+							dfltmail = atol(valuestr);
+							dfltmailflg = TRUE;
+						}
+						else {
+							fprintf(stderr,
+								"qdel: unsupported %s \'%s\'\n",
+								attr->name, attr->value);
+						}
+					}
+				}
+			}
+			attr = attr->next;
+		}
+		ss = ss->next;
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ *	Return the extend string for the next delete request.
+ *
+ * @par
+ *	When jobs to be deleted are over 1000, mail function is disabled
+ *	by sending the flag below to server via its extend field:
+ *	  "" -- delete a job with a mail
+ *	  "nomail" -- delete a job without sending a mail
+ *	  "force" -- force job to be deleted with a mail
+ *	  "nomailforce" -- force job to be deleted without sending a mail
+ *	  "nomaildeletehist" -- delete history of a job without sending mail
+ *	  "nomailforcedeletehist" -- force delete history of a job without sending mail.
+ *	Deletes still in flight are counted as deleted.
+ *
+ * @return	char *
+ */
+static char *
+delete_arg(void)
+{
+	int mails;				/* number of emails we can send */
+
+	mails = dfltmail ? dfltmail : 1000;
+	if (num_deleted + num_inflight >= mails && !mails_suppressed) {
+		mails_suppressed = TRUE;
+		/* current warg1 "nomail" should be at start */
+		strcat(warg1, warg);
+		strcpy(warg, warg1);
+	}
+	return warg;
+}
+
+/**
+ * @brief
+ *	Delete one job, waiting for the server's reply.  A job unknown to
+ *	the server is looked up and deleted where it now lives.
+ *
+ * @param[in] job_id_out - job to delete
+ * @param[in] server_out - server to send the delete to
+ * @param[in] located - TRUE if server_out is where the job was located
+ * @param[in] resent - TRUE if the delete may already have been done on a
+ *		       connection that broke; a job unknown to the server
+ *		       is then taken as deleted
+ *
+ * @return	int
+ * @retval	0	go on with the next job
+ * @retval	!0	the server could not be queried, stop
+ */
+static int
+deljob_sync(char *job_id_out, char *server_out, int located, int resent)
+{
+	int connect;
+	int stat;
+	char rmt_server[MAXSERVERNAME];
+
+	connect = cnt2server(server_out);
+	if (connect <= 0) {
+		fprintf(stderr, "qdel: cannot connect to server %s (errno=%d)\n",
+			pbs_server, pbs_errno);
+		any_failed = pbs_errno;
+		return 0;
+	}
+
+	/* retrieve default: suppress_email from server: default_qdel_arguments */
+	if (dfltmailflg == FALSE && get_dfltmail(connect) != 0) {
+		pbs_disconnect(connect);
+		return any_failed;
+	}
+
+	stat = pbs_deljob(connect, job_id_out, delete_arg());
+
+	/*
+	 * The counter num_deleted should not be updated  when a history job is deleted .
+	 */
+	if (pbs_errno != PBSE_HISTJOBDELETED)
+		num_deleted++;
+	if (stat && (pbs_errno != PBSE_UNKJOBID && pbs_errno != PBSE_HISTJOBDELETED)) {
+		prt_job_err("qdel", connect, job_id_out);
+		any_failed = pbs_errno;
+	} else if (stat && (pbs_errno == PBSE_UNKJOBID) && resent) {
+		/* the first delete went through before the connection broke */
+	} else if (stat && (pbs_errno == PBSE_UNKJOBID) && !located) {
+		if (locate_job(job_id_out, server_out, rmt_server)) {
+			pbs_disconnect(connect);
+			return deljob_sync(job_id_out, rmt_server, TRUE, FALSE);
+		}
+		prt_job_err("qdel", connect, job_id_out);
+		any_failed = pbs_errno;
+	}
+
+	pbs_disconnect(connect);
+	return 0;
+}
+
+/**
+ * @brief
+ *	Take the completion of one delete in flight on a connection.
+ *
+ * @param[in] connect - server connection
+ * @param[in] server_out - server of the connection
+ *
+ * @return	int
+ * @retval	0	a delete completed
+ * @retval	1	the server does not take request ids, the deletes in
+ *			flight were not done
+ * @retval	-1	the connection failed, the deletes in flight are
+ *			unanswered and may or may not have been done
+ */
+static int
+collect_delete(int connect, char *server_out)
+{
+	int i;
+	int reqid;
+	char rmt_server[MAXSERVERNAME];
+
+	if (PBSD_async_poll(connect, -1, &reqid) != 1)
+		return -1;
+	if (reqid == 0) {
+		/* an older server rejects the header carrying the request id */
+		if (pbs_errno == PBSE_PROTOCOL || pbs_errno == PBSE_UNKREQ)
+			return 1;
+		return -1;
+	}
+
+	for (i = 0; i < num_inflight; i++) {
+		if (inflight[i].reqid == reqid)
+			break;
+	}
+	if (i == num_inflight)
+		return 0;
+
+	if (pbs_errno != PBSE_HISTJOBDELETED)
+		num_deleted++;
+	if (pbs_errno != PBSE_NONE && pbs_errno != PBSE_UNKJOBID && pbs_errno != PBSE_HISTJOBDELETED) {
+		prt_job_err("qdel", connect, inflight[i].job_id);
+		any_failed = pbs_errno;
+	} else if (pbs_errno == PBSE_UNKJOBID) {
+		if (locate_job(inflight[i].job_id, server_out, rmt_server))
+			(void)deljob_sync(inflight[i].job_id, rmt_server, TRUE, FALSE);
+		else {
+			prt_job_err("qdel", connect, inflight[i].job_id);
+			any_failed = pbs_errno;
+		}
+	}
+
+	inflight[i] = inflight[--num_inflight];
+	return 0;
+}
+
+/**
+ * @brief
+ *	Wait for all deletes in flight on a connection and close it.  If the
+ *	server cannot answer them, they are sent again one at a time: all
+ *	later deletes too if it refused the request ids, or as deletes that
+ *	may already be done if the connection broke.
+ *
+ * @param[in] connect - server connection
+ * @param[in] server_out - server of the connection
+ * @param[in] rc - what collect_delete() last returned on the connection
+ *
+ * @return	void
+ */
+static void
+drain_deletes(int connect, char *server_out, int rc)
+{
+	int i;
+
+	while (rc == 0 && num_inflight > 0)
+		rc = collect_delete(connect, server_out);
+	pbs_disconnect(connect);
+	if (rc == 1)
+		pipelined = FALSE;
+
+	for (i = 0; i < num_inflight; i++)
+		(void)deljob_sync(inflight[i].job_id, server_out, FALSE, rc == -1);
+	num_inflight = 0;
+}
+
+/**
+ * @brief
+ *	Delete the jobs picked by a filter with one Delete Job List request
+ *	and report the jobs that could not be deleted.
+ *
+ * @param[in] filter - owner, job_state and queue to match
+ * @param[in] server - server of the jobs, NULL for the default server
+ *
+ * @return	void
+ */
+static void
+delete_filtered(struct attrl *filter, char *server)
+{
+	int connect;
+	int i;
+	char *errmsg;
+	struct batch_reply *reply;
+	struct brp_joblist *plist;
+
+	connect = cnt2server(server);
+	if (connect <= 0) {
+		fprintf(stderr, "qdel: cannot connect to server %s (errno=%d)\n",
+			pbs_server, pbs_errno);
+		any_failed = pbs_errno;
+		return;
+	}
+
+	reply = PBSD_joblist(connect, PBS_BATCH_DeleteJobList, NULL, filter, NULL, warg);
+	if (reply == NULL) {
+		any_failed = pbs_errno;
+		if ((errmsg = pbs_geterrmsg(connect)) != NULL)
+			fprintf(stderr, "qdel: %s\n", errmsg);
+		else
+			fprintf(stderr, "qdel: Server returned error %d\n", pbs_errno);
+		pbs_disconnect(connect);
+		return;
+	}
+
+	plist = &reply->brp_un.brp_joblist;
+	for (i = 0; i < plist->brp_nerr; i++) {
+		any_failed = plist->brp_errs[i].brp_code;
+		fprintf(stderr, "qdel: %s %s\n",
+			pbse_to_txt(plist->brp_errs[i].brp_code),
+			plist->brp_errs[i].brp_jobid);
+	}
+	if (plist->brp_nfail > plist->brp_nerr)
+		fprintf(stderr, "qdel: %d more jobs could not be deleted\n",
+			plist->brp_nfail - plist->brp_nerr);
+
+	PBSD_FreeReply(reply);
+	pbs_disconnect(connect);
+}
+
 
 int
 main(argc, argv, envp) /* qdel */
@@ -67,36 +377,32 @@ char **envp;
 {
 	int c;
 	int errflg=0;
-	int any_failed=0;
 	char *pc;
 
 	int forcedel = FALSE;
 	int deletehist = FALSE;
-	int mails_suppressed = FALSE;
 
+	int connect = -1;
+	int reqid;
+	int rc;
 
 	char job_id[PBS_MAXCLTJOBID];	/* from the command line */
 
 	char job_id_out[PBS_MAXCLTJOBID];
 	char server_out[MAXSERVERNAME];
-	char rmt_server[MAXSERVERNAME];
+	char cur_server[MAXSERVERNAME];	/* server of connect */
 
 	char *keystr, *valuestr;
-	int dfltmail = 0;
-	int dfltmailflg = FALSE;
-	int mails;				/* number of emails we can send */
-	int num_deleted = 0;
-	struct attrl *attr;
-	struct batch_status *ss = NULL;
-	char *errmsg;
 
-#define MAX_TIME_DELAY_LEN 32
-	/* -W no longer supports a time delay */
-	/* max length is "nomailforcedeletehist" plus terminating '\0' */
-	char warg[MAX_TIME_DELAY_LEN+1];
-	char warg1[MAX_TIME_DELAY_LEN+7];
+	/* -u, -s and -q pick the jobs on the server instead of job ids */
+	char *u_arg = NULL;
+	char *s_arg = NULL;
+	char *q_arg = NULL;
+	char *filt_server = NULL;
+	struct attrl filt[3];
+	struct attrl *filter = NULL;
 
-#define GETOPT_ARGS "W:x"
+#define GETOPT_ARGS "W:xu:s:q:"
 
 	/*test for real deal or just version and exit*/
 
@@ -143,15 +449,56 @@ char **envp;
 			case  'x' :
 				deletehist = TRUE;
 				break;
+			case 'u':
+				u_arg = optarg;
+				break;
+			case 's':
+				s_arg = optarg;
+				break;
+			case 'q':
+				q_arg = optarg;
+				break;
 			default :
 				errflg++;
 		}
 	}
 
-	if (errflg || optind >= argc) {
+	/* chain the filter attributes, -q takes queue[@server] or @server */
+	memset(filt, 0, sizeof(filt));
+	if (u_arg != NULL) {
+		filt[0].name = ATTR_owner;
+		filt[0].value = u_arg;
+		filt[0].next = filter;
+		filter = &filt[0];
+	}
+	if (s_arg != NULL) {
+		filt[1].name = ATTR_state;
+		filt[1].value = s_arg;
+		filt[1].next = filter;
+		filter = &filt[1];
+	}
+	if (q_arg != NULL) {
+		if ((pc = strchr(q_arg, '@')) != NULL) {
+			*pc = '\0';
+			filt_server = pc + 1;
+		}
+		if (*q_arg != '\0') {
+			filt[2].name = ATTR_queue;
+			filt[2].value = q_arg;
+			filt[2].next = filter;
+			filter = &filt[2];
+		}
+	}
+	if ((u_arg && *u_arg == '\0') || (s_arg && *s_arg == '\0') ||
+		((u_arg || s_arg || q_arg) && filter == NULL))
+		errflg++;
+
+	if (errflg || (optind >= argc && filter == NULL) ||
+		(optind < argc && (u_arg || s_arg || q_arg))) {
 		static char usage[] =
 			"usage:\n"
 		"\tqdel [-W force|suppress_email=X] [-x] job_identifier...\n"
+		"\tqdel [-W force] [-x] [-u user] [-s states] [-q destination]\n"
 		"\tqdel --version\n";
 		fprintf(stderr, "%s", usage);
 		exit(2);
@@ -171,102 +518,71 @@ char **envp;
 		exit(1);
 	}
 
-	for (; optind < argc; optind++) {
-		int connect;
-		int stat=0;
-		int located = FALSE;
+	if (u_arg || s_arg || q_arg) {
+		delete_filtered(filter, filt_server);
+		CS_close_app();
+		exit(any_failed);
+	}
 
+	for (; optind < argc; optind++) {
 		strcpy(job_id, argv[optind]);
 		if (get_server(job_id, job_id_out, server_out)) {
 			fprintf(stderr, "qdel: illegally formed job identifier: %s\n", job_id);
 			any_failed = 1;
 			continue;
 		}
-cnt:
-		connect = cnt2server(server_out);
-		if (connect <= 0) {
-			fprintf(stderr, "qdel: cannot connect to server %s (errno=%d)\n",
-				pbs_server, pbs_errno);
-			any_failed = pbs_errno;
+
+		if (!pipelined) {
+			if (deljob_sync(job_id_out, server_out, FALSE, FALSE) != 0)
+				break;
 			continue;
 		}
 
-		/* retrieve default: suppress_email from server: default_qdel_arguments */
-		if (dfltmailflg == FALSE) {
-			ss = pbs_statserver(connect, NULL, NULL);
-			if (ss == NULL && pbs_errno != PBSE_NONE) {
+		/*
+		 * Deletes to one server are sent without waiting for each reply,
+		 * up to QDEL_INFLIGHT_MAX at a time on the same connection.
+		 */
+		if (connect > 0 && strcmp(server_out, cur_server) != 0) {
+			drain_deletes(connect, cur_server, 0);
+			connect = -1;
+		}
+		if (connect <= 0) {
+			connect = cnt2server(server_out);
+			if (connect <= 0) {
+				fprintf(stderr, "qdel: cannot connect to server %s (errno=%d)\n",
+					pbs_server, pbs_errno);
 				any_failed = pbs_errno;
-				if ((errmsg = pbs_geterrmsg(connect)) != NULL)
-					fprintf(stderr, "qdel: %s\n", errmsg);
-				else
-					fprintf(stderr, "qdel: Error %d\n", pbs_errno);
-				break;
+				continue;
 			}
+			strcpy(cur_server, server_out);
 
-			while (ss != NULL && dfltmailflg != TRUE) {
-				attr = ss->attribs;
-				while (attr != NULL) {
-					if (strcmp(attr->name, ATTR_dfltqdelargs) == 0) {
-						if (attr->value != NULL && dfltmailflg != TRUE) {
-							if (parse_equal_string(attr->value, &keystr, &valuestr)) {
-								if (strcmp(keystr, "-Wsuppress_email") == 0) {
-									dfltmail = atol(valuestr);
-									dfltmailflg = TRUE;
-								}
-								else {
-									fprintf(stderr,
-										"qdel: unsupported %s \'%s\'\n",
-										attr->name, attr->value);
-								}
-							}
-						}
-					}
-					attr = attr->next;
-				}
-				ss = ss->next;
+			/* retrieve default: suppress_email from server: default_qdel_arguments */
+			if (dfltmailflg == FALSE && get_dfltmail(connect) != 0) {
+				pbs_disconnect(connect);
+				connect = -1;
+				break;
 			}
 		}
 
-		/* when jobs to be deleted over 1000, mail function is disabled
-		 * by sending the flag below to server via its extend field:
-		 *   "" -- delete a job with a mail
-		 *   "nomail" -- delete a job without sending a mail
-		 *   "force" -- force job to be deleted with a mail
-		 *   "nomailforce" -- force job to be deleted without sending a mail
-		 *   "nomaildeletehist" -- delete history of a job without sending mail
-		 *   "nomailforcedeletehist" -- force delete history of a job without sending mail.
-		 */
-		mails = dfltmail ? dfltmail : 1000;
-		if (num_deleted >= mails && !mails_suppressed) {
-			mails_suppressed = TRUE;
-			/* current warg1 "nomail" should be at start */
-			strcat(warg1, warg);
-			strcpy(warg, warg1);
+		if ((reqid = PBSD_deljob_async(connect, job_id_out, delete_arg())) <= 0) {
+			drain_deletes(connect, cur_server, 0);
+			connect = -1;
+			if (deljob_sync(job_id_out, server_out, FALSE, FALSE) != 0)
+				break;
+			continue;
 		}
+		inflight[num_inflight].reqid = reqid;
+		strcpy(inflight[num_inflight].job_id, job_id_out);
+		num_inflight++;
 
-		stat = pbs_deljob(connect, job_id_out, warg);
-
-		/*
-		 * The counter num_deleted should not be updated  when a history job is deleted .
-		 */
-		if (pbs_errno != PBSE_HISTJOBDELETED)
-			num_deleted++;
-		if (stat && (pbs_errno != PBSE_UNKJOBID && pbs_errno != PBSE_HISTJOBDELETED)) {
-			prt_job_err("qdel", connect, job_id_out);
-			any_failed = pbs_errno;
-		} else if (stat && (pbs_errno == PBSE_UNKJOBID) && !located) {
-			located = TRUE;
-			if (locate_job(job_id_out, server_out, rmt_server)) {
-				pbs_disconnect(connect);
-				strcpy(server_out, rmt_server);
-				goto cnt;
-			}
-			prt_job_err("qdel", connect, job_id_out);
-			any_failed = pbs_errno;
+		if (num_inflight == QDEL_INFLIGHT_MAX &&
+			(rc = collect_delete(connect, cur_server)) != 0) {
+			drain_deletes(connect, cur_server, rc);
+			connect = -1;
 		}
-
-		pbs_disconnect(connect);
 	}
+	if (connect > 0)
+		drain_deletes(connect, cur_server, 0);
 
 	/*cleanup security library initializations before exiting*/
 	CS_close_app();
@@ -149,6 +149,7 @@ int zopt = FALSE;		/* -z option */
 
 struct server *servers = NULL;  /* Linked list of server structures */
 int nservers = 0;               /* Number of servers */
+static int mgr_list_unsupported = 0; /* server takes no PBS_BATCH_ManagerList */
 
 /* active objects */
 struct objname *active_servers;
@@ -2541,6 +2542,54 @@ handle_formula(struct attropl *attribs)
 	return;
 }
 
+/**
+ * @brief
+ * 	list_objname - fold several vnode names into one objname so that a
+ *	set or unset of them goes to the server as a single
+ *	PBS_BATCH_ManagerList request instead of one request per vnode
+ *
+ * @param[in] oper   The command
+ * @param[in] type   The object type
+ * @param[in] name   The object name list
+ *
+ * @return struct objname *
+ * @retval objname holding the comma separated names, free with free_objname()
+ * @retval NULL if the names have to be sent one at a time
+ *
+ */
+static struct objname *
+list_objname(int oper, int type, struct objname *name)
+{
+	struct objname *pname;
+	struct objname *list;
+	size_t len = 0;
+
+	if (mgr_list_unsupported || (type != MGR_OBJ_NODE) ||
+		((oper != MGR_CMD_SET) && (oper != MGR_CMD_UNSET)))
+		return NULL;
+	if ((name == NULL) || (name->next == NULL) ||
+		(active_servers == NULL) || (active_servers->next != NULL))
+		return NULL;
+
+	for (pname = name; pname != NULL; pname = pname->next) {
+		if ((pname->svr_name != NULL) || (pname->obj_name == NULL) ||
+			(*pname->obj_name == '\0'))
+			return NULL;
+		len += strlen(pname->obj_name) + 1;
+	}
+
+	list = new_objname();
+	list->obj_type = type;
+	Mstring(list->obj_name, len);
+	list->obj_name[0] = '\0';
+	for (pname = name; pname != NULL; pname = pname->next) {
+		if (pname != name)
+			strcat(list->obj_name, ",");
+		strcat(list->obj_name, pname->obj_name);
+	}
+	return list;
+}
+
 /**
  * @brief
  * 	execute - contact the server and execute the command
@@ -2579,6 +2628,8 @@ execute(int aopt, int oper, int type, char *names, struct attropl *attribs)
 	struct objname *pname = NULL;	/* Pointer to current object name */
 	struct objname *sname = NULL;	/* Pointer to current server name */
 	struct objname *svrs;		/* servers to loop through */
+	struct objname *list = NULL;	/* all names in one request */
+	struct objname *objs = NULL;	/* the names folded into list */
 	struct attrl *sa;		/* Argument needed for status routines */
 	/* Argument used to request queue names */
 	struct server *sp;		/* Pointer to server structure */
@@ -2624,6 +2675,11 @@ execute(int aopt, int oper, int type, char *names, struct attropl *attribs)
 	else
 		pname = name;
 
+	if ((list = list_objname(oper, type, pname)) != NULL) {
+		objs = pname;
+		pname = list;
+	}
+
 	for (; pname != NULL; pname = pname->next) {
 		if (pname->svr_name != NULL)
 			svrs = temp_objname(NULL, pname->svr_name, pname->svr);
@@ -2893,6 +2949,24 @@ execute(int aopt, int oper, int type, char *names, struct attropl *attribs)
 				} else {
 					if ((strlen(pname->obj_name) == 0) && type == MGR_OBJ_SCHED && oper != MGR_CMD_DELETE) {
 						perr = pbs_manager(sp->s_connect, oper, type, PBS_DFLT_SCHED_NAME, attribs, NULL);
+					} else if (pname == list) {
+						perr = PBSD_manager(sp->s_connect, PBS_BATCH_ManagerList, oper, type, pname->obj_name, attribs, NULL);
+						if (perr == PBSE_UNKREQ) {
+							/*
+							 * The server predates list requests and has
+							 * dropped the connection, reconnect and send
+							 * the names one at a time.
+							 */
+							mgr_list_unsupported = 1;
+							pbs_disconnect(sp->s_connect);
+							if ((sp->s_connect = cnt2server(sp->s_name)) <= 0) {
+								PSTDERR1("qmgr: cannot connect to server %s\n", sp->s_name)
+								exit(1);
+							}
+							list->next = objs;
+							temp_objname(NULL, NULL, NULL);
+							continue;
+						}
 					} else
 						perr = pbs_manager(sp->s_connect, oper, type, pname->obj_name, attribs, NULL);
 				}
@@ -2973,6 +3047,10 @@ execute(int aopt, int oper, int type, char *names, struct attropl *attribs)
 			temp_objname(NULL, NULL, NULL);		/* clears reference count */
 		}
 	}
+	if (list != NULL) {
+		list->next = NULL;
+		free_objname(list);
+	}
 	if (name != NULL)
 		free_objname_list(name);
 	return error;
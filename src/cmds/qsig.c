@@ -57,22 +57,145 @@
 #include <pbs_config.h>   /* the master config generated by configure */
 #include <pbs_version.h>
 
+#define MAX_SIGNAL_TYPE_LEN 32
+static char sig_string[MAX_SIGNAL_TYPE_LEN+1] = "SIGTERM";
+
+static int any_failed = 0;
+static int batched = TRUE;	/* FALSE once a server refuses signal job lists */
+
+/**
+ * @brief
+ *	Signal one job, waiting for the server's reply.  A job unknown to
+ *	the server is looked up and signaled where it now lives.
+ *
+ * @param[in] job_id_out - job to signal
+ * @param[in] server_out - server to send the signal to
+ *
+ * @return	void
+ */
+static void
+sigjob_one(char *job_id_out, char *server_out)
+{
+	int connect;
+	int stat = 0;
+	int located = FALSE;
+	char server[MAXSERVERNAME];
+	char rmt_server[MAXSERVERNAME];
+
+	strcpy(server, server_out);
+cnt:
+	connect = cnt2server(server);
+	if (connect <= 0) {
+		fprintf(stderr, "qsig: cannot connect to server %s (errno=%d)\n",
+			pbs_server, pbs_errno);
+		any_failed = pbs_errno;
+		return;
+	}
+
+	stat = pbs_sigjob(connect, job_id_out, sig_string, NULL);
+	if (stat && (pbs_errno != PBSE_UNKJOBID)) {
+		prt_job_err("qsig", connect, job_id_out);
+		any_failed = pbs_errno;
+	} else if (stat && (pbs_errno == PBSE_UNKJOBID) && !located) {
+		located = TRUE;
+		if (locate_job(job_id_out, server, rmt_server)) {
+			pbs_disconnect(connect);
+			strcpy(server, rmt_server);
+			goto cnt;
+		}
+		prt_job_err("qsig", connect, job_id_out);
+		any_failed = pbs_errno;
+	}
+
+	pbs_disconnect(connect);
+}
+
+/**
+ * @brief
+ *	Signal the jobs of one server with a single Signal Job List request.
+ *	Jobs the server does not know are signaled one by one, so they are
+ *	looked up where they now live, as are all jobs if the server does
+ *	not take signal job lists.
+ *
+ * @param[in] jobids - NULL terminated list of jobs at server_out
+ * @param[in] server_out - server of the jobs
+ *
+ * @return	void
+ */
+static void
+sigjob_list(char **jobids, char *server_out)
+{
+	int connect;
+	int i;
+	char *errmsg;
+	struct batch_reply *reply = NULL;
+	struct brp_joblist *plist;
+
+	if (batched && jobids[0] != NULL && jobids[1] != NULL) {
+		connect = cnt2server(server_out);
+		if (connect <= 0) {
+			fprintf(stderr, "qsig: cannot connect to server %s (errno=%d)\n",
+				pbs_server, pbs_errno);
+			any_failed = pbs_errno;
+			return;
+		}
+		reply = PBSD_joblist(connect, PBS_BATCH_SignalJobList, jobids, NULL, sig_string, NULL);
+		if (reply == NULL) {
+			if (pbs_errno != PBSE_UNKREQ && pbs_errno != PBSE_PROTOCOL) {
+				any_failed = pbs_errno;
+				if ((errmsg = pbs_geterrmsg(connect)) != NULL)
+					fprintf(stderr, "qsig: %s\n", errmsg);
+				else
+					fprintf(stderr, "qsig: Server returned error %d\n", pbs_errno);
+				pbs_disconnect(connect);
+				return;
+			}
+			/* an older server without the list request */
+			batched = FALSE;
+		}
+		pbs_disconnect(connect);
+	}
+
+	if (reply == NULL) {
+		for (i = 0; jobids[i] != NULL; i++)
+			sigjob_one(jobids[i], server_out);
+		return;
+	}
+
+	plist = &reply->brp_un.brp_joblist;
+	for (i = 0; i < plist->brp_nerr; i++) {
+		if (plist->brp_errs[i].brp_code == PBSE_UNKJOBID) {
+			sigjob_one(plist->brp_errs[i].brp_jobid, server_out);
+			continue;
+		}
+		any_failed = plist->brp_errs[i].brp_code;
+		fprintf(stderr, "qsig: %s %s\n",
+			pbse_to_txt(plist->brp_errs[i].brp_code),
+			plist->brp_errs[i].brp_jobid);
+	}
+	if (plist->brp_nfail > plist->brp_nerr) {
+		any_failed = PBSE_SYSTEM;
+		fprintf(stderr, "qsig: %d more jobs could not be signaled\n",
+			plist->brp_nfail - plist->brp_nerr);
+	}
+	PBSD_FreeReply(reply);
+}
+
 
 int
 main(int argc, char **argv, char **envp) /* qsig */
 {
 	int c;
+	int i;
+	int n;
 	int errflg=0;
-	int any_failed=0;
 
 	char job_id[PBS_MAXCLTJOBID];       /* from the command line */
 
 	char job_id_out[PBS_MAXCLTJOBID];
 	char server_out[MAXSERVERNAME];
-	char rmt_server[MAXSERVERNAME];
-
-#define MAX_SIGNAL_TYPE_LEN 32
-	static char sig_string[MAX_SIGNAL_TYPE_LEN+1] = "SIGTERM";
+	char cur_server[MAXSERVERNAME];	/* server of the jobs in ids */
+	char **ids;
 
 #define GETOPT_ARGS "s:"
 
@@ -110,43 +233,38 @@ main(int argc, char **argv, char **envp) /* qsig */
 		exit(2);
 	}
 
+	/* jobs given one after another for the same server are signaled together */
+	if ((ids = calloc(argc - optind + 1, sizeof(char *))) == NULL) {
+		fprintf(stderr, "qsig: out of memory\n");
+		exit(2);
+	}
+	n = 0;
 	for (; optind < argc; optind++) {
-		int connect;
-		int stat=0;
-		int located = FALSE;
-
 		strcpy(job_id, argv[optind]);
 		if (get_server(job_id, job_id_out, server_out)) {
 			fprintf(stderr, "qsig: illegally formed job identifier: %s\n", job_id);
 			any_failed = 1;
 			continue;
 		}
-cnt:
-		connect = cnt2server(server_out);
-		if (connect <= 0) {
-			fprintf(stderr, "qsig: cannot connect to server %s (errno=%d)\n",
-				pbs_server, pbs_errno);
-			any_failed = pbs_errno;
-			continue;
+		if (n > 0 && strcmp(server_out, cur_server) != 0) {
+			sigjob_list(ids, cur_server);
+			for (i = 0; i < n; i++)
+				free(ids[i]);
+			ids[0] = NULL;
+			n = 0;
 		}
-
-		stat = pbs_sigjob(connect, job_id_out, sig_string, NULL);
-		if (stat && (pbs_errno != PBSE_UNKJOBID)) {
-			prt_job_err("qsig", connect, job_id_out);
-			any_failed = pbs_errno;
-		} else if (stat && (pbs_errno == PBSE_UNKJOBID) && !located) {
-			located = TRUE;
-			if (locate_job(job_id_out, server_out, rmt_server)) {
-				pbs_disconnect(connect);
-				strcpy(server_out, rmt_server);
-				goto cnt;
-			}
-			prt_job_err("qsig", connect, job_id_out);
-			any_failed = pbs_errno;
+		if ((ids[n] = strdup(job_id_out)) == NULL) {
+			fprintf(stderr, "qsig: out of memory\n");
+			exit(2);
 		}
-
-		pbs_disconnect(connect);
+		ids[++n] = NULL;
+		strcpy(cur_server, server_out);
 	}
+	if (n > 0)
+		sigjob_list(ids, cur_server);
+	for (i = 0; i < n; i++)
+		free(ids[i]);
+	free(ids);
 
 	/*cleanup security library initializations before exiting*/
 	CS_close_app();
@@ -13,6 +13,11 @@
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <netinet/in.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <time.h>
 #include "libpbs.h"
 #include "dis.h"
 #include "server_limits.h"
@@ -22,6 +27,9 @@
 #include "pbs_ecl.h"
 
 #define PBS_IFF_MAX_CONN_RETRIES 6
+#define PBS_IFF_MAX_SESSIONS 8	/* server connections the daemon keeps open */
+#define PBS_IFF_MAX_CLIENTS 256	/* clients the daemon serves at once */
+#define PBS_IFF_MAX_ERRTXT 1024	/* longest server message passed to a client */
 
 /**
  * @file	iff2.c
@@ -30,9 +38,13 @@
  *
  * @par	Usage: call via pbs_connect() with
  *		pbs_iff [-t] hostname port [parent_connection_port]
+ *		pbs_iff -d
  *		pbs_iff --version
  *
  *		The parent_connection_port is required unless -t (for test) is given.
+ *
+ * @par	With -d, run by root, pbs_iff stays up as a daemon serving the clients
+ *	on this host over a unix socket, see iff_daemon().
  */
 /*
  * Copyright (C) 1994-2020 Altair Engineering, Inc.
@@ -75,6 +87,393 @@
 
 
 
+/*
+ * A connection the daemon keeps open from a reserved port to a server,
+ * on which it sends the authentication requests of the clients.
+ */
+static struct iff_session {
+	char is_server[PBS_MAXSERVERNAME + 1];
+	unsigned int is_port;
+	char is_client_addr[16];
+	int is_sock;
+} iff_sessions[PBS_IFF_MAX_SESSIONS];
+static int iff_next_session = 0;
+
+/*
+ * A client connection of the daemon.  The request is read and the answer
+ * written as the socket allows, so a client that is slow to talk holds up
+ * no other client.
+ */
+static struct iff_client {
+	int ic_sock;
+	uid_t ic_uid;			/* user at the other end of the socket */
+	time_t ic_expire;		/* drop the client if not answered by then */
+	struct iff_request ic_req;
+	size_t ic_in;			/* bytes of ic_req read so far */
+	char ic_out[2 * sizeof(int) + PBS_IFF_MAX_ERRTXT]; /* the answer */
+	size_t ic_outlen;		/* length of the answer, 0 until known */
+	size_t ic_done;			/* bytes of the answer written so far */
+} iff_clients[PBS_IFF_MAX_CLIENTS];
+
+/**
+ * @brief
+ *	close a session of the daemon
+ *
+ * @param[in] ps - the session
+ */
+static void
+iff_close_session(struct iff_session *ps)
+{
+	if (ps->is_sock >= 0)
+		(void)pbs_disconnect(ps->is_sock);
+	ps->is_sock = -1;
+	ps->is_server[0] = '\0';
+}
+
+/**
+ * @brief
+ *	find the open session to a server for a client address, or open one
+ *	in place of the oldest
+ *
+ * @param[in] preq - the client's request
+ *
+ * @return struct iff_session *
+ * @retval the session
+ * @retval NULL if the server cannot be reached
+ */
+static struct iff_session *
+iff_get_session(struct iff_request *preq)
+{
+	struct iff_session *ps;
+	pbs_net_t hostaddr;
+	int sock = -1;
+	int i;
+
+	for (i = 0; i < PBS_IFF_MAX_SESSIONS; i++) {
+		ps = &iff_sessions[i];
+		if (ps->is_sock >= 0 && ps->is_port == preq->ir_server_port &&
+			strcmp(ps->is_server, preq->ir_server) == 0 &&
+			strcmp(ps->is_client_addr, preq->ir_client_addr) == 0)
+			return ps;
+	}
+
+	/*
+	 * the other clients are waiting, so do not sleep between retries;
+	 * a client the daemon cannot serve runs pbs_iff, which does
+	 */
+	if ((hostaddr = get_hostaddr(preq->ir_server)) == (pbs_net_t)0)
+		return NULL;
+	for (i = 0; i < PBS_IFF_MAX_CONN_RETRIES; i++) {
+		sock = client_to_svr_extend(hostaddr, preq->ir_server_port, 1,
+			preq->ir_client_addr[0] != '\0' ? preq->ir_client_addr : NULL);
+		if (sock != PBS_NET_RC_RETRY)
+			break;
+	}
+	if (sock < 0)
+		return NULL;
+	if (pbs_client_thread_init_connect_context(sock) != 0) {
+		close(sock);
+		return NULL;
+	}
+
+	ps = &iff_sessions[iff_next_session];
+	iff_next_session = (iff_next_session + 1) % PBS_IFF_MAX_SESSIONS;
+	iff_close_session(ps);
+	strcpy(ps->is_server, preq->ir_server);
+	ps->is_port = preq->ir_server_port;
+	strcpy(ps->is_client_addr, preq->ir_client_addr);
+	ps->is_sock = sock;
+	return ps;
+}
+
+/**
+ * @brief
+ *	close a client connection of the daemon
+ *
+ * @param[in] pc - the client
+ */
+static void
+iff_drop_client(struct iff_client *pc)
+{
+	(void)close(pc->ic_sock);
+	pc->ic_sock = -1;
+}
+
+/**
+ * @brief
+ *	authenticate the connection of a client whose request has been read,
+ *	and build the answer pbs_iff would write on its stdout
+ *
+ * @param[in] pc - the client
+ *
+ * @return int
+ * @retval  0 the answer is in pc->ic_out
+ * @retval -1 the client cannot be served, drop it so that it runs pbs_iff
+ */
+static int
+iff_answer(struct iff_client *pc)
+{
+	struct iff_request *preq = &pc->ic_req;
+	struct iff_session *ps;
+	struct passwd *pwent;
+	char *msg;
+	int err;
+	int len;
+	int try;
+
+	/* a client of another version runs pbs_iff instead */
+	if (preq->ir_version != PBS_IFF_REQ_VERSION)
+		return -1;
+	if ((pwent = getpwuid(pc->ic_uid)) == NULL)
+		return -1;
+	preq->ir_server[PBS_MAXSERVERNAME] = '\0';
+	preq->ir_client_addr[sizeof(preq->ir_client_addr) - 1] = '\0';
+	preq->ir_encrypt_method[MAXAUTHNAME] = '\0';
+
+	/* a kept session may have been closed by the server, so try a new one */
+	for (try = 0; try < 2; try++) {
+		if ((ps = iff_get_session(preq)) == NULL)
+			return -1;
+		pbs_errno = 0;
+		err = tcp_send_auth_req(ps->is_sock, preq->ir_parent_port, pwent->pw_name,
+			AUTH_RESVPORT_NAME, preq->ir_encrypt_method[0] ? preq->ir_encrypt_method : NULL);
+		if (err == 0 || pbs_errno == PBSE_BADCRED)
+			break;
+		iff_close_session(ps);
+		ps = NULL;
+	}
+	if (ps == NULL)
+		return -1;
+
+	err = pbs_errno;
+	memcpy(pc->ic_out, &err, sizeof(int));
+	pc->ic_outlen = sizeof(int);
+	if (err == 0)
+		return 0;
+
+	/* the server closes the connection after a rejection */
+	msg = get_conn_errtxt(ps->is_sock);
+	len = (msg != NULL) ? strlen(msg) : 0;
+	if (len > PBS_IFF_MAX_ERRTXT)
+		len = PBS_IFF_MAX_ERRTXT;
+	memcpy(pc->ic_out + pc->ic_outlen, &len, sizeof(int));
+	pc->ic_outlen += sizeof(int);
+	if (len > 0)
+		memcpy(pc->ic_out + pc->ic_outlen, msg, len);
+	pc->ic_outlen += len;
+	iff_close_session(ps);
+	return 0;
+}
+
+/**
+ * @brief
+ *	move a client along: read what it sent, answer a complete request,
+ *	and write what the socket takes of the answer
+ *
+ * @param[in] pc - the client
+ * @param[in] revents - events poll() returned for the client socket
+ */
+static void
+iff_client_io(struct iff_client *pc, short revents)
+{
+	ssize_t n;
+
+	if (pc->ic_outlen == 0) {
+		if (!(revents & (POLLIN | POLLHUP | POLLERR)))
+			return;
+		n = read(pc->ic_sock, (char *)&pc->ic_req + pc->ic_in,
+			sizeof(pc->ic_req) - pc->ic_in);
+		if (n == -1 && (errno == EINTR || errno == EAGAIN))
+			return;
+		if (n <= 0) {
+			iff_drop_client(pc);
+			return;
+		}
+		pc->ic_in += n;
+		if (pc->ic_in < sizeof(pc->ic_req))
+			return;
+		if (iff_answer(pc) != 0) {
+			iff_drop_client(pc);
+			return;
+		}
+	} else if (!(revents & (POLLOUT | POLLHUP | POLLERR)))
+		return;
+
+	n = write(pc->ic_sock, pc->ic_out + pc->ic_done, pc->ic_outlen - pc->ic_done);
+	if (n == -1 && (errno == EINTR || errno == EAGAIN))
+		return;
+	if (n <= 0) {
+		iff_drop_client(pc);
+		return;
+	}
+	pc->ic_done += n;
+	if (pc->ic_done == pc->ic_outlen)
+		iff_drop_client(pc);
+}
+
+/**
+ * @brief
+ *	accept the waiting clients of the daemon into free client slots
+ *
+ * @param[in] lsock - listening socket
+ */
+static void
+iff_accept(int lsock)
+{
+	struct iff_client *pc;
+	struct ucred cred;
+	socklen_t credlen;
+	int csock;
+	int i;
+
+	for (i = 0; i < PBS_IFF_MAX_CLIENTS; i++) {
+		pc = &iff_clients[i];
+		if (pc->ic_sock >= 0)
+			continue;
+		if ((csock = accept(lsock, NULL, NULL)) == -1) {
+			if (errno == EINTR || errno == ECONNABORTED)
+				continue;
+			if (errno == EAGAIN || errno == EWOULDBLOCK)
+				return;
+			exit(1);
+		}
+		/* the user is the one at the other end of the socket */
+		credlen = sizeof(cred);
+		if (getsockopt(csock, SOL_SOCKET, SO_PEERCRED, &cred, &credlen) == -1 ||
+			fcntl(csock, F_SETFL, O_NONBLOCK) == -1) {
+			(void)close(csock);
+			continue;
+		}
+		(void)fcntl(csock, F_SETFD, FD_CLOEXEC);
+		pc->ic_sock = csock;
+		pc->ic_uid = cred.uid;
+		pc->ic_expire = time(NULL) + PBS_DIS_TCP_TIMEOUT_SHORT;
+		pc->ic_in = 0;
+		pc->ic_outlen = 0;
+		pc->ic_done = 0;
+	}
+}
+
+/**
+ * @brief
+ *	run pbs_iff as a daemon for the clients on this host
+ *
+ * @par	Clients find the daemon at PBS_TMPDIR/pbs_iff.sock and send it the
+ *	arguments they would give pbs_iff.  The daemon takes the user from
+ *	the credentials of the unix socket, and keeps its connections to the
+ *	server open, so a command costs neither a fork and exec of pbs_iff
+ *	nor a second connection to the server.
+ *
+ * @par	Up to PBS_IFF_MAX_CLIENTS clients are served at once from one poll()
+ *	loop.  Only the exchange with the server, which answers right away,
+ *	is done inline; a client that does not finish within
+ *	PBS_DIS_TCP_TIMEOUT_SHORT seconds is dropped and runs pbs_iff itself.
+ *
+ * @return int
+ * @retval 1 the daemon could not start, otherwise it does not return
+ */
+static int
+iff_daemon(void)
+{
+	struct sockaddr_un sun;
+	struct pollfd pollfds[PBS_IFF_MAX_CLIENTS + 1];
+	struct iff_client *slot[PBS_IFF_MAX_CLIENTS + 1];
+	mode_t oldmask;
+	time_t now;
+	int lsock;
+	int nfds;
+	int nfree;
+	int i;
+
+	if (getuid() != 0) {
+		fprintf(stderr, "pbs_iff: only root may run the daemon\n");
+		return (1);
+	}
+	if (pbs_loadconf(0) == 0 || pbs_conf.pbs_tmpdir == NULL) {
+		fprintf(stderr, "pbs_iff: cannot read the PBS configuration\n");
+		return (1);
+	}
+
+	memset(&sun, 0, sizeof(sun));
+	sun.sun_family = AF_UNIX;
+	snprintf(sun.sun_path, sizeof(sun.sun_path), "%s/%s", pbs_conf.pbs_tmpdir, PBS_IFF_SOCK);
+	if ((lsock = socket(AF_UNIX, SOCK_STREAM, 0)) == -1) {
+		perror("pbs_iff: socket");
+		return (1);
+	}
+	/* any user may connect; create it so rather than chmod a path in a public directory */
+	(void)unlink(sun.sun_path);
+	oldmask = umask(0);
+	i = bind(lsock, (struct sockaddr *)&sun, sizeof(sun));
+	(void)umask(oldmask);
+	if (i == -1 || listen(lsock, 256) == -1) {
+		perror("pbs_iff: cannot listen on socket");
+		return (1);
+	}
+	(void)fcntl(lsock, F_SETFD, FD_CLOEXEC);
+	(void)fcntl(lsock, F_SETFL, O_NONBLOCK);
+
+	/* go into the background */
+	if (fork() > 0)
+		return (0);
+	(void)setsid();
+	(void)signal(SIGPIPE, SIG_IGN);
+	(void)signal(SIGHUP, SIG_IGN);
+	i = open("/dev/null", O_RDWR);
+	(void)dup2(i, 0);
+	(void)dup2(i, 1);
+	(void)dup2(i, 2);
+	if (i > 2)
+		(void)close(i);
+
+	for (i = 0; i < PBS_IFF_MAX_SESSIONS; i++)
+		iff_sessions[i].is_sock = -1;
+	for (i = 0; i < PBS_IFF_MAX_CLIENTS; i++)
+		iff_clients[i].ic_sock = -1;
+
+	for (;;) {
+		now = time(NULL);
+		nfds = 0;
+		nfree = 0;
+		for (i = 0; i < PBS_IFF_MAX_CLIENTS; i++) {
+			struct iff_client *pc = &iff_clients[i];
+
+			if (pc->ic_sock >= 0 && now >= pc->ic_expire)
+				iff_drop_client(pc);
+			if (pc->ic_sock < 0) {
+				nfree++;
+				continue;
+			}
+			pollfds[nfds].fd = pc->ic_sock;
+			pollfds[nfds].events = (pc->ic_outlen == 0) ? POLLIN : POLLOUT;
+			pollfds[nfds].revents = 0;
+			slot[nfds++] = pc;
+		}
+		/* leave new clients in the backlog while every slot is busy */
+		if (nfree > 0) {
+			pollfds[nfds].fd = lsock;
+			pollfds[nfds].events = POLLIN;
+			pollfds[nfds].revents = 0;
+			slot[nfds++] = NULL;
+		}
+
+		if (poll(pollfds, nfds, 1000) == -1) {
+			if (errno == EINTR)
+				continue;
+			exit(1);
+		}
+		for (i = 0; i < nfds; i++) {
+			if (pollfds[i].revents == 0)
+				continue;
+			if (slot[i] == NULL)
+				iff_accept(lsock);
+			else
+				iff_client_io(slot[i], pollfds[i].revents);
+		}
+	}
+}
+
+
 int
 main(int argc, char *argv[], char *envp[])
 {
@@ -92,6 +491,7 @@ main(int argc, char *argv[], char *envp[])
 	struct sockaddr_in sockname;
 	pbs_socklen_t	 socknamelen;
 	int		 testmode = 0;
+	int		 daemonmode = 0;
 	extern int	optind;
 	char *cln_hostaddr = NULL;
 
@@ -109,8 +509,11 @@ main(int argc, char *argv[], char *envp[])
 		}
 	}
 
-	while ((i = getopt(argc, argv, "ti:")) != EOF) {
+	while ((i = getopt(argc, argv, "dti:")) != EOF) {
 		switch (i) {
+			case 'd':
+				daemonmode = 1;
+				break;
 			case 't':
 				testmode = 1;
 				break;
@@ -125,6 +528,21 @@ main(int argc, char *argv[], char *envp[])
 		err = 1;
 	}
 
+	if (daemonmode) {
+		if (testmode || cln_hostaddr != NULL || optind != argc) {
+			fprintf(stderr, "Usage: %s -d\n", argv[0]);
+			return (1);
+		}
+		pbs_client_thread_set_single_threaded_mode();
+		set_no_attribute_verification();
+		if (pbs_client_thread_init_thread_context() != 0) {
+			fprintf(stderr, "pbs_iff: thread initialization failed\n");
+			return (1);
+		}
+		DIS_tcp_funcs();
+		return (iff_daemon());
+	}
+
 	/* Keep the backward compatibility of pbs_iff.
 	 * If the invoker component is older version,
 	 * It will pass one lesser argument to pbs_iff.
@@ -145,6 +563,7 @@ main(int argc, char *argv[], char *envp[])
 		fprintf(stderr,
 			"Usage: %s [-t] host port [parent_sock][parent_port]\n",
 			argv[0]);
+		fprintf(stderr, "       %s -d\n", argv[0]);
 		fprintf(stderr, "       %s --version\n", argv[0]);
 		return (1);
 	}
@@ -457,6 +457,7 @@ extern void free_depend(attribute *attr);
 extern void free_unkn(attribute *attr);
 extern int   parse_equal_string(char  *start, char **name, char **value);
 extern char *parse_comma_string(char *start);
+extern char *parse_comma_string_save(char *start, char **savep);
 extern char *return_external_value(char *name, char *val);
 extern char *return_internal_value(char *name, char *val);
 
@@ -600,6 +601,13 @@ extern int encode_attr_db(struct attribute_def *padef, struct attribute *pattr,
 extern int decode_attr_db(void *parent, pbs_db_attr_list_t *db_attr_list, 
 	void *padef_idx, struct attribute_def *padef, struct attribute *pattr, int limit, int unknown);
 
+/* decode_attr_db_part() steps, see attr_recov_db.c */
+#define ATTR_DB_DECODE_ALL	0	/* everything, as decode_attr_db() */
+#define ATTR_DB_DECODE_MT	1	/* values safe to decode off the main thread */
+#define ATTR_DB_DECODE_REST	2	/* the other values and the recovery actions */
+extern int decode_attr_db_part(void *parent, pbs_db_attr_list_t *db_attr_list,
+	void *padef_idx, struct attribute_def *padef, struct attribute *pattr, int limit, int unknown, int part);
+
 extern int is_attr(int, char *, int);
 
 extern int set_attr(struct attrl **attrib, char *attrib_name, char *attrib_value);
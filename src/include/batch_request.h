@@ -102,14 +102,21 @@ struct rq_manage {
 	pbs_list_head rq_attr; /* svrattrlist */
 };
 
-/* Management - used by PBS_BATCH_Manager requests */
+/* Management - used by PBS_BATCH_Manager and PBS_BATCH_ManagerList requests */
 struct rq_management {
 	struct rq_manage rq_manager;
 	struct batch_reply *rq_reply;
 	long rq_time;
+	char *rq_objlist; /* comma separated object names, ManagerList only */
 };
 
 
+/* ModifyJobList - attribute updates for several jobs */
+struct rq_modifyjoblist {
+	int rq_count;
+	struct rq_manage *rq_jobs;
+};
+
 /* HoldJob -  plus preference flag */
 struct rq_hold {
 	struct rq_manage rq_orig;
@@ -156,12 +163,27 @@ struct rq_runjob {
 	unsigned long rq_resch;
 };
 
+/* RunJobList - jobs to run, each on its own destination */
+struct rq_runjoblist {
+	int rq_count;
+	struct rq_runjob *rq_jobs;
+	int rq_cur;	/* index of the job being run */
+};
+
 /* SignalJob */
 struct rq_signal {
 	char rq_jid[PBS_MAXSVRJOBID + 1];
 	char rq_signame[PBS_SIGNAMESZ + 1];
 };
 
+/* DeleteJobList, SignalJobList - jobs named in a list or picked by a filter */
+struct rq_joblist {
+	int rq_count;
+	char **rq_jobids;			/* job ids, may be ranges of subjobs */
+	pbs_list_head rq_filter;		/* svrattrl: owner, job_state, queue */
+	char rq_signame[PBS_SIGNAMESZ + 1];	/* SignalJobList only */
+};
+
 /* Status (job, queue, server, hook) */
 struct rq_status {
 	char *rq_id; /* allow mulitple (job) ids */
@@ -274,6 +296,7 @@ struct batch_request {
 	int prot;				/* PROT_TCP or PROT_TPP */
 	int tpp_ack;				/* send acks for this tpp stream? */
 	char *tppcmd_msgid;			/* msg id for tpp commands */
+	int rq_reqid;				/* client request id, 0 if none */
 	struct batch_reply rq_reply;		/* the reply area for this request */
 	union indep_request {
 		struct rq_auth rq_auth;
@@ -292,12 +315,15 @@ struct batch_request {
 		struct rq_relnodes rq_relnodes;
 		struct rq_py_spawn rq_py_spawn;
 		struct rq_manage rq_modify;
+		struct rq_modifyjoblist rq_modifylist;
 		struct rq_move rq_move;
 		struct rq_register rq_register;
 		struct rq_manage rq_release;
 		char rq_rerun[PBS_MAXSVRJOBID + 1];
 		struct rq_rescq rq_rescq;
 		struct rq_runjob rq_run;
+		struct rq_runjoblist rq_runlist;
+		struct rq_joblist rq_joblist;
 		struct rq_selstat rq_select;
 		int rq_shutdown;
 		struct rq_signal rq_signal;
@@ -344,11 +370,16 @@ extern void req_connect(struct batch_request *);
 extern void req_defschedreply(struct batch_request *);
 extern void req_locatejob(struct batch_request *);
 extern void req_manager(struct batch_request *);
+extern void req_modifyjoblist(struct batch_request *);
 extern void req_movejob(struct batch_request *);
 extern void req_register(struct batch_request *);
 extern void req_releasejob(struct batch_request *);
 extern void req_rescq(struct batch_request *);
 extern void req_runjob(struct batch_request *);
+extern void req_runjoblist(struct batch_request *);
+extern void req_joblist(struct batch_request *);
+extern void joblist_child_reply(struct batch_request *, struct batch_request *);
+extern int joblist_next(void);
 extern void req_selectjobs(struct batch_request *);
 extern void req_stat_que(struct batch_request *);
 extern void req_stat_svr(struct batch_request *);
@@ -377,6 +408,8 @@ extern int decode_DIS_CopyHookFile(int, struct batch_request *);
 extern int decode_DIS_DelHookFile(int, struct batch_request *);
 extern int decode_DIS_JobObit(int, struct batch_request *);
 extern int decode_DIS_Manage(int, struct batch_request *);
+extern int decode_DIS_ManageList(int, struct batch_request *);
+extern int decode_DIS_ModifyList(int, struct batch_request *);
 extern int decode_DIS_MoveJob(int, struct batch_request *);
 extern int decode_DIS_MessageJob(int, struct batch_request *);
 extern int decode_DIS_ModifyResv(int, struct batch_request *);
@@ -409,6 +442,8 @@ extern int encode_DIS_Cred(int, char *, char *, int, char *, size_t, long);
 extern int dis_request_read(int, struct batch_request *);
 extern int dis_reply_read(int, struct batch_reply *, int);
 extern int decode_DIS_PreemptJobs(int, struct batch_request *);
+extern int decode_DIS_RunList(int, struct batch_request *);
+extern int decode_DIS_JobList(int, struct batch_request *);
 
 #ifdef __cplusplus
 }
@@ -369,6 +369,7 @@ extern hook *find_hookbyevent(int);
 extern int encode_hook_content(char *, char *, char *, char *, size_t);
 extern int decode_hook_content(char *, char *, char *, char *, size_t);
 extern void print_hooks(unsigned int);
+extern unsigned long hook_bundle_checksum(unsigned long);
 extern void mark_hook_file_bad(char *);
 
 extern char *hook_event_as_string(unsigned int);
@@ -302,6 +302,31 @@ typedef struct	noderes {
 	enum PBS_NodeRes_Status nr_status;
 } noderes;
 
+/*
+ * A sister that passes an IM_POLL_JOB down the fan-out tree (see
+ * $sister_fanout) collects one of these records per host in its
+ * subtree, and sends them all up to its parent in a single reply.
+ */
+typedef struct im_relay_rec {
+	pbs_list_link	rr_link;
+	int		rr_host;	/* index into ji_hosts */
+	int		rr_status;	/* 0 or error seen for the host */
+	int		rr_exitval;	/* recommendation to kill the job */
+	unsigned long	rr_cput;	/* cpu time */
+	unsigned long	rr_mem;		/* memory */
+	unsigned long	rr_cpupercent;	/* cpu percent */
+	pbs_list_head	rr_used;	/* svrattrl list of hook set resources */
+} im_relay_rec;
+
+typedef struct im_relay {
+	int		ir_stream;	/* stream to the parent */
+	tm_event_t	ir_event;	/* event the parent waits on */
+	tm_event_t	ir_gen;		/* tags events sent to children */
+	int		ir_pending;	/* children not yet heard from */
+	int		ir_nrecs;	/* number of entries in ir_recs */
+	pbs_list_head	ir_recs;	/* list of im_relay_rec */
+} im_relay;
+
 /* State for a sister */
 
 #define SISTER_OKAY		0
@@ -487,6 +512,9 @@ struct job {
 					 * vnodes assigned to the job
 					 */
 	tm_node_id	ji_nodekill;	/* set to nodeid requesting job die */
+	im_relay       *ji_relay;	/* POLL being relayed down the tree */
+	pbs_list_head	ji_rused_sent;	/* usage last sent, $resc_used_delta */
+	time_t		ji_rused_sent_time; /* when all changes were last sent */
 	int		ji_flags;	/* mom only flags */
 	void	       *ji_setup;	/* save setup info */
 
@@ -502,6 +530,8 @@ struct job {
 	int		ji_discarding;	/* discarding job */
 	struct batch_request *ji_prunreq; /* outstanding runjob request */
 	pbs_list_head	ji_svrtask;	/* links to svr work_task list */
+	pbs_list_link	ji_rusedsave;	/* links to jobs with unsaved usage */
+	pbs_list_link	ji_histjobs;	/* links to history jobs, by age */
 	struct pbs_queue  *ji_qhdr;	/* current queue header */
 	struct resc_resv  *ji_myResv;	/* !=0 job belongs to a reservation */
 	/* see also, attribute JOB_ATR_myResv */
@@ -761,6 +791,7 @@ typedef struct	infoent {
 #define IM_EXEC_PROLOGUE	24
 #define IM_CRED 		25
 #define IM_PMIX			26
+#define IM_RELAY		27	/* command passed down the fan-out tree */
 
 #define IM_ERROR		99
 #define IM_ERROR2		100
@@ -62,6 +62,7 @@ extern "C" {
 
 #define PBS_BATCH_PROT_TYPE 2
 #define PBS_BATCH_PROT_VER  1
+#define PBS_BATCH_PROT_VER_ASYNC 2 /* header and reply carry a request id */
 #define SCRIPT_CHUNK_Z (65536)
 #ifndef TRUE
 #define TRUE  1
@@ -120,8 +121,19 @@ typedef struct pbs_conn {
 	char *ch_errtxt;	  /* pointer to last server error text	*/
 	pthread_mutex_t ch_mutex; /* serialize connection between threads */
 	pbs_tcp_chan_t *ch_chan;  /* pointer tcp chan structure for this connection */
+	int ch_lastid;		  /* last request id handed out on this connection */
+	int ch_pending;		  /* requests sent with an id and not yet completed */
+	struct pbs_async_done *ch_done; /* completions read ahead of their poll */
 } pbs_conn_t;
 
+/* reply to a request sent with a request id, queued until it is polled */
+struct pbs_async_done {
+	struct pbs_async_done *ad_next;
+	int ad_reqid;
+	int ad_code;
+	char *ad_errtxt;
+};
+
 int destroy_connection(int);
 int set_conn_errtxt(int, const char *);
 char * get_conn_errtxt(int);
@@ -130,6 +142,10 @@ int get_conn_errno(int);
 pbs_tcp_chan_t * get_conn_chan(int);
 int set_conn_chan(int, pbs_tcp_chan_t *);
 pthread_mutex_t * get_conn_mutex(int);
+int new_conn_reqid(int);
+int add_conn_done(int, int, int, char *);
+int get_conn_done(int, int *, int *, char **);
+int get_conn_pending(int);
 
 /* max number of preempt orderings */
 #define PREEMPT_ORDER_MAX 20
@@ -173,6 +189,26 @@ struct rq_preempt {
 
 typedef struct rq_preempt brp_preempt_jobs;
 
+/* reply to Run Job List Request, one result code per job in request order */
+struct brp_runjobs {
+	int brp_count;
+	int *brp_codes;
+};
+
+/* a job a Delete/Signal Job List Request failed on */
+struct brp_joberr {
+	char brp_jobid[PBS_MAXSVRJOBID + 1];
+	int brp_code;
+};
+
+/* reply to Delete/Signal Job List Request */
+struct brp_joblist {
+	int brp_ndone;			/* jobs deleted or signaled */
+	int brp_nfail;			/* jobs that failed */
+	int brp_nerr;			/* failed jobs listed in brp_errs */
+	struct brp_joberr *brp_errs;
+};
+
 #define BATCH_REPLY_CHOICE_NULL		1	/* no reply choice, just code */
 #define BATCH_REPLY_CHOICE_Queue	2	/* Job ID, see brp_jid */
 #define BATCH_REPLY_CHOICE_RdytoCom	3	/* select, see brp_jid */
@@ -183,6 +219,8 @@ typedef struct rq_preempt brp_preempt_jobs;
 #define BATCH_REPLY_CHOICE_Locate	8	/* locate, see brp_locate */
 #define BATCH_REPLY_CHOICE_RescQuery	9	/* Resource Query */
 #define BATCH_REPLY_CHOICE_PreemptJobs	10	/* Preempt Job */
+#define BATCH_REPLY_CHOICE_RunJobs	11	/* Run Job List, see brp_runjobs */
+#define BATCH_REPLY_CHOICE_JobList	12	/* Delete/Signal Job List, see brp_joblist */
 
 /*
  * the following is the basic Batch Reply structure
@@ -192,6 +230,7 @@ struct batch_reply
 	int brp_code;
 	int brp_auxcode;
 	int brp_choice; /* the union discriminator */
+	int brp_reqid; /* request id of the request answered, 0 if none */
 	union {
 		char brp_jid[PBS_MAXSVRJOBID + 1];
 		struct brp_select *brp_select; /* select replies */
@@ -204,6 +243,8 @@ struct batch_reply
 		char brp_locate[PBS_MAXDEST + 1];
 		struct brp_rescq brp_rescq; /* query resource reply */
 		brp_preempt_jobs brp_preempt_jobs; /* preempt jobs reply */
+		struct brp_runjobs brp_runjobs; /* run job list reply */
+		struct brp_joblist brp_joblist; /* delete/signal job list reply */
 	} brp_un;
 };
 
@@ -279,6 +320,11 @@ struct batch_reply
 #define PBS_BATCH_Authenticate		95
 #define PBS_BATCH_ModifyJob_Async	96
 #define PBS_BATCH_AsyrunJob_ack	97
+#define PBS_BATCH_ManagerList	98
+#define PBS_BATCH_RunJobList	99
+#define PBS_BATCH_ModifyJobList_Async	100
+#define PBS_BATCH_DeleteJobList	101
+#define PBS_BATCH_SignalJobList	102
 
 #define PBS_BATCH_FileOpt_Default	0
 #define PBS_BATCH_FileOpt_OFlg		1
@@ -286,6 +332,23 @@ struct batch_reply
 
 #define PBS_IFF_CLIENT_ADDR "PBS_IFF_CLIENT_ADDR"
 
+/*
+ * Unix socket, in PBS_TMPDIR, of the pbs_iff daemon started with "pbs_iff -d".
+ * A client sends it a struct iff_request in place of running pbs_iff, and
+ * reads back the same answer pbs_iff writes on its stdout.
+ */
+#define PBS_IFF_SOCK "pbs_iff.sock"
+#define PBS_IFF_REQ_VERSION 1	/* version of struct iff_request */
+
+struct iff_request {
+	unsigned int ir_version;		/* PBS_IFF_REQ_VERSION */
+	char ir_server[PBS_MAXSERVERNAME + 1];	/* server host */
+	unsigned int ir_server_port;		/* server port */
+	char ir_client_addr[16];		/* address the client connected from */
+	unsigned int ir_parent_port;		/* port of the client's connection */
+	char ir_encrypt_method[MAXAUTHNAME + 1];
+};
+
 /* time out values for tcp_dis read/write */
 #define PBS_DIS_TCP_TIMEOUT_CONNECT	10
 #define PBS_DIS_TCP_TIMEOUT_REPLY	10
@@ -316,6 +379,10 @@ extern int PBSD_copyhookfile(int, char *, int, char **);
 extern int PBSD_delhookfile(int, char *, int, char **);
 extern int PBSD_mgr_put(int, int, int, int, char *, struct attropl *, char *, int, char **);
 extern int PBSD_manager(int, int, int, int, char *, struct attropl *, char *);
+extern int PBSD_manager_async(int, int, int, int, char *, struct attropl *, char *);
+extern int PBSD_deljob_async(int, char *, char *);
+extern int PBSD_async_poll(int, int, int *);
+extern int PBSD_async_pending(int);
 extern int PBSD_msg_put(int, char *, int, char *, char *, int, char **);
 extern int PBSD_relnodes_put(int, char *, char *, char *, int, char **);
 extern int PBSD_py_spawn_put(int, char *, char **, char **, int, char **);
@@ -328,6 +395,9 @@ extern struct batch_reply *PBSD_rdrpy_sock(int, int *);
 extern void PBSD_FreeReply(struct batch_reply *);
 extern struct batch_status *PBSD_status(int, int, char *, struct attrl *, char *);
 extern preempt_job_info *PBSD_preempt_jobs(int, char **);
+extern int PBSD_runjob_list(int, int, char **, char **, int *);
+extern struct batch_reply *PBSD_joblist(int, int, char **, struct attrl *, char *, char *);
+extern int PBSD_modifyjob_list(int, int, char **, struct attrl **);
 extern struct batch_status *PBSD_status_get(int);
 extern char *PBSD_queuejob(int, char *, char *, struct attropl *, char *, int, char **, int *);
 extern int decode_DIS_svrattrl(int, pbs_list_head *);
@@ -349,10 +419,14 @@ extern int encode_DIS_SubmitResv(int, char *, struct attropl *);
 extern int encode_DIS_JobCredential(int, int, char *, int);
 extern int encode_DIS_ReqExtend(int, char *);
 extern int encode_DIS_ReqHdr(int, int, char *);
+extern int encode_DIS_ReqHdr_id(int, int, char *, int);
 extern int encode_DIS_Rescq(int, char **, int);
 extern int encode_DIS_Run(int, char *, char *, unsigned long);
+extern int encode_DIS_RunList(int, int, char **, char **);
+extern int encode_DIS_ModifyList(int, int, char **, struct attrl **);
 extern int encode_DIS_ShutDown(int, int);
 extern int encode_DIS_SignalJob(int, char *, char *);
+extern int encode_DIS_JobList(int, char **, struct attrl *, char *);
 extern int encode_DIS_Status(int, char *, struct attrl *);
 extern int encode_DIS_attrl(int, struct attrl *);
 extern int encode_DIS_attropl(int, struct attropl *);
@@ -147,6 +147,15 @@ extern enum hup_action	call_hup;
 
 extern int mock_run;
 
+/*
+ * Values for $proc_tracking: how the poll loop samples job processes.
+ */
+#define PROC_TRACK_SCAN		0	/* read every process in /proc */
+#define PROC_TRACK_JOB		1	/* read only processes of known jobs */
+extern int proc_tracking;
+
+extern int stage_parallel;	/* $stage_parallel: remote copies at once */
+
 /* public funtions within MOM */
 
 #ifdef	_PBS_JOB_H
@@ -223,6 +232,7 @@ extern int   mom_deljob_wait(job *);
 extern int   run_pelog(int which, char *file, job *pjob, int pe_io_type);
 extern int   is_joined(job *);
 extern void  update_jobs_status(void);
+extern void  reset_resc_used_sent(void);
 extern void  update_ajob_status(job *);
 extern void  update_ajob_status_using_cmd(job *, int, int);
 extern void  calc_cpupercent(job *, unsigned long, unsigned long, time_t);
@@ -231,6 +241,8 @@ extern int   task_save(pbs_task *ptask);
 extern void send_join_job_restart(int, eventent *, int, job *, pbs_list_head *);
 extern int send_resc_used_to_ms(int stream, job *pjob);
 extern int recv_resc_used_from_sister(int stream, job *pjob, int nodeidx);
+extern int get_resc_used_hook_list(job *pjob, pbs_list_head *phead);
+extern int set_resc_used_from_list(job *pjob, int nodeidx, pbs_list_head *phead);
 extern int  is_comm_up(int);
 
 /* Defines for pe_io_type, see run_pelog() */
@@ -256,6 +268,11 @@ extern void	end_proc(void);
 extern int	task_recov(job *pjob);
 extern int	send_sisters(job *pjob, int com, pbs_jobndstm_t);
 extern int	send_sisters_inner(job *pjob, int com, pbs_jobndstm_t, char *);
+extern int	send_sisters_tree(job *pjob, int com, char *);
+extern int	im_relay_request(int stream, job *pjob, tm_event_t event);
+extern int	im_relay_reply(int stream, job *pjob, tm_event_t gen);
+extern void	im_relay_failed(job *pjob, hnodent *np, int errcode, tm_event_t gen);
+extern void	im_relay_free(job *pjob);
 extern int	send_sisters_job_update(job *pjob);
 extern int	im_compose(int stream, char *jobid, char *cookie,
 	int command, tm_event_t	event, tm_task_id taskid, int version);
@@ -349,6 +366,7 @@ extern int is_child_path(char *, char *);
 extern int pbs_glob(char *, char *);
 extern void  rmjobdir(char *, char *, uid_t, gid_t);
 extern int stage_file(int, int, char *, struct rqfpair *, int, cpy_files *, char *);
+extern int stage_file_finish(cpy_files *);
 #ifdef WIN32
 extern void  bld_wenv_variables(char *, char *);
 extern void  init_envp(void);
@@ -70,6 +70,7 @@ typedef unsigned long pbs_net_t;        /* for holding host addresses */
 #define PBS_NET_CONN_FORCE_QSUB_UPDATE	0x10
 /* Unused - #define PBS_NET_CONN_GSSAPIAUTH 0x20 */
 #define PBS_NET_CONN_TO_SCHED	0x40
+#define PBS_NET_CONN_ASYNC	0x80	/* client sent requests with request ids */
 
 #define	QSUB_DAEMON	"qsub-daemon"
 
@@ -114,9 +115,10 @@ typedef unsigned long pbs_net_t;        /* for holding host addresses */
 #define IS_HOOK_JOB_ACTION              16 /* request from hook to delete/requeue job */
 #define IS_HOOK_ACTION_ACK              17 /* acknowledge a request of the above 2    */
 #define IS_HOOK_SCHEDULER_RESTART_CYCLE 18 /* hook wish scheduler to recycle */
-#define IS_HOOK_CHECKSUMS               19 /* mom reports about hooks seen */
+#define IS_HOOK_CHECKSUMS               19 /* mom reports about hooks seen, or server asks for that */
 #define IS_UPDATE_FROM_HOOK2            20 /* request to update vnodes from a hook running on a parent mom host or an allowed non-parent mom host */
 #define IS_HELLOSVR                     21 /* hello send to server from mom to initiate a hello sequence */
+#define IS_HOOK_BUNDLE                  22 /* mom reports one checksum of all its hooks */
 
 #define IS_CMD          40
 #define IS_CMD_REPLY    41
@@ -375,6 +375,35 @@ int pbs_db_save_obj(void *conn, pbs_db_obj_info_t *obj, int savetype);
  */
 int pbs_db_delete_obj(void *conn, pbs_db_obj_info_t *obj);
 
+/**
+ * @brief
+ *	Start a transaction, so that the following saves and deletes are
+ *	committed together by pbs_db_end_trx()
+ *
+ * @param[in]	conn - Connected database handle
+ *
+ * @return      int
+ * @retval      -1  - Failure
+ * @retval       0  - success
+ *
+ */
+int pbs_db_begin_trx(void *conn);
+
+/**
+ * @brief
+ *	End the transaction started by pbs_db_begin_trx()
+ *
+ * @param[in]	conn - Connected database handle
+ * @param[in]	commit - 1 to commit, 0 to roll back
+ *
+ * @return      int
+ * @retval      -1  - Failure, or the transaction was rolled back
+ *			  instead of committed
+ * @retval       0  - success
+ *
+ */
+int pbs_db_end_trx(void *conn, int commit);
+
 /**
  * @brief
  *	Delete attributes of an existing object from the database
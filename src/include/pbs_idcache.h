@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 1994-2020 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+#ifndef _PBS_IDCACHE_H
+#define _PBS_IDCACHE_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <sys/types.h>
+#include <pwd.h>
+#include <grp.h>
+
+/*
+ * Cache of user and group lookups (passwd, group and supplementary group
+ * list of a user) for the daemons, see pbs_idcache.c
+ */
+
+#define PBS_IDCACHE_TTL		300	/* seconds a found entry is good for */
+#define PBS_IDCACHE_NEG_TTL	60	/* seconds a not found entry is good for */
+#define PBS_IDCACHE_REFRESH	60	/* seconds between refresher passes */
+#define PBS_IDCACHE_STATS	3600	/* seconds between logging the stats */
+
+extern int idcache_init(int ttl, int neg_ttl, int refresher);
+extern struct passwd *idcache_getpwnam(const char *name);
+extern struct group *idcache_getgrnam(const char *name);
+extern int idcache_initgroups(const char *user, gid_t gid);
+extern void idcache_refresh(void);
+extern void idcache_log_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _PBS_IDCACHE_H */
@@ -331,6 +331,7 @@ extern "C" {
 #define ATTR_cred_renew_period	"cred_renew_period"
 #define ATTR_cred_renew_cache_period "cred_renew_cache_period"
 #define ATTR_attr_update_period "attr_update_period"
+#define ATTR_stat_snapshot_threshold "stat_snapshot_threshold"
 
 /**
  * RPP_MAX_PKT_CHECK_DEFAULT controls the number of loops used to process
@@ -363,6 +364,9 @@ extern "C" {
 #define ATTR_sched_preempt_sort  "preempt_sort"
 #define ATTR_sched_server_dyn_res_alarm "server_dyn_res_alarm"
 #define ATTR_job_run_wait "job_run_wait"
+#define ATTR_sched_cycle_min_interval "sched_cycle_min_interval"
+#define ATTR_sched_triggers "sched_triggers"
+#define ATTR_sched_cycles "sched_cycles"
 
 /* additional node "attributes" names */
 
@@ -237,6 +237,8 @@ struct pbs_config
 	unsigned pbs_use_compression:1;	/* whether pbs should compress communication data */
 	unsigned pbs_use_mcast:1;		/* whether pbs should multicast communication */
 	unsigned pbs_use_ft:1;		/* whether pbs should force use fault tolerant communications */
+	char *pbs_compression_type;		/* codec used to compress communication data (zlib, lz4, zstd) */
+	char *pbs_compression_dict;		/* path to a shared dictionary used by the compression codec */
 	char *pbs_leaf_name;			/* non-default name of this leaf in the communication network */
 	char *pbs_leaf_routers;		/* for this leaf, the optional list of routers to talk to */
 	char *pbs_comm_name;			/* non-default name of this router in the communication network */
@@ -277,6 +279,8 @@ extern struct pbs_config pbs_conf;
 #define PBS_CONF_DATA_SERVICE_PORT           "PBS_DATA_SERVICE_PORT"
 #define PBS_CONF_DATA_SERVICE_HOST           "PBS_DATA_SERVICE_HOST"
 #define PBS_CONF_USE_COMPRESSION     	     "PBS_USE_COMPRESSION"
+#define PBS_CONF_COMPRESSION_TYPE	     "PBS_COMPRESSION_TYPE"
+#define PBS_CONF_COMPRESSION_DICT	     "PBS_COMPRESSION_DICT"
 #define PBS_CONF_USE_MCAST		     "PBS_USE_MCAST"
 #define PBS_CONF_FORCE_FT_COMM		     "PBS_FORCE_FT_COMM"
 #define PBS_CONF_LEAF_NAME		     "PBS_LEAF_NAME"
@@ -258,6 +258,8 @@ struct pbsnode {
 	struct devices device;
 	attribute nd_attr[ND_ATR_LAST];
 	short newobj; /* new node ? */
+	char nd_savehash[DIGEST_LENGTH]; /* signature of what was last saved */
+	pbs_list_link nd_savelink; /* on list of nodes whose save was put off */
 };
 
 enum	warn_codes { WARN_none, WARN_ngrp_init, WARN_ngrp_ck, WARN_ngrp };
@@ -445,6 +447,8 @@ extern char *msg_daemonname;
 
 #ifndef PBS_MOM
 extern int node_save_db(struct pbsnode *pnode);
+extern void node_save_db_defer(struct pbsnode *pnode);
+extern void flush_node_saves(void);
 struct pbsnode *node_recov_db(char *nd_name, struct pbsnode *pnode);
 extern int add_mom_to_pool(mominfo_t *);
 extern void remove_mom_from_pool(mominfo_t *);
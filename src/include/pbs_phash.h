@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 1994-2020 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+#ifndef _PBS_PHASH_H
+#define _PBS_PHASH_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+/*
+ * Minimal perfect hash over a fixed set of names, such as the names in an
+ * attribute or resource definition table.  The table is built once and is
+ * read only afterwards, so lookups need no locking and allocate nothing.
+ * Names are compared without regard to case.
+ */
+typedef struct pbs_phash pbs_phash;
+
+/**
+ * @brief
+ *	Build a perfect hash table over a list of names
+ *
+ * @param[in] - names - the names; they must stay valid for the life of the table
+ * @param[in] - n     - number of names
+ *
+ * @return pbs_phash *
+ * @retval !NULL - success
+ * @retval NULL  - failure
+ *
+ */
+extern pbs_phash *pbs_phash_create(char **names, int n);
+
+/**
+ * @brief
+ *	Free a table made by pbs_phash_create()
+ *
+ * @param[in] - ph - the table
+ *
+ * @return void
+ *
+ */
+extern void pbs_phash_destroy(pbs_phash *ph);
+
+/**
+ * @brief
+ *	Find a name in the table
+ *
+ * @param[in] - ph   - the table
+ * @param[in] - name - name to find, need not be null terminated
+ * @param[in] - len  - length of name
+ *
+ * @return int
+ * @retval >=0 - position of the name in the list given to pbs_phash_create()
+ * @retval -1  - not found
+ *
+ */
+extern int pbs_phash_find(pbs_phash *ph, const char *name, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _PBS_PHASH_H */
@@ -91,6 +91,9 @@ typedef struct pbs_sched {
 	pbs_net_t pbs_scheduler_addr;
 	unsigned int pbs_scheduler_port;
 	time_t sch_next_schedule;		/* when to next run scheduler cycle */
+	time_t sch_cycle_end;			/* when the last scheduler cycle ended */
+	long sch_triggers;			/* scheduling triggers received */
+	long sch_cycles;			/* scheduler cycles started */
 	char sc_name[PBS_MAXSCHEDNAME + 1];
 	struct preempt_ordering preempt_order[PREEMPT_ORDER_MAX + 1];
 	/* sched object's attributes  */
@@ -102,6 +105,7 @@ typedef struct pbs_sched {
 extern pbs_sched *dflt_scheduler;
 extern	pbs_list_head	svr_allscheds;
 extern void set_scheduler_flag(int flag, pbs_sched *psched);
+extern int sched_trigger_wait(pbs_sched *psched);
 extern int find_assoc_sched_jid(char *jid, pbs_sched **target_sched);
 extern int find_assoc_sched_pque(pbs_queue *pq, pbs_sched **target_sched);
 extern pbs_sched *find_sched_from_sock(int sock);
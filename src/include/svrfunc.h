@@ -111,6 +111,7 @@ extern int update_svrlive(void);
 extern void init_socket_licenses(char *);
 extern void update_job_finish_comment(job *, int, char *);
 extern void svr_saveorpurge_finjobhist(job *);
+extern void flush_rused_saves(void);
 extern int recreate_exec_vnode(job *, char *, char *, char *, int);
 extern void unset_extra_attributes(job *);
 extern int node_delete_db(struct pbsnode *);
@@ -167,6 +168,7 @@ extern int is_ts_node(char *);
 extern char *cnv_eh(job *);
 extern char *find_ts_node(void);
 extern void job_purge(job *);
+extern void job_purge_batch(int);
 extern void check_block(job *, char *);
 extern void free_nodes(job *);
 extern int job_route(job *);
@@ -179,6 +181,8 @@ extern char *lastname(char *);
 extern void chk_array_doneness(job *);
 extern void update_array_indices_remaining_attr(job *);
 extern job *create_subjob(job *, char *, int *);
+extern void subjob_inherit_attrs(job *);
+extern void subjob_keep_attrs(job *);
 extern char *cvt_range(struct ajtrkhd *, int);
 extern job *find_arrayparent(char *);
 extern int get_subjob_state(job *, int);
@@ -193,6 +197,7 @@ extern int numindex_to_offset(job *, int);
 #ifndef PBS_MOM
 extern void svr_setjob_histinfo(job *, histjob_type);
 extern void svr_histjob_update(job *, int, int);
+extern void svr_histjob_link(job *);
 extern char *form_attr_comment(const char *, const char *);
 extern void complete_running(job *);
 extern void am_jobs_add(job *);
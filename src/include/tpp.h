@@ -107,6 +107,12 @@ extern "C" {
 #define TPP_ROUTER_NODE         3  /* router */
 #define TPP_AUTH_NODE           4  /* authenticated, but yet unknown node type till a join happens */
 
+/* tpp compression codecs, the value of tpp_config.compress */
+#define TPP_COMPR_NONE          0  /* data is sent uncompressed */
+#define TPP_COMPR_ZLIB          1  /* zlib deflate, the default codec */
+#define TPP_COMPR_LZ4           2  /* lz4 frame format, low cpu cost */
+#define TPP_COMPR_ZSTD          3  /* zstd frame format */
+
 extern	int	tpp_fd;
 extern	int	rpp_retry;
 extern	int	rpp_highwater;
@@ -115,7 +121,8 @@ struct tpp_config {
 	char   **routers; /* other proxy names (and backups) to connect to */
 	int    numthreads;
 	char   *node_name; /* list of comma separated node names */
-	int    compress;
+	int    compress; /* compression codec, TPP_COMPR_NONE if disabled */
+	char   *compress_dict; /* path to shared compression dictionary file */
 	int    tcp_keepalive; /* use keepalive? */
 	int    tcp_keep_idle;
 	int    tcp_keep_intvl;
@@ -144,6 +151,9 @@ extern void tpp_add_close_func(int, void (*func)(int));
 extern void (*tpp_log_func)(int, const char *, char *);
 extern char *tpp_parse_hostname(char *, int *);
 extern int tpp_init_router(struct tpp_config *);
+extern int tpp_compr_codec(char *);
+extern char *tpp_compr_name(int);
+extern int tpp_compr_init(int, char *);
 extern void tpp_router_shutdown(void);
 
 /* special tpp only multicast function prototypes */
@@ -113,6 +113,7 @@ decode_arst_direct(struct attribute *patr, char *val)
 	char			*pbuf = NULL;
 	char			*pc;
 	char			*pstr;
+	char			*savep = NULL;
 	struct array_strings	*stp = NULL;
 	int			 rc;
 	char			 strbuf[BUF_SIZE];	/* Should handle most values */
@@ -172,14 +173,14 @@ decode_arst_direct(struct attribute *patr, char *val)
 	/* now copy in substrings and set pointers */
 	pc = pbuf;
 	j = 0;
-	pstr = parse_comma_string(sbufp);
+	pstr = parse_comma_string_save(sbufp, &savep);
 	while ((pstr != NULL) && (j < ns)) {
 		stp->as_string[j] = pc;
 		while (*pstr) {
 			*pc++ = *pstr++;
 		}
 		*pc++ = '\0';
-		pstr = parse_comma_string(NULL);
+		pstr = parse_comma_string_save(NULL, &savep);
 		j++;
 	}
 
@@ -634,6 +635,7 @@ arst_string(char *str, attribute *pattr)
  *	the next value element is returned...
  *
  * @param[in] start - string to be parsed
+ * @param[in,out] savep - where the parse continues from when start is NULL
  *
  * @return 	string
  * @retval	start address for string	Success
@@ -642,15 +644,14 @@ arst_string(char *str, attribute *pattr)
  */
 
 static char *
-parse_comma_string_bs(char *start)
+parse_comma_string_bs(char *start, char **savep)
 {
-	static char *pc = NULL;	/* if start is null, restart from here */
+	char	    *pc;	/* if start is null, restart from *savep */
 	char	    *dest;
 	char	    *back;
 	char	    *rv;
 
-	if (start != NULL)
-		pc = start;
+	pc = (start != NULL) ? start : *savep;
 
 	/* skip over leading white space */
 	while (pc && *pc && isspace((int)*pc))
@@ -691,6 +692,7 @@ parse_comma_string_bs(char *start)
 
 	if (*pc)
 		*pc++ = '\0';	/* if not end, terminate this and adv past */
+	*savep = pc;
 
 	*dest = '\0';
 	back = dest;
@@ -780,6 +782,7 @@ decode_arst_direct_bs(struct attribute *patr, char *val)
 	char			*pbuf = NULL;
 	char			*pc;
 	char			*pstr;
+	char			*savep = NULL;
 	char			*sbufp = NULL;
 	struct array_strings	*stp = NULL;
 	char			 strbuf[BUF_SIZE];	/* Should handle most values */
@@ -836,14 +839,14 @@ decode_arst_direct_bs(struct attribute *patr, char *val)
 	/* now copy in substrings and set pointers */
 	pc = pbuf;
 	j = 0;
-	pstr = parse_comma_string_bs(sbufp);
+	pstr = parse_comma_string_bs(sbufp, &savep);
 	while ((pstr != NULL) && (j < ns)) {
 		stp->as_string[j] = pc;
 		while (*pstr) {
 			*pc++ = *pstr++;
 		}
 		*pc++ = '\0';
-		pstr = parse_comma_string_bs(NULL);
+		pstr = parse_comma_string_bs(NULL, &savep);
 		j++;
 	}
 
@@ -54,6 +54,7 @@
 #include "resource.h"
 #include "pbs_error.h"
 #include "pbs_idx.h"
+#include "pbs_phash.h"
 
 
 /**
@@ -93,7 +94,11 @@ int comp_resc_gt;	/* count of resources compared > */
 int comp_resc_eq;	/* count of resources compared = */
 int comp_resc_lt;	/* count of resources compared < */
 int comp_resc_nc;	/* count of resources not compared  */
-void *resc_attrdef_idx = NULL;
+void *resc_attrdef_idx = NULL;	/* site-defined resources */
+
+/* the built-in resources, which never change after start up */
+static pbs_phash *resc_def_phash = NULL;
+static resource_def *resc_def_base = NULL;
 
 /**
  * @brief
@@ -456,6 +461,10 @@ free_resc(attribute *pattr)
  * @brief
  * 	 create the search index for resource deinitions
  *
+ *	The built-in resources go in a perfect hash of their names.  Resources
+ *	defined later by the site are added to and removed from the general
+ *	index, resc_attrdef_idx, which starts out empty.
+ *
  * @param[in] rscdf - address of array of resource_def structs
  * @param[in] limit - number of members in resource_def array
  *
@@ -468,22 +477,31 @@ int
 cr_rescdef_idx(resource_def *resc_def, int limit)
 {
 	int i;
+	char **names;
 
 	if (!resc_def)
 		return -1;
 
-	/* create the attribute index */
+	/* create the index for site-defined resources */
 	if ((resc_attrdef_idx = pbs_idx_create(PBS_IDX_ICASE_CMP, 0)) == NULL)
 		return -1;
 
-	/* add all attributes to the tree with key as the attr name */
+	/* add all built-in resources to the hash with key as the name */
+	if ((names = malloc((limit + 1) * sizeof(char *))) == NULL)
+		return -1;
 	for (i = 0; i < limit; i++) {
-		if (strcmp(resc_def->rs_name, RESC_NOOP_DEF) != 0) {
-			if (pbs_idx_insert(resc_attrdef_idx, resc_def->rs_name, resc_def) != PBS_IDX_RET_OK)
-				return -1;
-		}
-		resc_def++;
+		if (strcmp(resc_def[i].rs_name, RESC_NOOP_DEF) != 0)
+			names[i] = resc_def[i].rs_name;
+		else
+			names[i] = NULL;
 	}
+	pbs_phash_destroy(resc_def_phash);
+	resc_def_phash = pbs_phash_create(names, limit);
+	free(names);
+	if (resc_def_phash == NULL)
+		return -1;
+	resc_def_base = resc_def;
+
 	return 0;
 }
 
@@ -503,6 +521,13 @@ resource_def *
 find_resc_def(resource_def *resc_def, char *name)
 {
 	resource_def *found_def = NULL, *def = NULL;
+	int i;
+
+	if (name == NULL)
+		return NULL;
+
+	if ((i = pbs_phash_find(resc_def_phash, name, strlen(name))) >= 0)
+		return &resc_def_base[i];
 
 	if (pbs_idx_find(resc_attrdef_idx, (void **) &name, (void **)&found_def, NULL) == PBS_IDX_RET_OK)
 		def = &resc_def[found_def - resc_def];
@@ -52,7 +52,7 @@
 #include "attribute.h"
 #include "pbs_error.h"
 #include "libpbs.h"
-#include "pbs_idx.h"
+#include "pbs_phash.h"
 
 /**
  *
@@ -92,6 +92,9 @@ clear_attr(attribute *pattr, struct attribute_def *pdef)
  * @brief
  * 	Create the search index for the provided attribute def array
  *
+ *	The index is a perfect hash of the attribute names, so a lookup is
+ *	a fixed amount of work whatever the size of the array.
+ *
  * @param[in] attr_def - ptr to attribute definitions
  * @param[in] limit - limit on size of def array
  *
@@ -104,22 +107,21 @@ void *
 cr_attrdef_idx(struct attribute_def *adef, int limit)
 {
 	int i;
-	void *attrdef_idx = NULL;
+	char **names;
+	pbs_phash *attrdef_idx;
 
 	if (!adef)
 		return NULL;
 
-	/* create the attribute index */
-	if ((attrdef_idx = pbs_idx_create(PBS_IDX_ICASE_CMP, 0)) == NULL)
+	if ((names = malloc((limit + 1) * sizeof(char *))) == NULL)
 		return NULL;
+	for (i = 0; i < limit; i++)
+		names[i] = adef[i].at_name;
+
+	/* create the attribute index with key as the attr name */
+	attrdef_idx = pbs_phash_create(names, limit);
+	free(names);
 
-	/* add all attributes to the tree with key as the attr name */
-	for (i = 0; i < limit; i++) {
-		if (pbs_idx_insert(attrdef_idx, adef->at_name, adef) != PBS_IDX_RET_OK)
-			return NULL;
-		
-		adef++;
-	}
 	return attrdef_idx;
 }
 
@@ -143,13 +145,10 @@ cr_attrdef_idx(struct attribute_def *adef, int limit)
 int
 find_attr(void *attrdef_idx, struct attribute_def *attr_def, char *name)
 {
-	int index = -1;
-	struct attribute_def *found_def = NULL;
+	if (name == NULL)
+		return -1;
 
-	if (pbs_idx_find(attrdef_idx, (void **) &name, (void **)&found_def, NULL) == PBS_IDX_RET_OK)
-		index = (found_def - attr_def);
-		
-	return index;
+	return pbs_phash_find((pbs_phash *)attrdef_idx, name, strlen(name));
 }
 
 /**
@@ -428,6 +427,8 @@ free_svrattrl(svrattrl *pal)
  *	the next value element is returned...
  *
  *	A null pointer is returned when there are no (more) value elements.
+ *
+ *	See parse_comma_string_save() for a version safe to use from threads.
  */
 
 char *
@@ -435,11 +436,32 @@ parse_comma_string(char *start)
 {
 	static char *pc;	/* if start is null, restart from here */
 
+	return (parse_comma_string_save(start, &pc));
+}
+
+/**
+ * @brief
+ * 	parse_comma_string_save() - parse_comma_string() with the position
+ *	kept by the caller, as strtok_r() does for strtok().
+ *
+ * @param[in]		start	-	string to parse, NULL to continue
+ * @param[in,out]	savep	-	where the parse continues from
+ *
+ * @return	char *
+ * @retval	next value element
+ * @retval	NULL when there are no (more) value elements
+ */
+
+char *
+parse_comma_string_save(char *start, char **savep)
+{
+	char	    *pc;
 	char	    *back;
 	char	    *rv;
 
-	if (start != NULL)
-		pc = start;
+	pc = (start != NULL) ? start : *savep;
+	if (pc == NULL)
+		return NULL;
 
 	if (*pc == '\0')
 		return NULL;	/* already at end, no strings */
@@ -464,6 +486,7 @@ parse_comma_string(char *start)
 
 	if (*pc)
 		*pc++ = '\0';	/* if not end, terminate this and adv past */
+	*savep = pc;
 
 	return (rv);
 }
@@ -278,6 +278,60 @@ db_cursor_next(void *conn, void *st, pbs_db_obj_info_t *obj)
 	return 1; /* no more rows */
 }
 
+/**
+ * @brief
+ *	Start a transaction, so that the following saves and deletes are
+ *	committed together by pbs_db_end_trx()
+ *
+ * @param[in]	conn - Connected database handle
+ *
+ * @return	int
+ * @retval	-1  - Failure
+ * @retval	0   - success
+ *
+ */
+int
+pbs_db_begin_trx(void *conn)
+{
+	if (db_execute_str(conn, "BEGIN") == -1)
+		return -1;
+	return 0;
+}
+
+/**
+ * @brief
+ *	End the transaction started by pbs_db_begin_trx()
+ *
+ * @par
+ *	A transaction in which a statement failed is rolled back by the
+ *	database even when asked to commit; that is reported as a failure.
+ *
+ * @param[in]	conn - Connected database handle
+ * @param[in]	commit - 1 to commit, 0 to roll back
+ *
+ * @return	int
+ * @retval	-1  - Failure, or the transaction was rolled back instead
+ *		      of committed
+ * @retval	0   - success
+ *
+ */
+int
+pbs_db_end_trx(void *conn, int commit)
+{
+	PGresult *res;
+	int rc = 0;
+
+	res = PQexec((PGconn *)conn, commit ? "COMMIT" : "ROLLBACK");
+	if (PQresultStatus(res) != PGRES_COMMAND_OK) {
+		db_set_error(conn, &errmsg_cache, "Execution of string statement\n",
+			commit ? "COMMIT" : "ROLLBACK", PQresultErrorField(res, PG_DIAG_SQLSTATE));
+		rc = -1;
+	} else if (commit && strcmp(PQcmdStatus(res), "COMMIT") != 0)
+		rc = -1;
+	PQclear(res);
+	return rc;
+}
+
 /**
  * @brief
  *	Delete an existing object from the database
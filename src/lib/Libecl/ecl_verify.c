@@ -52,6 +52,7 @@
 #include <pbs_config.h>   /* the master config generated by configure */
 
 #include <sys/types.h>
+#include <pthread.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -66,10 +67,30 @@
 #include "server.h"
 #include "libpbs.h"
 #include "pbs_client_thread.h"
+#include "pbs_phash.h"
 
 static enum batch_op seljobs_opstring_enums[] = {EQ, NE, GE, GT, LE, LT};
 static int size_seljobs = sizeof(seljobs_opstring_enums)/sizeof(enum batch_op);
 
+/*
+ * Perfect hashes of the names in each definition table, built the first
+ * time any of them is needed.
+ */
+static struct ecl_def_hash {
+	struct ecl_attribute_def *dh_def;
+	int *dh_size;
+	pbs_phash *dh_hash;
+} ecl_def_hashes[] = {
+	{ecl_job_attr_def, &ecl_job_attr_size, NULL},
+	{ecl_svr_attr_def, &ecl_svr_attr_size, NULL},
+	{ecl_sched_attr_def, &ecl_sched_attr_size, NULL},
+	{ecl_que_attr_def, &ecl_que_attr_size, NULL},
+	{ecl_node_attr_def, &ecl_node_attr_size, NULL},
+	{ecl_resv_attr_def, &ecl_resv_attr_size, NULL},
+	{ecl_svr_resc_def, &ecl_svr_resc_size, NULL}
+};
+static pthread_once_t ecl_def_hash_once = PTHREAD_ONCE_INIT;
+
 /* static function declarations */
 static int
 __pbs_verify_attributes(int connect, int batch_request,
@@ -80,6 +101,7 @@ __pbs_verify_attributes_dummy(int connect, int batch_request,
 static struct ecl_attribute_def * ecl_findattr(int, struct attropl *);
 static struct ecl_attribute_def * ecl_find_attr_in_def(
 	struct ecl_attribute_def *, char *, int);
+static pbs_phash *ecl_get_def_hash(struct ecl_attribute_def *, int);
 static int get_attr_type(struct ecl_attribute_def attr_def);
 
 /* default function pointer assignments */
@@ -306,7 +328,8 @@ verify_an_attribute(int batch_request, int parent_object, int cmd,
 	if (pattr->value == NULL || pattr->value[0] == '\0') {
 
 		/* allow empty/null values for unset/delete of pbs_manager */
-		if ((batch_request == PBS_BATCH_Manager) &&
+		if ((batch_request == PBS_BATCH_Manager ||
+			batch_request == PBS_BATCH_ManagerList) &&
 			(cmd == MGR_CMD_UNSET || cmd == MGR_CMD_DELETE))
 			return PBSE_NONE;
 
@@ -600,6 +623,64 @@ static struct ecl_attribute_def * ecl_findattr(int parent_object,
 	return NULL;
 }
 
+/**
+ * @brief
+ *	Build the perfect hashes of the definition tables
+ *
+ * @par
+ *	Called once through pthread_once().  A table whose hash cannot be
+ *	built is searched linearly.
+ *
+ * @return void
+ *
+ * @par MT-safe: No
+ */
+static void
+ecl_build_def_hashes(void)
+{
+	int i;
+	int j;
+	int n;
+	char **names;
+
+	for (i = 0; i < (int)(sizeof(ecl_def_hashes) / sizeof(ecl_def_hashes[0])); i++) {
+		n = *ecl_def_hashes[i].dh_size;
+		if ((names = malloc((n + 1) * sizeof(char *))) == NULL)
+			continue;
+		for (j = 0; j < n; j++)
+			names[j] = ecl_def_hashes[i].dh_def[j].at_name;
+		ecl_def_hashes[i].dh_hash = pbs_phash_create(names, n);
+		free(names);
+	}
+}
+
+/**
+ * @brief
+ *	Return the perfect hash of the names in a definition table
+ *
+ * @param[in]	def	-	the definition table
+ * @param[in]	limit	-	number of entries being searched
+ *
+ * @return	pbs_phash *
+ * @retval	the hash
+ * @retval	NULL if there is none for this table
+ *
+ * @par MT-safe: Yes
+ */
+static pbs_phash *
+ecl_get_def_hash(struct ecl_attribute_def *def, int limit)
+{
+	int i;
+
+	if (pthread_once(&ecl_def_hash_once, ecl_build_def_hashes) != 0)
+		return NULL;
+	for (i = 0; i < (int)(sizeof(ecl_def_hashes) / sizeof(ecl_def_hashes[0])); i++) {
+		if (ecl_def_hashes[i].dh_def == def && *ecl_def_hashes[i].dh_size == limit)
+			return ecl_def_hashes[i].dh_hash;
+	}
+	return NULL;
+}
+
 /**
  * @brief
  * 	find_attr - find attribute definition by name
@@ -628,8 +709,15 @@ static struct ecl_attribute_def * ecl_find_attr_in_def(
 	char *name, int limit)
 {
 	int index;
+	pbs_phash *ph;
 
 	if (attr_def) {
+		/* the attribute name ends where a resource name would start */
+		if ((ph = ecl_get_def_hash(attr_def, limit)) != NULL &&
+			(index = pbs_phash_find(ph, name, strcspn(name, ".,"))) >= 0)
+			return &(attr_def[index]);
+
+		/* not a known name as it stands, check it the long way */
 		for (index = 0; index < limit; index++) {
 			char *pc = NULL;
 
@@ -698,6 +786,15 @@ get_attr_type(struct ecl_attribute_def attr_def)
 struct ecl_attribute_def *
 ecl_find_resc_def(struct ecl_attribute_def *rscdf, char *name, int limit) 
 {
+	pbs_phash *ph;
+	int i;
+
+	if ((ph = ecl_get_def_hash(rscdf, limit)) != NULL) {
+		if ((i = pbs_phash_find(ph, name, strlen(name))) >= 0)
+			return (&rscdf[i]);
+		return NULL;
+	}
+
 	while (limit--) {
 		if (strcasecmp(rscdf->at_name, name) == 0)
 			return (rscdf);
@@ -45,6 +45,9 @@
 #ifndef WIN32
 #include <netinet/tcp.h>
 #include <dlfcn.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
 #else
 #include "win.h"
 #endif
@@ -439,6 +442,121 @@ tcp_send_auth_req(int sock, unsigned int port, char *user, char *auth_method, ch
 	return 0;
 }
 
+#ifndef WIN32
+/**
+ * @brief
+ *	_iff_io - read or write all of a buffer on the pbs_iff daemon socket
+ *
+ * @param[in] sock - socket to the daemon
+ * @param[in] buf - buffer
+ * @param[in] len - bytes to transfer
+ * @param[in] out - 1 to write, 0 to read
+ *
+ * @return int
+ * @retval  0 success
+ * @retval -1 error or end of file
+ */
+static int
+_iff_io(int sock, void *buf, size_t len, int out)
+{
+	char *p = buf;
+	ssize_t n;
+
+	while (len > 0) {
+		/* a daemon going away must not kill the client with SIGPIPE */
+#ifdef MSG_NOSIGNAL
+		n = out ? send(sock, p, len, MSG_NOSIGNAL) : read(sock, p, len);
+#else
+		n = out ? write(sock, p, len) : read(sock, p, len);
+#endif
+		if (n == -1 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return -1;
+		p += n;
+		len -= n;
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ *	_ask_iff_daemon - have the pbs_iff daemon authenticate the connection,
+ *	which saves running pbs_iff and its connection to the server.
+ *
+ * @param[in]  client_addr     Address the client connected from.
+ * @param[in]  server_name     Connecting PBS server host name.
+ * @param[in]  server_port     Connecting PBS server port number.
+ * @param[in]  psock_port      Client's port of the connection, network order.
+ * @param[out] ebuf            Error message from the server.
+ * @param[in]  ebufsz          Size of ebuf.
+ * @param[out] rc              0 if authenticated, else -1.
+ *
+ * @return int
+ * @retval  0 the daemon answered, rc is set.
+ * @retval -1 no daemon is running, run pbs_iff instead.
+ */
+static int
+_ask_iff_daemon(char *client_addr, char *server_name, int server_port, u_short psock_port, char *ebuf, size_t ebufsz, int *rc)
+{
+	struct sockaddr_un sun;
+	struct iff_request req;
+	struct stat sb;
+	int sock;
+	int len = 0;
+
+	if (pbs_conf.pbs_tmpdir == NULL)
+		return -1;
+
+	/*
+	 * only a socket made by root can be the daemon, in a directory where
+	 * no other user can replace it: owned by root and either writable by
+	 * root alone or sticky
+	 */
+	if (lstat(pbs_conf.pbs_tmpdir, &sb) == -1 || !S_ISDIR(sb.st_mode) || sb.st_uid != 0 ||
+		((sb.st_mode & (S_IWGRP | S_IWOTH)) && !(sb.st_mode & S_ISVTX)))
+		return -1;
+	memset(&sun, 0, sizeof(sun));
+	sun.sun_family = AF_UNIX;
+	snprintf(sun.sun_path, sizeof(sun.sun_path), "%s/%s", pbs_conf.pbs_tmpdir, PBS_IFF_SOCK);
+	if (lstat(sun.sun_path, &sb) == -1 || !S_ISSOCK(sb.st_mode) || sb.st_uid != 0)
+		return -1;
+	if ((sock = socket(AF_UNIX, SOCK_STREAM, 0)) == -1)
+		return -1;
+	if (connect(sock, (struct sockaddr *)&sun, sizeof(sun)) == -1) {
+		close(sock);
+		return -1;
+	}
+
+	memset(&req, 0, sizeof(req));
+	req.ir_version = PBS_IFF_REQ_VERSION;
+	snprintf(req.ir_server, sizeof(req.ir_server), "%s", server_name);
+	req.ir_server_port = server_port;
+	snprintf(req.ir_client_addr, sizeof(req.ir_client_addr), "%s", client_addr);
+	req.ir_parent_port = ntohs(psock_port);
+	snprintf(req.ir_encrypt_method, sizeof(req.ir_encrypt_method), "%s", pbs_conf.encrypt_method);
+
+	if (_iff_io(sock, &req, sizeof(req), 1) != 0 ||
+		_iff_io(sock, rc, sizeof(int), 0) != 0) {
+		close(sock);
+		return -1;
+	}
+
+	pbs_errno = *rc;
+	if (*rc > 0) {
+		if (_iff_io(sock, &len, sizeof(int), 0) == 0 && len > 0) {
+			if (len > (int)(ebufsz - 1))
+				len = ebufsz - 1;
+			if (_iff_io(sock, ebuf, len, 0) == 0)
+				ebuf[len] = '\0';
+		}
+		*rc = -1;
+	}
+	close(sock);
+	return 0;
+}
+#endif
+
 /*
  * @brief
  *	_invoke_pbs_iff - call pbs_iff(1) to authenticate user/connection to the PBS server.
@@ -528,6 +646,9 @@ _invoke_pbs_iff(int psock, char *server_name, int server_port, char *ebuf, size_
 	}
 
 #else	/* UNIX code here */
+	if (_ask_iff_daemon(pbs_client_addr, server_name, server_port, psock_port, ebuf, ebufsz, &rc) == 0)
+		return rc;
+
 	if (pbs_conf.encrypt_method[0] != '\0') {
 		snprintf(cmd[0], sizeof(cmd[0]) - 1, "%s=%s %s=%s %s %s %u %d %u",
 				PBS_IFF_CLIENT_ADDR, pbs_client_addr,
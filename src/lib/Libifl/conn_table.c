@@ -49,6 +49,7 @@ static int add_connection(int);
 static pbs_conn_t * get_connection(int);
 static int destroy_conntable(void);
 static void _destroy_connection(int);
+static void free_conn_done(pbs_conn_t *);
 
 #ifdef WIN32
 #define INVALID_SOCK(x) (x == INVALID_SOCKET || x < 0 || x >= PBS_LOCAL_CONNECTION)
@@ -133,6 +134,7 @@ add_connection(int fd)
 			free(connection[fd]->ch_errtxt);
 		connection[fd]->ch_errtxt = NULL;
 		connection[fd]->ch_errno = 0;
+		free_conn_done(connection[fd]);
 	}
 	return 0;
 
@@ -144,6 +146,29 @@ add_connection_err:
 	return -1;
 }
 
+/** @brief
+ *	free_conn_done - drop the queued completions and request id state
+ *	of a connection
+ *
+ * @param[in] p - connection
+ *
+ * @return void
+ *
+ */
+static void
+free_conn_done(pbs_conn_t *p)
+{
+	struct pbs_async_done *pd;
+
+	while ((pd = p->ch_done) != NULL) {
+		p->ch_done = pd->ad_next;
+		free(pd->ad_errtxt);
+		free(pd);
+	}
+	p->ch_lastid = 0;
+	p->ch_pending = 0;
+}
+
 /** @brief
  *	_destroy_connection - destroy connection in connection table
  *
@@ -158,6 +183,7 @@ _destroy_connection(int fd)
 	if (connection[fd]) {
 		if (connection[fd]->ch_errtxt)
 			free(connection[fd]->ch_errtxt);
+		free_conn_done(connection[fd]);
 		pthread_mutex_destroy(&(connection[fd]->ch_mutex));
 		/*
 		 * DON'T free connection[i]->ch_chan
@@ -522,3 +548,172 @@ get_conn_mutex(int fd)
 	UNLOCK_TABLE(NULL);
 	return mutex;
 }
+
+/**
+ * @brief
+ * 	new_conn_reqid - hand out the next request id of a connection
+ *
+ * @par
+ *	Ids start at 1 and are unique among the requests in flight on the
+ *	connection.  The request is counted as pending until its completion
+ *	is taken with get_conn_done().
+ *
+ * @param[in] fd - socket number
+ *
+ * @return int
+ * @retval >0 - request id
+ * @retval -1 - error
+ *
+ * @par MT-safe: Yes
+ */
+int
+new_conn_reqid(int fd)
+{
+	pbs_conn_t *p = NULL;
+	int id;
+
+	if (INVALID_SOCK(fd))
+		return -1;
+
+	LOCK_TABLE(-1);
+	p = get_connection(fd);
+	if (p == NULL) {
+		UNLOCK_TABLE(-1);
+		return -1;
+	}
+	if (p->ch_lastid == INT_MAX)
+		p->ch_lastid = 0;
+	id = ++p->ch_lastid;
+	p->ch_pending++;
+	UNLOCK_TABLE(-1);
+	return id;
+}
+
+/**
+ * @brief
+ * 	add_conn_done - queue the completion of a request sent with an id
+ *
+ * @param[in] fd - socket number
+ * @param[in] reqid - request id from the reply
+ * @param[in] code - reply code
+ * @param[in] errtxt - reply text, may be NULL, copied
+ *
+ * @return int
+ * @retval 0 - success
+ * @retval -1 - error
+ *
+ * @par MT-safe: Yes
+ */
+int
+add_conn_done(int fd, int reqid, int code, char *errtxt)
+{
+	pbs_conn_t *p = NULL;
+	struct pbs_async_done *pd;
+	struct pbs_async_done **ppd;
+
+	if (INVALID_SOCK(fd))
+		return -1;
+
+	if ((pd = calloc(1, sizeof(struct pbs_async_done))) == NULL)
+		return -1;
+	pd->ad_reqid = reqid;
+	pd->ad_code = code;
+	if (errtxt != NULL && (pd->ad_errtxt = strdup(errtxt)) == NULL) {
+		free(pd);
+		return -1;
+	}
+
+	LOCK_TABLE(-1);
+	p = get_connection(fd);
+	if (p == NULL) {
+		UNLOCK_TABLE(-1);
+		free(pd->ad_errtxt);
+		free(pd);
+		return -1;
+	}
+	for (ppd = &p->ch_done; *ppd != NULL; ppd = &(*ppd)->ad_next)
+		;
+	*ppd = pd;
+	UNLOCK_TABLE(-1);
+	return 0;
+}
+
+/**
+ * @brief
+ * 	get_conn_done - take the oldest queued completion of a connection
+ *
+ * @param[in] fd - socket number
+ * @param[out] reqid - request id
+ * @param[out] code - reply code
+ * @param[out] errtxt - reply text or NULL, to be freed by the caller
+ *
+ * @return int
+ * @retval 1 - a completion was returned
+ * @retval 0 - none queued
+ * @retval -1 - error
+ *
+ * @par MT-safe: Yes
+ */
+int
+get_conn_done(int fd, int *reqid, int *code, char **errtxt)
+{
+	pbs_conn_t *p = NULL;
+	struct pbs_async_done *pd;
+
+	if (INVALID_SOCK(fd))
+		return -1;
+
+	LOCK_TABLE(-1);
+	p = get_connection(fd);
+	if (p == NULL) {
+		UNLOCK_TABLE(-1);
+		return -1;
+	}
+	if ((pd = p->ch_done) == NULL) {
+		UNLOCK_TABLE(-1);
+		return 0;
+	}
+	p->ch_done = pd->ad_next;
+	if (pd->ad_reqid != 0 && p->ch_pending > 0)
+		p->ch_pending--;
+	UNLOCK_TABLE(-1);
+
+	*reqid = pd->ad_reqid;
+	*code = pd->ad_code;
+	*errtxt = pd->ad_errtxt;
+	free(pd);
+	return 1;
+}
+
+/**
+ * @brief
+ * 	get_conn_pending - number of requests sent with an id whose completion
+ *	has not been taken yet
+ *
+ * @param[in] fd - socket number
+ *
+ * @return int
+ * @retval >= 0 - success
+ * @retval -1 - error
+ *
+ * @par MT-safe: Yes
+ */
+int
+get_conn_pending(int fd)
+{
+	pbs_conn_t *p = NULL;
+	int n;
+
+	if (INVALID_SOCK(fd))
+		return -1;
+
+	LOCK_TABLE(-1);
+	p = get_connection(fd);
+	if (p == NULL) {
+		UNLOCK_TABLE(-1);
+		return -1;
+	}
+	n = p->ch_pending;
+	UNLOCK_TABLE(-1);
+	return n;
+}
@@ -43,6 +43,8 @@
  * @file	dec_Manage.c
  * @brief
  * decode_DIS_Manage() - decode a Manager Batch Request
+ * decode_DIS_ManageList() - decode a Manager List Batch Request
+ * decode_DIS_ModifyList() - decode a Modify Job List Batch Request
  *
  *	This request is used for most operations where an object is being
  *	created, deleted, or altered.
@@ -109,3 +111,99 @@ decode_DIS_Manage(int sock, struct batch_request *preq)
 	if (rc) return rc;
 	return (decode_DIS_svrattrl(sock, &preq->rq_ind.rq_manager.rq_attr));
 }
+
+/**
+ * @brief
+ *	-decode a Manager List Batch Request
+ *
+ * @par	Functionality:
+ *	Same as decode_DIS_Manage() except that the object name is a comma
+ *	separated list of objects of unbounded length.  The list is left in
+ *	rq_objlist and rq_objname is left empty.
+ *
+ * @par	Data items are:\n
+ *		unsigned int    command\n
+ *              unsigned int    object type\n
+ *              string          object name list\n
+ *              attropl         attributes
+ *
+ * @param[in] sock - socket descriptor
+ * @param[out] preq - pointer to batch_request structure
+ *
+ * @return      int
+ * @retval      DIS_SUCCESS(0)  success
+ * @retval      error code      error
+ *
+ */
+
+int
+decode_DIS_ManageList(int sock, struct batch_request *preq)
+{
+	int rc;
+
+	CLEAR_HEAD(preq->rq_ind.rq_manager.rq_attr);
+	preq->rq_ind.rq_manager.rq_cmd = disrui(sock, &rc);
+	if (rc) return rc;
+	preq->rq_ind.rq_manager.rq_objtype = disrui(sock, &rc);
+	if (rc) return rc;
+	preq->rq_ind.rq_manager.rq_objname[0] = '\0';
+	preq->rq_ind.rq_management.rq_objlist = disrst(sock, &rc);
+	if (rc) return rc;
+	return (decode_DIS_svrattrl(sock, &preq->rq_ind.rq_manager.rq_attr));
+}
+
+/**
+ * @brief
+ *	-decode a Modify Job List Batch Request
+ *
+ * @par	Functionality:
+ *	Each job in the list is decoded into its own rq_manage entry, as a
+ *	decode_DIS_Manage() of a job with command MGR_CMD_SET would.
+ *
+ * @par	Data items are:\n
+ *		unsigned int    count of jobs\n
+ *		then for each job:\n
+ *              string          job id\n
+ *              attrl           attributes
+ *
+ * @param[in] sock - socket descriptor
+ * @param[out] preq - pointer to batch_request structure
+ *
+ * @return      int
+ * @retval      DIS_SUCCESS(0)  success
+ * @retval      error code      error
+ *
+ */
+
+int
+decode_DIS_ModifyList(int sock, struct batch_request *preq)
+{
+	int rc;
+	int i;
+	int count;
+	struct rq_manage *pmod;
+
+	preq->rq_ind.rq_modifylist.rq_count = 0;
+	preq->rq_ind.rq_modifylist.rq_jobs = NULL;
+	count = disrui(sock, &rc);
+	if (rc)
+		return rc;
+
+	pmod = calloc(count ? count : 1, sizeof(struct rq_manage));
+	if (pmod == NULL)
+		return DIS_NOMALLOC;
+	preq->rq_ind.rq_modifylist.rq_jobs = pmod;
+
+	for (i = 0; i < count; i++) {
+		CLEAR_HEAD(pmod[i].rq_attr);
+		/* count what has been set up so it can be freed */
+		preq->rq_ind.rq_modifylist.rq_count = i + 1;
+		pmod[i].rq_cmd = MGR_CMD_SET;
+		pmod[i].rq_objtype = MGR_OBJ_JOB;
+		if ((rc = disrfst(sock, PBS_MAXSVRJOBID+1, pmod[i].rq_objname)) != 0)
+			return rc;
+		if ((rc = decode_DIS_svrattrl(sock, &pmod[i].rq_attr)) != 0)
+			return rc;
+	}
+	return rc;
+}
@@ -50,6 +50,7 @@
  *			Protocol Version (unsigned integer)
  *			Request Type (unsignded integer)
  *			User Name (string)
+ *			Request Id (unsigned integer, version 2 only)
  *
  * @par Returns:
  *		  -1	on EOF (end of file on first read only)
@@ -104,5 +105,14 @@ decode_DIS_ReqHdr(int sock, struct batch_request *preq, int *proto_type, int *pr
 		return rc;
 	}
 
-	return (disrfst(sock, PBS_MAXUSER+1, preq->rq_user));
+	if ((rc = disrfst(sock, PBS_MAXUSER+1, preq->rq_user)) != 0)
+		return rc;
+
+	preq->rq_reqid = 0;
+	if (*proto_ver == PBS_BATCH_PROT_VER_ASYNC) {
+		preq->rq_reqid = disrui(sock, &rc);
+		if (rc == 0 && preq->rq_reqid == 0)
+			rc = DIS_PROTO;
+	}
+	return rc;
 }
@@ -43,6 +43,7 @@
  * @file	dec_RunJob.c
  * @brief
  * decode_DIS_RunJob() - decode a Run Job batch request
+ * decode_DIS_RunList() - decode a Run Job List batch request
  *
  *	The batch_request structure must already exist (be allocated by the
  *	caller.   It is assumed that the header fields (protocol type,
@@ -105,3 +106,53 @@ decode_DIS_Run(int sock, struct batch_request *preq)
 	preq->rq_ind.rq_run.rq_resch = disrul(sock, &rc);
 	return rc;
 }
+
+/**
+ * @brief-
+ *	decode a Run Job List batch request
+ *
+ * @par	Data items are:\n
+ *		unsigned int    count of jobs\n
+ *		then for each job:\n
+ *		string          job id\n
+ *		string          destination\n
+ *
+ * @param[in] sock - socket descriptor
+ * @param[out] preq - pointer to batch_request structure
+ *
+ * @return      int
+ * @retval      DIS_SUCCESS(0)  success
+ * @retval      error code      error
+ *
+ */
+
+int
+decode_DIS_RunList(int sock, struct batch_request *preq)
+{
+	int rc;
+	int i;
+	int count;
+	struct rq_runjob *prun;
+
+	preq->rq_ind.rq_runlist.rq_count = 0;
+	preq->rq_ind.rq_runlist.rq_jobs = NULL;
+	count = disrui(sock, &rc);
+	if (rc)
+		return rc;
+
+	prun = calloc(count ? count : 1, sizeof(struct rq_runjob));
+	if (prun == NULL)
+		return DIS_NOMALLOC;
+	preq->rq_ind.rq_runlist.rq_jobs = prun;
+
+	for (i = 0; i < count; i++) {
+		if ((rc = disrfst(sock, PBS_MAXSVRJOBID+1, prun[i].rq_jid)) != 0)
+			return rc;
+		prun[i].rq_destin = disrst(sock, &rc);
+		if (rc)
+			return rc;
+		/* count what has been allocated so it can be freed */
+		preq->rq_ind.rq_runlist.rq_count = i + 1;
+	}
+	return rc;
+}
@@ -43,6 +43,7 @@
  * @file	dec_Sig.c
  * @brief
  * 	decode_DIS_SignalJob() - decode a Signal Job batch request
+ * 	decode_DIS_JobList() - decode a Delete/Signal Job List batch request
  *
  *	The batch_request structure must already exist (be allocated by the
  *	caller.   It is assumed that the header fields (protocol type,
@@ -97,3 +98,55 @@ decode_DIS_SignalJob(int sock, struct batch_request *preq)
 	rc = disrfst(sock, PBS_SIGNAMESZ+1, preq->rq_ind.rq_signal.rq_signame);
 	return rc;
 }
+
+/**
+ * @brief-
+ *	decode a Delete Job List or Signal Job List batch request
+ *
+ * @par	Data items are:\n
+ *		unsigned int    count of job ids\n
+ *		string          job id (count times)\n
+ *		svrattrl        filter (owner, job_state, queue)\n
+ *		string          signal (name), empty for a delete
+ *
+ * @param[in] sock - socket descriptor
+ * @param[out] preq - pointer to batch_request structure
+ *
+ * @return      int
+ * @retval      DIS_SUCCESS(0)  success
+ * @retval      error code      error
+ *
+ */
+
+int
+decode_DIS_JobList(int sock, struct batch_request *preq)
+{
+	int rc;
+	int i;
+	int count;
+	struct rq_joblist *plist = &preq->rq_ind.rq_joblist;
+
+	plist->rq_count = 0;
+	plist->rq_jobids = NULL;
+	CLEAR_HEAD(plist->rq_filter);
+	count = disrui(sock, &rc);
+	if (rc)
+		return rc;
+
+	plist->rq_jobids = calloc(count ? count : 1, sizeof(char *));
+	if (plist->rq_jobids == NULL)
+		return DIS_NOMALLOC;
+
+	for (i = 0; i < count; i++) {
+		plist->rq_jobids[i] = disrst(sock, &rc);
+		if (rc)
+			return rc;
+		/* count what has been allocated so it can be freed */
+		plist->rq_count = i + 1;
+	}
+
+	if ((rc = decode_DIS_svrattrl(sock, &plist->rq_filter)) != 0)
+		return rc;
+
+	return disrfst(sock, PBS_SIGNAMESZ+1, plist->rq_signame);
+}
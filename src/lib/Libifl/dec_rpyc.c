@@ -102,7 +102,12 @@ decode_DIS_replyCmd(int sock, struct batch_reply *reply)
 	if (i != PBS_BATCH_PROT_TYPE) return DIS_PROTO;
 	i = disrui(sock, &rc);
 	if (rc != 0) return rc;
-	if (i != PBS_BATCH_PROT_VER) return DIS_PROTO;
+	reply->brp_reqid = 0;
+	if (i == PBS_BATCH_PROT_VER_ASYNC) {
+		reply->brp_reqid = disrui(sock, &rc);
+		if (rc != 0) return rc;
+	} else if (i != PBS_BATCH_PROT_VER)
+		return DIS_PROTO;
 
 	/* next decode code, auxcode and choice (union type identifier) */
 
@@ -258,6 +263,40 @@ decode_DIS_replyCmd(int sock, struct batch_reply *reply)
 
 			break;
 
+		case BATCH_REPLY_CHOICE_RunJobs:
+
+			/* Run Job List Reply */
+			ct = disrui(sock, &rc);
+			if (rc) break;
+			reply->brp_un.brp_runjobs.brp_codes = calloc(ct ? ct : 1, sizeof(int));
+			if (reply->brp_un.brp_runjobs.brp_codes == NULL)
+				return DIS_NOMALLOC;
+			reply->brp_un.brp_runjobs.brp_count = ct;
+			for (i = 0; (i < ct) && (rc == 0); i++)
+				reply->brp_un.brp_runjobs.brp_codes[i] = disrsi(sock, &rc);
+			break;
+
+		case BATCH_REPLY_CHOICE_JobList:
+
+			/* Delete/Signal Job List Reply */
+			reply->brp_un.brp_joblist.brp_ndone = disrui(sock, &rc);
+			if (rc) break;
+			reply->brp_un.brp_joblist.brp_nfail = disrui(sock, &rc);
+			if (rc) break;
+			ct = disrui(sock, &rc);
+			if (rc) break;
+			reply->brp_un.brp_joblist.brp_errs = calloc(ct ? ct : 1, sizeof(struct brp_joberr));
+			if (reply->brp_un.brp_joblist.brp_errs == NULL)
+				return DIS_NOMALLOC;
+			reply->brp_un.brp_joblist.brp_nerr = ct;
+			for (i = 0; (i < ct) && (rc == 0); i++) {
+				rc = disrfst(sock, PBS_MAXSVRJOBID + 1,
+					reply->brp_un.brp_joblist.brp_errs[i].brp_jobid);
+				if (rc == 0)
+					reply->brp_un.brp_joblist.brp_errs[i].brp_code = disrsi(sock, &rc);
+			}
+			break;
+
 		default:
 			return -1;
 	}
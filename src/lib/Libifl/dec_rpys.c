@@ -101,7 +101,12 @@ decode_DIS_replySvr(int sock, struct batch_reply *reply)
 	if (i != PBS_BATCH_PROT_TYPE) return DIS_PROTO;
 	i = disrui(sock, &rc);
 	if (rc != 0) return rc;
-	if (i != PBS_BATCH_PROT_VER) return DIS_PROTO;
+	reply->brp_reqid = 0;
+	if (i == PBS_BATCH_PROT_VER_ASYNC) {
+		reply->brp_reqid = disrui(sock, &rc);
+		if (rc != 0) return rc;
+	} else if (i != PBS_BATCH_PROT_VER)
+		return DIS_PROTO;
 
 	/* next decode code, auxcode and choice (union type identifier) */
 
@@ -43,6 +43,7 @@
  * @file	enc_Manage.c
  * @brief
  * encode_DIS_Manage() - encode a Manager Batch Request
+ * encode_DIS_ModifyList() - encode a Modify Job List Batch Request
  *
  *	This request is used for most operations where an object is being
  *	created, deleted, or altered.
@@ -86,3 +87,40 @@ encode_DIS_Manage(int sock, int command, int objtype, char *objname, struct attr
 
 	return (encode_DIS_attropl(sock, aoplp));
 }
+
+/**
+ * @brief
+ *	-encode a Modify Job List Batch Request
+ *
+ * @par	Functionality:
+ *		Carries the attribute updates of several jobs, each one is
+ *		applied by the server as a modify job request of its own.
+ *
+ * @param[in] sock - socket descriptor
+ * @param[in] count - number of jobs
+ * @param[in] jobids - job identifiers
+ * @param[in] attribs - attribute list to set on each job
+ *
+ * @return      int
+ * @retval      DIS_SUCCESS(0)  success
+ * @retval      error code      error
+ *
+ */
+
+int
+encode_DIS_ModifyList(int sock, int count, char **jobids, struct attrl **attribs)
+{
+	int rc;
+	int i;
+
+	if ((rc = diswui(sock, count)) != 0)
+		return rc;
+
+	for (i = 0; i < count; i++) {
+		if ((rc = diswst(sock, jobids[i])) != 0)
+			return rc;
+		if ((rc = encode_DIS_attrl(sock, attribs[i])) != 0)
+			return rc;
+	}
+	return rc;
+}
@@ -48,6 +48,7 @@
  *			Protocol Version (unsigned integer)
  *			Request Type (unsignded integer)
  *			User Name (string)
+ *			Request Id (unsigned integer, version 2 only)
  */
 
 #include <pbs_config.h>   /* the master config generated by configure */
@@ -82,3 +83,38 @@ encode_DIS_ReqHdr(int sock, int reqt, char *user)
 	}
 	return 0;
 }
+
+/**
+ * @brief
+ *	-encode a Request Header carrying a request id
+ *
+ * @par
+ *	The header is sent with protocol version PBS_BATCH_PROT_VER_ASYNC so
+ *	that the server answers with a reply carrying the same id.  Replies to
+ *	such requests may come back in any order.
+ *
+ * @param[in] sock - socket descriptor
+ * @param[in] reqt - request type
+ * @param[in] user - user name
+ * @param[in] reqid - request id, > 0
+ *
+ * @return      int
+ * @retval      DIS_SUCCESS(0)  success
+ * @retval      error code      error
+ *
+ */
+
+int
+encode_DIS_ReqHdr_id(int sock, int reqt, char *user, int reqid)
+{
+	int rc;
+
+	if ((rc = diswui(sock, PBS_BATCH_PROT_TYPE))	||
+		(rc = diswui(sock, PBS_BATCH_PROT_VER_ASYNC))	||
+		(rc = diswui(sock, reqt))			||
+		(rc = diswst(sock, user))			||
+		(rc = diswui(sock, reqid))) {
+		return rc;
+	}
+	return 0;
+}
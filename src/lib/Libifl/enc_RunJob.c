@@ -43,6 +43,7 @@
  * @file	enc_RunJob.c
  * @brief
  * encode_DIS_RunJob() - encode a Run Job Batch Request
+ * encode_DIS_RunList() - encode a Run Job List Batch Request
  *
  * @par Data items are:
  * 			string		job id
@@ -89,3 +90,42 @@ encode_DIS_Run(int sock, char *id, char *where, unsigned long arg)
 
 	return 0;
 }
+
+/**
+ * @brief
+ *	-encode a Run Job List Batch Request
+ *
+ * @par Data items are:\n
+ *		unsigned int	count of jobs\n
+ *		then for each job:\n
+ *		string		job id\n
+ *		string		destination
+ *
+ * @param[in] sock - socket descriptor
+ * @param[in] count - number of jobs
+ * @param[in] jobids - ids of the jobs to run
+ * @param[in] where - destination of each job, NULL entries are sent empty
+ *
+ * @return      int
+ * @retval      DIS_SUCCESS(0)  success
+ * @retval      error code      error
+ *
+ */
+
+int
+encode_DIS_RunList(int sock, int count, char **jobids, char **where)
+{
+	int rc;
+	int i;
+
+	if ((rc = diswui(sock, count)) != 0)
+		return rc;
+
+	for (i = 0; i < count; i++) {
+		if (((rc = diswst(sock, jobids[i])) != 0) ||
+			((rc = diswst(sock, where[i] ? where[i] : "")) != 0))
+			return rc;
+	}
+
+	return 0;
+}
@@ -43,6 +43,7 @@
  * @file	enc_Sig.c
  * @brief
  * encode_DIS_SignalJob() - encode a Signal Job Batch Request
+ * encode_DIS_JobList() - encode a Delete/Signal Job List Batch Request
  *
  * @par Data items are:
  * 			string		job id
@@ -80,3 +81,45 @@ encode_DIS_SignalJob(int sock, char *jobid, char *signal)
 
 	return 0;
 }
+
+/**
+ * @brief
+ *	-encode a Delete Job List or Signal Job List Batch Request
+ *
+ * @par Data items are:
+ *		unsigned int	count of job ids
+ *		string		job id (count times)
+ *		attrl		filter (owner, job_state, queue)
+ *		string		signal, empty for a delete
+ *
+ * @param[in] sock - socket descriptor
+ * @param[in] jobids - NULL terminated list of job ids, may be NULL
+ * @param[in] filter - attributes selecting the jobs, may be NULL
+ * @param[in] signal - signal, NULL for a delete
+ *
+ * @return      int
+ * @retval      DIS_SUCCESS(0)  success
+ * @retval      error code      error
+ *
+ */
+int
+encode_DIS_JobList(int sock, char **jobids, struct attrl *filter, char *signal)
+{
+	int   rc;
+	int   i;
+	int   count = 0;
+
+	if (jobids != NULL)
+		while (jobids[count] != NULL)
+			count++;
+
+	if ((rc = diswui(sock, count)) != 0)
+		return rc;
+	for (i = 0; i < count; i++) {
+		if ((rc = diswst(sock, jobids[i])) != 0)
+			return rc;
+	}
+	if ((rc = encode_DIS_attrl(sock, filter)) != 0)
+		return rc;
+	return diswst(sock, signal ? signal : "");
+}
@@ -221,6 +221,33 @@ encode_DIS_reply_inner(int sock, struct batch_reply *reply)
 
 			break;
 
+		case BATCH_REPLY_CHOICE_RunJobs:
+
+			/* Run Job List Reply */
+			ct = reply->brp_un.brp_runjobs.brp_count;
+			if ((rc = diswui(sock, ct)) != 0)
+				return rc;
+			for (i = 0; i < ct; i++) {
+				if ((rc = diswsi(sock, reply->brp_un.brp_runjobs.brp_codes[i])) != 0)
+					return rc;
+			}
+			break;
+
+		case BATCH_REPLY_CHOICE_JobList:
+
+			/* Delete/Signal Job List Reply */
+			ct = reply->brp_un.brp_joblist.brp_nerr;
+			if (((rc = diswui(sock, reply->brp_un.brp_joblist.brp_ndone)) != 0) ||
+				((rc = diswui(sock, reply->brp_un.brp_joblist.brp_nfail)) != 0) ||
+				((rc = diswui(sock, ct)) != 0))
+				return rc;
+			for (i = 0; i < ct; i++) {
+				if (((rc = diswst(sock, reply->brp_un.brp_joblist.brp_errs[i].brp_jobid)) != 0) ||
+					((rc = diswsi(sock, reply->brp_un.brp_joblist.brp_errs[i].brp_code)) != 0))
+					return rc;
+			}
+			break;
+
 		default:
 			return -1;
 	}
@@ -233,8 +260,14 @@ encode_DIS_reply(int sock, struct batch_reply *reply)
 {
 	int rc;
 	/* first encode "header" consisting of protocol type and version */
+	/* and, for a request sent with a request id, that id */
 
-	if ((rc = diswui(sock, PBS_BATCH_PROT_TYPE))   ||
+	if (reply->brp_reqid != 0) {
+		if ((rc = diswui(sock, PBS_BATCH_PROT_TYPE))		||
+			(rc = diswui(sock, PBS_BATCH_PROT_VER_ASYNC))	||
+			(rc = diswui(sock, reply->brp_reqid)))
+				return rc;
+	} else if ((rc = diswui(sock, PBS_BATCH_PROT_TYPE))   ||
 		(rc = diswui(sock, PBS_BATCH_PROT_VER)))
 			return rc;
 
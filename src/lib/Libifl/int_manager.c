@@ -114,3 +114,80 @@ PBSD_manager(int c, int function, int command, int objtype, char *objname, struc
 
 	return rc;
 }
+
+/**
+ * @brief
+ *	-send a manager request with a request id, without waiting for the reply
+ *
+ * @par
+ *	Several requests may be in flight on the connection; the completion of
+ *	each is collected with PBSD_async_poll() by the returned id.
+ *
+ * @param[in] c - communication handle
+ * @param[in] function - req type
+ * @param[in] command - command
+ * @param[in] objtype - object type
+ * @param[in] objname - object name
+ * @param[in] aoplp - attribute list
+ * @param[in] extend - extend string for req
+ *
+ * @return	int
+ * @retval	>0	request id
+ * @retval	-1	error, see pbs_errno
+ *
+ */
+int
+PBSD_manager_async(int c, int function, int command, int objtype, char *objname, struct attropl *aoplp, char *extend)
+{
+	int rc;
+	int reqid;
+
+	/* initialize the thread context data, if not initialized */
+	if (pbs_client_thread_init_thread_context() != 0)
+		return -1;
+
+	/* verify the object name if creating a new one */
+	if (command == MGR_CMD_CREATE)
+		if (pbs_verify_object_name(objtype, objname) != 0)
+			return -1;
+
+	/* now verify the attributes, if verification is enabled */
+	if ((pbs_verify_attributes(c, function, objtype,
+		command, aoplp)) != 0)
+		return -1;
+
+	/* lock pthread mutex here for this connection */
+	/* blocking call, waits for mutex release */
+	if (pbs_client_thread_lock_connection(c) != 0)
+		return -1;
+
+	if ((reqid = new_conn_reqid(c)) <= 0) {
+		(void)pbs_client_thread_unlock_connection(c);
+		pbs_errno = PBSE_SYSTEM;
+		return -1;
+	}
+
+	DIS_tcp_funcs();
+
+	if ((rc = encode_DIS_ReqHdr_id(c, function, pbs_current_user, reqid)) ||
+		(rc = encode_DIS_Manage(c, command, objtype, objname, aoplp)) ||
+		(rc = encode_DIS_ReqExtend(c, extend))) {
+		if (set_conn_errtxt(c, dis_emsg[rc]) != 0)
+			pbs_errno = PBSE_SYSTEM;
+		else
+			pbs_errno = PBSE_PROTOCOL;
+		(void)pbs_client_thread_unlock_connection(c);
+		return -1;
+	}
+	if (dis_flush(c)) {
+		pbs_errno = PBSE_PROTOCOL;
+		(void)pbs_client_thread_unlock_connection(c);
+		return -1;
+	}
+
+	/* unlock the thread lock and update the thread context data */
+	if (pbs_client_thread_unlock_connection(c) != 0)
+		return -1;
+
+	return reqid;
+}
@@ -55,6 +55,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
+#include <errno.h>
+#ifndef WIN32
+#include <poll.h>
+#endif
 #include "libpbs.h"
 #include "dis.h"
 
@@ -123,6 +127,21 @@ PBSD_rdrpy(int c)
 		return NULL;
 	}
 	reply = PBSD_rdrpy_sock(c, &rc);
+	/*
+	 * replies to requests sent with a request id may come in ahead of
+	 * the reply waited for, keep them for PBSD_async_poll()
+	 */
+	while (reply != NULL && reply->brp_reqid != 0) {
+		if (add_conn_done(c, reply->brp_reqid, reply->brp_code,
+			(reply->brp_choice == BATCH_REPLY_CHOICE_Text) ?
+			reply->brp_un.brp_txt.brp_str : NULL) != 0) {
+			PBSD_FreeReply(reply);
+			pbs_errno = PBSE_SYSTEM;
+			return NULL;
+		}
+		PBSD_FreeReply(reply);
+		reply = PBSD_rdrpy_sock(c, &rc);
+	}
 	if (reply == NULL) {
 		if (set_conn_errno(c, PBSE_PROTOCOL) != 0) {
 			pbs_errno = PBSE_SYSTEM;
@@ -212,7 +231,144 @@ struct batch_reply *reply;
 		(void)free(reply->brp_un.brp_rescq.brq_down);
 	} else if (reply->brp_choice == BATCH_REPLY_CHOICE_PreemptJobs) {
 		(void)free(reply->brp_un.brp_preempt_jobs.ppj_list);
+	} else if (reply->brp_choice == BATCH_REPLY_CHOICE_RunJobs) {
+		(void)free(reply->brp_un.brp_runjobs.brp_codes);
+	} else if (reply->brp_choice == BATCH_REPLY_CHOICE_JobList) {
+		(void)free(reply->brp_un.brp_joblist.brp_errs);
 	}
 
 	(void)free(reply);
 }
+
+/**
+ * @brief
+ *	-wait for the completion of a request sent with a request id
+ *
+ * @par
+ *	Returns the oldest completion not yet returned, reading replies from
+ *	the connection as needed.  The reply code is left in pbs_errno and on
+ *	the connection, with its text, for pbs_geterrmsg().  A reply without
+ *	a request id is returned with id 0; that is how a server that does
+ *	not know request ids rejects the first one before closing the
+ *	connection.
+ *
+ * @param[in] c - communication handle
+ * @param[in] timeout - seconds to wait for a reply, < 0 to wait as long
+ *			as the connection timeout allows
+ * @param[out] reqid - id of the completed request
+ *
+ * @return	int
+ * @retval	1	a completion was returned
+ * @retval	0	none within timeout, or no request pending
+ * @retval	-1	error, see pbs_errno; the connection is unusable
+ *
+ */
+int
+PBSD_async_poll(int c, int timeout, int *reqid)
+{
+	int rc;
+	int code;
+	char *errtxt = NULL;
+	struct batch_reply *reply;
+#ifdef WIN32
+	fd_set readset;
+	struct timeval tv;
+#else
+	struct pollfd pollfds[1];
+#endif
+
+	if (reqid == NULL) {
+		pbs_errno = PBSE_IVALREQ;
+		return -1;
+	}
+
+	/* initialize the thread context data, if not already initialized */
+	if (pbs_client_thread_init_thread_context() != 0)
+		return -1;
+
+	/* lock pthread mutex here for this connection */
+	/* blocking call, waits for mutex release */
+	if (pbs_client_thread_lock_connection(c) != 0)
+		return -1;
+
+	rc = get_conn_done(c, reqid, &code, &errtxt);
+	if (rc == 0 && get_conn_pending(c) > 0) {
+		if (timeout >= 0) {
+#ifdef WIN32
+			FD_ZERO(&readset);
+			FD_SET((unsigned int)c, &readset);
+			tv.tv_sec = timeout;
+			tv.tv_usec = 0;
+			do {
+				rc = select(FD_SETSIZE, &readset, NULL, NULL, &tv);
+			} while (rc == -1 && ((errno = WSAGetLastError()) == WSAEINTR));
+#else
+			pollfds[0].fd = c;
+			pollfds[0].events = POLLIN;
+			pollfds[0].revents = 0;
+			do {
+				rc = poll(pollfds, 1, timeout * 1000);
+			} while (rc == -1 && errno == EINTR);
+#endif
+		} else
+			rc = 1;
+		if (rc > 0) {
+			DIS_tcp_funcs();
+			reply = PBSD_rdrpy_sock(c, &rc);
+			if (reply == NULL) {
+				(void)set_conn_errno(c, PBSE_PROTOCOL);
+				(void)set_conn_errtxt(c, dis_emsg[rc]);
+				(void)pbs_client_thread_unlock_connection(c);
+				pbs_errno = PBSE_PROTOCOL;
+				return -1;
+			}
+			rc = add_conn_done(c, reply->brp_reqid, reply->brp_code,
+				(reply->brp_choice == BATCH_REPLY_CHOICE_Text) ?
+				reply->brp_un.brp_txt.brp_str : NULL);
+			PBSD_FreeReply(reply);
+			if (rc == 0)
+				rc = get_conn_done(c, reqid, &code, &errtxt);
+		}
+	}
+	if (rc <= 0) {
+		(void)pbs_client_thread_unlock_connection(c);
+		if (rc < 0) {
+			pbs_errno = PBSE_SYSTEM;
+			return -1;
+		}
+		return 0;
+	}
+
+	if ((set_conn_errno(c, code) != 0) || (set_conn_errtxt(c, errtxt) != 0)) {
+		free(errtxt);
+		(void)pbs_client_thread_unlock_connection(c);
+		pbs_errno = PBSE_SYSTEM;
+		return -1;
+	}
+	free(errtxt);
+
+	/* unlock the thread lock and update the thread context data */
+	if (pbs_client_thread_unlock_connection(c) != 0)
+		return -1;
+
+	pbs_errno = code;
+	return 1;
+}
+
+/**
+ * @brief
+ *	-number of requests sent with a request id on a connection whose
+ *	completion has not been returned by PBSD_async_poll() yet
+ *
+ * @param[in] c - communication handle
+ *
+ * @return	int
+ * @retval	>= 0	number of pending requests
+ * @retval	-1	error
+ *
+ */
+int
+PBSD_async_pending(int c)
+{
+	return get_conn_pending(c);
+}
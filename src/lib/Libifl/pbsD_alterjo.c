@@ -49,6 +49,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "libpbs.h"
+#include "dis.h"
 
 /**
  * @brief	Convenience function to create attropl list from attrl (shallow copy)
@@ -203,3 +204,64 @@ __pbs_asyalterjob(int c, char *jobid, struct attrl *attrib, char *extend)
 	return i;
 
 }
+
+/**
+ * @brief	Send the attribute updates of several jobs in one request,
+ *		Asynchronously
+ *
+ * @par
+ *	Like pbs_asyalterjob() for each job, but in a single request.  No
+ *	reply is sent back by the server.
+ *
+ * @param[in] c - connection handle
+ * @param[in] count - number of jobs in jobids and attribs
+ * @param[in] jobids - job identifiers
+ * @param[in] attribs - attribute list to set on each job
+ *
+ * @return	int
+ * @retval	0	success
+ * @retval	!0	error
+ *
+ */
+int
+PBSD_modifyjob_list(int c, int count, char **jobids, struct attrl **attribs)
+{
+	int rc;
+
+	if ((count <= 0) || (jobids == NULL) || (attribs == NULL))
+		return (pbs_errno = PBSE_IVALREQ);
+
+	/* initialize the thread context data, if not initialized */
+	if (pbs_client_thread_init_thread_context() != 0)
+		return pbs_errno;
+
+	/* lock pthread mutex here for this connection */
+	/* blocking call, waits for mutex release */
+	if (pbs_client_thread_lock_connection(c) != 0)
+		return pbs_errno;
+
+	DIS_tcp_funcs();
+
+	if ((rc = encode_DIS_ReqHdr(c, PBS_BATCH_ModifyJobList_Async, pbs_current_user)) ||
+		(rc = encode_DIS_ModifyList(c, count, jobids, attribs)) ||
+		(rc = encode_DIS_ReqExtend(c, NULL))) {
+		if (set_conn_errtxt(c, dis_emsg[rc]) != 0)
+			pbs_errno = PBSE_SYSTEM;
+		else
+			pbs_errno = PBSE_PROTOCOL;
+		(void)pbs_client_thread_unlock_connection(c);
+		return pbs_errno;
+	}
+
+	if (dis_flush(c)) {
+		pbs_errno = PBSE_PROTOCOL;
+		(void)pbs_client_thread_unlock_connection(c);
+		return pbs_errno;
+	}
+
+	/* unlock the thread lock and update the thread context data */
+	if (pbs_client_thread_unlock_connection(c) != 0)
+		return pbs_errno;
+
+	return 0;
+}
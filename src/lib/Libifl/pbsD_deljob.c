@@ -80,3 +80,34 @@ __pbs_deljob(int c, char *jobid, char *extend)
 		aoplp,
 		extend);
 }
+
+/**
+ * @brief
+ *	Send the Delete Job request to the server with a request id and
+ *	return without waiting for the reply
+ *
+ * @param[in] c - connection handler
+ * @param[in] jobid - job identifier
+ * @param[in] extend - string to encode req
+ *
+ * @return	int
+ * @retval	>0	request id, see PBSD_async_poll()
+ * @retval	-1	error
+ *
+ */
+
+int
+PBSD_deljob_async(int c, char *jobid, char *extend)
+{
+	if ((jobid == NULL) || (*jobid == '\0')) {
+		pbs_errno = PBSE_IVALREQ;
+		return -1;
+	}
+
+	return PBSD_manager_async(c, PBS_BATCH_DeleteJob,
+		MGR_CMD_DELETE,
+		MGR_OBJ_JOB,
+		jobid,
+		NULL,
+		extend);
+}
@@ -182,3 +182,79 @@ __pbs_runjob(int c, char *jobid, char *location, char *extend)
 {
 	return __runjob_helper(c, jobid, location, extend, PBS_BATCH_RunJob);
 }
+
+/**
+ * @brief
+ *	-send a run job list batch request
+ *
+ * @par
+ *	Sends the run requests of several jobs in one batch request and waits
+ *	for the single reply, which carries one result code per job.
+ *
+ * @param[in] c - communication handle
+ * @param[in] count - number of jobs in jobids and locations
+ * @param[in] jobids - job identifiers
+ * @param[in] locations - exec_vnode to run each job on
+ * @param[out] codes - result code of each job, in the order of jobids
+ *
+ * @return      int
+ * @retval      0       request was handled, see codes for each job
+ * @retval      !0      error, codes is set to the error for every job
+ *
+ */
+
+int
+PBSD_runjob_list(int c, int count, char **jobids, char **locations, int *codes)
+{
+	int rc = 0;
+	int i;
+	struct batch_reply *reply = NULL;
+
+	if ((count <= 0) || (jobids == NULL) || (locations == NULL) || (codes == NULL))
+		return (pbs_errno = PBSE_IVALREQ);
+
+	/* initialize the thread context data, if not already initialized */
+	if (pbs_client_thread_init_thread_context() != 0)
+		return pbs_errno;
+
+	/* lock pthread mutex here for this connection */
+	/* blocking call, waits for mutex release */
+	if (pbs_client_thread_lock_connection(c) != 0)
+		return pbs_errno;
+
+	DIS_tcp_funcs();
+
+	if ((rc = encode_DIS_ReqHdr(c, PBS_BATCH_RunJobList, pbs_current_user)) ||
+		(rc = encode_DIS_RunList(c, count, jobids, locations)) ||
+		(rc = encode_DIS_ReqExtend(c, NULL))) {
+		if (set_conn_errtxt(c, dis_emsg[rc]) != 0)
+			pbs_errno = PBSE_SYSTEM;
+		else
+			pbs_errno = PBSE_PROTOCOL;
+		rc = pbs_errno;
+	} else if (dis_flush(c)) {
+		rc = pbs_errno = PBSE_PROTOCOL;
+	} else {
+		reply = PBSD_rdrpy(c);
+		rc = get_conn_errno(c);
+		if ((rc == 0) && ((reply == NULL) ||
+			(reply->brp_choice != BATCH_REPLY_CHOICE_RunJobs) ||
+			(reply->brp_un.brp_runjobs.brp_count != count)))
+			rc = pbs_errno = PBSE_PROTOCOL;
+	}
+
+	if (rc == 0) {
+		for (i = 0; i < count; i++)
+			codes[i] = reply->brp_un.brp_runjobs.brp_codes[i];
+	} else {
+		for (i = 0; i < count; i++)
+			codes[i] = rc;
+	}
+	PBSD_FreeReply(reply);
+
+	/* unlock the thread lock and update the thread context data */
+	if (pbs_client_thread_unlock_connection(c) != 0)
+		return pbs_errno;
+
+	return rc;
+}
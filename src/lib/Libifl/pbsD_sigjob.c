@@ -47,6 +47,7 @@
 #include <string.h>
 #include <stdio.h>
 #include "libpbs.h"
+#include "dis.h"
 #include "pbs_ecl.h"
 
 
@@ -100,3 +101,87 @@ __pbs_sigjob(int c, char *jobid, char *signal, char *extend)
 
 	return (rc);
 }
+
+/**
+ * @brief
+ *	-send a delete job list or signal job list batch request
+ *
+ * @par
+ *	The jobs are either named in jobids or picked by the server with the
+ *	filter (owner, job_state and queue attributes).  The server works
+ *	through the jobs and answers once with the number of jobs done and
+ *	failed, and the ids and error codes of (up to a limit of) the failed
+ *	ones.
+ *
+ * @param[in] c - communication handle
+ * @param[in] function - PBS_BATCH_DeleteJobList or PBS_BATCH_SignalJobList
+ * @param[in] jobids - NULL terminated list of job ids, may be NULL
+ * @param[in] filter - attributes selecting the jobs, may be NULL
+ * @param[in] signal - signal for PBS_BATCH_SignalJobList, else NULL
+ * @param[in] extend - extend string for request
+ *
+ * @return      struct batch_reply *
+ * @retval      reply   with brp_choice BATCH_REPLY_CHOICE_JobList, free
+ *			with PBSD_FreeReply()
+ * @retval      NULL    error, pbs_errno is set
+ *
+ */
+struct batch_reply *
+PBSD_joblist(int c, int function, char **jobids, struct attrl *filter,
+	char *signal, char *extend)
+{
+	int rc = 0;
+	struct batch_reply *reply = NULL;
+
+	if (((jobids == NULL) || (*jobids == NULL)) && (filter == NULL)) {
+		pbs_errno = PBSE_IVALREQ;
+		return NULL;
+	}
+	if ((function == PBS_BATCH_SignalJobList) && (signal == NULL)) {
+		pbs_errno = PBSE_IVALREQ;
+		return NULL;
+	}
+
+	/* initialize the thread context data, if not already initialized */
+	if (pbs_client_thread_init_thread_context() != 0)
+		return NULL;
+
+	/* lock pthread mutex here for this connection */
+	/* blocking call, waits for mutex release */
+	if (pbs_client_thread_lock_connection(c) != 0)
+		return NULL;
+
+	DIS_tcp_funcs();
+
+	if ((rc = encode_DIS_ReqHdr(c, function, pbs_current_user)) ||
+		(rc = encode_DIS_JobList(c, jobids, filter, signal)) ||
+		(rc = encode_DIS_ReqExtend(c, extend))) {
+		if (set_conn_errtxt(c, dis_emsg[rc]) != 0)
+			pbs_errno = PBSE_SYSTEM;
+		else
+			pbs_errno = PBSE_PROTOCOL;
+		rc = pbs_errno;
+	} else if (dis_flush(c)) {
+		rc = pbs_errno = PBSE_PROTOCOL;
+	} else {
+		reply = PBSD_rdrpy(c);
+		rc = get_conn_errno(c);
+		if ((rc == 0) && ((reply == NULL) ||
+			(reply->brp_choice != BATCH_REPLY_CHOICE_JobList)))
+			rc = pbs_errno = PBSE_PROTOCOL;
+	}
+
+	if (rc != 0) {
+		pbs_errno = rc;
+		PBSD_FreeReply(reply);
+		reply = NULL;
+	}
+
+	/* unlock the thread lock and update the thread context data */
+	if (pbs_client_thread_unlock_connection(c) != 0) {
+		PBSD_FreeReply(reply);
+		return NULL;
+	}
+
+	return reply;
+}
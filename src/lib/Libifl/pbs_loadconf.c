@@ -116,6 +116,8 @@ struct pbs_config pbs_conf = {
 	1, 					/* use compression by default with TCP */
 	1,					/* use mcast by default with TCP */
 	0,					/* force fault tolerant comm disabled by default */
+	NULL,					/* compression codec, zlib by default */
+	NULL,					/* no compression dictionary by default */
 	NULL,					/* default leaf name */
 	NULL,					/* for leaf, default communication routers list */
 	NULL,					/* default router name */
@@ -446,6 +448,14 @@ __pbs_loadconf(int reload)
 				if (sscanf(conf_value, "%u", &uvalue) == 1)
 					pbs_conf.pbs_use_compression = ((uvalue > 0) ? 1 : 0);
 			}
+			else if (!strcmp(conf_name, PBS_CONF_COMPRESSION_TYPE)) {
+				free(pbs_conf.pbs_compression_type);
+				pbs_conf.pbs_compression_type = strdup(conf_value);
+			}
+			else if (!strcmp(conf_name, PBS_CONF_COMPRESSION_DICT)) {
+				free(pbs_conf.pbs_compression_dict);
+				pbs_conf.pbs_compression_dict = strdup(conf_value);
+			}
 			else if (!strcmp(conf_name, PBS_CONF_USE_MCAST)) {
 				if (sscanf(conf_value, "%u", &uvalue) == 1)
 					pbs_conf.pbs_use_mcast = ((uvalue > 0) ? 1 : 0);
@@ -732,6 +742,18 @@ __pbs_loadconf(int reload)
 		if (sscanf(gvalue, "%u", &uvalue) == 1)
 			pbs_conf.pbs_use_compression = ((uvalue > 0) ? 1 : 0);
 	}
+	if ((gvalue = getenv(PBS_CONF_COMPRESSION_TYPE)) != NULL) {
+		free(pbs_conf.pbs_compression_type);
+		if ((pbs_conf.pbs_compression_type = strdup(gvalue)) == NULL) {
+			goto err;
+		}
+	}
+	if ((gvalue = getenv(PBS_CONF_COMPRESSION_DICT)) != NULL) {
+		free(pbs_conf.pbs_compression_dict);
+		if ((pbs_conf.pbs_compression_dict = strdup(gvalue)) == NULL) {
+			goto err;
+		}
+	}
 	if ((gvalue = getenv(PBS_CONF_USE_MCAST)) != NULL) {
 		if (sscanf(gvalue, "%u", &uvalue) == 1)
 			pbs_conf.pbs_use_mcast = ((uvalue > 0) ? 1 : 0);
@@ -1064,6 +1086,14 @@ err:
 		free(pbs_conf.pbs_lr_save_path);
 		pbs_conf.pbs_lr_save_path = NULL;
 	}
+	if (pbs_conf.pbs_compression_type) {
+		free(pbs_conf.pbs_compression_type);
+		pbs_conf.pbs_compression_type = NULL;
+	}
+	if (pbs_conf.pbs_compression_dict) {
+		free(pbs_conf.pbs_compression_dict);
+		pbs_conf.pbs_compression_dict = NULL;
+	}
 	if (pbs_conf.supported_auth_methods) {
 		free_string_array(pbs_conf.supported_auth_methods);
 		pbs_conf.supported_auth_methods = NULL;
@@ -239,6 +239,7 @@ typedef struct {
 	unsigned int dest_sd;    /* destination stream descriptor, IO thread only */
 	unsigned int src_magic;  /* A magically unique number that identifies src stream uniquely */
 	unsigned int dest_magic; /* A magically unique number that identifies dest stream uniquely */
+	unsigned char peer_compr; /* codecs the peer advertised, IO thread updates, APP thread reads */
 
 	short used_locally;      /* Whether this stream was accessed locally by the APP, APP thread only */
 
@@ -769,6 +770,11 @@ tpp_init(struct tpp_config *cnf)
 	snprintf(log_buffer, TPP_LOGBUF_SZ, "TPP leaf node names = %s", tpp_conf->node_name);
 	tpp_log_func(LOG_CRIT, NULL, log_buffer);
 
+	if (tpp_conf->compress != TPP_COMPR_NONE) {
+		if (tpp_compr_init(tpp_conf->compress, tpp_conf->compress_dict) != 0)
+			tpp_conf->compress = TPP_COMPR_NONE;
+	}
+
 	tpp_init_lock(&strmarray_lock);
 	if (tpp_mbox_init(&app_mbox) != 0) {
 		tpp_log_func(LOG_CRIT, __func__, "Failed to create application mbox");
@@ -1115,6 +1121,45 @@ get_active_router(int index)
 	return -1;
 }
 
+/**
+ * @brief
+ *	Get the codecs advertised by the destination of a stream
+ *
+ * @par Functionality:
+ *	For a multicast stream only the codecs advertised by every member
+ *	stream are returned, since the same compressed data goes to all of them.
+ *
+ * @param[in] sd - The stream descriptor
+ *
+ * @return - Mask of TPP_COMPR_CAP() bits, 0 if none are known
+ *
+ * @par MT-safe: Yes
+ *
+ */
+static unsigned char
+get_peer_compr(unsigned int sd)
+{
+	stream_t *strm;
+	stream_t *member;
+	unsigned char compr;
+	int i;
+
+	if ((strm = get_strm_atomic(sd)) == NULL)
+		return 0;
+	if (strm->strm_type != TPP_STRM_MCAST)
+		return strm->peer_compr;
+	if (strm->mcast_data == NULL || strm->mcast_data->num_fds == 0)
+		return 0;
+
+	compr = 0xff;
+	for (i = 0; i < strm->mcast_data->num_fds; i++) {
+		if ((member = get_strm_atomic(strm->mcast_data->strms[i])) == NULL)
+			return 0;
+		compr &= member->peer_compr;
+	}
+	return compr;
+}
+
 /**
  * @brief
  *	Sends data to a stream
@@ -1152,10 +1197,10 @@ tpp_send(int sd, void *data, int len)
 
 	TPP_DBPRT(("Sending: sd=%d, len=%d", sd, len));
 
-	if ((tpp_conf->compress == 1) && (len > TPP_COMPR_SIZE)) {
+	if ((tpp_conf->compress != TPP_COMPR_NONE) && (len > TPP_COMPR_SIZE)) {
 		void *outbuf;
 
-		outbuf = tpp_deflate(data, len, &cmprsd_len);
+		outbuf = tpp_deflate(get_peer_compr(sd), data, len, &cmprsd_len);
 		if (outbuf == NULL) {
 			tpp_log_func(LOG_CRIT, __func__, "tpp deflate failed");
 			return -1;
@@ -1242,6 +1287,7 @@ tpp_send_inner(int sd, void *data, int len, int full_len, int cmprsd_len)
 
 	dhdr.ack_seq = htonl(UNINITIALIZED_INT);
 	dhdr.dup = 0;
+	dhdr.compr = tpp_compr_caps();
 	dhdr.cmprsd_len = htonl(cmprsd_len);
 	dhdr.totlen = htonl(full_len);
 	memcpy(&dhdr.src_addr, &strm->src_addr, sizeof(tpp_addr_t));
@@ -2240,8 +2286,8 @@ tpp_mcast_send(int mtfd, void *data, unsigned int len, unsigned int full_len, un
 	chunks[0].len = sizeof(tpp_mcast_pkt_hdr_t);
 	totlen = chunks[0].len;
 
-	if (tpp_conf->compress == 1 && minfo_len > TPP_COMPR_SIZE) {
-		def_ctx = tpp_multi_deflate_init(minfo_len);
+	if (tpp_conf->compress != TPP_COMPR_NONE && minfo_len > TPP_COMPR_SIZE) {
+		def_ctx = tpp_multi_deflate_init(0, minfo_len); /* pbs_comm codecs are not known to leaves */
 		if (def_ctx == NULL)
 			goto err;
 	} else {
@@ -2951,6 +2997,7 @@ send_ack_packet(ack_info_t *ack)
 	dhdr.seq_no = htonl(ack->seq_no); /* seq no to ack */
 	dhdr.ack_seq = dhdr.seq_no; /* same as seq_no */
 	dhdr.dup = 0;
+	dhdr.compr = tpp_compr_caps();
 	memcpy(&dhdr.src_addr, &strm->src_addr, sizeof(tpp_addr_t));
 	memcpy(&dhdr.dest_addr, &strm->dest_addr, sizeof(tpp_addr_t));
 
@@ -3682,6 +3729,7 @@ send_spl_packet(stream_t *strm, int type)
 
 	dhdr.ack_seq = htonl(UNINITIALIZED_INT);
 	dhdr.dup = 0;
+	dhdr.compr = tpp_compr_caps();
 	memcpy(&dhdr.src_addr, &strm->src_addr, sizeof(tpp_addr_t));
 	memcpy(&dhdr.dest_addr, &strm->dest_addr, sizeof(tpp_addr_t));
 
@@ -4553,6 +4601,9 @@ leaf_pkt_handler(int tfd, void *data, int len, void *ctx, void *extra)
 			 */
 			strm->dest_sd = src_sd; /* next time outgoing will have dest_fd */
 			strm->dest_magic = src_magic; /* used for matching next time onwards */
+			/* multicast data is relayed by pbs_comm, which does not advertise for the sender */
+			if (p->compr != 0)
+				strm->peer_compr = p->compr; /* codecs we may compress with towards the peer */
 
 			seq_no_expected = strm->seq_no_expected;
 			TPP_DBPRT(("sequence_no expected = %u", seq_no_expected));
@@ -208,6 +208,7 @@ typedef struct {
 typedef struct {
 	unsigned char type;        /* type of the packet - TPP_DATA, JOIN etc */
 	unsigned char dup;         /* Is this a duplicate packet? */
+	unsigned char compr;       /* codecs the sender can inflate, 0 from older nodes */
 
 	unsigned int src_magic;    /* magic id of source stream */
 	unsigned int cmprsd_len;   /* length of compressed data, 0 if not compressed */
@@ -286,6 +287,10 @@ enum TPP_MSG_TYPES {
 #define TPP_SEND_SIZE           8192
 #define TPP_COMPR_SIZE          8192
 
+/* codec capability bits, advertised to peers as returned by tpp_compr_caps */
+#define TPP_COMPR_CAP(c)        (1 << (c))
+#define TPP_COMPR_CAP_DICT      0x80
+
 /* tpp cmds used internally by the layer to notify messages between threads */
 #define TPP_CMD_SEND            1
 #define TPP_CMD_CLOSE           2
@@ -333,6 +338,7 @@ typedef struct {
 	int delay;		/* time delay in re-connecting to the router */
 	int index;		/* the preference of data going over this connection */
 	void *my_leaves_idx;	/* leaves connected to this router, used by comm only */
+	unsigned char compr;	/* codecs advertised in the router's join, used by comm only */
 } tpp_router_t;
 
 /*
@@ -403,6 +409,8 @@ typedef struct {
 	void *td;
 	char tpplogbuf[TPP_LOGBUF_SZ];
 	char tppstaticbuf[TPP_LOGBUF_SZ];
+	void *zstd_cctx; /* per thread zstd compression context */
+	void *zstd_dctx; /* per thread zstd decompression context */
 } tpp_tls_t;
 
 typedef struct {
@@ -491,9 +499,11 @@ int tpp_send_ctl_msg(int, int, tpp_addr_t *, tpp_addr_t *, unsigned int, char, c
 int tpp_cr_thrd(void *(*start_routine)(void*), pthread_t *, void *);
 int tpp_set_keep_alive(int, struct tpp_config *);
 
-void *tpp_deflate(void *, unsigned int, unsigned int *);
+unsigned char tpp_compr_caps(void);
+void *tpp_deflate(unsigned char, void *, unsigned int, unsigned int *);
+void *tpp_deflate_codec(int, void *, unsigned int, unsigned int *);
 void *tpp_inflate(void *, unsigned int, unsigned int);
-void *tpp_multi_deflate_init(int);
+void *tpp_multi_deflate_init(unsigned char, int);
 int tpp_multi_deflate_do(void *, int, void *, unsigned int);
 void *tpp_multi_deflate_done(void *, unsigned int *);
 
@@ -449,6 +449,7 @@ router_send_ctl_join(int tfd, void *data, void *c)
 		tpp_router_t *r = NULL;
 		tpp_join_pkt_hdr_t hdr = {0};
 		tpp_chunk_t chunks[2] = {{0}};
+		unsigned char compr;
 		r = (tpp_router_t *) ctx->ptr;
 
 		/* send a TPP_CTL_JOIN message */
@@ -458,9 +459,17 @@ router_send_ctl_join(int tfd, void *data, void *c)
 		hdr.index = 0;
 		hdr.num_addrs = 0;
 
+		/*
+		 * advertise our codecs after the header, older routers
+		 * do not look past the header of a router join
+		 */
+		compr = tpp_compr_caps();
+
 		chunks[0].data = &hdr;
 		chunks[0].len = sizeof(tpp_join_pkt_hdr_t);
-		rc = tpp_transport_vsend(r->conn_fd, chunks, 1);
+		chunks[1].data = &compr;
+		chunks[1].len = sizeof(compr);
+		rc = tpp_transport_vsend(r->conn_fd, chunks, 2);
 		if (rc == 0) {
 			tpp_lock(&router_lock);
 
@@ -812,6 +821,7 @@ router_close_handler_inner(int tfd, int error, void *c, int hop)
 			 */
 			r->conn_fd = -1;
 			r->state = TPP_ROUTER_STATE_DISCONNECTED;
+			r->compr = 0; /* re-advertised on the next join */
 
 			tpp_unlock(&router_lock);
 
@@ -1344,6 +1354,12 @@ router_pkt_handler(int tfd, void *data, int len, void *c, void *extra)
 				r->initiator = 0;
 				r->state = TPP_ROUTER_STATE_CONNECTED;
 
+				/* codecs the router advertised, none if it predates codec negotiation */
+				if (len > (int) sizeof(tpp_join_pkt_hdr_t))
+					r->compr = *((unsigned char *) data + sizeof(tpp_join_pkt_hdr_t));
+				else
+					r->compr = 0;
+
 				snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "tfd=%d, pbs_comm %s connected", tfd, tpp_netaddr(&r->router_addr));
 				tpp_log_func(LOG_CRIT, NULL, tpp_get_logbuf());
 
@@ -1848,8 +1864,8 @@ router_pkt_handler(int tfd, void *data, int len, void *c, void *extra)
 
 						/* allocate minfo_buf for this target comm */
 						c_minfo_len = sizeof(tpp_mcast_pkt_info_t) * num_streams;
-						if (tpp_conf->compress == 1 && c_minfo_len > TPP_COMPR_SIZE) {
-							rlist[found].cmpr_ctx = tpp_multi_deflate_init(c_minfo_len);
+						if (tpp_conf->compress != TPP_COMPR_NONE && c_minfo_len > TPP_COMPR_SIZE) {
+							rlist[found].cmpr_ctx = tpp_multi_deflate_init(target_router->compr, c_minfo_len);
 							if (rlist[found].cmpr_ctx == NULL)
 								goto mcast_err;
 						} else {
@@ -2306,6 +2322,11 @@ tpp_init_router(struct tpp_config *cnf)
 		return -1;
 	}
 
+	if (tpp_conf->compress != TPP_COMPR_NONE) {
+		if (tpp_compr_init(tpp_conf->compress, tpp_conf->compress_dict) != 0)
+			tpp_conf->compress = TPP_COMPR_NONE;
+	}
+
 	tpp_init_lock(&router_lock);
 
 	routers_idx = pbs_idx_create(0, sizeof(tpp_addr_t));
@@ -55,12 +55,14 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <unistd.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <netdb.h>
 #include <pthread.h>
 #include <sys/types.h>
+#include <sys/stat.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #ifndef WIN32
@@ -73,6 +75,12 @@
 #ifdef PBS_COMPRESSION_ENABLED
 #include <zlib.h>
 #endif
+#ifdef PBS_COMPRESSION_LZ4
+#include <lz4frame.h>
+#endif
+#ifdef PBS_COMPRESSION_ZSTD
+#include <zstd.h>
+#endif
 
 /*
  *	Global Variables
@@ -356,9 +364,22 @@ set_tpp_config(void (*log_fn)(int, const char *, char *), struct pbs_config *pbs
 	}
 
 #ifdef PBS_COMPRESSION_ENABLED
-	tpp_conf->compress = pbs_conf->pbs_use_compression;
+	tpp_conf->compress = TPP_COMPR_NONE;
+	if (pbs_conf->pbs_use_compression) {
+		tpp_conf->compress = tpp_compr_codec(pbs_conf->pbs_compression_type);
+		if (tpp_conf->compress == -1) {
+			snprintf(log_buffer, TPP_LOGBUF_SZ, "TPP compression codec %s not available, using zlib",
+				pbs_conf->pbs_compression_type);
+			tpp_log_func(LOG_WARNING, NULL, log_buffer);
+			tpp_conf->compress = TPP_COMPR_ZLIB;
+		}
+		snprintf(log_buffer, TPP_LOGBUF_SZ, "TPP compression codec = %s", tpp_compr_name(tpp_conf->compress));
+		tpp_log_func(LOG_INFO, NULL, log_buffer);
+	}
+	tpp_conf->compress_dict = pbs_conf->pbs_compression_dict;
 #else
-	tpp_conf->compress = 0;
+	tpp_conf->compress = TPP_COMPR_NONE;
+	tpp_conf->compress_dict = NULL;
 #endif
 
 	/* set default parameters for keepalive */
@@ -1490,6 +1511,29 @@ mk_hostname(char *host, int port)
 	return node_name;
 }
 
+/**
+ * @brief
+ *	Destructor of the thread TLS, called when a thread exits
+ *
+ * @param[in] p - The thread's tpp_tls_t
+ *
+ * @par MT-safe: Yes
+ *
+ */
+static void
+tpp_free_tls_data(void *p)
+{
+	tpp_tls_t *ptr = p;
+
+	if (ptr == NULL)
+		return;
+#ifdef PBS_COMPRESSION_ZSTD
+	ZSTD_freeCCtx(ptr->zstd_cctx);
+	ZSTD_freeDCtx(ptr->zstd_dctx);
+#endif
+	free(ptr);
+}
+
 /**
  * @brief
  *	Once function for initializing TLS key
@@ -1507,7 +1551,7 @@ mk_hostname(char *host, int port)
 static void
 tpp_init_tls_key_once()
 {
-	if (pthread_key_create(&tpp_key_tls, NULL) != 0) {
+	if (pthread_key_create(&tpp_key_tls, tpp_free_tls_data) != 0) {
 		fprintf(stderr, "Failed to initialize TLS key\n");
 	}
 }
@@ -1591,172 +1635,348 @@ tpp_get_logbuf()
 	return ptr->tpplogbuf;
 }
 
-#ifdef PBS_COMPRESSION_ENABLED
-
-#define COMPR_LEVEL Z_DEFAULT_COMPRESSION
-
-struct def_ctx {
-	z_stream cmpr_strm;
-	void *cmpr_buf;
-	int len;
+/*
+ * Compression codec support
+ *
+ * The codec used for outgoing data is chosen locally (PBS_COMPRESSION_TYPE),
+ * but is only used towards peers that advertised they can inflate it. Every
+ * node advertises the codecs it has compiled in (tpp_compr_caps) in the data
+ * packet header of its streams and in the join it sends to other routers.
+ * Older nodes leave that byte zero, so they, and any peer that has not been
+ * heard from yet, are sent plain zlib, which every version of TPP inflates.
+ *
+ * The lz4 and zstd codecs emit their standard frame formats, which start with
+ * a well known magic number, while zlib streams never do. The receiving side
+ * therefore detects the codec of every compressed buffer from its first bytes.
+ *
+ * An optional shared dictionary (PBS_COMPRESSION_DICT) primes the zlib and
+ * zstd codecs. It is only used towards peers that advertised a dictionary
+ * too. Both formats record the dictionary id in the compressed stream, so a
+ * receiver with a different dictionary fails loudly instead of producing
+ * garbage.
+ */
+#define TPP_LZ4_MAGIC		0x184D2204
+#define TPP_ZSTD_MAGIC		0xFD2FB528
+#define TPP_ZSTD_LEVEL		1
+#define TPP_COMPR_DICT_MAX	(1024 * 1024)
+
+static struct {
+	int codec;
+	char *name;
+} tpp_compr_codecs[] = {
+	{TPP_COMPR_NONE, "none"},
+	{TPP_COMPR_ZLIB, "zlib"},
+	{TPP_COMPR_LZ4, "lz4"},
+	{TPP_COMPR_ZSTD, "zstd"}
 };
 
+static int tpp_compr_type = TPP_COMPR_ZLIB; /* codec used for outgoing data */
+static void *tpp_compr_dict = NULL; /* shared dictionary, if any */
+static unsigned int tpp_compr_dict_len = 0;
+#ifdef PBS_COMPRESSION_ZSTD
+static ZSTD_CDict *tpp_zstd_cdict = NULL;
+static ZSTD_DDict *tpp_zstd_ddict = NULL;
+#endif
+
 /**
  * @brief
- *	Initialize a multi step deflation
- *	Allocate an initial result buffer of given length
+ *	Check whether support for a compression codec is compiled in
  *
- * @param[in] initial_len -  initial length of result buffer
+ * @param[in] codec - The codec (TPP_COMPR_XXX)
  *
- * @return - The deflate context
- * @retval - NULL  - Failure
- * @retval - !NULL - Success
+ * @return - 1 if available, 0 otherwise
  *
- * @par Side Effects:
- *	None
+ * @par MT-safe: Yes
+ */
+static int
+tpp_compr_available(int codec)
+{
+	switch (codec) {
+		case TPP_COMPR_NONE:
+			return 1;
+#ifdef PBS_COMPRESSION_ENABLED
+		case TPP_COMPR_ZLIB:
+			return 1;
+#endif
+#ifdef PBS_COMPRESSION_LZ4
+		case TPP_COMPR_LZ4:
+			return 1;
+#endif
+#ifdef PBS_COMPRESSION_ZSTD
+		case TPP_COMPR_ZSTD:
+			return 1;
+#endif
+		default:
+			return 0;
+	}
+}
+
+/**
+ * @brief
+ *	Return the codecs this node can inflate, as advertised to its peers
  *
- * @par MT-safe: No
+ * @return - Mask of TPP_COMPR_CAP() bits, with TPP_COMPR_CAP_DICT set if a
+ *	     shared dictionary is loaded
  *
+ * @par MT-safe: Yes
  */
-void *
-tpp_multi_deflate_init(int initial_len)
+unsigned char
+tpp_compr_caps(void)
 {
-	int ret;
-	struct def_ctx *ctx = malloc(sizeof(struct def_ctx));
-	if (!ctx) {
-		snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "Out of memory allocating context buffer %lu bytes",
-			sizeof(struct def_ctx));
-		tpp_log_func(LOG_CRIT, __func__, tpp_get_logbuf());
-		return NULL;
-	}
+	unsigned char caps = 0;
+#ifdef PBS_COMPRESSION_ENABLED
+	int codec;
 
-	if ((ctx->cmpr_buf = malloc(initial_len)) == NULL) {
-		free(ctx);
-		snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "Out of memory allocating deflate buffer %d bytes", initial_len);
-		tpp_log_func(LOG_CRIT, __func__, tpp_get_logbuf());
-		return NULL;
+	for (codec = TPP_COMPR_ZLIB; codec <= TPP_COMPR_ZSTD; codec++) {
+		if (tpp_compr_available(codec))
+			caps |= TPP_COMPR_CAP(codec);
 	}
+	if (tpp_compr_dict != NULL)
+		caps |= TPP_COMPR_CAP_DICT;
+#endif
+	return caps;
+}
 
-	/* allocate deflate state */
-	ctx->cmpr_strm.zalloc = Z_NULL;
-	ctx->cmpr_strm.zfree = Z_NULL;
-	ctx->cmpr_strm.opaque = Z_NULL;
-	ret = deflateInit(&ctx->cmpr_strm, COMPR_LEVEL);
-	if (ret != Z_OK) {
-		free(ctx->cmpr_buf);
-		free(ctx);
-		tpp_log_func(LOG_CRIT, __func__, "Multi compression init failed");
-		return NULL;
+/**
+ * @brief
+ *	Map a codec name (as given in PBS_COMPRESSION_TYPE) to a codec value
+ *
+ * @param[in] name - Name of the codec, NULL or empty selects zlib
+ *
+ * @return - The codec
+ * @retval  -1 - Unknown codec, or codec not compiled in
+ * @retval >=0 - The TPP_COMPR_XXX value
+ *
+ * @par MT-safe: Yes
+ */
+int
+tpp_compr_codec(char *name)
+{
+	int i;
+
+	if (name == NULL || *name == '\0')
+		return TPP_COMPR_ZLIB;
+
+	for (i = 0; i < sizeof(tpp_compr_codecs) / sizeof(tpp_compr_codecs[0]); i++) {
+		if (strcasecmp(name, tpp_compr_codecs[i].name) == 0) {
+			if (!tpp_compr_available(tpp_compr_codecs[i].codec))
+				return -1;
+			return tpp_compr_codecs[i].codec;
+		}
 	}
+	return -1;
+}
 
-	ctx->len = initial_len;
-	ctx->cmpr_strm.avail_out = initial_len;
-	ctx->cmpr_strm.next_out = ctx->cmpr_buf;
-	return (void *) ctx;
+/**
+ * @brief
+ *	Return the printable name of a codec
+ *
+ * @param[in] codec - The codec (TPP_COMPR_XXX)
+ *
+ * @return - Name of the codec, "unknown" if not a valid codec
+ *
+ * @par MT-safe: Yes
+ */
+char *
+tpp_compr_name(int codec)
+{
+	int i;
+
+	for (i = 0; i < sizeof(tpp_compr_codecs) / sizeof(tpp_compr_codecs[0]); i++) {
+		if (tpp_compr_codecs[i].codec == codec)
+			return tpp_compr_codecs[i].name;
+	}
+	return "unknown";
 }
 
 /**
  * @brief
- *	Add data to a multi step deflation
+ *	Set the codec used for outgoing data and load the shared dictionary
  *
- * @param[in] c - The deflate context
- * @param[in] fini - Whether this call is the final data addition
- * @param[in] inbuf - Pointer to data buffer to add
- * @param[in] inlen - Length of input buffer to add
+ * @par Functionality:
+ *	A dictionary that cannot be loaded is logged and compression continues
+ *	without it, since a missing dictionary file must not stop the daemon.
  *
- * @return - Error code
- * @retval - -1  - Failure
- * @retval -  0  - Success
+ * @param[in] codec     - The codec (TPP_COMPR_XXX)
+ * @param[in] dict_path - Path to the dictionary file, NULL for none
  *
- * @par Side Effects:
- *	None
+ * @return - Error code
+ * @retval -1 - Codec is not available
+ * @retval  0 - Success
  *
  * @par MT-safe: No
- *
  */
 int
-tpp_multi_deflate_do(void *c, int fini, void *inbuf, unsigned int inlen)
+tpp_compr_init(int codec, char *dict_path)
 {
-	struct def_ctx *ctx = c;
-	int flush;
-	int ret;
-	int filled;
-	void *p;
+	int fd;
+	struct stat sb;
+	void *dict;
+	ssize_t len;
 
-	ctx->cmpr_strm.avail_in = inlen;
-	ctx->cmpr_strm.next_in = inbuf;
+	if (!tpp_compr_available(codec)) {
+		snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "TPP compression codec %s not available", tpp_compr_name(codec));
+		tpp_log_func(LOG_CRIT, __func__, tpp_get_logbuf());
+		return -1;
+	}
+	tpp_compr_type = codec;
 
-	flush = (fini == 1) ? Z_FINISH : Z_NO_FLUSH;
-	while (1) {
-		ret = deflate(&ctx->cmpr_strm, flush);
-		if (ret == Z_OK && ctx->cmpr_strm.avail_out == 0) {
-			/* more output pending, but no output buffer space */
-			filled = (char *) ctx->cmpr_strm.next_out - (char *) ctx->cmpr_buf;
-			ctx->len = ctx->len * 2;
-			p = realloc(ctx->cmpr_buf, ctx->len);
-			if (!p) {
-				snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "Out of memory allocating deflate buffer %d bytes", ctx->len);
-				tpp_log_func(LOG_CRIT, __func__, tpp_get_logbuf());
-				deflateEnd(&ctx->cmpr_strm);
-				free(ctx->cmpr_buf);
-				free(ctx);
-				return -1;
-			}
-			ctx->cmpr_buf = p;
-			ctx->cmpr_strm.next_out = (Bytef *)((char *) ctx->cmpr_buf + filled);
-			ctx->cmpr_strm.avail_out = ctx->len - filled;
-		} else
-			break;
+	if (dict_path == NULL || *dict_path == '\0' || codec == TPP_COMPR_NONE)
+		return 0;
+
+	if ((fd = open(dict_path, O_RDONLY)) == -1) {
+		snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "Failed to open compression dictionary %s, errno=%d", dict_path, errno);
+		tpp_log_func(LOG_WARNING, __func__, tpp_get_logbuf());
+		return 0;
 	}
-	if (fini == 1 && ret != Z_STREAM_END) {
-		deflateEnd(&ctx->cmpr_strm);
-		free(ctx->cmpr_buf);
-		free(ctx);
-		tpp_log_func(LOG_CRIT, __func__, "Multi compression step failed");
-		return -1;
+	if (fstat(fd, &sb) == -1 || sb.st_size == 0 || sb.st_size > TPP_COMPR_DICT_MAX) {
+		close(fd);
+		snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "Compression dictionary %s is empty or larger than %d bytes", dict_path, TPP_COMPR_DICT_MAX);
+		tpp_log_func(LOG_WARNING, __func__, tpp_get_logbuf());
+		return 0;
 	}
+	if ((dict = malloc(sb.st_size)) == NULL) {
+		close(fd);
+		snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "Out of memory allocating dictionary buffer %ld bytes", (long) sb.st_size);
+		tpp_log_func(LOG_CRIT, __func__, tpp_get_logbuf());
+		return 0;
+	}
+	len = read(fd, dict, sb.st_size);
+	close(fd);
+	if (len != sb.st_size) {
+		free(dict);
+		snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "Failed to read compression dictionary %s", dict_path);
+		tpp_log_func(LOG_WARNING, __func__, tpp_get_logbuf());
+		return 0;
+	}
+
+#ifdef PBS_COMPRESSION_ZSTD
+	tpp_zstd_cdict = ZSTD_createCDict(dict, len, TPP_ZSTD_LEVEL);
+	tpp_zstd_ddict = ZSTD_createDDict(dict, len);
+	if (tpp_zstd_cdict == NULL || tpp_zstd_ddict == NULL) {
+		ZSTD_freeCDict(tpp_zstd_cdict);
+		ZSTD_freeDDict(tpp_zstd_ddict);
+		tpp_zstd_cdict = NULL;
+		tpp_zstd_ddict = NULL;
+		free(dict);
+		tpp_log_func(LOG_WARNING, __func__, "Failed to create zstd dictionary");
+		return 0;
+	}
+#endif
+	tpp_compr_dict = dict;
+	tpp_compr_dict_len = len;
+
+	snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "Loaded compression dictionary %s, %ld bytes", dict_path, (long) len);
+	tpp_log_func(LOG_INFO, NULL, tpp_get_logbuf());
 	return 0;
 }
 
+#ifdef PBS_COMPRESSION_ENABLED
+
+#define COMPR_LEVEL Z_DEFAULT_COMPRESSION
+
+struct def_ctx {
+	int codec;		/* codec used for this deflate */
+	int use_dict;		/* prime the codec with the shared dictionary */
+	z_stream cmpr_strm;	/* zlib stream state */
+	void *cmpr_buf;		/* output (or, for non zlib codecs, input) buffer */
+	int len;		/* allocated length of cmpr_buf */
+	unsigned int used;	/* bytes used in cmpr_buf, for non zlib codecs */
+};
+
 /**
  * @brief
- *	Complete the deflate and
+ *	Pick the codec for data sent to a peer
  *
- * @param[in] c - The deflate context
- * @param[out] cmpr_len - The total length after compression
+ * @par Functionality:
+ *	The configured codec is used only if the peer advertised it, and the
+ *	shared dictionary only if the peer advertised one as well. Anything
+ *	else gets plain zlib.
  *
- * @return - compressed buffer
- * @retval - NULL  - Failure
- * @retval - !NULL - Success
+ * @param[in]  caps     - The codecs advertised by the peer, 0 if unknown
+ * @param[out] use_dict - Whether to prime the codec with the dictionary
  *
- * @par Side Effects:
- *	None
+ * @return - The codec (TPP_COMPR_XXX)
  *
- * @par MT-safe: No
+ * @par MT-safe: Yes
+ */
+static int
+tpp_compr_select(unsigned char caps, int *use_dict)
+{
+	*use_dict = 0;
+	if (!(caps & TPP_COMPR_CAP(tpp_compr_type)))
+		return TPP_COMPR_ZLIB;
+	if (tpp_compr_dict != NULL && tpp_compr_type != TPP_COMPR_LZ4) {
+		if (!(caps & TPP_COMPR_CAP_DICT))
+			return TPP_COMPR_ZLIB;
+		*use_dict = 1;
+	}
+	return tpp_compr_type;
+}
+
+/**
+ * @brief
+ *	Detect the codec that produced a compressed buffer
+ *
+ * @param[in] inbuf - The compressed data
+ * @param[in] inlen - Length of the compressed data
  *
+ * @return - The codec (TPP_COMPR_XXX)
+ *
+ * @par MT-safe: Yes
  */
-void *
-tpp_multi_deflate_done(void *c, unsigned int *cmpr_len)
+static int
+tpp_compr_detect(void *inbuf, unsigned int inlen)
 {
-	struct def_ctx *ctx = c;
-	void *data = ctx->cmpr_buf;
-	int ret;
+	unsigned char *p = inbuf;
+	unsigned int magic;
+
+	if (inlen < 4)
+		return TPP_COMPR_ZLIB;
+
+	/* frame magic numbers are stored little endian */
+	magic = (unsigned int) p[0] | ((unsigned int) p[1] << 8) |
+		((unsigned int) p[2] << 16) | ((unsigned int) p[3] << 24);
+	if (magic == TPP_LZ4_MAGIC)
+		return TPP_COMPR_LZ4;
+	if (magic == TPP_ZSTD_MAGIC)
+		return TPP_COMPR_ZSTD;
+	return TPP_COMPR_ZLIB;
+}
 
-	*cmpr_len = ctx->cmpr_strm.total_out;
+/**
+ * @brief
+ *	Initialize a zlib deflate stream, optionally priming it with the
+ *	shared dictionary
+ *
+ * @param[in] strm     - The stream to initialize
+ * @param[in] use_dict - Prime the stream with the dictionary, if loaded
+ *
+ * @return - zlib error code
+ *
+ * @par MT-safe: Yes
+ */
+static int
+tpp_zlib_deflate_init(z_stream *strm, int use_dict)
+{
+	int ret;
 
-	ret = deflateEnd(&ctx->cmpr_strm);
-	free(ctx);
-	if (ret != Z_OK) {
-		free(data);
-		tpp_log_func(LOG_CRIT, __func__, "Compression cleanup failed");
-		return NULL;
+	strm->zalloc = Z_NULL;
+	strm->zfree = Z_NULL;
+	strm->opaque = Z_NULL;
+	ret = deflateInit(strm, COMPR_LEVEL);
+	if (ret == Z_OK && use_dict && tpp_compr_dict != NULL) {
+		ret = deflateSetDictionary(strm, tpp_compr_dict, tpp_compr_dict_len);
+		if (ret != Z_OK)
+			deflateEnd(strm);
 	}
-	return data;
+	return ret;
 }
 
 /**
- * @brief Deflate (compress) data
+ * @brief Deflate (compress) data using zlib
  *
+ * @param[in] use_dict - Prime the stream with the dictionary, if loaded
  * @param[in] inbuf   - Ptr to buffer to compress
  * @param[in] inlen   - The size of input buffer
  * @param[out] outlen - The size of the compressed data
@@ -1767,8 +1987,8 @@ tpp_multi_deflate_done(void *c, unsigned int *cmpr_len)
  *
  * @par MT-safe: No
  **/
-void *
-tpp_deflate(void *inbuf, unsigned int inlen, unsigned int *outlen)
+static void *
+tpp_zlib_deflate(int use_dict, void *inbuf, unsigned int inlen, unsigned int *outlen)
 {
 	z_stream strm;
 	int ret;
@@ -1777,13 +1997,8 @@ tpp_deflate(void *inbuf, unsigned int inlen, unsigned int *outlen)
 	void *p;
 	int len;
 
-	*outlen = 0;
-
 	/* allocate deflate state */
-	strm.zalloc = Z_NULL;
-	strm.zfree = Z_NULL;
-	strm.opaque = Z_NULL;
-	ret = deflateInit(&strm, Z_DEFAULT_COMPRESSION);
+	ret = tpp_zlib_deflate_init(&strm, use_dict);
 	if (ret != Z_OK) {
 		tpp_log_func(LOG_CRIT, __func__, "Compression failed");
 		return NULL;
@@ -1854,7 +2069,7 @@ tpp_deflate(void *inbuf, unsigned int inlen, unsigned int *outlen)
 }
 
 /**
- * @brief Inflate (de-compress) data
+ * @brief Inflate (de-compress) zlib data
  *
  * @param[in] inbuf  - Ptr to compress data buffer
  * @param[in] inlen  - The size of input buffer
@@ -1866,8 +2081,8 @@ tpp_deflate(void *inbuf, unsigned int inlen, unsigned int *outlen)
  *
  * @par MT-safe: No
  **/
-void *
-tpp_inflate(void *inbuf, unsigned int inlen, unsigned int totlen)
+static void *
+tpp_zlib_inflate(void *inbuf, unsigned int inlen, unsigned int totlen)
 {
 	int ret;
 	z_stream strm;
@@ -1906,6 +2121,18 @@ tpp_inflate(void *inbuf, unsigned int inlen, unsigned int totlen)
 	strm.avail_out = totlen;
 	strm.next_out = outbuf;
 	ret = inflate(&strm, Z_FINISH);
+	if (ret == Z_NEED_DICT) {
+		/* sender primed the stream with the shared dictionary */
+		if (tpp_compr_dict == NULL) {
+			inflateEnd(&strm);
+			free(outbuf);
+			tpp_log_func(LOG_CRIT, __func__, "Decompression needs a dictionary, but none is loaded");
+			return NULL;
+		}
+		ret = inflateSetDictionary(&strm, tpp_compr_dict, tpp_compr_dict_len);
+		if (ret == Z_OK)
+			ret = inflate(&strm, Z_FINISH);
+	}
 	inflateEnd(&strm);
 	if (ret != Z_STREAM_END) {
 		free(outbuf);
@@ -1915,30 +2142,573 @@ tpp_inflate(void *inbuf, unsigned int inlen, unsigned int totlen)
 	}
 	return outbuf;
 }
-#else
-void *
-tpp_multi_deflate_init(int initial_len)
-{
-	tpp_log_func(LOG_CRIT, __func__, "TPP compression disabled");
-	return NULL;
-}
 
-int
-tpp_multi_deflate_do(void *c, int fini, void *inbuf, unsigned int inlen)
+#ifdef PBS_COMPRESSION_LZ4
+/**
+ * @brief Compress data into a lz4 frame
+ *
+ * @param[in] inbuf   - Ptr to buffer to compress
+ * @param[in] inlen   - The size of input buffer
+ * @param[out] outlen - The size of the compressed data
+ *
+ * @return      - Ptr to the compressed data buffer
+ * @retval  !NULL - Success
+ * @retval   NULL - Failure
+ *
+ * @par MT-safe: Yes
+ **/
+static void *
+tpp_lz4_deflate(void *inbuf, unsigned int inlen, unsigned int *outlen)
 {
-	tpp_log_func(LOG_CRIT, __func__, "TPP compression disabled");
-	return -1;
-}
+	LZ4F_preferences_t prefs;
+	size_t bound;
+	size_t ret;
+	void *data;
 
-void *
+	memset(&prefs, 0, sizeof(prefs));
+	prefs.frameInfo.contentSize = inlen;
+
+	bound = LZ4F_compressFrameBound(inlen, &prefs);
+	if ((data = malloc(bound)) == NULL) {
+		snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "Out of memory allocating deflate buffer %lu bytes", (unsigned long) bound);
+		tpp_log_func(LOG_CRIT, __func__, tpp_get_logbuf());
+		return NULL;
+	}
+
+	ret = LZ4F_compressFrame(data, bound, inbuf, inlen, &prefs);
+	if (LZ4F_isError(ret)) {
+		free(data);
+		snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "Compression failed, %s", LZ4F_getErrorName(ret));
+		tpp_log_func(LOG_CRIT, __func__, tpp_get_logbuf());
+		return NULL;
+	}
+
+	*outlen = ret;
+	return data;
+}
+
+/**
+ * @brief Decompress a lz4 frame
+ *
+ * @param[in] inbuf  - Ptr to compress data buffer
+ * @param[in] inlen  - The size of input buffer
+ * @param[in] totlen - The total size of the uncompress data
+ *
+ * @return      - Ptr to the uncompressed data buffer
+ * @retval  !NULL - Success
+ * @retval   NULL - Failure
+ *
+ * @par MT-safe: Yes
+ **/
+static void *
+tpp_lz4_inflate(void *inbuf, unsigned int inlen, unsigned int totlen)
+{
+	LZ4F_decompressionContext_t dctx;
+	size_t dst_len = totlen;
+	size_t src_len = inlen;
+	size_t ret;
+	void *outbuf;
+
+	if ((outbuf = malloc(totlen > inlen ? totlen : inlen)) == NULL) {
+		snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "Out of memory allocating inflate buffer %d bytes", totlen);
+		tpp_log_func(LOG_CRIT, __func__, tpp_get_logbuf());
+		return NULL;
+	}
+
+	ret = LZ4F_createDecompressionContext(&dctx, LZ4F_VERSION);
+	if (LZ4F_isError(ret)) {
+		free(outbuf);
+		tpp_log_func(LOG_CRIT, __func__, "Decompression Init failed");
+		return NULL;
+	}
+	ret = LZ4F_decompress(dctx, outbuf, &dst_len, inbuf, &src_len, NULL);
+	LZ4F_freeDecompressionContext(dctx);
+
+	/* a return value of 0 means the frame was fully decoded */
+	if (LZ4F_isError(ret) || ret != 0 || dst_len != totlen) {
+		free(outbuf);
+		snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "Decompression failed, %s",
+			LZ4F_isError(ret) ? LZ4F_getErrorName(ret) : "truncated frame");
+		tpp_log_func(LOG_CRIT, __func__, tpp_get_logbuf());
+		return NULL;
+	}
+	return outbuf;
+}
+#endif
+
+#ifdef PBS_COMPRESSION_ZSTD
+/**
+ * @brief Compress data into a zstd frame
+ *
+ * @param[in] use_dict - Compress with the dictionary, if loaded
+ * @param[in] inbuf   - Ptr to buffer to compress
+ * @param[in] inlen   - The size of input buffer
+ * @param[out] outlen - The size of the compressed data
+ *
+ * @return      - Ptr to the compressed data buffer
+ * @retval  !NULL - Success
+ * @retval   NULL - Failure
+ *
+ * @par MT-safe: Yes
+ **/
+static void *
+tpp_zstd_deflate(int use_dict, void *inbuf, unsigned int inlen, unsigned int *outlen)
+{
+	tpp_tls_t *tls;
+	size_t bound;
+	size_t ret;
+	void *data;
+
+	/* compression contexts are expensive to set up, keep one per thread */
+	if ((tls = tpp_get_tls()) == NULL)
+		return NULL;
+	if (tls->zstd_cctx == NULL && (tls->zstd_cctx = ZSTD_createCCtx()) == NULL) {
+		tpp_log_func(LOG_CRIT, __func__, "Compression Init failed");
+		return NULL;
+	}
+
+	bound = ZSTD_compressBound(inlen);
+	if ((data = malloc(bound)) == NULL) {
+		snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "Out of memory allocating deflate buffer %lu bytes", (unsigned long) bound);
+		tpp_log_func(LOG_CRIT, __func__, tpp_get_logbuf());
+		return NULL;
+	}
+
+	if (use_dict && tpp_zstd_cdict)
+		ret = ZSTD_compress_usingCDict(tls->zstd_cctx, data, bound, inbuf, inlen, tpp_zstd_cdict);
+	else
+		ret = ZSTD_compressCCtx(tls->zstd_cctx, data, bound, inbuf, inlen, TPP_ZSTD_LEVEL);
+	if (ZSTD_isError(ret)) {
+		free(data);
+		snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "Compression failed, %s", ZSTD_getErrorName(ret));
+		tpp_log_func(LOG_CRIT, __func__, tpp_get_logbuf());
+		return NULL;
+	}
+
+	*outlen = ret;
+	return data;
+}
+
+/**
+ * @brief Decompress a zstd frame
+ *
+ * @param[in] inbuf  - Ptr to compress data buffer
+ * @param[in] inlen  - The size of input buffer
+ * @param[in] totlen - The total size of the uncompress data
+ *
+ * @return      - Ptr to the uncompressed data buffer
+ * @retval  !NULL - Success
+ * @retval   NULL - Failure
+ *
+ * @par MT-safe: Yes
+ **/
+static void *
+tpp_zstd_inflate(void *inbuf, unsigned int inlen, unsigned int totlen)
+{
+	tpp_tls_t *tls;
+	size_t ret;
+	void *outbuf;
+
+	if ((tls = tpp_get_tls()) == NULL)
+		return NULL;
+	if (tls->zstd_dctx == NULL && (tls->zstd_dctx = ZSTD_createDCtx()) == NULL) {
+		tpp_log_func(LOG_CRIT, __func__, "Decompression Init failed");
+		return NULL;
+	}
+
+	if ((outbuf = malloc(totlen > inlen ? totlen : inlen)) == NULL) {
+		snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "Out of memory allocating inflate buffer %d bytes", totlen);
+		tpp_log_func(LOG_CRIT, __func__, tpp_get_logbuf());
+		return NULL;
+	}
+
+	if (tpp_zstd_ddict)
+		ret = ZSTD_decompress_usingDDict(tls->zstd_dctx, outbuf, totlen, inbuf, inlen, tpp_zstd_ddict);
+	else
+		ret = ZSTD_decompressDCtx(tls->zstd_dctx, outbuf, totlen, inbuf, inlen);
+	if (ZSTD_isError(ret) || ret != totlen) {
+		free(outbuf);
+		snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "Decompression failed, %s",
+			ZSTD_isError(ret) ? ZSTD_getErrorName(ret) : "short frame");
+		tpp_log_func(LOG_CRIT, __func__, tpp_get_logbuf());
+		return NULL;
+	}
+	return outbuf;
+}
+#endif
+
+/**
+ * @brief Compress data with the given codec
+ *
+ * @param[in] codec    - The codec to use (TPP_COMPR_XXX)
+ * @param[in] use_dict - Prime the codec with the dictionary, if loaded
+ * @param[in] inbuf    - Ptr to buffer to compress
+ * @param[in] inlen    - The size of input buffer
+ * @param[out] outlen  - The size of the compressed data
+ *
+ * @return      - Ptr to the compressed data buffer
+ * @retval  !NULL - Success
+ * @retval   NULL - Failure
+ *
+ * @par MT-safe: No
+ **/
+static void *
+tpp_deflate_with(int codec, int use_dict, void *inbuf, unsigned int inlen, unsigned int *outlen)
+{
+	*outlen = 0;
+
+	switch (codec) {
+#ifdef PBS_COMPRESSION_LZ4
+		case TPP_COMPR_LZ4:
+			return tpp_lz4_deflate(inbuf, inlen, outlen);
+#endif
+#ifdef PBS_COMPRESSION_ZSTD
+		case TPP_COMPR_ZSTD:
+			return tpp_zstd_deflate(use_dict, inbuf, inlen, outlen);
+#endif
+		default:
+			return tpp_zlib_deflate(use_dict, inbuf, inlen, outlen);
+	}
+}
+
+/**
+ * @brief Compress data with the given codec, using the shared dictionary
+ *	if one is loaded
+ *
+ * @param[in] codec   - The codec to use (TPP_COMPR_XXX)
+ * @param[in] inbuf   - Ptr to buffer to compress
+ * @param[in] inlen   - The size of input buffer
+ * @param[out] outlen - The size of the compressed data
+ *
+ * @return      - Ptr to the compressed data buffer
+ * @retval  !NULL - Success
+ * @retval   NULL - Failure
+ *
+ * @par MT-safe: No
+ **/
+void *
+tpp_deflate_codec(int codec, void *inbuf, unsigned int inlen, unsigned int *outlen)
+{
+	return tpp_deflate_with(codec, 1, inbuf, inlen, outlen);
+}
+
+/**
+ * @brief
+ *	Initialize a multi step deflation
+ *	Allocate an initial result buffer of given length
+ *
+ * @par Functionality:
+ *	zlib streams the data as it is added. The frame based codecs collect
+ *	the data and compress it in one go when the final data is added.
+ *
+ * @param[in] caps - The codecs advertised by the receiving peer
+ * @param[in] initial_len -  initial length of result buffer
+ *
+ * @return - The deflate context
+ * @retval - NULL  - Failure
+ * @retval - !NULL - Success
+ *
+ * @par Side Effects:
+ *	None
+ *
+ * @par MT-safe: No
+ *
+ */
+void *
+tpp_multi_deflate_init(unsigned char caps, int initial_len)
+{
+	int ret;
+	struct def_ctx *ctx = malloc(sizeof(struct def_ctx));
+	if (!ctx) {
+		snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "Out of memory allocating context buffer %lu bytes",
+			sizeof(struct def_ctx));
+		tpp_log_func(LOG_CRIT, __func__, tpp_get_logbuf());
+		return NULL;
+	}
+
+	if ((ctx->cmpr_buf = malloc(initial_len)) == NULL) {
+		free(ctx);
+		snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "Out of memory allocating deflate buffer %d bytes", initial_len);
+		tpp_log_func(LOG_CRIT, __func__, tpp_get_logbuf());
+		return NULL;
+	}
+
+	ctx->codec = tpp_compr_select(caps, &ctx->use_dict);
+	ctx->len = initial_len;
+	ctx->used = 0;
+	if (ctx->codec != TPP_COMPR_ZLIB)
+		return (void *) ctx;
+
+	/* allocate deflate state */
+	ret = tpp_zlib_deflate_init(&ctx->cmpr_strm, ctx->use_dict);
+	if (ret != Z_OK) {
+		free(ctx->cmpr_buf);
+		free(ctx);
+		tpp_log_func(LOG_CRIT, __func__, "Multi compression init failed");
+		return NULL;
+	}
+
+	ctx->cmpr_strm.avail_out = initial_len;
+	ctx->cmpr_strm.next_out = ctx->cmpr_buf;
+	return (void *) ctx;
+}
+
+/**
+ * @brief
+ *	Add data to a frame based (non zlib) multi step deflation
+ *
+ * @param[in] ctx - The deflate context
+ * @param[in] fini - Whether this call is the final data addition
+ * @param[in] inbuf - Pointer to data buffer to add
+ * @param[in] inlen - Length of input buffer to add
+ *
+ * @return - Error code
+ * @retval - -1  - Failure
+ * @retval -  0  - Success
+ *
+ * @par MT-safe: No
+ *
+ */
+static int
+tpp_multi_deflate_frame(struct def_ctx *ctx, int fini, void *inbuf, unsigned int inlen)
+{
+	void *p;
+	unsigned int outlen;
+
+	if (inlen > 0) {
+		if (ctx->used + inlen > ctx->len) {
+			while (ctx->used + inlen > ctx->len)
+				ctx->len = ctx->len * 2;
+			if ((p = realloc(ctx->cmpr_buf, ctx->len)) == NULL) {
+				snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "Out of memory allocating deflate buffer %d bytes", ctx->len);
+				tpp_log_func(LOG_CRIT, __func__, tpp_get_logbuf());
+				free(ctx->cmpr_buf);
+				free(ctx);
+				return -1;
+			}
+			ctx->cmpr_buf = p;
+		}
+		memcpy((char *) ctx->cmpr_buf + ctx->used, inbuf, inlen);
+		ctx->used += inlen;
+	}
+
+	if (fini == 1) {
+		p = tpp_deflate_with(ctx->codec, ctx->use_dict, ctx->cmpr_buf, ctx->used, &outlen);
+		free(ctx->cmpr_buf);
+		if (p == NULL) {
+			free(ctx);
+			tpp_log_func(LOG_CRIT, __func__, "Multi compression step failed");
+			return -1;
+		}
+		ctx->cmpr_buf = p;
+		ctx->used = outlen;
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ *	Add data to a multi step deflation
+ *
+ * @param[in] c - The deflate context
+ * @param[in] fini - Whether this call is the final data addition
+ * @param[in] inbuf - Pointer to data buffer to add
+ * @param[in] inlen - Length of input buffer to add
+ *
+ * @return - Error code
+ * @retval - -1  - Failure
+ * @retval -  0  - Success
+ *
+ * @par Side Effects:
+ *	None
+ *
+ * @par MT-safe: No
+ *
+ */
+int
+tpp_multi_deflate_do(void *c, int fini, void *inbuf, unsigned int inlen)
+{
+	struct def_ctx *ctx = c;
+	int flush;
+	int ret;
+	int filled;
+	void *p;
+
+	if (ctx->codec != TPP_COMPR_ZLIB)
+		return tpp_multi_deflate_frame(ctx, fini, inbuf, inlen);
+
+	ctx->cmpr_strm.avail_in = inlen;
+	ctx->cmpr_strm.next_in = inbuf;
+
+	flush = (fini == 1) ? Z_FINISH : Z_NO_FLUSH;
+	while (1) {
+		ret = deflate(&ctx->cmpr_strm, flush);
+		if (ret == Z_OK && ctx->cmpr_strm.avail_out == 0) {
+			/* more output pending, but no output buffer space */
+			filled = (char *) ctx->cmpr_strm.next_out - (char *) ctx->cmpr_buf;
+			ctx->len = ctx->len * 2;
+			p = realloc(ctx->cmpr_buf, ctx->len);
+			if (!p) {
+				snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "Out of memory allocating deflate buffer %d bytes", ctx->len);
+				tpp_log_func(LOG_CRIT, __func__, tpp_get_logbuf());
+				deflateEnd(&ctx->cmpr_strm);
+				free(ctx->cmpr_buf);
+				free(ctx);
+				return -1;
+			}
+			ctx->cmpr_buf = p;
+			ctx->cmpr_strm.next_out = (Bytef *)((char *) ctx->cmpr_buf + filled);
+			ctx->cmpr_strm.avail_out = ctx->len - filled;
+		} else
+			break;
+	}
+	if (fini == 1 && ret != Z_STREAM_END) {
+		deflateEnd(&ctx->cmpr_strm);
+		free(ctx->cmpr_buf);
+		free(ctx);
+		tpp_log_func(LOG_CRIT, __func__, "Multi compression step failed");
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ *	Complete the deflate and
+ *
+ * @param[in] c - The deflate context
+ * @param[out] cmpr_len - The total length after compression
+ *
+ * @return - compressed buffer
+ * @retval - NULL  - Failure
+ * @retval - !NULL - Success
+ *
+ * @par Side Effects:
+ *	None
+ *
+ * @par MT-safe: No
+ *
+ */
+void *
 tpp_multi_deflate_done(void *c, unsigned int *cmpr_len)
+{
+	struct def_ctx *ctx = c;
+	void *data = ctx->cmpr_buf;
+	int ret;
+
+	if (ctx->codec != TPP_COMPR_ZLIB) {
+		*cmpr_len = ctx->used;
+		free(ctx);
+		return data;
+	}
+
+	*cmpr_len = ctx->cmpr_strm.total_out;
+
+	ret = deflateEnd(&ctx->cmpr_strm);
+	free(ctx);
+	if (ret != Z_OK) {
+		free(data);
+		tpp_log_func(LOG_CRIT, __func__, "Compression cleanup failed");
+		return NULL;
+	}
+	return data;
+}
+
+/**
+ * @brief Deflate (compress) data for a peer, with the configured codec if
+ *	the peer advertised it, zlib otherwise
+ *
+ * @param[in] caps    - The codecs advertised by the peer, 0 if unknown
+ * @param[in] inbuf   - Ptr to buffer to compress
+ * @param[in] inlen   - The size of input buffer
+ * @param[out] outlen - The size of the compressed data
+ *
+ * @return      - Ptr to the compressed data buffer
+ * @retval  !NULL - Success
+ * @retval   NULL - Failure
+ *
+ * @par MT-safe: No
+ **/
+void *
+tpp_deflate(unsigned char caps, void *inbuf, unsigned int inlen, unsigned int *outlen)
+{
+	int codec;
+	int use_dict;
+
+	codec = tpp_compr_select(caps, &use_dict);
+	return tpp_deflate_with(codec, use_dict, inbuf, inlen, outlen);
+}
+
+/**
+ * @brief Inflate (de-compress) data
+ *
+ * @par Functionality:
+ *	The codec is detected from the compressed data itself, so data
+ *	compressed by any compiled in codec can be inflated.
+ *
+ * @param[in] inbuf  - Ptr to compress data buffer
+ * @param[in] inlen  - The size of input buffer
+ * @param[in] totlen - The total size of the uncompress data
+ *
+ * @return      - Ptr to the uncompressed data buffer
+ * @retval  !NULL - Success
+ * @retval   NULL - Failure
+ *
+ * @par MT-safe: No
+ **/
+void *
+tpp_inflate(void *inbuf, unsigned int inlen, unsigned int totlen)
+{
+	int codec = tpp_compr_detect(inbuf, inlen);
+
+	switch (codec) {
+#ifdef PBS_COMPRESSION_LZ4
+		case TPP_COMPR_LZ4:
+			return tpp_lz4_inflate(inbuf, inlen, totlen);
+#endif
+#ifdef PBS_COMPRESSION_ZSTD
+		case TPP_COMPR_ZSTD:
+			return tpp_zstd_inflate(inbuf, inlen, totlen);
+#endif
+		case TPP_COMPR_ZLIB:
+			return tpp_zlib_inflate(inbuf, inlen, totlen);
+		default:
+			snprintf(tpp_get_logbuf(), TPP_LOGBUF_SZ, "Data compressed with %s, which is not available", tpp_compr_name(codec));
+			tpp_log_func(LOG_CRIT, __func__, tpp_get_logbuf());
+			return NULL;
+	}
+}
+#else
+void *
+tpp_multi_deflate_init(unsigned char caps, int initial_len)
+{
+	tpp_log_func(LOG_CRIT, __func__, "TPP compression disabled");
+	return NULL;
+}
+
+int
+tpp_multi_deflate_do(void *c, int fini, void *inbuf, unsigned int inlen)
+{
+	tpp_log_func(LOG_CRIT, __func__, "TPP compression disabled");
+	return -1;
+}
+
+void *
+tpp_multi_deflate_done(void *c, unsigned int *cmpr_len)
+{
+	tpp_log_func(LOG_CRIT, __func__, "TPP compression disabled");
+	return NULL;
+}
+
+void *
+tpp_deflate_codec(int codec, void *inbuf, unsigned int inlen, unsigned int *outlen)
 {
 	tpp_log_func(LOG_CRIT, __func__, "TPP compression disabled");
 	return NULL;
 }
 
 void *
-tpp_deflate(void *inbuf, unsigned int inlen, unsigned int *outlen)
+tpp_deflate(unsigned char caps, void *inbuf, unsigned int inlen, unsigned int *outlen)
 {
 	tpp_log_func(LOG_CRIT, __func__, "TPP compression disabled");
 	return NULL;
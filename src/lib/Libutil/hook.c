@@ -3435,6 +3435,40 @@ print_hook(hook	*phook, char *heading)
 		LOG_INFO, __func__, log_buffer);
 }
 
+/**
+ * @brief
+ *	Return one checksum for the whole set of mom hooks in svr_allhooks
+ *	and the hook resourcedef file.  The server and a mom holding the
+ *	same hook files get the same value, whatever the order of the list.
+ *
+ * @param[in] rescdef_checksum - checksum of the hook resourcedef file
+ *
+ * @return unsigned long
+ */
+unsigned long
+hook_bundle_checksum(unsigned long rescdef_checksum)
+{
+	hook		*phook;
+	unsigned long	sum = rescdef_checksum;
+	unsigned long	h;
+	char		*p;
+
+	for (phook = (hook *)GET_NEXT(svr_allhooks); phook != NULL;
+		phook = (hook *)GET_NEXT(phook->hi_allhooks)) {
+		if ((phook->hook_name == NULL) || phook->pending_delete ||
+			((phook->event & MOM_EVENTS) == 0))
+			continue;
+		h = 5381;
+		for (p = phook->hook_name; *p != '\0'; p++)
+			h = h * 33 + (unsigned char)*p;
+		h = h * 31 + phook->hook_control_checksum;
+		h = h * 31 + phook->hook_script_checksum;
+		h = h * 31 + phook->hook_config_checksum;
+		sum += h;	/* a sum does not depend on the order */
+	}
+	return (sum);
+}
+
 /**
  * @brief
  * 	Prints all the attributes and their values of all hooks appearing
@@ -71,44 +71,79 @@
 #endif
 
 #define DATE_LIMIT (3*(60*60*24*365)) /* Limit to 3 years from now */
+#define OCCR_CACHE_SIZE 16	/* number of recurrence rules kept expanded */
+
+#ifdef LIBICAL
+/*
+ * Expansion of a recurrence rule from a start time.  Callers loop over the
+ * occurrences of a reservation by index, so the occurrences are kept as
+ * they are computed, and the iterator is kept to compute more when a
+ * larger index is asked for.  This makes such a loop linear instead of
+ * expanding the rule from dtstart on every call.
+ */
+struct occr_cache {
+	char *oc_rrule;
+	char *oc_tz;
+	time_t oc_dtstart;
+	icaltimezone *oc_zone;
+	struct icalrecur_iterator_impl *oc_itr;	/* NULL once the rule is exhausted */
+	time_t *oc_local;	/* occurrences, in the timezone of the rule */
+	time_t *oc_utc;		/* occurrences, in UTC */
+	int oc_count;		/* number of occurrences computed */
+	int oc_size;		/* slots in oc_local and oc_utc */
+};
+
+static struct occr_cache occr_cache[OCCR_CACHE_SIZE];
+static int occr_cache_next = 0;	/* slot to reuse next */
 
 /**
  * @brief
- * 	Returns the number of occurrences defined by a recurrence rule.
+ * 	Release the expansion held in a cache slot.
  *
- * @par	The total number of occurrences is currently limited to a hardcoded
- * 	3 years limit from the current date.
+ * @param[in] oc - The cache slot
  *
- * @par	NOTE: Determine whether 3 years limit is the right way to go about setting
- * 	a limit on the total number of occurrences.
+ */
+static void
+free_occr_cache(struct occr_cache *oc)
+{
+	if (oc->oc_itr != NULL)
+		icalrecur_iterator_free(oc->oc_itr);
+	free(oc->oc_rrule);
+	free(oc->oc_tz);
+	free(oc->oc_local);
+	free(oc->oc_utc);
+	memset(oc, 0, sizeof(struct occr_cache));
+}
+
+/**
+ * @brief
+ * 	Find the expansion of a recurrence rule from a start time, setting
+ * 	up a new one in place of the oldest if it is not cached.
  *
  * @param[in] rrule - The recurrence rule as defined by the user
- * @param[in] tt - The start time of the first occurrence
+ * @param[in] dtstart - The start time of the first occurrence
  * @param[in] tz - The timezone associated to the recurrence rule
  *
- * @return	int
- * @retval 	the total number of occurrences
+ * @return	struct occr_cache *
+ * @retval	the expansion
+ * @retval	NULL if the timezone is unknown or out of memory
  *
  */
-int
-get_num_occurrences(char *rrule, time_t dtstart, char *tz)
+static struct occr_cache *
+get_occr_cache(char *rrule, time_t dtstart, char *tz)
 {
-
-
-#ifdef LIBICAL
+	struct occr_cache *oc;
 	struct icalrecurrencetype rt;
 	struct icaltimetype start;
 	icaltimezone *localzone;
-	struct icaltimetype next;
-	struct icalrecur_iterator_impl *itr;
-	time_t now;
-	time_t date_limit;
-	int num_resv = 0;
+	int i;
 
-	/* if any of the argument is NULL, we are dealing with
-	 * advance reservation, so return 1 occurrence */
-	if (rrule == NULL || tz == NULL)
-		return 1;
+	for (i = 0; i < OCCR_CACHE_SIZE; i++) {
+		oc = &occr_cache[i];
+		if (oc->oc_rrule != NULL && oc->oc_dtstart == dtstart &&
+			strcmp(oc->oc_rrule, rrule) == 0 && strcmp(oc->oc_tz, tz) == 0)
+			return oc;
+	}
 
 	icalerror_clear_errno();
 
@@ -121,28 +156,121 @@ get_num_occurrences(char *rrule, time_t dtstart, char *tz)
 	localzone = icaltimezone_get_builtin_timezone(tz);
 
 	if (localzone == NULL)
-		return 0;
+		return NULL;
 
-	now = time(NULL);
-	date_limit = now + DATE_LIMIT;
+	oc = &occr_cache[occr_cache_next];
+	occr_cache_next = (occr_cache_next + 1) % OCCR_CACHE_SIZE;
+	free_occr_cache(oc);
+
+	if ((oc->oc_rrule = strdup(rrule)) == NULL ||
+		(oc->oc_tz = strdup(tz)) == NULL) {
+		free_occr_cache(oc);
+		return NULL;
+	}
 
 	rt = icalrecurrencetype_from_string(rrule);
 
 	start = icaltime_from_timet_with_zone(dtstart, 0, NULL);
 	icaltimezone_convert_time(&start, icaltimezone_get_utc_timezone(), localzone);
 
-	itr = (struct icalrecur_iterator_impl*) icalrecur_iterator_new(rt, start);
+	oc->oc_dtstart = dtstart;
+	oc->oc_zone = localzone;
+	oc->oc_itr = (struct icalrecur_iterator_impl*) icalrecur_iterator_new(rt, start);
 
-	next = icalrecur_iterator_next(itr);
+	return oc;
+}
+
+/**
+ * @brief
+ * 	Compute the occurrences of a cached expansion up to a given number.
+ *
+ * @param[in] oc - The expansion
+ * @param[in] num - The number of occurrences wanted
+ *
+ * @return	int
+ * @retval	the number of occurrences computed, less than num if the
+ * 		rule has fewer occurrences or memory ran out
+ *
+ */
+static int
+fill_occr_cache(struct occr_cache *oc, int num)
+{
+	struct icaltimetype next;
+	time_t *tmp;
+	int size;
+
+	while (oc->oc_count < num && oc->oc_itr != NULL) {
+		if (oc->oc_count == oc->oc_size) {
+			size = (oc->oc_size == 0) ? 64 : oc->oc_size * 2;
+			if ((tmp = realloc(oc->oc_local, size * sizeof(time_t))) == NULL)
+				break;
+			oc->oc_local = tmp;
+			if ((tmp = realloc(oc->oc_utc, size * sizeof(time_t))) == NULL)
+				break;
+			oc->oc_utc = tmp;
+			oc->oc_size = size;
+		}
+
+		next = icalrecur_iterator_next(oc->oc_itr);
+		if (icaltime_is_null_time(next)) {
+			icalrecur_iterator_free(oc->oc_itr);
+			oc->oc_itr = NULL;
+			break;
+		}
+		oc->oc_local[oc->oc_count] = icaltime_as_timet(next);
+		icaltimezone_convert_time(&next, oc->oc_zone,
+			icaltimezone_get_utc_timezone());
+		oc->oc_utc[oc->oc_count] = icaltime_as_timet(next);
+		oc->oc_count++;
+	}
+
+	return oc->oc_count;
+}
+#endif
+
+/**
+ * @brief
+ * 	Returns the number of occurrences defined by a recurrence rule.
+ *
+ * @par	The total number of occurrences is currently limited to a hardcoded
+ * 	3 years limit from the current date.
+ *
+ * @par	NOTE: Determine whether 3 years limit is the right way to go about setting
+ * 	a limit on the total number of occurrences.
+ *
+ * @param[in] rrule - The recurrence rule as defined by the user
+ * @param[in] tt - The start time of the first occurrence
+ * @param[in] tz - The timezone associated to the recurrence rule
+ *
+ * @return	int
+ * @retval 	the total number of occurrences
+ *
+ */
+int
+get_num_occurrences(char *rrule, time_t dtstart, char *tz)
+{
+
+
+#ifdef LIBICAL
+	struct occr_cache *oc;
+	time_t date_limit;
+	int num_resv = 0;
+
+	/* if any of the argument is NULL, we are dealing with
+	 * advance reservation, so return 1 occurrence */
+	if (rrule == NULL || tz == NULL)
+		return 1;
+
+	if ((oc = get_occr_cache(rrule, dtstart, tz)) == NULL)
+		return 0;
+
+	date_limit = time(NULL) + DATE_LIMIT;
 
 	/* Compute the total number of occurrences.
 	 * Breaks out if the total number of allowed occurrences is exceeded */
-	while (!icaltime_is_null_time(next) &&
-		(icaltime_as_timet(next) < date_limit)) {
+	while (fill_occr_cache(oc, num_resv + 1) > num_resv &&
+		oc->oc_local[num_resv] < date_limit)
 		num_resv++;
-		next = icalrecur_iterator_next(itr);
-	}
-	icalrecur_iterator_free(itr);
 
 	return num_resv;
 #else
@@ -160,9 +288,9 @@ get_num_occurrences(char *rrule, time_t dtstart, char *tz)
  * 	index, and start time. This function assumes that the
  * 	time dtsart passed in is the one to start the occurrence from.
  *
- * @par	NOTE: This function should be made reentrant such that
- * 	it can be looped over without having to loop over every occurrence
- * 	over and over again.
+ * @par	The expansion of the rule is cached, so looping over the
+ * 	occurrences of a reservation by index costs one step of the
+ * 	recurrence iterator per call rather than idx steps.
  *
  * @param[in] rrule - The recurrence rule as defined by the user
  * @param[in] dtstart - The start time from which to start
@@ -178,13 +306,7 @@ time_t
 get_occurrence(char *rrule, time_t dtstart, char *tz, int idx)
 {
 #ifdef LIBICAL
-	struct icalrecurrencetype rt;
-	struct icaltimetype start;
-	icaltimezone *localzone;
-	struct icaltimetype next;
-	struct icalrecur_iterator_impl *itr;
-	int i;
-	time_t next_occr = dtstart;
+	struct occr_cache *oc;
 
 	if (rrule == NULL)
 		return dtstart;
@@ -192,38 +314,17 @@ get_occurrence(char *rrule, time_t dtstart, char *tz, int idx)
 	if (tz == NULL)
 		return -1;
 
-	icalerror_clear_errno();
-
-	icalerror_set_error_state(ICAL_PARSE_ERROR, ICAL_ERROR_NONFATAL);
-#ifdef LIBICAL_API2
-	icalerror_set_errors_are_fatal(0);
-#else
-	icalerror_errors_are_fatal = 0;
-#endif
-	localzone = icaltimezone_get_builtin_timezone(tz);
-
-	if (localzone == NULL)
+	if ((oc = get_occr_cache(rrule, dtstart, tz)) == NULL)
 		return -1;
 
-	rt = icalrecurrencetype_from_string(rrule);
-
-	start = icaltime_from_timet_with_zone(dtstart, 0, NULL);
-	icaltimezone_convert_time(&start, icaltimezone_get_utc_timezone(), localzone);
-	next = start;
-
-	itr = (struct icalrecur_iterator_impl*) icalrecur_iterator_new(rt, start);
-	/* Skip as many occurrences as specified by idx */
-	for (i = 0; i < idx && !icaltime_is_null_time(next); i++)
-		next = icalrecur_iterator_next(itr);
+	if (idx <= 0)
+		return dtstart;
 
-	if (!icaltime_is_null_time(next)) {
-		icaltimezone_convert_time(&next, localzone,
-			icaltimezone_get_utc_timezone());
-		next_occr = icaltime_as_timet(next);
-	} else next_occr = -1; /* If reached end of possible date-time return -1 */
-		icalrecur_iterator_free(itr);
+	/* If reached end of possible date-time return -1 */
+	if (fill_occr_cache(oc, idx) < idx)
+		return -1;
 
-	return next_occr;
+	return oc->oc_utc[idx - 1];
 #else
 	return dtstart;
 #endif
@@ -574,10 +675,16 @@ set_ical_zoneinfo(char *path)
 {
 #ifdef LIBICAL
 	static int called = 0;
+	int i;
+
 	if (path != NULL) {
 		if(called)
 			free_zone_directory();
 
+		/* the cached expansions were computed with the old zones */
+		for (i = 0; i < OCCR_CACHE_SIZE; i++)
+			free_occr_cache(&occr_cache[i]);
+
 		set_zone_directory(path);
 		called = 1;
 	}
@@ -0,0 +1,707 @@
+/*
+ * Copyright (C) 1994-2020 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+/**
+ * @file	pbs_idcache.c
+ *
+ * @brief
+ *	Cache of user and group lookups for the daemons.
+ *
+ * @par
+ *	getpwnam(), getgrnam() and initgroups() can take a long time when
+ *	the names come from LDAP or SSSD, and the daemons make them on every
+ *	job submit, start and purge.  Found entries are kept for ttl seconds
+ *	and names which were not found for neg_ttl seconds.  A refresher
+ *	pass, run by a thread or from the daemon's main loop, looks the
+ *	entries in use up again before they expire so the daemon rarely
+ *	waits on a lookup, and drops the entries not in use.
+ *
+ * @par
+ *	Like getpwnam(), the passwd and group returned point to storage
+ *	which is overwritten by the next call of the same function.  Until
+ *	idcache_init() is called the lookups go straight to the system.
+ *
+ * Functions included are:
+ *	idcache_init()
+ *	idcache_getpwnam()
+ *	idcache_getgrnam()
+ *	idcache_initgroups()
+ *	idcache_refresh()
+ *	idcache_log_stats()
+ */
+
+#include <pbs_config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <signal.h>
+#include <pthread.h>
+#include "pbs_idx.h"
+#include "pbs_idcache.h"
+#include "log.h"
+
+#define IDC_PASSWD	'p'
+#define IDC_GROUP	'g'
+#define IDC_GLIST	'l'
+
+#define IDC_BUFSIZE	16384	/* buffer for getpwnam_r() and getgrnam_r() */
+#define IDC_MAXGROUPS	1024	/* most supplementary groups kept for a user */
+
+typedef struct idcache_ent {
+	void *ie_data;		/* copy of the entry, NULL if not found */
+	int ie_ngroups;		/* number of gids in ie_data, IDC_GLIST only */
+	time_t ie_expire;	/* when the entry has to be looked up again */
+	int ie_used;		/* looked up since the last refresher pass */
+	char ie_key[1];		/* type followed by name, allocated with entry */
+} idcache_ent;
+
+static struct {
+	long hits;
+	long neg_hits;
+	long misses;
+	long refreshes;
+	long drops;
+} idc_stats;
+
+static void *idc_idx = NULL;
+static int idc_ttl = PBS_IDCACHE_TTL;
+static int idc_neg_ttl = PBS_IDCACHE_NEG_TTL;
+static pthread_mutex_t idc_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static struct passwd *idc_pwd = NULL;	/* returned by idcache_getpwnam() */
+static struct group *idc_grp = NULL;	/* returned by idcache_getgrnam() */
+
+/**
+ * @brief
+ *	copy a passwd into a single allocation, so it can be freed at once
+ *
+ * @param[in]	pwd	-	passwd to copy
+ *
+ * @return	struct passwd *
+ * @retval	copy of pwd
+ * @retval	NULL	: out of memory
+ */
+static struct passwd *
+idc_dup_passwd(struct passwd *pwd)
+{
+	struct passwd *np;
+	char *p;
+	size_t len;
+
+	len = sizeof(struct passwd) + strlen(pwd->pw_name) + strlen(pwd->pw_passwd) +
+		strlen(pwd->pw_gecos) + strlen(pwd->pw_dir) + strlen(pwd->pw_shell) + 5;
+	if ((np = malloc(len)) == NULL)
+		return NULL;
+	*np = *pwd;
+	p = (char *)(np + 1);
+	np->pw_name = strcpy(p, pwd->pw_name);
+	p += strlen(p) + 1;
+	np->pw_passwd = strcpy(p, pwd->pw_passwd);
+	p += strlen(p) + 1;
+	np->pw_gecos = strcpy(p, pwd->pw_gecos);
+	p += strlen(p) + 1;
+	np->pw_dir = strcpy(p, pwd->pw_dir);
+	p += strlen(p) + 1;
+	np->pw_shell = strcpy(p, pwd->pw_shell);
+	return np;
+}
+
+/**
+ * @brief
+ *	copy a group into a single allocation, so it can be freed at once
+ *
+ * @param[in]	grp	-	group to copy
+ *
+ * @return	struct group *
+ * @retval	copy of grp
+ * @retval	NULL	: out of memory
+ */
+static struct group *
+idc_dup_group(struct group *grp)
+{
+	struct group *ng;
+	char *p;
+	size_t len;
+	int nmem;
+	int i;
+
+	len = sizeof(struct group) + strlen(grp->gr_name) + strlen(grp->gr_passwd) + 2;
+	for (nmem = 0; grp->gr_mem[nmem] != NULL; nmem++)
+		len += strlen(grp->gr_mem[nmem]) + 1;
+	len += (nmem + 1) * sizeof(char *);
+	if ((ng = malloc(len)) == NULL)
+		return NULL;
+	*ng = *grp;
+	ng->gr_mem = (char **)(ng + 1);
+	p = (char *)(ng->gr_mem + nmem + 1);
+	for (i = 0; i < nmem; i++) {
+		ng->gr_mem[i] = strcpy(p, grp->gr_mem[i]);
+		p += strlen(p) + 1;
+	}
+	ng->gr_mem[nmem] = NULL;
+	ng->gr_name = strcpy(p, grp->gr_name);
+	p += strlen(p) + 1;
+	ng->gr_passwd = strcpy(p, grp->gr_passwd);
+	return ng;
+}
+
+/**
+ * @brief
+ *	copy the data of a cache entry
+ *
+ * @param[in]	key	-	key of the entry, its first character gives the type
+ * @param[in]	data	-	data to copy
+ * @param[in]	ngroups	-	number of gids in data, for a group list
+ *
+ * @return	void *
+ * @retval	copy of data
+ * @retval	NULL	: out of memory
+ */
+static void *
+idc_dup(const char *key, void *data, int ngroups)
+{
+	void *copy;
+
+	switch (*key) {
+		case IDC_PASSWD:
+			return idc_dup_passwd(data);
+		case IDC_GROUP:
+			return idc_dup_group(data);
+		default:
+			if ((copy = malloc((ngroups + 1) * sizeof(gid_t))) != NULL)
+				memcpy(copy, data, ngroups * sizeof(gid_t));
+			return copy;
+	}
+}
+
+/**
+ * @brief
+ *	look a name up in the system, without the cache
+ *
+ * @param[in]	key	-	type of lookup followed by the name, for a group
+ *				list the name is followed by ':' and the gid
+ * @param[out]	data	-	result, to be freed by the caller,
+ *				NULL if the name is not found
+ * @param[out]	ngroups	-	number of gids in data, for a group list
+ *
+ * @return	int
+ * @retval	0	: looked up, found or not
+ * @retval	-1	: the lookup failed, nothing should be cached
+ *
+ * @par MT-safe: Yes
+ */
+static int
+idc_lookup(const char *key, void **data, int *ngroups)
+{
+	char buf[IDC_BUFSIZE];
+	const char *name = key + 1;
+	char *p;
+	int rc;
+
+	*data = NULL;
+	*ngroups = 0;
+	switch (*key) {
+		case IDC_PASSWD: {
+			struct passwd pwd;
+			struct passwd *ppwd = NULL;
+
+			rc = getpwnam_r(name, &pwd, buf, sizeof(buf), &ppwd);
+			if (rc != 0 && rc != ENOENT && rc != ESRCH)
+				return -1;
+			if (ppwd != NULL && (*data = idc_dup_passwd(ppwd)) == NULL)
+				return -1;
+			return 0;
+		}
+		case IDC_GROUP: {
+			struct group grp;
+			struct group *pgrp = NULL;
+
+			rc = getgrnam_r(name, &grp, buf, sizeof(buf), &pgrp);
+			if (rc != 0 && rc != ENOENT && rc != ESRCH)
+				return -1;
+			if (pgrp != NULL && (*data = idc_dup_group(pgrp)) == NULL)
+				return -1;
+			return 0;
+		}
+		case IDC_GLIST: {
+			gid_t *groups;
+			int ng = IDC_MAXGROUPS;
+
+			snprintf(buf, sizeof(buf), "%s", name);
+			if ((p = strrchr(buf, ':')) == NULL)
+				return -1;
+			*p++ = '\0';
+			if ((groups = malloc(IDC_MAXGROUPS * sizeof(gid_t))) == NULL)
+				return -1;
+			if (getgrouplist(buf, (gid_t) strtoul(p, NULL, 10), groups, &ng) < 0) {
+				free(groups);
+				return -1;
+			}
+			*data = groups;
+			*ngroups = ng;
+			return 0;
+		}
+	}
+	return -1;
+}
+
+/**
+ * @brief
+ *	store the result of a lookup in the cache, adding the entry if needed
+ *
+ * @param[in]	key	-	key of the entry
+ * @param[in]	data	-	result of the lookup, NULL if the name was not
+ *				found; a copy is stored
+ * @param[in]	ngroups	-	number of gids in data, for a group list
+ * @param[in]	used	-	whether the entry is being looked up now
+ *
+ * @return	void
+ *
+ * @par MT-safe: No, the caller holds idc_mutex
+ */
+static void
+idc_store(const char *key, void *data, int ngroups, int used)
+{
+	idcache_ent *ent = NULL;
+	void *pkey = (void *) key;
+	void *copy = NULL;
+
+	if (data != NULL && (copy = idc_dup(key, data, ngroups)) == NULL)
+		return;
+
+	if (pbs_idx_find(idc_idx, &pkey, (void **) &ent, NULL) != PBS_IDX_RET_OK) {
+		if ((ent = malloc(sizeof(idcache_ent) + strlen(key))) == NULL) {
+			free(copy);
+			return;
+		}
+		strcpy(ent->ie_key, key);
+		ent->ie_data = NULL;
+		ent->ie_used = 0;
+		if (pbs_idx_insert(idc_idx, ent->ie_key, ent) != PBS_IDX_RET_OK) {
+			free(ent);
+			free(copy);
+			return;
+		}
+	}
+	free(ent->ie_data);
+	ent->ie_data = copy;
+	ent->ie_ngroups = ngroups;
+	ent->ie_expire = time(NULL) + (copy != NULL ? idc_ttl : idc_neg_ttl);
+	if (used)
+		ent->ie_used = 1;
+}
+
+/**
+ * @brief
+ *	find a name in the cache, looking it up in the system if it is
+ *	not there or has expired
+ *
+ * @param[in]	key	-	type of lookup followed by the name
+ * @param[out]	data	-	result, to be freed by the caller,
+ *				NULL if the name is not found
+ * @param[out]	ngroups	-	number of gids in data, for a group list
+ *
+ * @return	int
+ * @retval	0	: success, found or not
+ * @retval	-1	: the lookup failed
+ */
+static int
+idc_get(const char *key, void **data, int *ngroups)
+{
+	idcache_ent *ent = NULL;
+	void *pkey = (void *) key;
+
+	*data = NULL;
+	*ngroups = 0;
+
+	pthread_mutex_lock(&idc_mutex);
+	if (pbs_idx_find(idc_idx, &pkey, (void **) &ent, NULL) == PBS_IDX_RET_OK &&
+	    ent->ie_expire > time(NULL)) {
+		ent->ie_used = 1;
+		if (ent->ie_data == NULL)
+			idc_stats.neg_hits++;
+		else {
+			idc_stats.hits++;
+			if ((*data = idc_dup(key, ent->ie_data, ent->ie_ngroups)) == NULL) {
+				pthread_mutex_unlock(&idc_mutex);
+				return -1;
+			}
+			*ngroups = ent->ie_ngroups;
+		}
+		pthread_mutex_unlock(&idc_mutex);
+		return 0;
+	}
+	idc_stats.misses++;
+	pthread_mutex_unlock(&idc_mutex);
+
+	/* do not hold the lock while waiting on the name service */
+	if (idc_lookup(key, data, ngroups) != 0)
+		return -1;
+
+	pthread_mutex_lock(&idc_mutex);
+	idc_store(key, *data, *ngroups, 1);
+	pthread_mutex_unlock(&idc_mutex);
+	return 0;
+}
+
+
+/**
+ * @brief
+ *	add a copy of a key to a list of keys
+ *
+ * @param[in,out]	list	-	list of keys
+ * @param[in,out]	n	-	number of keys in the list
+ * @param[in,out]	size	-	number of slots in the list
+ * @param[in]		key	-	key to add
+ *
+ * @return	int
+ * @retval	0	: success
+ * @retval	-1	: out of memory
+ */
+static int
+idc_addkey(char ***list, int *n, int *size, const char *key)
+{
+	char **tmp;
+
+	if (*n == *size) {
+		if ((tmp = realloc(*list, (*size + 64) * sizeof(char *))) == NULL)
+			return -1;
+		*list = tmp;
+		*size += 64;
+	}
+	if (((*list)[*n] = strdup(key)) == NULL)
+		return -1;
+	(*n)++;
+	return 0;
+}
+
+/**
+ * @brief
+ *	one refresher pass: look the entries in use up again before they
+ *	expire, and drop the expired entries which were not used
+ *
+ * @par
+ *	The server runs this from the refresher thread.  MoM forks job
+ *	children while a lookup may be in progress, so she runs it from
+ *	her main loop instead, see idcache_init().
+ *
+ * @return	void
+ */
+void
+idcache_refresh(void)
+{
+	static time_t next_stats = 0;
+	static char **refresh = NULL;
+	static char **drop = NULL;
+	static int rsize = 0;
+	static int dsize = 0;
+	idcache_ent *ent;
+	void *ctx;
+	void *pkey;
+	int nrefresh = 0;
+	int ndrop = 0;
+	int i;
+	void *data;
+	int ngroups;
+	time_t now;
+
+	if (idc_idx == NULL)
+		return;
+
+	now = time(NULL);
+	if (next_stats == 0)
+		next_stats = now + PBS_IDCACHE_STATS;
+
+	/* the keys belong to the entries, so collect them and act after the walk */
+	pthread_mutex_lock(&idc_mutex);
+	ctx = NULL;
+	while (pbs_idx_find(idc_idx, NULL, (void **) &ent, &ctx) == PBS_IDX_RET_OK) {
+		if (ent->ie_expire > now + PBS_IDCACHE_REFRESH)
+			continue;
+		if (ent->ie_used) {
+			if (idc_addkey(&refresh, &nrefresh, &rsize, ent->ie_key) == 0)
+				ent->ie_used = 0;
+		} else if (ent->ie_expire <= now)
+			idc_addkey(&drop, &ndrop, &dsize, ent->ie_key);
+	}
+	pbs_idx_free_ctx(ctx);
+
+	for (i = 0; i < ndrop; i++) {
+		pkey = drop[i];
+		if (pbs_idx_find(idc_idx, &pkey, (void **) &ent, NULL) == PBS_IDX_RET_OK) {
+			pbs_idx_delete(idc_idx, ent->ie_key);
+			free(ent->ie_data);
+			free(ent);
+			idc_stats.drops++;
+		}
+		free(drop[i]);
+	}
+	pthread_mutex_unlock(&idc_mutex);
+
+	for (i = 0; i < nrefresh; i++) {
+		if (idc_lookup(refresh[i], &data, &ngroups) == 0) {
+			pthread_mutex_lock(&idc_mutex);
+			idc_store(refresh[i], data, ngroups, 0);
+			idc_stats.refreshes++;
+			pthread_mutex_unlock(&idc_mutex);
+			free(data);
+		}
+		free(refresh[i]);
+	}
+
+	if (now >= next_stats) {
+		idcache_log_stats();
+		next_stats = now + PBS_IDCACHE_STATS;
+	}
+}
+
+/**
+ * @brief
+ *	refresher thread: run a refresher pass every PBS_IDCACHE_REFRESH
+ *	seconds
+ *
+ * @param[in]	arg	-	not used
+ *
+ * @return	void *
+ */
+static void *
+idc_refresher(void *arg)
+{
+	for (;;) {
+		sleep(PBS_IDCACHE_REFRESH);
+		idcache_refresh();
+	}
+	return NULL;
+}
+
+/**
+ * @brief
+ *	pthread_atfork handlers, so a child does not inherit a held lock
+ */
+static void
+idc_atfork_prepare(void)
+{
+	pthread_mutex_lock(&idc_mutex);
+}
+
+static void
+idc_atfork_release(void)
+{
+	pthread_mutex_unlock(&idc_mutex);
+}
+
+/**
+ * @brief
+ *	set up the cache and, if asked, start its refresher thread
+ *
+ * @param[in]	ttl	-	seconds a found entry is kept
+ * @param[in]	neg_ttl	-	seconds a name which was not found is remembered
+ * @param[in]	refresher -	if nonzero, start the refresher thread;
+ *				otherwise the caller runs idcache_refresh()
+ *				every PBS_IDCACHE_REFRESH seconds
+ *
+ * @return	int
+ * @retval	0	: success
+ * @retval	-1	: failure, lookups go straight to the system
+ *
+ * @par MT-safe: No, call once before starting other threads
+ */
+int
+idcache_init(int ttl, int neg_ttl, int refresher)
+{
+	pthread_t tid;
+	pthread_attr_t attr;
+	sigset_t allsigs;
+	sigset_t oldsigs;
+	int rc;
+
+	if (idc_idx != NULL)
+		return 0;
+
+	idc_ttl = ttl;
+	idc_neg_ttl = neg_ttl;
+	if ((idc_idx = pbs_idx_create(PBS_IDX_HASH, 0)) == NULL) {
+		log_err(-1, __func__, "Creating the identity cache index failed");
+		return -1;
+	}
+	if (pthread_atfork(idc_atfork_prepare, idc_atfork_release, idc_atfork_release) != 0) {
+		log_err(-1, __func__, "pthread_atfork failed");
+		pbs_idx_destroy(idc_idx);
+		idc_idx = NULL;
+		return -1;
+	}
+	if (!refresher)
+		return 0;
+
+	/* the refresher must not take the signals meant for the main thread */
+	sigfillset(&allsigs);
+	pthread_sigmask(SIG_BLOCK, &allsigs, &oldsigs);
+	pthread_attr_init(&attr);
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+	rc = pthread_create(&tid, &attr, idc_refresher, NULL);
+	pthread_attr_destroy(&attr);
+	pthread_sigmask(SIG_SETMASK, &oldsigs, NULL);
+	if (rc != 0)
+		log_err(rc, __func__, "Could not start the identity cache refresher, entries will only expire");
+
+	return 0;
+}
+
+/**
+ * @brief
+ *	cached getpwnam()
+ *
+ * @param[in]	name	-	user name
+ *
+ * @return	struct passwd *
+ * @retval	passwd of the user, valid until the next call
+ * @retval	NULL	: not found or lookup failed
+ */
+struct passwd *
+idcache_getpwnam(const char *name)
+{
+	char key[IDC_BUFSIZE];
+	void *data;
+	int ngroups;
+
+	if (idc_idx == NULL)
+		return getpwnam(name);
+	if (name == NULL)
+		return NULL;
+
+	snprintf(key, sizeof(key), "%c%s", IDC_PASSWD, name);
+	free(idc_pwd);
+	idc_pwd = NULL;
+	if (idc_get(key, &data, &ngroups) != 0)
+		return NULL;
+	idc_pwd = data;
+	return idc_pwd;
+}
+
+/**
+ * @brief
+ *	cached getgrnam()
+ *
+ * @param[in]	name	-	group name
+ *
+ * @return	struct group *
+ * @retval	group entry, valid until the next call
+ * @retval	NULL	: not found or lookup failed
+ */
+struct group *
+idcache_getgrnam(const char *name)
+{
+	char key[IDC_BUFSIZE];
+	void *data;
+	int ngroups;
+
+	if (idc_idx == NULL)
+		return getgrnam(name);
+	if (name == NULL)
+		return NULL;
+
+	snprintf(key, sizeof(key), "%c%s", IDC_GROUP, name);
+	free(idc_grp);
+	idc_grp = NULL;
+	if (idc_get(key, &data, &ngroups) != 0)
+		return NULL;
+	idc_grp = data;
+	return idc_grp;
+}
+
+/**
+ * @brief
+ *	cached initgroups(), sets the supplementary groups of the process
+ *
+ * @param[in]	user	-	user name
+ * @param[in]	gid	-	group to add to the list
+ *
+ * @return	int
+ * @retval	0	: success
+ * @retval	-1	: failure, errno is set
+ */
+int
+idcache_initgroups(const char *user, gid_t gid)
+{
+	char key[IDC_BUFSIZE];
+	void *data;
+	int ngroups;
+	int rc;
+
+	if (idc_idx == NULL)
+		return initgroups(user, gid);
+
+	snprintf(key, sizeof(key), "%c%s:%lu", IDC_GLIST, user, (unsigned long) gid);
+	if (idc_get(key, &data, &ngroups) != 0 || data == NULL)
+		return initgroups(user, gid);
+	rc = setgroups(ngroups, data);
+	free(data);
+	return rc;
+}
+
+/**
+ * @brief
+ *	log the counters of the cache
+ *
+ * @return	void
+ */
+void
+idcache_log_stats(void)
+{
+	long hits, neg_hits, misses, refreshes, drops;
+
+	if (idc_idx == NULL)
+		return;
+
+	pthread_mutex_lock(&idc_mutex);
+	hits = idc_stats.hits;
+	neg_hits = idc_stats.neg_hits;
+	misses = idc_stats.misses;
+	refreshes = idc_stats.refreshes;
+	drops = idc_stats.drops;
+	pthread_mutex_unlock(&idc_mutex);
+
+	log_eventf(PBSEVENT_DEBUG, PBS_EVENTCLASS_SERVER, LOG_DEBUG, __func__,
+		   "identity cache: hits=%ld negative hits=%ld misses=%ld refreshes=%ld dropped=%ld",
+		   hits, neg_hits, misses, refreshes, drops);
+}
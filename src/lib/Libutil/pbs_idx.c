@@ -39,16 +39,181 @@
 
 #include "pbs_idx.h"
 #include "avltree.h"
+#include <ctype.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
+
+/*
+ * An index is either an AVL tree, which keeps its keys in order and can
+ * hold duplicate keys, or an open addressing hash table (PBS_IDX_HASH),
+ * which does neither but finds a key without allocating and with a single
+ * key compare in the usual case.
+ */
+#define IDX_HASH_INITSIZE	64	/* initial number of slots, power of 2 */
+
+/* a slot in a hash index; hk_key is NULL if never used, HASH_TOMB if freed */
+typedef struct _hash_ent {
+	uint32_t hk_hash;
+	void *hk_key;
+	void *hk_data;
+} hash_ent;
+
+static char hash_tomb;
+#define HASH_TOMB ((void *) &hash_tomb)
+
+typedef struct _hash_ix {
+	hash_ent *ents;
+	size_t size;	/* number of slots */
+	size_t count;	/* slots in use */
+	size_t tombs;	/* freed slots */
+} hash_ix;
+
+typedef struct _pbs_idx {
+	int flags;
+	int keylen;
+	union {
+		AVL_IX_DESC avl;
+		hash_ix hash;
+	} u;
+} pbs_idx;
 
 /* iteration context structure, opaque to application */
 typedef struct _iter_ctx {
-	AVL_IX_DESC *idx; /* pointer to idx */
+	pbs_idx *idx; /* pointer to idx */
 	AVL_IX_REC *pkey; /* pointer to key used while iteration */
+	size_t pos; /* slot of the current entry of a hash index */
 } iter_ctx;
 
+/**
+ * @brief
+ *	hash a key of a hash index
+ *
+ * @param[in] - idx - pointer to index
+ * @param[in] - key - the key
+ *
+ * @return uint32_t
+ *
+ */
+static uint32_t
+hash_key(pbs_idx *idx, void *key)
+{
+	uint32_t h = 2166136261u;
+	unsigned char *p = key;
+	int i;
+
+	if (idx->keylen != 0) {
+		for (i = 0; i < idx->keylen; i++) {
+			h ^= p[i];
+			h *= 16777619u;
+		}
+	} else if (idx->flags & PBS_IDX_ICASE_CMP) {
+		for (; *p; p++) {
+			h ^= (uint32_t) tolower(*p);
+			h *= 16777619u;
+		}
+	} else {
+		for (; *p; p++) {
+			h ^= *p;
+			h *= 16777619u;
+		}
+	}
+	h ^= h >> 16;
+	h *= 0x85ebca6bu;
+	h ^= h >> 13;
+	return h;
+}
+
+/**
+ * @brief
+ *	compare two keys of a hash index
+ *
+ * @return int
+ * @retval 0  - keys are equal
+ * @retval !0 - keys differ
+ *
+ */
+static int
+hash_keycmp(pbs_idx *idx, void *k1, void *k2)
+{
+	if (idx->keylen != 0)
+		return memcmp(k1, k2, idx->keylen);
+	if (idx->flags & PBS_IDX_ICASE_CMP)
+		return strcasecmp(k1, k2);
+	return strcmp(k1, k2);
+}
+
+/**
+ * @brief
+ *	find the slot holding a key in a hash index
+ *
+ * @param[in] - idx - pointer to index
+ * @param[in] - key - the key
+ * @param[in] - h   - hash of the key
+ *
+ * @return long
+ * @retval >=0 - slot of the key
+ * @retval -1  - key not in index
+ *
+ */
+static long
+hash_lookup(pbs_idx *idx, void *key, uint32_t h)
+{
+	hash_ix *hx = &idx->u.hash;
+	size_t mask = hx->size - 1;
+	size_t i;
+
+	for (i = h & mask; hx->ents[i].hk_key != NULL; i = (i + 1) & mask) {
+		if (hx->ents[i].hk_key != HASH_TOMB && hx->ents[i].hk_hash == h &&
+			hash_keycmp(idx, hx->ents[i].hk_key, key) == 0)
+			return (long) i;
+	}
+	return -1;
+}
+
+/**
+ * @brief
+ *	resize a hash index so that at most half of its slots are in use,
+ *	dropping the freed slots
+ *
+ * @param[in] - idx - pointer to index
+ *
+ * @return int
+ * @retval PBS_IDX_RET_OK   - success
+ * @retval PBS_IDX_RET_FAIL - failure
+ *
+ */
+static int
+hash_resize(pbs_idx *idx)
+{
+	hash_ix *hx = &idx->u.hash;
+	hash_ent *ents;
+	size_t size = IDX_HASH_INITSIZE;
+	size_t mask;
+	size_t i;
+	size_t j;
+
+	while (size < (hx->count + 1) * 2)
+		size *= 2;
+	if ((ents = calloc(size, sizeof(hash_ent))) == NULL)
+		return PBS_IDX_RET_FAIL;
+	mask = size - 1;
+	for (i = 0; i < hx->size; i++) {
+		if (hx->ents[i].hk_key == NULL || hx->ents[i].hk_key == HASH_TOMB)
+			continue;
+		for (j = hx->ents[i].hk_hash & mask; ents[j].hk_key != NULL; j = (j + 1) & mask)
+			;
+		ents[j] = hx->ents[i];
+	}
+	free(hx->ents);
+	hx->ents = ents;
+	hx->size = size;
+	hx->tombs = 0;
+	return PBS_IDX_RET_OK;
+}
+
 /**
  * @brief
  *	Create an empty index
@@ -64,13 +229,26 @@ typedef struct _iter_ctx {
 void *
 pbs_idx_create(int flags, int keylen)
 {
-	void *idx = NULL;
+	pbs_idx *idx = NULL;
+
+	/* a hash index cannot hold duplicate keys */
+	if ((flags & PBS_IDX_HASH) && (flags & PBS_IDX_DUPS_OK))
+		return NULL;
 
-	idx = malloc(sizeof(AVL_IX_DESC));
+	idx = calloc(1, sizeof(pbs_idx));
 	if (idx == NULL)
 		return NULL;
+	idx->flags = flags;
+	idx->keylen = keylen;
 
-	if (avl_create_index(idx, flags, keylen)) {
+	if (flags & PBS_IDX_HASH) {
+		idx->u.hash.size = IDX_HASH_INITSIZE;
+		idx->u.hash.ents = calloc(IDX_HASH_INITSIZE, sizeof(hash_ent));
+		if (idx->u.hash.ents == NULL) {
+			free(idx);
+			return NULL;
+		}
+	} else if (avl_create_index(&idx->u.avl, flags, keylen)) {
 		free(idx);
 		return NULL;
 	}
@@ -90,9 +268,19 @@ pbs_idx_create(int flags, int keylen)
 void
 pbs_idx_destroy(void *idx)
 {
-	if (idx != NULL) {
-		avl_destroy_index(idx);
-		free(idx);
+	pbs_idx *pidx = idx;
+	size_t i;
+
+	if (pidx != NULL) {
+		if (pidx->flags & PBS_IDX_HASH) {
+			for (i = 0; i < pidx->u.hash.size; i++) {
+				if (pidx->u.hash.ents[i].hk_key != HASH_TOMB)
+					free(pidx->u.hash.ents[i].hk_key);
+			}
+			free(pidx->u.hash.ents);
+		} else
+			avl_destroy_index(&pidx->u.avl);
+		free(pidx);
 		idx = NULL;
 	}
 }
@@ -113,17 +301,52 @@ pbs_idx_destroy(void *idx)
 int
 pbs_idx_insert(void *idx, void *key, void *data)
 {
+	pbs_idx *pidx = idx;
 	AVL_IX_REC *pkey;
 
 	if (idx == NULL || key == NULL)
 		return PBS_IDX_RET_FAIL;
 
-	pkey = avlkey_create(idx, key);
+	if (pidx->flags & PBS_IDX_HASH) {
+		hash_ix *hx = &pidx->u.hash;
+		uint32_t h = hash_key(pidx, key);
+		size_t mask;
+		size_t i;
+		void *kcopy;
+
+		if (hash_lookup(pidx, key, h) != -1)
+			return PBS_IDX_RET_FAIL;
+		/* keep at least a quarter of the slots never used */
+		if ((hx->count + hx->tombs + 1) * 4 > hx->size * 3) {
+			if (hash_resize(pidx) != PBS_IDX_RET_OK)
+				return PBS_IDX_RET_FAIL;
+		}
+		if (pidx->keylen != 0) {
+			if ((kcopy = malloc(pidx->keylen)) != NULL)
+				memcpy(kcopy, key, pidx->keylen);
+		} else
+			kcopy = strdup(key);
+		if (kcopy == NULL)
+			return PBS_IDX_RET_FAIL;
+
+		mask = hx->size - 1;
+		for (i = h & mask; hx->ents[i].hk_key != NULL && hx->ents[i].hk_key != HASH_TOMB; i = (i + 1) & mask)
+			;
+		if (hx->ents[i].hk_key == HASH_TOMB)
+			hx->tombs--;
+		hx->ents[i].hk_hash = h;
+		hx->ents[i].hk_key = kcopy;
+		hx->ents[i].hk_data = data;
+		hx->count++;
+		return PBS_IDX_RET_OK;
+	}
+
+	pkey = avlkey_create(&pidx->u.avl, key);
 	if (pkey == NULL)
 		return PBS_IDX_RET_FAIL;
 
 	pkey->recptr = data;
-	if (avl_add_key(pkey, idx) != AVL_IX_OK) {
+	if (avl_add_key(pkey, &pidx->u.avl) != AVL_IX_OK) {
 		free(pkey);
 		return PBS_IDX_RET_FAIL;
 	}
@@ -131,6 +354,28 @@ pbs_idx_insert(void *idx, void *key, void *data)
 	return PBS_IDX_RET_OK;
 }
 
+/**
+ * @brief
+ *	free the slot of a hash index
+ *
+ * @param[in] - pidx - pointer to index
+ * @param[in] - pos  - the slot
+ *
+ * @return void
+ *
+ */
+static void
+hash_delete_pos(pbs_idx *pidx, size_t pos)
+{
+	hash_ix *hx = &pidx->u.hash;
+
+	free(hx->ents[pos].hk_key);
+	hx->ents[pos].hk_key = HASH_TOMB;
+	hx->ents[pos].hk_data = NULL;
+	hx->count--;
+	hx->tombs++;
+}
+
 /**
  * @brief
  *	delete entry from index
@@ -146,17 +391,26 @@ pbs_idx_insert(void *idx, void *key, void *data)
 int
 pbs_idx_delete(void *idx, void *key)
 {
+	pbs_idx *pidx = idx;
 	AVL_IX_REC *pkey;
 
 	if (idx == NULL || key == NULL)
 		return PBS_IDX_RET_FAIL;
 
-	pkey = avlkey_create(idx, key);
+	if (pidx->flags & PBS_IDX_HASH) {
+		long pos = hash_lookup(pidx, key, hash_key(pidx, key));
+
+		if (pos != -1)
+			hash_delete_pos(pidx, (size_t) pos);
+		return PBS_IDX_RET_OK;
+	}
+
+	pkey = avlkey_create(&pidx->u.avl, key);
 	if (pkey == NULL)
 		return PBS_IDX_RET_FAIL;
 
 	pkey->recptr = NULL;
-	avl_delete_key(pkey, idx);
+	avl_delete_key(pkey, &pidx->u.avl);
 	free(pkey);
 	return PBS_IDX_RET_OK;
 }
@@ -178,10 +432,92 @@ pbs_idx_delete_byctx(void *ctx)
 {
 	iter_ctx *pctx = (iter_ctx *) ctx;
 
-	if (pctx == NULL || pctx->idx == NULL || pctx->pkey == NULL)
+	if (pctx == NULL || pctx->idx == NULL)
 		return PBS_IDX_RET_FAIL;
 
-	avl_delete_key(pctx->pkey, pctx->idx);
+	if (pctx->idx->flags & PBS_IDX_HASH) {
+		hash_ix *hx = &pctx->idx->u.hash;
+
+		if (pctx->pos >= hx->size || hx->ents[pctx->pos].hk_key == NULL ||
+			hx->ents[pctx->pos].hk_key == HASH_TOMB)
+			return PBS_IDX_RET_FAIL;
+		hash_delete_pos(pctx->idx, pctx->pos);
+		return PBS_IDX_RET_OK;
+	}
+
+	if (pctx->pkey == NULL)
+		return PBS_IDX_RET_FAIL;
+
+	avl_delete_key(pctx->pkey, &pctx->idx->u.avl);
+	return PBS_IDX_RET_OK;
+}
+
+/**
+ * @brief
+ *	find or iterate entry in a hash index, see pbs_idx_find()
+ *
+ */
+static int
+hash_find(pbs_idx *pidx, void **key, void **data, void **ctx)
+{
+	hash_ix *hx = &pidx->u.hash;
+	iter_ctx *pctx = NULL;
+	size_t pos;
+	long found;
+
+	*data = NULL;
+	if (ctx != NULL && *ctx != NULL) {
+		pctx = (iter_ctx *) *ctx;
+		if (key)
+			*key = NULL;
+		if (pctx->idx != pidx)
+			return PBS_IDX_RET_FAIL;
+		/* there is no next entry after a lookup by key */
+		if (pctx->pkey != NULL)
+			return PBS_IDX_RET_FAIL;
+		pos = pctx->pos + 1;
+	} else if (key != NULL && *key != NULL) {
+		if ((found = hash_lookup(pidx, *key, hash_key(pidx, *key))) == -1)
+			return PBS_IDX_RET_FAIL;
+		*data = hx->ents[found].hk_data;
+		if (ctx != NULL) {
+			if ((pctx = malloc(sizeof(iter_ctx))) == NULL)
+				return PBS_IDX_RET_FAIL;
+			pctx->idx = pidx;
+			pctx->pkey = (AVL_IX_REC *) HASH_TOMB;	/* marks lookup by key */
+			pctx->pos = (size_t) found;
+			*ctx = pctx;
+		}
+		return PBS_IDX_RET_OK;
+	} else
+		pos = 0;
+
+	/* iterate, in no particular order */
+	for (; pos < hx->size; pos++) {
+		if (hx->ents[pos].hk_key != NULL && hx->ents[pos].hk_key != HASH_TOMB)
+			break;
+	}
+	if (pos >= hx->size) {
+		if (pctx)
+			pctx->pos = hx->size;
+		return PBS_IDX_RET_FAIL;
+	}
+
+	*data = hx->ents[pos].hk_data;
+	if (key)
+		*key = hx->ents[pos].hk_key;
+	if (pctx != NULL)
+		pctx->pos = pos;
+	else if (ctx != NULL) {
+		if ((pctx = malloc(sizeof(iter_ctx))) == NULL) {
+			*data = NULL;
+			return PBS_IDX_RET_FAIL;
+		}
+		pctx->idx = pidx;
+		pctx->pkey = NULL;
+		pctx->pos = pos;
+		*ctx = pctx;
+	}
 	return PBS_IDX_RET_OK;
 }
 
@@ -207,10 +543,16 @@ pbs_idx_delete_byctx(void *ctx)
  * @note
  * 	ctx should be free'd after use, using pbs_idx_free_ctx()
  *
+ * @note
+ *	A hash index is iterated in no particular order, there is no next
+ *	entry after a lookup by key, and entries must not be added to it
+ *	while it is being iterated.
+ *
  */
 int
 pbs_idx_find(void *idx, void **key, void **data, void **ctx)
 {
+	pbs_idx *pidx = idx;
 	iter_ctx *pctx;
 	AVL_IX_REC *pkey;
 	int rc = AVL_IX_FAIL;
@@ -218,6 +560,9 @@ pbs_idx_find(void *idx, void **key, void **data, void **ctx)
 	if (idx == NULL || data == NULL)
 		return PBS_IDX_RET_FAIL;
 
+	if (pidx->flags & PBS_IDX_HASH)
+		return hash_find(pidx, key, data, ctx);
+
 	if (ctx != NULL && *ctx != NULL) {
 		pctx = (iter_ctx *) *ctx;
 
@@ -228,7 +573,7 @@ pbs_idx_find(void *idx, void **key, void **data, void **ctx)
 		if (pctx->idx != idx || pctx->pkey == NULL)
 			return PBS_IDX_RET_FAIL;
 
-		if (avl_next_key(pctx->pkey, pctx->idx) != AVL_IX_OK)
+		if (avl_next_key(pctx->pkey, &pctx->idx->u.avl) != AVL_IX_OK)
 			return PBS_IDX_RET_FAIL;
 
 		*data = pctx->pkey->recptr;
@@ -238,15 +583,15 @@ pbs_idx_find(void *idx, void **key, void **data, void **ctx)
 		return PBS_IDX_RET_OK;
 	} else {
 		*data = NULL;
-		pkey = avlkey_create(idx, key ? *key : NULL);
+		pkey = avlkey_create(&pidx->u.avl, key ? *key : NULL);
 		if (pkey == NULL)
 			return PBS_IDX_RET_FAIL;
 
 		if (key != NULL && *key != NULL) {
-			rc = avl_find_key(pkey, idx);
+			rc = avl_find_key(pkey, &pidx->u.avl);
 		} else {
-			avl_first_key(idx);
-			rc = avl_next_key(pkey, idx);
+			avl_first_key(&pidx->u.avl);
+			rc = avl_next_key(pkey, &pidx->u.avl);
 		}
 
 		if (rc == AVL_IX_OK) {
@@ -259,8 +604,9 @@ pbs_idx_find(void *idx, void **key, void **data, void **ctx)
 					free(pkey);
 					return PBS_IDX_RET_FAIL;
 				}
-				pctx->idx = idx;
+				pctx->idx = pidx;
 				pctx->pkey = pkey;
+				pctx->pos = 0;
 				*ctx = (void *) pctx;
 
 				return PBS_IDX_RET_OK;
@@ -286,7 +632,8 @@ pbs_idx_free_ctx(void *ctx)
 {
 	if (ctx != NULL) {
 		iter_ctx *pctx = (iter_ctx *) ctx;
-		free(pctx->pkey);
+		if (!(pctx->idx->flags & PBS_IDX_HASH))
+			free(pctx->pkey);
 		free(ctx);
 		ctx = NULL;
 	}
@@ -0,0 +1,322 @@
+/*
+ * Copyright (C) 1994-2020 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+/**
+ * @file	pbs_phash.c
+ *
+ * @brief
+ *	Minimal perfect hash tables for fixed sets of names.
+ *
+ * @par
+ *	The tables use hash and displace: every name is first hashed to a
+ *	bucket, and each bucket records either the slot of its only name or
+ *	the seed of a second hash which sends all of its names to free slots.
+ *	A lookup is therefore two hashes and one string compare, whatever the
+ *	number of names.  There are as many slots as distinct names.
+ *
+ * Functions included are:
+ *	pbs_phash_create()
+ *	pbs_phash_destroy()
+ *	pbs_phash_find()
+ */
+
+#include <pbs_config.h>
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "pbs_phash.h"
+
+/* give up on a set of names if no seed this large places a bucket */
+#define PHASH_MAX_SEED	(1 << 24)
+
+struct pbs_phash {
+	int	 ph_size;	/* number of slots, i.e. distinct names */
+	int	*ph_disp;	/* per bucket: seed, or -(slot + 1) */
+	int	*ph_pos;	/* per slot: position of the name in the list */
+	char	**ph_name;	/* per slot: the name */
+};
+
+/* a bucket while the table is built */
+struct phash_bkt {
+	int	 pb_bucket;
+	int	 pb_count;
+	int	*pb_pos;
+};
+
+/**
+ * @brief
+ *	Case insensitive hash of a name
+ *
+ * @param[in] - seed - selects one of a family of hash functions
+ * @param[in] - name - the name
+ * @param[in] - len  - length of name
+ *
+ * @return uint32_t
+ *
+ */
+static uint32_t
+phash_hash(uint32_t seed, const char *name, size_t len)
+{
+	uint32_t h = 2166136261u ^ seed;
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		h ^= (uint32_t)tolower((unsigned char)name[i]);
+		h *= 16777619u;
+	}
+	/* mix the bits so that nearby seeds give unrelated hashes */
+	h ^= h >> 16;
+	h *= 0x85ebca6bu;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35u;
+	h ^= h >> 16;
+	return h;
+}
+
+/**
+ * @brief
+ *	qsort comparator, largest bucket first
+ */
+static int
+phash_bkt_cmp(const void *a, const void *b)
+{
+	return ((const struct phash_bkt *)b)->pb_count -
+		((const struct phash_bkt *)a)->pb_count;
+}
+
+/**
+ * @brief
+ *	Build a perfect hash table over a list of names
+ *
+ * @param[in] - names - the names; they must stay valid for the life of the table
+ * @param[in] - n     - number of names
+ *
+ * @return pbs_phash *
+ * @retval !NULL - success
+ * @retval NULL  - failure
+ *
+ * @note
+ *	When a name appears more than once, its first position is the one found.
+ *
+ */
+pbs_phash *
+pbs_phash_create(char **names, int n)
+{
+	pbs_phash *ph = NULL;
+	struct phash_bkt *bkts = NULL;
+	int *bucket_of = NULL;
+	int *pos = NULL;
+	int *slots = NULL;
+	char *used = NULL;
+	int m;
+	int i;
+	int j;
+	int k;
+	int b;
+	int next;
+	uint32_t d;
+
+	if (names == NULL || n < 0)
+		return NULL;
+
+	/* n buckets at first; the table is sized once duplicates are known */
+	bkts = calloc(n + 1, sizeof(struct phash_bkt));
+	bucket_of = malloc((n + 1) * sizeof(int));
+	pos = malloc((n + 1) * sizeof(int));
+	if (bkts == NULL || bucket_of == NULL || pos == NULL)
+		goto err;
+
+	/* drop duplicates, which always share a bucket, and missing names */
+	for (i = 0; i < n; i++)
+		bucket_of[i] = names[i] ? phash_hash(0, names[i], strlen(names[i])) % n : -1;
+	m = 0;
+	for (i = 0; i < n; i++) {
+		if (bucket_of[i] < 0)
+			continue;
+		for (j = 0; j < i; j++) {
+			if (bucket_of[j] == bucket_of[i] && bucket_of[j] >= 0 &&
+				strcasecmp(names[j], names[i]) == 0)
+				break;
+		}
+		if (j < i)
+			bucket_of[i] = -1;
+		else
+			pos[m++] = i;
+	}
+
+	ph = malloc(sizeof(pbs_phash) + m * (2 * sizeof(int) + sizeof(char *)) + 1);
+	if (ph == NULL)
+		goto err;
+	ph->ph_size = m;
+	ph->ph_name = (char **)(ph + 1);
+	ph->ph_disp = (int *)(ph->ph_name + m);
+	ph->ph_pos = ph->ph_disp + m;
+	if (m == 0)
+		goto done;
+
+	slots = malloc(m * sizeof(int));
+	used = calloc(m, 1);
+	if (slots == NULL || used == NULL)
+		goto err;
+
+	/* group the distinct names into m buckets */
+	for (b = 0; b < m; b++) {
+		bkts[b].pb_bucket = b;
+		bkts[b].pb_count = 0;
+		ph->ph_disp[b] = 0;
+	}
+	for (i = 0; i < m; i++) {
+		bucket_of[i] = phash_hash(0, names[pos[i]], strlen(names[pos[i]])) % m;
+		bkts[bucket_of[i]].pb_count++;
+	}
+	for (b = 0, k = 0; b < m; b++) {
+		bkts[b].pb_pos = slots + k;	/* slots is scratch space here */
+		k += bkts[b].pb_count;
+		bkts[b].pb_count = 0;
+	}
+	for (i = 0; i < m; i++) {
+		b = bucket_of[i];
+		bkts[b].pb_pos[bkts[b].pb_count++] = pos[i];
+	}
+	qsort(bkts, m, sizeof(struct phash_bkt), phash_bkt_cmp);
+
+	/* place the buckets holding several names by searching for a seed */
+	for (b = 0; b < m && bkts[b].pb_count > 1; b++) {
+		for (d = 1; d < PHASH_MAX_SEED; d++) {
+			for (j = 0; j < bkts[b].pb_count; j++) {
+				char *nm = names[bkts[b].pb_pos[j]];
+
+				bucket_of[j] = phash_hash(d, nm, strlen(nm)) % m;
+				if (used[bucket_of[j]])
+					break;
+				for (k = 0; k < j; k++)
+					if (bucket_of[k] == bucket_of[j])
+						break;
+				if (k < j)
+					break;
+			}
+			if (j == bkts[b].pb_count)
+				break;
+		}
+		if (d == PHASH_MAX_SEED)
+			goto err;
+		ph->ph_disp[bkts[b].pb_bucket] = (int)d;
+		for (j = 0; j < bkts[b].pb_count; j++) {
+			used[bucket_of[j]] = 1;
+			ph->ph_pos[bucket_of[j]] = bkts[b].pb_pos[j];
+		}
+	}
+
+	/* the buckets holding one name take the free slots in turn */
+	for (next = 0; b < m && bkts[b].pb_count == 1; b++) {
+		while (used[next])
+			next++;
+		used[next] = 1;
+		ph->ph_disp[bkts[b].pb_bucket] = -(next + 1);
+		ph->ph_pos[next] = bkts[b].pb_pos[0];
+	}
+
+	for (i = 0; i < m; i++)
+		ph->ph_name[i] = names[ph->ph_pos[i]];
+
+done:
+	free(bkts);
+	free(bucket_of);
+	free(pos);
+	free(slots);
+	free(used);
+	return ph;
+
+err:
+	free(ph);
+	ph = NULL;
+	goto done;
+}
+
+/**
+ * @brief
+ *	Free a table made by pbs_phash_create()
+ *
+ * @param[in] - ph - the table
+ *
+ * @return void
+ *
+ */
+void
+pbs_phash_destroy(pbs_phash *ph)
+{
+	free(ph);
+}
+
+/**
+ * @brief
+ *	Find a name in the table
+ *
+ * @param[in] - ph   - the table
+ * @param[in] - name - name to find, need not be null terminated
+ * @param[in] - len  - length of name
+ *
+ * @return int
+ * @retval >=0 - position of the name in the list given to pbs_phash_create()
+ * @retval -1  - not found
+ *
+ */
+int
+pbs_phash_find(pbs_phash *ph, const char *name, size_t len)
+{
+	int d;
+	int s;
+
+	if (ph == NULL || ph->ph_size == 0 || name == NULL)
+		return -1;
+
+	d = ph->ph_disp[phash_hash(0, name, len) % ph->ph_size];
+	if (d < 0)
+		s = -d - 1;
+	else
+		s = phash_hash((uint32_t)d, name, len) % ph->ph_size;
+
+	if (strncasecmp(ph->ph_name[s], name, len) != 0 || ph->ph_name[s][len] != '\0')
+		return -1;
+	return ph->ph_pos[s];
+}
@@ -102,6 +102,7 @@ extern pbs_list_head	svr_alljobs;
 extern int		exiting_tasks;
 extern char		*msg_daemonname;
 extern int		svr_hook_resend_job_attrs;
+extern int		resc_used_delta;
 #ifdef	WIN32
 extern char		*mom_home;
 #endif
@@ -1046,6 +1047,150 @@ update_ajob_status(job *pjob)
 	update_ajob_status_using_cmd(pjob, IS_RESCUSED, 0);
 }
 
+/*
+ * With $resc_used_delta, a value that changed by less than the threshold
+ * is still sent once it has been held back this long.
+ */
+#define RESC_USED_DELTA_MAXAGE	600
+
+/**
+ * @brief
+ *	Convert an encoded resources_used value to a number so that two
+ *	updates can be compared.
+ *
+ * @param[in]	val - value string, e.g. "00:10:05", "2048kb" or "3"
+ * @param[out]	num - time in seconds, size in kb, or the number itself
+ *
+ * @return int
+ * @retval 0	val holds a number
+ * @retval -1	val is not a number
+ *
+ */
+static int
+resc_used_number(char *val, double *num)
+{
+	char	*end;
+	long	h, m, s;
+	int	shift = 0;
+
+	if (val == NULL)
+		return -1;
+	if (sscanf(val, "%ld:%ld:%ld", &h, &m, &s) == 3) {
+		*num = (double)(h * 3600 + m * 60 + s);
+		return 0;
+	}
+	*num = strtod(val, &end);
+	if (end == val)
+		return -1;
+	switch (tolower(*end)) {
+		case 'p': shift++; /* fall through */
+		case 't': shift++; /* fall through */
+		case 'g': shift++; /* fall through */
+		case 'm': shift++; /* fall through */
+		case 'k':
+			end++;
+			break;
+		default:
+			/* bytes or words, scaled the same below */
+			shift--;
+	}
+	if ((tolower(*end) == 'b') || (tolower(*end) == 'w'))
+		end++;
+	if (*end != '\0')
+		return -1;
+	for (; shift > 0; shift--)
+		*num *= 1024;
+	if (shift < 0)
+		*num /= 1024;
+	return 0;
+}
+
+/**
+ * @brief
+ *	Remove from an update of a job the resources_used values which the
+ *	server already has, or which moved by less than $resc_used_delta
+ *	percent of what was last sent, and remember the values left in.
+ *
+ * @param[in]	  pjob - job the update is for
+ * @param[in,out] phead - svrattrl list of the update
+ *
+ * @return Void
+ *
+ */
+static void
+resc_used_delta_filter(job *pjob, pbs_list_head *phead)
+{
+	svrattrl	*pal;
+	svrattrl	*next;
+	svrattrl	*old;
+	double		 nval;
+	double		 oval;
+	double		 diff;
+	int		 all;
+
+	/* now and then send every change, however small */
+	all = ((time_now - pjob->ji_rused_sent_time) >= RESC_USED_DELTA_MAXAGE);
+
+	for (pal = (svrattrl *)GET_NEXT(*phead); pal != NULL; pal = next) {
+		next = (svrattrl *)GET_NEXT(pal->al_link);
+		if ((strcmp(pal->al_name, ATTR_used) != 0) &&
+			(strcmp(pal->al_name, ATTR_session) != 0))
+			continue;
+
+		old = find_svrattrl_list_entry(&pjob->ji_rused_sent,
+			pal->al_name, pal->al_resc);
+		if (old != NULL) {
+			if (strcmp(old->al_value, pal->al_value) == 0) {
+				delete_link(&pal->al_link);
+				free(pal);
+				continue;
+			}
+			if (!all && (resc_used_delta > 0) &&
+				(resc_used_number(old->al_value, &oval) == 0) &&
+				(resc_used_number(pal->al_value, &nval) == 0)) {
+				diff = (nval > oval) ? (nval - oval) : (oval - nval);
+				if ((diff * 100) < (oval * resc_used_delta)) {
+					delete_link(&pal->al_link);
+					free(pal);
+					continue;
+				}
+			}
+			delete_link(&old->al_link);
+			free(old);
+		}
+
+		old = attrlist_create(pal->al_name, pal->al_resc,
+			strlen(pal->al_value));
+		if (old == NULL)
+			continue;
+		strcpy(old->al_value, pal->al_value);
+		append_link(&pjob->ji_rused_sent, &old->al_link, old);
+	}
+	if (all)
+		pjob->ji_rused_sent_time = time_now;
+}
+
+/**
+ * @brief
+ *	Forget what usage was last sent to the server for each job, so the
+ *	next update carries everything again.  Called when the server
+ *	(re)connects, as it may have lost updates that were never saved.
+ *
+ * @return Void
+ *
+ */
+void
+reset_resc_used_sent(void)
+{
+	job	*pjob;
+
+	for (pjob = (job *)GET_NEXT(svr_alljobs);
+		pjob; pjob = (job *)GET_NEXT(pjob->ji_alljobs)) {
+		free_attrlist(&pjob->ji_rused_sent);
+		pjob->ji_rused_sent_time = 0;
+	}
+}
+
 /**
  * @brief
  * 	update_jobs_status - return the status of jobs to the server
@@ -1081,7 +1226,6 @@ update_jobs_status(void)
 		if (pjob->ji_qs.ji_substate != JOB_SUBSTATE_RUNNING)
 			continue;
 
-		++count;
 		/* allocate reply structure and fill in header portion */
 		prused = (struct resc_used_update *)
 			malloc(sizeof(struct resc_used_update));
@@ -1095,9 +1239,7 @@ update_jobs_status(void)
 			prused->ru_hop    = pjob->ji_wattr[(int)JOB_ATR_runcount].at_val.at_long;
 		}
 		CLEAR_HEAD(prused->ru_attr);
-		*prusednext	  = prused;	/* make last on list */
 		prused->ru_next   = NULL;	/* terminate list */
-		prusednext	  = &prused->ru_next;	/* track last link */
 
 		/* now append the session id and resources used */
 		(void)job_attr_def[(int)JOB_ATR_session_id].at_encode(
@@ -1131,6 +1273,19 @@ update_jobs_status(void)
 			}
 
 		}
+
+		if (resc_used_delta >= 0) {
+			resc_used_delta_filter(pjob, &prused->ru_attr);
+			if (GET_NEXT(prused->ru_attr) == NULL) {
+				/* nothing the server needs to hear about */
+				(void)free(prused);
+				continue;
+			}
+		}
+
+		++count;
+		*prusednext	  = prused;	/* make last on list */
+		prusednext	  = &prused->ru_next;	/* track last link */
 	}
 
 	/* now send info to server via tpp */
@@ -87,8 +87,10 @@
 #include "pbs_ifl.h"
 #include "placementsets.h"
 #include "mom_vnode.h"
+#include "pbs_idcache.h"
 #ifndef NAS /* localmod 113 */
 #include "hwloc.h"
+#include "pbs_idx.h"
 #endif /* localmod 113 */
 
 /**
@@ -142,6 +144,40 @@ proc_stat_t	*proc_info = NULL;
 int		nproc = 0;
 int		max_proc = 0;
 
+/*
+ * After each sample the entries of proc_info[] are chained by session
+ * so the per-job sums only look at the processes of the job's tasks.
+ */
+typedef struct sess_link {
+	int	sl_next;	/* next entry in the same session, -1 at end */
+	int	sl_last;	/* last entry in the chain, kept at the head */
+} sess_link;
+static sess_link	*sess_links = NULL;	/* parallel to proc_info[] */
+static void		*sess_idx = NULL;	/* session id -> chain head + 1 */
+
+/*
+ * State for $proc_tracking job: which processes to read on the next
+ * sample, and when /proc was last read in full.
+ */
+#define	PROC_RESCAN_TIME	300	/* seconds between full /proc scans */
+static time_t	last_full_scan = 0;
+static int	children_ok = 0;	/* /proc/<pid>/task/<tid>/children works */
+static pid_t	*track_pids = NULL;	/* job processes seen last sample */
+static int	ntrack_pids = 0;
+static int	max_track_pids = 0;
+
+/*
+ * Mount points of the cgroup hierarchies the job cgroups live in.
+ */
+enum cg_hier {
+	CG_UNIFIED,	/* cgroup v2 */
+	CG_CPUACCT,	/* v1 cpuacct controller */
+	CG_MEMORY,	/* v1 memory controller */
+	CG_NUM
+};
+static char	cg_mount[CG_NUM][MAXPATHLEN + 1];
+static int	cg_mounts_read = 0;
+
 extern	char	*ret_string;
 extern	char	extra_parm[];
 extern	char	no_parm[];
@@ -3484,7 +3520,7 @@ add_restrict_user_exceptions(char *user)
 	if ((user == NULL) || (user[0] == '\0'))
 		return;
 
-	pwent = getpwnam(user);
+	pwent = idcache_getpwnam(user);
 	if (pwent == NULL) {
 		sprintf(log_buffer, "User %s not found", user);
 		log_event(PBSEVENT_SYSTEM, 0, LOG_DEBUG, __func__, log_buffer);
@@ -4094,30 +4130,97 @@ end_proc(void)
 
 /**
  * @brief
- *	 Scan a list of tasks and return true if one of them matches sid
+ *	Return the first entry of proc_info[] in a session.
  *
- * @param[in] pjob - job pointer
  * @param[in] sid - session id
  *
- * @return	Bool
- * @retval	TRUE
- * @retval	FALSE	Error
+ * @return	int
+ * @retval	index into proc_info[]
+ * @retval	-1	no process in the session
  *
  */
 static int
-injob(job *pjob, pid_t sid)
+sess_first(pid_t sid)
 {
-	task	*ptask;
+	void	*key = &sid;
+	void	*data = NULL;
+	int	i;
 
-	for (ptask = (task *)GET_NEXT(pjob->ji_tasks);
-		ptask;
-		ptask = (task *)GET_NEXT(ptask->ti_jobtask)) {
+	if (sess_idx == NULL) {
+		/* no index for this sample, search the table */
+		for (i = 0; i < nproc; i++) {
+			if (proc_info[i].session == sid)
+				return i;
+		}
+		return -1;
+	}
+	if (pbs_idx_find(sess_idx, &key, &data, NULL) != PBS_IDX_RET_OK)
+		return -1;
+	return ((int)(intptr_t)data - 1);
+}
+
+/**
+ * @brief
+ *	Return the entry of proc_info[] following i in the same session.
+ *
+ * @param[in] i - index into proc_info[] returned by sess_first() or
+ *		  sess_next()
+ *
+ * @return	int
+ * @retval	index into proc_info[]
+ * @retval	-1	no more processes in the session
+ *
+ */
+static int
+sess_next(int i)
+{
+	int	j;
+
+	if (sess_idx == NULL) {
+		for (j = i + 1; j < nproc; j++) {
+			if (proc_info[j].session == proc_info[i].session)
+				return j;
+		}
+		return -1;
+	}
+	return (sess_links[i].sl_next);
+}
+
+/**
+ * @brief
+ *	Step through the live tasks of a job, skipping a task whose
+ *	session was already returned for an earlier task.
+ *
+ * @param[in] pjob - job pointer
+ * @param[in] ptask - task returned by the last call, NULL to start
+ *
+ * @return	task *
+ * @retval	next task with a session of its own
+ * @retval	NULL	no more
+ *
+ */
+static task *
+next_job_session(job *pjob, task *ptask)
+{
+	task	*prev;
+
+	if (ptask == NULL)
+		ptask = (task *)GET_NEXT(pjob->ji_tasks);
+	else
+		ptask = (task *)GET_NEXT(ptask->ti_jobtask);
+	for (; ptask != NULL; ptask = (task *)GET_NEXT(ptask->ti_jobtask)) {
 		if (ptask->ti_qs.ti_sid <= 1)
 			continue;
-		if (ptask->ti_qs.ti_sid == sid)
-			return TRUE;
+		for (prev = (task *)GET_NEXT(pjob->ji_tasks);
+			prev != ptask;
+			prev = (task *)GET_NEXT(prev->ti_jobtask)) {
+			if (prev->ti_qs.ti_sid == ptask->ti_qs.ti_sid)
+				break;
+		}
+		if (prev == ptask)
+			return ptask;
 	}
-	return FALSE;
+	return NULL;
 }
 
 /**
@@ -4156,13 +4259,9 @@ cput_sum(job *pjob)
 		active_tasks++;
 		tcput = 0;
 		taskprocs = 0;
-		for (i=0; i<nproc; i++) {
+		for (i = sess_first(ptask->ti_qs.ti_sid); i != -1; i = sess_next(i)) {
 			ps = &proc_info[i];
 
-			/* is this process part of the task? */
-			if (ptask->ti_qs.ti_sid != ps->session)
-				continue;
-
 			nps++;
 			taskprocs++;
 
@@ -4302,18 +4401,20 @@ mem_sum(job *pjob)
 	int		i;
 	ulong		segadd;
 	proc_stat_t	*ps;
+	task		*ptask;
 
 	segadd = 0;
 
-	for (i=0; i<nproc; i++) {
+	for (ptask = next_job_session(pjob, NULL); ptask != NULL;
+		ptask = next_job_session(pjob, ptask)) {
+		for (i = sess_first(ptask->ti_qs.ti_sid); i != -1; i = sess_next(i)) {
 
-		ps = &proc_info[i];
+			ps = &proc_info[i];
 
-		if (!injob(pjob, ps->session))
-			continue;
-		segadd += ps->vsize;
-		DBPRT(("%s: pid: %d  pr_size: %lu  total: %lu\n",
-			__func__, ps->pid, (ulong)ps->vsize, segadd))
+			segadd += ps->vsize;
+			DBPRT(("%s: pid: %d  pr_size: %lu  total: %lu\n",
+				__func__, ps->pid, (ulong)ps->vsize, segadd))
+		}
 	}
 
 	return (segadd);
@@ -4336,16 +4437,17 @@ resi_sum(job *pjob)
 	int		i;
 	ulong		resisize;
 	proc_stat_t	*ps;
+	task		*ptask;
 
 	resisize = 0;
-	for (i=0; i<nproc; i++) {
-
-		ps = &proc_info[i];
+	for (ptask = next_job_session(pjob, NULL); ptask != NULL;
+		ptask = next_job_session(pjob, ptask)) {
+		for (i = sess_first(ptask->ti_qs.ti_sid); i != -1; i = sess_next(i)) {
 
-		if (!injob(pjob, ps->session))
-			continue;
+			ps = &proc_info[i];
 
-		resisize += ps->rss * pagesize;
+			resisize += ps->rss * pagesize;
+		}
 	}
 
 	return (resisize);
@@ -4547,58 +4649,185 @@ mom_open_poll(void)
 		log_err(errno, __func__, "malloc");
 		return (PBSE_SYSTEM);
 	}
+	sess_links = (sess_link *)malloc(sizeof(sess_link) * TBL_INC);
+	if (sess_links == NULL) {
+		log_err(errno, __func__, "malloc");
+		return (PBSE_SYSTEM);
+	}
 	max_proc = TBL_INC;
 
+	/*
+	 * $proc_tracking job finds the processes a job forks through the
+	 * children lists of the processes it already knows about.
+	 */
+	sprintf(log_buffer, "/proc/self/task/%d/children", (int)getpid());
+	children_ok = (access(log_buffer, R_OK) == 0);
+
 	return (PBSE_NONE);
 }
 
 /**
  * @brief
- * 	Declare start of polling loop.
+ *	Append a pid to a growable list of pids.
+ *
+ * @param[in,out] list - the list
+ * @param[in,out] num - number of pids in the list
+ * @param[in,out] max - number of pids there is room for
+ * @param[in] pid - pid to add
+ *
+ * @return	Void
+ *
+ */
+static void
+pid_push(pid_t **list, int *num, int *max, pid_t pid)
+{
+	if (*num == *max) {
+		void	*hold;
+
+		*max += TBL_INC;
+		hold = realloc((void *)*list, *max * sizeof(pid_t));
+		assert(hold != NULL);
+		*list = (pid_t *)hold;
+	}
+	(*list)[(*num)++] = pid;
+}
+
+/**
+ * @brief
+ *	Read /proc/<name>/stat into the next free entry of proc_info[].
+ *
+ * @param[in] name - entry under /proc, either "<pid>" or ".<pid>"
+ * @param[in] nomem - set for a ".<pid>" thread entry whose memory is
+ *		      already counted with its process
  *
  * @return	int
- * @retval	PBSE_INTERNAL	Dir pdir in NULL
- * @retval	PBSE_NONE	Success
+ * @retval	0	process added to proc_info[]
+ * @retval	1	process is owned by root or gone, skipped
+ * @retval	2	stat file could not be read
+ * @retval	-1	internal error
  *
  */
-int
-mom_get_sample(void)
+static int
+read_proc_stat(char *name, int nomem)
 {
-	struct dirent		*dent = NULL;
 	FILE			*fd = NULL;
 	static char		path[MAXPATHLEN + 1];
-	char			procname[MAXPATHLEN + 1]; /* space for dent->d_name plus extra */
-	char			procid[MAXPATHLEN + 1];
+	char			procname[MAXPATHLEN + 1]; /* space for name plus extra */
 	struct stat		sb;
 	proc_stat_t		*ps = NULL;
+	unsigned long long 	starttime;
+	char			*stat_str = NULL;
+
+	snprintf(procname, sizeof(procname), "/proc/%s", name);
+	if ((stat(procname, &sb) == -1) || (sb.st_uid == 0)) {
+		/* ignore root-owned processes */
+		return 1;
+	}
+	snprintf(procname, sizeof(procname), "/proc/%s/stat", name);
+
+	if ((fd = fopen(procname, "r")) == NULL)
+		return 2;
+
+	ps = &proc_info[nproc];
+	stat_str = choose_procflagsfmt();
+	if (stat_str == NULL) {
+		log_err(errno, __func__, "choose_procflagsfmt allocation failed");
+		fclose(fd);
+		return -1;
+	}
+	if (fscanf(fd, stat_str,
+		   &ps->pid,		/* "%d "	1  pid %d The process id */
+		   path,		/* "(%[^)]) "	2  comm %s The filename of the executable */
+		   &ps->state,		/* "%c "	3  state %c "RSDZTW" */
+		   &ps->ppid,		/* "%d "	4  ppid %d The PID of the parent */
+		   &ps->pgrp,		/* "%d "	5  pgrp %d The process group ID */
+		   &ps->session,	/* "%d "	6  session %d The session ID */
+			   		/* "%*d "	7  ignored:  tty_nr */
+ 		   			/* "%*d "	8  ignored:  tpgid */
+		   &ps->flags,		/* "%u or %lu"	9  flags */
+				   	/* "%*lu "	10 ignored:  minflt */
+				   	/* "%*lu "	11 ignored:  cminflt */
+				   	/* "%*lu "	12 ignored:  majflt */
+				   	/* "%*lu "	13 ignored:  cmajflt */
+		   &ps->utime,		/* "%lu "	14 utime %lu */
+		   &ps->stime,		/* "%lu "	15 stime %lu */
+		   &ps->cutime,		/* "%ld "	16 cutime %ld */
+		   &ps->cstime,		/* "%ld "	17 cstime %ld */
+			   		/* "%*ld "	18 ignored:  priority %ld */
+		   			/* "%*ld "	19 ignored:  nice %ld */
+		   			/* "%*ld "	20 ignored:  num_threads %ld */
+		   			/* "%*ld "	21 ignored:  itrealvalue %ld - no longer maintained */
+		   &starttime,		/* "%llu "	22 starttime (was %lu before Linux 2.6 - see proc(5) for conversion details */
+		   &ps->vsize,		/* "%lu "	23 vsize (bytes) */
+		   &ps->rss		/* "%ld "	24 rss (number of pages) */
+		) != 14) {
+		fclose(fd);
+		return 2;
+	}
+
+	if (fstat(fileno(fd), &sb) == -1) {
+		fclose(fd);
+		return 2;
+	}
+	ps->uid = sb.st_uid;
+	fclose(fd);
+
+	/*
+	 ** A .pid thread shows the memory of the process
+	 ** but we only want to count it once.
+	 */
+	if (nomem) {
+		ps->vsize = 0;
+		ps->rss = 0;
+	}
+
+	ps->start_time = linux_time + (starttime / hz);
+	snprintf(ps->comm, sizeof(ps->comm), "%.*s",
+		(int)(sizeof(ps->comm) - 1), path);
+
+	ps->utime = JTOS(ps->utime);
+	ps->stime = JTOS(ps->stime);
+	ps->cutime = JTOS(ps->cutime);
+	ps->cstime = JTOS(ps->cstime);
+	if (++nproc == max_proc) {
+		void	*hold;
+		DBPRT(("%s: alloc more proc table space %d\n", __func__, nproc))
+		max_proc += TBL_INC;
+		hold = realloc((void *)proc_info,
+			max_proc*sizeof(proc_stat_t));
+		assert(hold != NULL);
+		proc_info = (proc_stat_t *)hold;
+		hold = realloc((void *)sess_links,
+			max_proc*sizeof(sess_link));
+		assert(hold != NULL);
+		sess_links = (sess_link *)hold;
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ *	Fill proc_info[] with every process in /proc.
+ *
+ * @return	int
+ * @retval	PBSE_INTERNAL	Error
+ * @retval	PBSE_NONE	Success
+ *
+ */
+static int
+sample_all_procs(void)
+{
+	struct dirent		*dent = NULL;
 	int			nprocs = 0;
 	int			ncached = 0;
 	int			ncantstat = 0;
 	int			nnomem = 0;
-	unsigned long long 	starttime;
 	int			nskipped = 0;
-	extern time_t		time_last_sample;
-	char			*stat_str = NULL;
-
-	/* There are no job tasks created in mock run mode, so no need to walk the proc table */
-	if (mock_run)
-		return PBSE_NONE;
-
-	DBPRT(("%s: entered\n", __func__))
-	if (pdir == NULL)
-		return PBSE_INTERNAL;
+	int			nomem;
 
 	rewinddir(pdir);
-	nproc = 0;
-	fd = NULL;
-	if (hz == 0)
-		hz = sysconf(_SC_CLK_TCK);
-	time_last_sample = time(0);
-	sampletime_floor = time_last_sample;
 	while (errno = 0, (dent = readdir(pdir)) != NULL) {
-		int	nomem = 0;
-		struct	stat	sbuf;
-
+		nomem = 0;
 		nprocs++;
 
 		/*
@@ -4611,102 +4840,528 @@ mom_get_sample(void)
 			} else
 				continue;
 		}
-		snprintf(procid, sizeof(procid), "/proc/%s", dent->d_name);
-		if ((stat(procid, &sbuf) == -1) || (sbuf.st_uid == 0)) {
-			/* ignore root-owned processes */
-			nskipped++;
-			continue;
+		switch (read_proc_stat(dent->d_name, nomem)) {
+			case 1:
+				nskipped++;
+				break;
+			case 2:
+				ncantstat++;
+				break;
+			case -1:
+				return PBSE_INTERNAL;
 		}
-		snprintf(procname, sizeof(procname), "/proc/%s/stat", dent->d_name);
+	}
+	if (errno != 0 && errno != ENOENT)
+		log_err(errno, __func__, "readdir");
+	sprintf(log_buffer,
+		"nprocs:  %d, cantstat:  %d, nomem:  %d, skipped:  %d, "
+		"cached:  %d",
+		nprocs - 2, ncantstat, nnomem, nskipped,
+		ncached);
+	log_event(PBSEVENT_DEBUG4, 0, LOG_DEBUG, __func__, log_buffer);
+	return (PBSE_NONE);
+}
+
+/**
+ * @brief
+ *	Add the children of every thread of a process to a list of pids.
+ *
+ * @param[in] pid - process
+ * @param[in,out] list - list of pids, see pid_push()
+ * @param[in,out] num - number of pids in the list
+ * @param[in,out] max - number of pids there is room for
+ *
+ * @return	Void
+ *
+ */
+static void
+proc_children(pid_t pid, pid_t **list, int *num, int *max)
+{
+	char		path[MAXPATHLEN + 1];
+	DIR		*dir;
+	struct dirent	*dent;
+	FILE		*fp;
+	long		child;
 
-		if ((fd = fopen(procname, "r")) == NULL) {
-			ncantstat++;
+	snprintf(path, sizeof(path), "/proc/%d/task", (int)pid);
+	if ((dir = opendir(path)) == NULL)
+		return;		/* process is gone */
+	while ((dent = readdir(dir)) != NULL) {
+		if (!isdigit(dent->d_name[0]))
 			continue;
-		}
+		snprintf(path, sizeof(path), "/proc/%d/task/%s/children",
+			(int)pid, dent->d_name);
+		if ((fp = fopen(path, "r")) == NULL)
+			continue;
+		while (fscanf(fp, "%ld", &child) == 1)
+			pid_push(list, num, max, (pid_t)child);
+		fclose(fp);
+	}
+	closedir(dir);
+}
 
-		ps = &proc_info[nproc];
-		stat_str = choose_procflagsfmt();
-		if (stat_str == NULL) {
-			log_err(errno, __func__, "choose_procflagsfmt allocation failed");
-			return PBSE_INTERNAL;
-		}
-		if (fscanf(fd, stat_str,
-			   &ps->pid,		/* "%d "	1  pid %d The process id */
-			   path,		/* "(%[^)]) "	2  comm %s The filename of the executable */
-			   &ps->state,		/* "%c "	3  state %c "RSDZTW" */
-			   &ps->ppid,		/* "%d "	4  ppid %d The PID of the parent */
-			   &ps->pgrp,		/* "%d "	5  pgrp %d The process group ID */
-			   &ps->session,	/* "%d "	6  session %d The session ID */
-				   		/* "%*d "	7  ignored:  tty_nr */
-	 		   			/* "%*d "	8  ignored:  tpgid */
-			   &ps->flags,		/* "%u or %lu"	9  flags */
-					   	/* "%*lu "	10 ignored:  minflt */
-					   	/* "%*lu "	11 ignored:  cminflt */
-					   	/* "%*lu "	12 ignored:  majflt */
-					   	/* "%*lu "	13 ignored:  cmajflt */
-			   &ps->utime,		/* "%lu "	14 utime %lu */
-			   &ps->stime,		/* "%lu "	15 stime %lu */
-			   &ps->cutime,		/* "%ld "	16 cutime %ld */
-			   &ps->cstime,		/* "%ld "	17 cstime %ld */
-				   		/* "%*ld "	18 ignored:  priority %ld */
-			   			/* "%*ld "	19 ignored:  nice %ld */
-			   			/* "%*ld "	20 ignored:  num_threads %ld */
-			   			/* "%*ld "	21 ignored:  itrealvalue %ld - no longer maintained */
-			   &starttime,		/* "%llu "	22 starttime (was %lu before Linux 2.6 - see proc(5) for conversion details */
-			   &ps->vsize,		/* "%lu "	23 vsize (bytes) */
-			   &ps->rss		/* "%ld "	24 rss (number of pages) */
-			) != 14) {
-			ncantstat++;
-			fclose(fd);
+/**
+ * @brief
+ *	Find where the cgroup hierarchies of interest are mounted.
+ *
+ * @return	Void
+ *
+ */
+static void
+read_cgroup_mounts(void)
+{
+	FILE		*fp;
+	struct mntent	*mp;
+
+	memset(cg_mount, 0, sizeof(cg_mount));
+	cg_mounts_read = 1;
+	if ((fp = setmntent("/proc/self/mounts", "r")) == NULL)
+		return;
+	while ((mp = getmntent(fp)) != NULL) {
+		if (strcmp(mp->mnt_type, "cgroup2") == 0) {
+			if (cg_mount[CG_UNIFIED][0] == '\0')
+				snprintf(cg_mount[CG_UNIFIED], MAXPATHLEN + 1,
+					"%s", mp->mnt_dir);
 			continue;
 		}
+		if (strcmp(mp->mnt_type, "cgroup") != 0)
+			continue;
+		if ((cg_mount[CG_CPUACCT][0] == '\0') &&
+			(hasmntopt(mp, "cpuacct") != NULL))
+			snprintf(cg_mount[CG_CPUACCT], MAXPATHLEN + 1,
+				"%s", mp->mnt_dir);
+		if ((cg_mount[CG_MEMORY][0] == '\0') &&
+			(hasmntopt(mp, "memory") != NULL))
+			snprintf(cg_mount[CG_MEMORY], MAXPATHLEN + 1,
+				"%s", mp->mnt_dir);
+	}
+	endmntent(fp);
+}
+
+/**
+ * @brief
+ *	Check for a name in a comma separated list of cgroup controllers.
+ *
+ * @param[in] list - controller list from /proc/<pid>/cgroup
+ * @param[in] name - controller name
+ *
+ * @return	Bool
+ * @retval	TRUE
+ * @retval	FALSE
+ *
+ */
+static int
+has_ctrl(char *list, char *name)
+{
+	size_t	n = strlen(name);
+	char	*p = list;
+
+	while (p != NULL) {
+		if ((strncmp(p, name, n) == 0) &&
+			((p[n] == ',') || (p[n] == '\0')))
+			return TRUE;
+		if ((p = strchr(p, ',')) != NULL)
+			p++;
+	}
+	return FALSE;
+}
 
-		if (fstat(fileno(fd), &sb) == -1) {
-			fclose(fd);
+/**
+ * @brief
+ *	Find the cgroup the cgroups hook made for a job.
+ *
+ * @param[in] pjob - job pointer
+ * @param[in] hier - CG_CPUACCT or CG_MEMORY, the v1 hierarchy wanted;
+ *		     a v2 cgroup has both
+ * @param[out] buf - directory of the job cgroup
+ * @param[in] len - size of buf
+ * @param[out] unified - set to TRUE if buf is a cgroup v2 directory
+ *
+ * @return	int
+ * @retval	0	found
+ * @retval	-1	the job has no cgroup of its own
+ *
+ */
+static int
+job_cgroup_dir(job *pjob, int hier, char *buf, size_t len, int *unified)
+{
+	task	*ptask;
+	FILE	*fp;
+	char	line[MAXPATHLEN + 1];
+	char	*ctrl;
+	char	*cgpath;
+	int	h;
+
+	if (!cg_mounts_read)
+		read_cgroup_mounts();
+	if ((ptask = next_job_session(pjob, NULL)) == NULL)
+		return -1;
+	snprintf(line, sizeof(line), "/proc/%d/cgroup",
+		(int)ptask->ti_qs.ti_sid);
+	if ((fp = fopen(line, "r")) == NULL)
+		return -1;
+	while (fgets(line, sizeof(line), fp) != NULL) {
+		line[strcspn(line, "\n")] = '\0';
+		/* hierarchy-ID:controller-list:cgroup-path */
+		if ((ctrl = strchr(line, ':')) == NULL)
+			continue;
+		ctrl++;
+		if ((cgpath = strchr(ctrl, ':')) == NULL)
+			continue;
+		*cgpath++ = '\0';
+		/* a cgroup shared with mom or other jobs is of no use */
+		if (strstr(cgpath, pjob->ji_qs.ji_jobid) == NULL)
+			continue;
+		if (*ctrl == '\0')
+			h = CG_UNIFIED;
+		else if ((hier == CG_CPUACCT) && has_ctrl(ctrl, "cpuacct"))
+			h = CG_CPUACCT;
+		else if ((hier == CG_MEMORY) && has_ctrl(ctrl, "memory"))
+			h = CG_MEMORY;
+		else
 			continue;
+		if (cg_mount[h][0] == '\0')
+			continue;
+		snprintf(buf, len, "%s%s", cg_mount[h], cgpath);
+		*unified = (h == CG_UNIFIED);
+		fclose(fp);
+		return 0;
+	}
+	fclose(fp);
+	return -1;
+}
+
+/**
+ * @brief
+ *	Read a number from a cgroup file.
+ *
+ * @param[in] dir - cgroup directory
+ * @param[in] file - file in dir
+ * @param[in] tag - for a "key value" file like cpu.stat, the key to
+ *		    read, NULL for a file holding a single number
+ * @param[out] val - the number
+ *
+ * @return	int
+ * @retval	0	Success
+ * @retval	-1	Error
+ *
+ */
+static int
+read_cgroup_value(char *dir, char *file, char *tag, unsigned long long *val)
+{
+	char	path[MAXPATHLEN + 1];
+	char	line[256];
+	FILE	*fp;
+	int	ret = -1;
+	size_t	n;
+
+	snprintf(path, sizeof(path), "%s/%s", dir, file);
+	if ((fp = fopen(path, "r")) == NULL)
+		return -1;
+	if (tag == NULL) {
+		if (fscanf(fp, "%llu", val) == 1)
+			ret = 0;
+	} else {
+		n = strlen(tag);
+		while (fgets(line, sizeof(line), fp) != NULL) {
+			if ((strncmp(line, tag, n) == 0) && (line[n] == ' ') &&
+				(sscanf(line + n, "%llu", val) == 1)) {
+				ret = 0;
+				break;
+			}
 		}
-		ps->uid = sb.st_uid;
-		fclose(fd);
+	}
+	fclose(fp);
+	return ret;
+}
 
-		/*
-		 ** A .pid thread shows the memory of the process
-		 ** but we only want to count it once.
-		 */
-		if (nomem) {
-			ps->vsize = 0;
-			ps->rss = 0;
+/**
+ * @brief
+ *	Get the cpu time and peak memory use the job cgroup has recorded,
+ *	which include processes of the job that have already exited.
+ *
+ * @param[in] pjob - job pointer
+ * @param[out] cput - cpu time in seconds, 0 if not known
+ * @param[out] mem - peak memory in bytes, 0 if not known
+ *
+ * @return	Void
+ *
+ */
+static void
+cgroup_job_usage(job *pjob, ulong *cput, ulong *mem)
+{
+	char			dir[MAXPATHLEN + 1];
+	int			unified;
+	unsigned long long	val;
+
+	*cput = 0;
+	*mem = 0;
+	if (job_cgroup_dir(pjob, CG_CPUACCT, dir, sizeof(dir), &unified) == 0) {
+		if (unified) {
+			if (read_cgroup_value(dir, "cpu.stat", "usage_usec", &val) == 0)
+				*cput = (ulong)(val / 1000000);
+		} else if (read_cgroup_value(dir, "cpuacct.usage", NULL, &val) == 0)
+			*cput = (ulong)(val / 1000000000);
+	}
+	if (job_cgroup_dir(pjob, CG_MEMORY, dir, sizeof(dir), &unified) == 0) {
+		if (unified) {
+			if ((read_cgroup_value(dir, "memory.peak", NULL, &val) == 0) ||
+				(read_cgroup_value(dir, "memory.current", NULL, &val) == 0))
+				*mem = (ulong)val;
+		} else if (read_cgroup_value(dir, "memory.max_usage_in_bytes",
+			NULL, &val) == 0)
+			*mem = (ulong)val;
+	}
+}
+
+/**
+ * @brief
+ *	Fill proc_info[] with the processes of the jobs on this mom only.
+ *
+ *	Starting from the task session leaders, the members of each job
+ *	cgroup and the job processes found by the last sample, read each
+ *	process and then the children it has.  A process that left the
+ *	tree of its task before it was ever seen is picked up by the next
+ *	full scan and followed from then on.
+ *
+ * @return	int
+ * @retval	PBSE_INTERNAL	Error
+ * @retval	PBSE_NONE	Success
+ *
+ */
+static int
+sample_job_procs(void)
+{
+	extern pbs_list_head	svr_alljobs;
+	job			*pjob;
+	task			*ptask;
+	void			*seen;
+	void			*key;
+	void			*data;
+	pid_t			*work = NULL;
+	int			nwork = 0;
+	int			max_work = 0;
+	pid_t			pid;
+	char			dir[MAXPATHLEN + 1];
+	char			path[MAXPATHLEN + 32];
+	char			name[32];
+	FILE			*fp;
+	long			lpid;
+	int			unified;
+	int			njobs = 0;
+	int			ncantstat = 0;
+	int			nskipped = 0;
+	int			i;
+
+	if ((seen = pbs_idx_create(0, sizeof(pid_t))) == NULL)
+		return (sample_all_procs());
+
+	for (pjob = (job *)GET_NEXT(svr_alljobs);
+		pjob != NULL;
+		pjob = (job *)GET_NEXT(pjob->ji_alljobs)) {
+		for (ptask = next_job_session(pjob, NULL); ptask != NULL;
+			ptask = next_job_session(pjob, ptask))
+			pid_push(&work, &nwork, &max_work, ptask->ti_qs.ti_sid);
+		if ((job_cgroup_dir(pjob, CG_CPUACCT, dir, sizeof(dir), &unified) == 0) ||
+			(job_cgroup_dir(pjob, CG_MEMORY, dir, sizeof(dir), &unified) == 0)) {
+			snprintf(path, sizeof(path), "%s/cgroup.procs", dir);
+			if ((fp = fopen(path, "r")) != NULL) {
+				while (fscanf(fp, "%ld", &lpid) == 1)
+					pid_push(&work, &nwork, &max_work, (pid_t)lpid);
+				fclose(fp);
+			}
 		}
+		njobs++;
+	}
+	for (i = 0; i < ntrack_pids; i++)
+		pid_push(&work, &nwork, &max_work, track_pids[i]);
 
-		ps->start_time = linux_time + (starttime / hz);
-		snprintf(ps->comm, sizeof(ps->comm), "%.*s",
-			(int)(sizeof(ps->comm) - 1), path);
-
-		ps->utime = JTOS(ps->utime);
-		ps->stime = JTOS(ps->stime);
-		ps->cutime = JTOS(ps->cutime);
-		ps->cstime = JTOS(ps->cstime);
-		if (++nproc == max_proc) {
-			void	*hold;
-			DBPRT(("%s: alloc more proc table space %d\n", __func__, nproc))
-			max_proc += TBL_INC;
-			hold = realloc((void *)proc_info,
-				max_proc*sizeof(proc_stat_t));
-			assert(hold != NULL);
-			proc_info = (proc_stat_t *)hold;
+	/* work[] grows with the children of each process read */
+	for (i = 0; i < nwork; i++) {
+		pid = work[i];
+		key = &pid;
+		if ((pid <= 1) ||
+			(pbs_idx_find(seen, &key, &data, NULL) == PBS_IDX_RET_OK))
+			continue;
+		if (pbs_idx_insert(seen, &pid, NULL) != PBS_IDX_RET_OK) {
+			free(work);
+			pbs_idx_destroy(seen);
+			nproc = 0;
+			return (sample_all_procs());
 		}
+		snprintf(name, sizeof(name), "%d", (int)pid);
+		switch (read_proc_stat(name, 0)) {
+			case 1:
+				nskipped++;
+				break;
+			case 2:
+				ncantstat++;
+				break;
+			case -1:
+				free(work);
+				pbs_idx_destroy(seen);
+				return PBSE_INTERNAL;
+		}
+		proc_children(pid, &work, &nwork, &max_work);
 	}
-	if (errno != 0 && errno != ENOENT)
-		log_err(errno, __func__, "readdir");
-	sampletime_ceil = time_last_sample;
+	free(work);
+	pbs_idx_destroy(seen);
+
 	sprintf(log_buffer,
-		"nprocs:  %d, cantstat:  %d, nomem:  %d, skipped:  %d, "
-		"cached:  %d",
-		nprocs - 2, ncantstat, nnomem, nskipped,
-		ncached);
+		"jobs:  %d, nprocs:  %d, cantstat:  %d, skipped:  %d",
+		njobs, nproc, ncantstat, nskipped);
 	log_event(PBSEVENT_DEBUG4, 0, LOG_DEBUG, __func__, log_buffer);
 	return (PBSE_NONE);
 }
 
+/**
+ * @brief
+ *	Chain the entries of proc_info[] by session, see sess_first().
+ *
+ * @return	Void
+ *
+ */
+static void
+index_sessions(void)
+{
+	void	*key;
+	void	*data;
+	int	head;
+	int	i;
+
+	if ((sess_idx = pbs_idx_create(0, sizeof(pid_t))) == NULL)
+		return;		/* sess_first() will search the table */
+
+	for (i = 0; i < nproc; i++) {
+		sess_links[i].sl_next = -1;
+		key = &proc_info[i].session;
+		if (pbs_idx_find(sess_idx, &key, &data, NULL) == PBS_IDX_RET_OK) {
+			head = (int)(intptr_t)data - 1;
+			sess_links[sess_links[head].sl_last].sl_next = i;
+			sess_links[head].sl_last = i;
+		} else {
+			sess_links[i].sl_last = i;
+			if (pbs_idx_insert(sess_idx, &proc_info[i].session,
+				(void *)(intptr_t)(i + 1)) != PBS_IDX_RET_OK) {
+				pbs_idx_destroy(sess_idx);
+				sess_idx = NULL;
+				return;
+			}
+		}
+	}
+}
+
+/**
+ * @brief
+ *	Remember which processes in proc_info[] belong to jobs, so the
+ *	next $proc_tracking job sample reads them even if they are no
+ *	longer descendants of their task.
+ *
+ * @return	Void
+ *
+ */
+static void
+remember_job_procs(void)
+{
+	extern pbs_list_head	svr_alljobs;
+	job			*pjob;
+	task			*ptask;
+	int			i;
+
+	ntrack_pids = 0;
+	for (pjob = (job *)GET_NEXT(svr_alljobs);
+		pjob != NULL;
+		pjob = (job *)GET_NEXT(pjob->ji_alljobs)) {
+		for (ptask = next_job_session(pjob, NULL); ptask != NULL;
+			ptask = next_job_session(pjob, ptask)) {
+			for (i = sess_first(ptask->ti_qs.ti_sid); i != -1;
+				i = sess_next(i))
+				pid_push(&track_pids, &ntrack_pids,
+					&max_track_pids, proc_info[i].pid);
+		}
+	}
+}
+
+/**
+ * @brief
+ *	Refill proc_info[] and index it by session.
+ *
+ * @param[in] full - read every process even under $proc_tracking job;
+ *		     needed by requests that may ask about any process
+ *
+ * @return	int
+ * @retval	PBSE_INTERNAL	Dir pdir in NULL
+ * @retval	PBSE_NONE	Success
+ *
+ */
+static int
+sample_procs(int full)
+{
+	extern time_t		time_last_sample;
+	static int		warned = 0;
+	int			rc;
+
+	/* There are no job tasks created in mock run mode, so no need to walk the proc table */
+	if (mock_run)
+		return PBSE_NONE;
+
+	DBPRT(("%s: entered\n", __func__))
+	if (pdir == NULL)
+		return PBSE_INTERNAL;
+
+	if (sess_idx != NULL) {
+		pbs_idx_destroy(sess_idx);
+		sess_idx = NULL;
+	}
+	nproc = 0;
+	if (hz == 0)
+		hz = sysconf(_SC_CLK_TCK);
+	time_last_sample = time(0);
+	sampletime_floor = time_last_sample;
+
+	if ((proc_tracking == PROC_TRACK_JOB) && !children_ok && !warned) {
+		log_event(PBSEVENT_SYSTEM, 0, LOG_WARNING, __func__,
+			"$proc_tracking job needs /proc/<pid>/task/<tid>/children, "
+			"reading all processes instead");
+		warned = 1;
+	}
+	if (!full && (proc_tracking == PROC_TRACK_JOB) && children_ok &&
+		((time_last_sample - last_full_scan) < PROC_RESCAN_TIME))
+		rc = sample_job_procs();
+	else {
+		rc = sample_all_procs();
+		last_full_scan = time_last_sample;
+		cg_mounts_read = 0;	/* notice cgroup mounts made since */
+	}
+	if (rc != PBSE_NONE)
+		return rc;
+
+	sampletime_ceil = time_last_sample;
+	index_sessions();
+	if (proc_tracking == PROC_TRACK_JOB)
+		remember_job_procs();
+	return (PBSE_NONE);
+}
+
+/**
+ * @brief
+ * 	Declare start of polling loop.
+ *
+ *	With $proc_tracking job only the processes of the jobs on this
+ *	mom are read, with a full scan of /proc every PROC_RESCAN_TIME
+ *	seconds.
+ *
+ * @return	int
+ * @retval	PBSE_INTERNAL	Dir pdir in NULL
+ * @retval	PBSE_NONE	Success
+ *
+ */
+int
+mom_get_sample(void)
+{
+	return (sample_procs(0));
+}
+
 /**
  * @brief
  * 	Update the resources used.<attributes> of a job.
@@ -4734,6 +5389,8 @@ mom_set_use(job *pjob)
 	resource_def	*rd;
 	u_Long 		*lp_sz, lnum_sz;
 	ulong		*lp, lnum, oldcput;
+	ulong		cg_cput = 0;
+	ulong		cg_mem = 0;
 	long		ncpus_req;
 
 	assert(pjob != NULL);
@@ -4781,6 +5438,11 @@ mom_set_use(job *pjob)
 	lp = (ulong *)&pres->rs_value.at_val.at_long;
 	oldcput = *lp;
 	lnum = cput_sum(pjob);
+	if (proc_tracking == PROC_TRACK_JOB) {
+		/* the job cgroup also counts processes already gone */
+		cgroup_job_usage(pjob, &cg_cput, &cg_mem);
+		lnum = MAX(lnum, (ulong)((double)cg_cput * cputfactor));
+	}
 	lnum = MAX(*lp, lnum);
 	if ((pres->rs_value.at_flags & ATR_VFLAG_HOOK) == 0) {
 		/* don't conflict with hook setting a value */
@@ -4830,6 +5492,7 @@ mom_set_use(job *pjob)
 	} else if ((pres->rs_value.at_flags & ATR_VFLAG_HOOK) == 0) {
 		lp_sz = &pres->rs_value.at_val.at_size.atsv_num;
 		lnum_sz = (resi_sum(pjob) + 1023) >> 10; /* as KB */
+		lnum_sz = MAX(lnum_sz, (cg_mem + 1023) >> 10);
 		*lp_sz = MAX(*lp_sz, lnum_sz);
 	}
 
@@ -4988,7 +5651,7 @@ kill_session(pid_t sesid, int sig, int dir)
 	if (sesid <= 1)
 		return 0;
 
-	(void)mom_get_sample();
+	(void)sample_procs(1);
 	ct = bld_ptree(sesid);
 	DBPRT(("%s: bld_ptree %d\n", __func__, ct))
 
@@ -5045,6 +5708,16 @@ mom_close_poll(void)
 		proc_info = NULL;
 		max_proc = 0;
 	}
+	free(sess_links);
+	sess_links = NULL;
+	if (sess_idx != NULL) {
+		pbs_idx_destroy(sess_idx);
+		sess_idx = NULL;
+	}
+	free(track_pids);
+	track_pids = NULL;
+	ntrack_pids = 0;
+	max_track_pids = 0;
 
 	return (PBSE_NONE);
 }
@@ -5097,7 +5770,7 @@ getprocs(void)
 	if (lastproc == reqnum)		/* don't need new proc table */
 		return 1;
 
-	if (mom_get_sample() != PBSE_NONE)
+	if (sample_procs(1) != PBSE_NONE)
 		return 0;
 
 	lastproc = reqnum;
@@ -5167,7 +5840,7 @@ cput_proc(pid_t pid)
 	double		cputime;
 	proc_stat_t	*ps = NULL;
 
-	mom_get_sample();
+	sample_procs(1);
 	for (i = 0; i < nproc; i++) {
 		ps = &proc_info[i];
 		if (ps->pid == pid)
@@ -5246,7 +5919,7 @@ mem_job(pid_t sid)
 
 	memsize = 0;
 
-	mom_get_sample();
+	sample_procs(1);
 	for (i=0; i<nproc; i++) {
 
 		ps = &proc_info[i];
@@ -5283,7 +5956,7 @@ mem_proc(pid_t pid)
 	int		i;
 	proc_stat_t	*ps = NULL;
 
-	mom_get_sample();
+	sample_procs(1);
 	for (i = 0; i < nproc; i++) {
 		ps = &proc_info[i];
 		if (ps->pid == pid)
@@ -5361,7 +6034,7 @@ resi_job(pid_t jobid)
 	proc_stat_t	*ps;
 
 	resisize = 0;
-	mom_get_sample();
+	sample_procs(1);
 
 	for (i=0; i<nproc; i++) {
 
@@ -5401,7 +6074,7 @@ resi_proc(pid_t pid)
 	proc_stat_t	*ps = NULL;
 
 
-	mom_get_sample();
+	sample_procs(1);
 	for (i = 0; i < nproc; i++) {
 		ps = &proc_info[i];
 		if (ps->pid == pid)
@@ -5493,7 +6166,7 @@ sessions(struct rm_attribute *attrib)
 		return NULL;
 	}
 
-	mom_get_sample();
+	sample_procs(1);
 
 	/*
 	 ** Search for members of session
@@ -5608,7 +6281,7 @@ pids(struct rm_attribute *attrib)
 		return NULL;
 	}
 
-	mom_get_sample();
+	sample_procs(1);
 
 	/*
 	 ** Search for members of session
@@ -5668,7 +6341,7 @@ nusers(struct rm_attribute *attrib)
 		return NULL;
 	}
 
-	mom_get_sample();
+	sample_procs(1);
 	for (i=0; i<nproc; i++) {
 		ps = &proc_info[i];
 
@@ -6493,7 +7166,7 @@ walltime(struct rm_attribute *attrib)
 		rm_errno = RM_ERR_SYSTEM;
 		return NULL;
 	}
-	mom_get_sample();
+	sample_procs(1);
 
 	start = now;
 	for (i=0; i<nproc; i++) {
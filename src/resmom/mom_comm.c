@@ -118,6 +118,7 @@ extern unsigned int	pbs_rm_port;
 extern int     mom_net_up;
 extern time_t  mom_net_up_time;
 extern int		max_poll_downtime_val;
+extern int		sister_fanout;
 extern  char   *msg_err_malloc;
 extern int
 write_pipe_data(int upfds, void *data, int data_size);
@@ -1649,6 +1650,16 @@ send_sisters_inner(job *pjob, int com, pbs_jobndstm_t command_func,
 	tm_event_t	event;
 	char		*cookie;
 
+	/*
+	 ** With $sister_fanout set, polls and deletes of a job with more
+	 ** sisters than that go down a tree of sisters instead.
+	 */
+	if ((sister_fanout > 0) && (command_func == NULL) &&
+		((com == IM_POLL_JOB) || (com == IM_DELETE_JOB)) &&
+		(pjob->ji_updated == 0) &&
+		(pjob->ji_numnodes - 1 > sister_fanout))
+		return send_sisters_tree(pjob, com, exclude_exec_host);
+
 	if (pbs_conf.pbs_use_mcast == 1)
 		return send_sisters_mcast_inner(pjob, com, command_func,
 						exclude_exec_host);
@@ -2264,6 +2275,15 @@ node_bailout(job *pjob, hnodent *np)
 				pjob->ji_nodekill = np->hn_node;
 				break;
 
+			case	IM_RELAY:
+				/*
+				 ** A child in the fan-out tree went away before
+				 ** answering a relayed POLL.
+				 */
+				DBPRT(("%s: RELAY %s\n", __func__, pjob->ji_qs.ji_jobid))
+				im_relay_failed(pjob, np, SISTER_EOF, ep->ee_client);
+				break;
+
 #ifdef PMIX
 			case	IM_PMIX:
 				/* I am MS and a node has failed a PMIX request. */
@@ -2729,11 +2749,12 @@ static	char	bail_format[] = "dis read failed: %s";
 
 /**
  * @brief
- *	Send resources_used values to the MS via
- *	'stream' descriptor.
+ *	Build in 'phead' the list of resources_used values of job 'pjob'
+ *	that were set by a mom hook, leaving out those like 'cput',
+ *	'mem' and 'cpupercent' that are always sent to the MS.
  *
- * @param[in] stream - descriptor pathway to MS.
- * @param[in] pjob - poineter to owning job structure
+ * @param[in] pjob - pointer to owning job structure
+ * @param[out] phead - list head that gets the svrattrl entries
  *
  * @return  error code
  * @retval -1     error
@@ -2741,7 +2762,7 @@ static	char	bail_format[] = "dis read failed: %s";
  *
  */
 int
-send_resc_used_to_ms(int stream, job *pjob)
+get_resc_used_hook_list(job *pjob, pbs_list_head *phead)
 {
 	extern int resc_access_perm;
 	attribute *at;
@@ -2749,11 +2770,9 @@ send_resc_used_to_ms(int stream, job *pjob)
 	svrattrl *pal;
 	svrattrl *nxpal;
 	pbs_list_head lhead;
-	pbs_list_head send_head;
-	svrattrl *psatl;
-	int ret;
 
-	if (pjob == NULL || stream == -1)
+	CLEAR_HEAD((*phead));
+	if (pjob == NULL)
 		return (-1);
 
 	at = &pjob->ji_wattr[(int) JOB_ATR_resc_used];
@@ -2766,8 +2785,6 @@ send_resc_used_to_ms(int stream, job *pjob)
 	CLEAR_HEAD(lhead);
 
 	(void) ad->at_encode(at, &lhead, ad->at_name, NULL, ATR_ENCODE_CLIENT, NULL);
-	memset(&send_head, 0, sizeof(send_head));
-	CLEAR_HEAD(send_head);
 
 	pal = (svrattrl *) GET_NEXT(lhead);
 	while (pal != NULL) {
@@ -2780,9 +2797,9 @@ send_resc_used_to_ms(int stream, job *pjob)
 		    strcmp(pal->al_resc, "cput") != 0 &&
 		    strcmp(pal->al_resc, "mem") != 0 &&
 		    strcmp(pal->al_resc, "cpupercent") != 0) {
-			if (add_to_svrattrl_list(&send_head, pal->al_name, pal->al_resc,
+			if (add_to_svrattrl_list(phead, pal->al_name, pal->al_resc,
 						 pal->al_value, pal->al_op, NULL) == -1) {
-				free_attrlist(&send_head);
+				free_attrlist(phead);
 				free_attrlist(&lhead);
 				return (-1);
 			}
@@ -2790,6 +2807,35 @@ send_resc_used_to_ms(int stream, job *pjob)
 		pal = nxpal;
 	}
 	free_attrlist(&lhead);
+	return (0);
+}
+
+/**
+ * @brief
+ *	Send resources_used values to the MS via
+ *	'stream' descriptor.
+ *
+ * @param[in] stream - descriptor pathway to MS.
+ * @param[in] pjob - poineter to owning job structure
+ *
+ * @return  error code
+ * @retval -1     error
+ * @retval  0     Success
+ *
+ */
+int
+send_resc_used_to_ms(int stream, job *pjob)
+{
+	pbs_list_head send_head;
+	svrattrl *psatl;
+	int ret;
+
+	if (pjob == NULL || stream == -1)
+		return (-1);
+
+	memset(&send_head, 0, sizeof(send_head));
+	if (get_resc_used_hook_list(pjob, &send_head) != 0)
+		return (-1);
 
 	psatl = (svrattrl *) GET_NEXT(send_head);
 	if (psatl == NULL) {
@@ -2806,15 +2852,13 @@ send_resc_used_to_ms(int stream, job *pjob)
 
 /**
  * @brief
- *	Received resources_used values for job 'jobid'
- *	from descriptor 'stream', with values to be saved in
- *	internal nodes resources table indexed by 'nodeidx'.
+ *	Save the resources_used values in list 'phead' for job 'pjob'
+ *	in the internal nodes resources table entry indexed by 'nodeidx'.
  *
- * @param[in] stream - descriptor pathway
  * @param[in] pjob - pointer to owning job structure
  * @param[in] nodeidx - node index to the job's internal resources table
- *			where received values will be saved.
- *			resources values received from
+ *			where the values will be saved.
+ * @param[in] phead - svrattrl list of resources_used values
  *
  * @return  error code
  * @retval -1     error
@@ -2822,42 +2866,32 @@ send_resc_used_to_ms(int stream, job *pjob)
  *
  */
 int
-recv_resc_used_from_sister(int stream, job *pjob, int nodeidx)
+set_resc_used_from_list(job *pjob, int nodeidx, pbs_list_head *phead)
 {
 	extern int resc_access_perm;
 	attribute_def *pdef;
-	pbs_list_head lhead;
 	svrattrl *psatl;
 	int errcode;
 
-	if (pjob == NULL || stream == -1 || nodeidx < 0)
+	if (pjob == NULL || nodeidx < 0)
 		return (-1);
 
 	pdef = &job_attr_def[(int) JOB_ATR_resc_used];
 
-	CLEAR_HEAD(lhead);
-	if (decode_DIS_svrattrl(stream, &lhead) != DIS_SUCCESS) {
-		sprintf(log_buffer, "decode_DIS_svrattrl failed");
-		return (-1);
-	}
 	if ((pjob->ji_resources[nodeidx].nr_used.at_flags & ATR_VFLAG_SET) != 0)
 		pdef->at_free(&pjob->ji_resources[nodeidx].nr_used);
 	/* decode attributes from request into job structure */
 	clear_attr(&pjob->ji_resources[nodeidx].nr_used, &job_attr_def[JOB_ATR_resc_used]);
 
 	resc_access_perm = READ_WRITE;
-	psatl = (svrattrl *) GET_NEXT(lhead);
+	psatl = (svrattrl *) GET_NEXT((*phead));
 	for (; psatl; psatl = (svrattrl *) GET_NEXT(psatl->al_link)) {
 
-		if ((psatl->al_name == NULL) || (psatl->al_resc == NULL)) {
-			free_attrlist(&lhead);
+		if ((psatl->al_name == NULL) || (psatl->al_resc == NULL))
 			return (-1);
-		}
 
-		if (strcmp(psatl->al_name, ATTR_used) != 0) {
-			free_attrlist(&lhead);
+		if (strcmp(psatl->al_name, ATTR_used) != 0)
 			return (-1);
-		}
 
 		/* decode attribute */
 		errcode = pdef->at_decode(&pjob->ji_resources[nodeidx].nr_used,
@@ -2865,17 +2899,717 @@ recv_resc_used_from_sister(int stream, job *pjob, int nodeidx)
 					  psatl->al_value);
 		/* Unknown resources still get decoded */
 		/* under "unknown" resource def */
-		if ((errcode != 0) && (errcode != PBSE_UNKRESC)) {
-			free_attrlist(&lhead);
+		if ((errcode != 0) && (errcode != PBSE_UNKRESC))
 			return (-1);
-		}
 
 		if (psatl->al_op == DFLT)
 			pjob->ji_resources[nodeidx].nr_used.at_flags |= ATR_VFLAG_DEFLT;
 	}
+	return (0);
+}
 
+/**
+ * @brief
+ *	Received resources_used values for job 'jobid'
+ *	from descriptor 'stream', with values to be saved in
+ *	internal nodes resources table indexed by 'nodeidx'.
+ *
+ * @param[in] stream - descriptor pathway
+ * @param[in] pjob - pointer to owning job structure
+ * @param[in] nodeidx - node index to the job's internal resources table
+ *			where received values will be saved.
+ *			resources values received from
+ *
+ * @return  error code
+ * @retval -1     error
+ * @retval  0     Success
+ *
+ */
+int
+recv_resc_used_from_sister(int stream, job *pjob, int nodeidx)
+{
+	pbs_list_head lhead;
+	int rc;
+
+	if (pjob == NULL || stream == -1 || nodeidx < 0)
+		return (-1);
+
+	CLEAR_HEAD(lhead);
+	if (decode_DIS_svrattrl(stream, &lhead) != DIS_SUCCESS) {
+		sprintf(log_buffer, "decode_DIS_svrattrl failed");
+		return (-1);
+	}
+	rc = set_resc_used_from_list(pjob, nodeidx, &lhead);
 	free_attrlist(&lhead);
-	return (0);
+	return (rc);
+}
+
+/**
+ * @brief
+ *	Check that a relayed request for 'pjob' comes from 'parent', the
+ *	host above me in the fan-out tree.  Mother superior is checked with
+ *	check_ms().  For any other sister, remember the stream if none is
+ *	open to her yet, otherwise the addresses must match.
+ *
+ * @param[in] stream - stream the request came in on
+ * @param[in] pjob - structure handle to job
+ * @param[in] parent - index into pjob->ji_hosts of the sender
+ *
+ * @return error code
+ * @retval TRUE  error
+ * @retval FALSE if okay
+ *
+ */
+static int
+check_relay(int stream, job *pjob, int parent)
+{
+	hnodent			*np;
+	struct	sockaddr_in	*node_addr;
+	struct	sockaddr_in	*stream_addr;
+
+	if ((parent < 0) || (parent >= pjob->ji_numnodes) ||
+		(parent == pjob->ji_nodeid)) {
+		sprintf(log_buffer, "relay from bad host index %d", parent);
+		log_joberr(-1, __func__, log_buffer, pjob->ji_qs.ji_jobid);
+		tpp_eom(stream);
+		return TRUE;
+	}
+	if (parent == 0)
+		return (check_ms(stream, pjob));
+
+	np = &pjob->ji_hosts[parent];
+	if (np->hn_stream != stream) {
+		node_addr = tpp_getaddr(np->hn_stream);
+		stream_addr = tpp_getaddr(stream);
+		if (node_addr == NULL) {
+			np->hn_stream = stream;
+		} else if ((stream_addr == NULL) ||
+			(memcmp(&stream_addr->sin_addr, &node_addr->sin_addr,
+			sizeof(node_addr->sin_addr)) != 0)) {
+			sprintf(log_buffer, "relay from %s does not match host %s",
+				netaddr(stream_addr), np->hn_host);
+			log_joberr(-1, __func__, log_buffer, pjob->ji_qs.ji_jobid);
+			tpp_eom(stream);
+			return TRUE;
+		}
+	}
+	np->hn_eof_ts = 0;
+	return FALSE;
+}
+
+/**
+ * @brief
+ *	Add a record for host 'host' to the relay state 'pr'.
+ *
+ * @param[in] pr - relay state
+ * @param[in] host - index into ji_hosts
+ * @param[in] status - 0 or the error seen for the host
+ *
+ * @return im_relay_rec *
+ * @retval record added
+ * @retval NULL on malloc failure
+ *
+ */
+static im_relay_rec *
+relay_rec_add(im_relay *pr, int host, int status)
+{
+	im_relay_rec	*rec;
+
+	rec = (im_relay_rec *)calloc(1, sizeof(im_relay_rec));
+	if (rec == NULL) {
+		log_err(errno, __func__, MALLOC_ERR_MSG);
+		return NULL;
+	}
+	CLEAR_LINK(rec->rr_link);
+	CLEAR_HEAD(rec->rr_used);
+	rec->rr_host = host;
+	rec->rr_status = status;
+	append_link(&pr->ir_recs, &rec->rr_link, rec);
+	pr->ir_nrecs++;
+	return rec;
+}
+
+/**
+ * @brief
+ *	Free relay state 'pr' and all the records hung off it.
+ *
+ * @param[in] pr - relay state
+ *
+ * @return Void
+ *
+ */
+static void
+relay_state_free(im_relay *pr)
+{
+	im_relay_rec	*rec;
+
+	if (pr == NULL)
+		return;
+	while ((rec = (im_relay_rec *)GET_NEXT(pr->ir_recs)) != NULL) {
+		free_attrlist(&rec->rr_used);
+		delete_link(&rec->rr_link);
+		free(rec);
+	}
+	free(pr);
+}
+
+/**
+ * @brief
+ *	Free any relay state kept for a job.
+ *
+ * @param[in] pjob - structure handle to job
+ *
+ * @return Void
+ *
+ */
+void
+im_relay_free(job *pjob)
+{
+	relay_state_free(pjob->ji_relay);
+	pjob->ji_relay = NULL;
+}
+
+/**
+ * @brief
+ *	Send the records collected for a relayed POLL up to the parent
+ *	in a single IM_ALL_OKAY reply, then drop the relay state.
+ *
+ *	reply (
+ *		count		int;
+ *		count times (
+ *			host		int;
+ *			status		int;
+ *			if status is 0 (
+ *				recommendation	int;
+ *				cput		u_long;
+ *				mem		u_long;
+ *				cpupercent	u_long;
+ *				resources_used	svrattrl;
+ *			)
+ *		)
+ *	)
+ *
+ * @param[in] pjob - structure handle to job
+ *
+ * @return Void
+ *
+ */
+static void
+relay_reply_send(job *pjob)
+{
+	im_relay	*pr = pjob->ji_relay;
+	im_relay_rec	*rec;
+	int		stream;
+	int		ret;
+
+	if (pr == NULL)
+		return;
+	pjob->ji_relay = NULL;
+	stream = pr->ir_stream;
+
+	ret = im_compose(stream, pjob->ji_qs.ji_jobid,
+		pjob->ji_wattr[(int)JOB_ATR_Cookie].at_val.at_str,
+		IM_ALL_OKAY, pr->ir_event, TM_NULL_TASK, IM_OLD_PROTOCOL_VER);
+	if (ret == DIS_SUCCESS)
+		ret = diswsi(stream, pr->ir_nrecs);
+	for (rec = (im_relay_rec *)GET_NEXT(pr->ir_recs);
+		(rec != NULL) && (ret == DIS_SUCCESS);
+		rec = (im_relay_rec *)GET_NEXT(rec->rr_link)) {
+		if ((ret = diswsi(stream, rec->rr_host)) != DIS_SUCCESS)
+			break;
+		if ((ret = diswsi(stream, rec->rr_status)) != DIS_SUCCESS)
+			break;
+		if (rec->rr_status != 0)
+			continue;
+		if (((ret = diswsi(stream, rec->rr_exitval)) != DIS_SUCCESS) ||
+			((ret = diswul(stream, rec->rr_cput)) != DIS_SUCCESS) ||
+			((ret = diswul(stream, rec->rr_mem)) != DIS_SUCCESS) ||
+			((ret = diswul(stream, rec->rr_cpupercent)) != DIS_SUCCESS))
+			break;
+		ret = encode_DIS_svrattrl(stream,
+			(svrattrl *)GET_NEXT(rec->rr_used));
+	}
+	if ((ret != DIS_SUCCESS) || (dis_flush(stream) == -1)) {
+		sprintf(log_buffer, "relayed POLL reply failed on stream %d",
+			stream);
+		log_joberr(-1, __func__, log_buffer, pjob->ji_qs.ji_jobid);
+	} else {
+		sprintf(log_buffer, "relayed POLL reply for %d hosts",
+			pr->ir_nrecs);
+		log_event(PBSEVENT_DEBUG3, PBS_EVENTCLASS_JOB, LOG_DEBUG,
+			pjob->ji_qs.ji_jobid, log_buffer);
+	}
+	relay_state_free(pr);
+}
+
+/**
+ * @brief
+ *	Send command 'com' down the fan-out tree to the hosts in 'hosts'.
+ *	The list is cut into at most 'fanout' runs of near equal length.
+ *	The first host of each run is sent an IM_RELAY carrying the rest
+ *	of the run, which she passes on the same way.
+ *
+ *	request (
+ *		parent		int;
+ *		command		int;
+ *		fanout		int;
+ *		count		int;
+ *		host		int; (count of them)
+ *	)
+ *
+ * @param[in] pjob - structure handle to job
+ * @param[in] com - IM_POLL_JOB or IM_DELETE_JOB
+ * @param[in] fanout - most children to send to
+ * @param[in] hosts - indices into pjob->ji_hosts
+ * @param[in] count - number of entries in hosts
+ *
+ * @return int
+ * @retval number of hosts covered by the runs that were sent
+ *
+ * @note
+ *	For IM_POLL_JOB sent by a sister, each child that can not be
+ *	reached is recorded as failed in pjob->ji_relay.  Mother superior
+ *	sets pjob->ji_nodekill instead, as send_sisters_inner() does.
+ *
+ */
+static int
+relay_send(job *pjob, int com, int fanout, int *hosts, int count)
+{
+	int		i, j;
+	int		first, last;
+	int		nchild;
+	int		num = 0;
+	int		ret;
+	hnodent		*np;
+	eventent	*ep;
+	tm_event_t	event;
+	im_relay	*pr = NULL;
+
+	if (com == IM_POLL_JOB)
+		pr = pjob->ji_relay;
+	nchild = (count < fanout) ? count : fanout;
+	for (i = 0; i < nchild; i++) {
+		first = (i * count) / nchild;
+		last = ((i + 1) * count) / nchild;
+		np = &pjob->ji_hosts[hosts[first]];
+
+		/*
+		 ** Only mother superior has streams open to every sister
+		 ** from JOIN_JOB, so a relaying sister opens her own.
+		 */
+		if (np->hn_stream == -1)
+			np->hn_stream = tpp_open(np->hn_host, np->hn_port);
+
+		ep = NULL;
+		event = TM_NULL_EVENT;
+		if (np->hn_stream < 0)
+			ret = DIS_PROTO;
+		else {
+			if (com != IM_DELETE_JOB) {
+				ep = event_alloc(pjob, IM_RELAY, -1, np,
+					(pr != NULL) ? pr->ir_gen : TM_NULL_EVENT,
+					TM_NULL_TASK);
+				event = ep->ee_event;
+			}
+			ret = DIS_SUCCESS;
+		}
+
+		if (ret == DIS_SUCCESS)
+			ret = im_compose(np->hn_stream, pjob->ji_qs.ji_jobid,
+				pjob->ji_wattr[(int)JOB_ATR_Cookie].at_val.at_str,
+				IM_RELAY, event, TM_NULL_TASK, IM_OLD_PROTOCOL_VER);
+		if (ret == DIS_SUCCESS)
+			ret = diswsi(np->hn_stream, pjob->ji_nodeid);
+		if (ret == DIS_SUCCESS)
+			ret = diswsi(np->hn_stream, com);
+		if (ret == DIS_SUCCESS)
+			ret = diswsi(np->hn_stream, fanout);
+		if (ret == DIS_SUCCESS)
+			ret = diswsi(np->hn_stream, last - first - 1);
+		for (j = first + 1; (j < last) && (ret == DIS_SUCCESS); j++)
+			ret = diswsi(np->hn_stream, hosts[j]);
+		if ((ret == DIS_SUCCESS) && (dis_flush(np->hn_stream) == -1))
+			ret = DIS_PROTO;
+
+		if (ret != DIS_SUCCESS) {
+			sprintf(log_buffer, "could not relay request %d to %s",
+				com, np->hn_host ? np->hn_host : "UNDEFINED");
+			log_joberr(-1, __func__, log_buffer, pjob->ji_qs.ji_jobid);
+			if (ep != NULL) {
+				delete_link(&ep->ee_next);
+				free(ep);
+			}
+			np->hn_sister = SISTER_EOF;
+			if (pjob->ji_qs.ji_svrflags & JOB_SVFLG_HERE) {
+				if (pjob->ji_nodekill == TM_ERROR_NODE)
+					pjob->ji_nodekill = np->hn_node;
+			} else if (pr != NULL)
+				(void)relay_rec_add(pr, hosts[first], SISTER_EOF);
+			continue;
+		}
+
+		np->hn_sister = SISTER_OKAY;
+		if (pr != NULL)
+			pr->ir_pending++;
+		num += last - first;
+	}
+	return num;
+}
+
+/**
+ * @brief
+ *	Mother superior's side of send_sisters_inner() when $sister_fanout
+ *	is set.  Build the list of sisters that would be sent 'com'
+ *	directly and hand it to relay_send().
+ *
+ * @param[in] pjob - structure handle to job
+ * @param[in] com - IM_POLL_JOB or IM_DELETE_JOB
+ * @param[in] exclude_exec_host - if not NULL, do not send to MOM
+ *				hostnames appearing in this list
+ *
+ * @return int
+ * @retval num - number of sisters covered by the requests sent out.
+ * @retval 0   - Failure
+ *
+ */
+int
+send_sisters_tree(job *pjob, int com, char *exclude_exec_host)
+{
+	int		i;
+	int		num;
+	int		count = 0;
+	int		*hosts;
+
+	if (!(pjob->ji_wattr[(int)JOB_ATR_Cookie].at_flags & ATR_VFLAG_SET))
+		return 0;
+
+	hosts = (int *)malloc(pjob->ji_numnodes * sizeof(int));
+	if (hosts == NULL) {
+		log_err(errno, __func__, MALLOC_ERR_MSG);
+		return 0;
+	}
+
+	for (i = 0; i < pjob->ji_numnodes; i++) {
+		hnodent		*np = &pjob->ji_hosts[i];
+
+		if (np->hn_node == pjob->ji_nodeid)	/* this is me */
+			continue;
+
+		if (np->hn_sister != SISTER_OKAY) {	/* sis is gone? */
+			if (pjob->ji_nodekill == TM_ERROR_NODE)
+				pjob->ji_nodekill = np->hn_node;
+			continue;
+		}
+
+		/* 'np' holds the RM port number in np->hn_port */
+		/* while exclude_exec_host stores the MOM port */
+		if ((exclude_exec_host != NULL) &&
+			in_exechost(exclude_exec_host, np->hn_host,
+						np->hn_port-1))
+			continue;
+
+		if (reliable_job_node_find(&pjob->ji_failed_node_list, np->hn_host) != NULL) {
+			snprintf(log_buffer, sizeof(log_buffer),
+			         "not sending request %d to failed mom %s",
+				 com, np->hn_host ? np->hn_host : "UNDEFINED");
+			log_event(PBSEVENT_DEBUG3, PBS_EVENTCLASS_JOB, LOG_DEBUG, pjob->ji_qs.ji_jobid, log_buffer);
+			continue;
+		}
+		hosts[count++] = i;
+	}
+
+	num = relay_send(pjob, com, sister_fanout, hosts, count);
+	free(hosts);
+	return num;
+}
+
+/**
+ * @brief
+ *	A sister has been sent an IM_RELAY.  Read the rest of the request,
+ *	pass it on to her share of the tree, and for IM_POLL_JOB start
+ *	collecting the replies, beginning with her own usage.
+ *	A POLL still waiting on children from the previous round is sent
+ *	up with what it has.
+ *
+ * @param[in] stream - stream the request came in on
+ * @param[in] pjob - structure handle to job
+ * @param[in] event - event to use in the reply to the parent
+ *
+ * @return int
+ * @retval the relayed command, IM_POLL_JOB or IM_DELETE_JOB
+ * @retval -1 on error, with log_buffer set
+ *
+ */
+int
+im_relay_request(int stream, job *pjob, tm_event_t event)
+{
+	static tm_event_t	relay_gen = TM_NULL_EVENT;
+	int			com, fanout, count;
+	int			i, ret;
+	int			*hosts = NULL;
+	im_relay		*pr;
+	im_relay_rec		*rec;
+
+	com = disrsi(stream, &ret);
+	if (ret != DIS_SUCCESS)
+		goto bad;
+	fanout = disrsi(stream, &ret);
+	if (ret != DIS_SUCCESS)
+		goto bad;
+	count = disrsi(stream, &ret);
+	if (ret != DIS_SUCCESS)
+		goto bad;
+	if (((com != IM_POLL_JOB) && (com != IM_DELETE_JOB)) ||
+		(fanout < 2) || (count < 0) || (count >= pjob->ji_numnodes)) {
+		sprintf(log_buffer, "bad relay command %d fanout %d count %d",
+			com, fanout, count);
+		return -1;
+	}
+
+	if (count > 0) {
+		hosts = (int *)malloc(count * sizeof(int));
+		if (hosts == NULL) {
+			sprintf(log_buffer, "malloc failure for relay hosts");
+			return -1;
+		}
+	}
+	for (i = 0; i < count; i++) {
+		hosts[i] = disrsi(stream, &ret);
+		if (ret != DIS_SUCCESS)
+			goto bad;
+		if ((hosts[i] <= 0) || (hosts[i] >= pjob->ji_numnodes) ||
+			(hosts[i] == pjob->ji_nodeid)) {
+			sprintf(log_buffer, "bad relay host index %d", hosts[i]);
+			free(hosts);
+			return -1;
+		}
+	}
+
+	if (com == IM_DELETE_JOB) {
+		(void)relay_send(pjob, com, fanout, hosts, count);
+		free(hosts);
+		return com;
+	}
+
+	pjob->ji_polltime = time_now;
+	if (pjob->ji_relay != NULL)
+		relay_reply_send(pjob);
+
+	pr = (im_relay *)calloc(1, sizeof(im_relay));
+	if (pr == NULL) {
+		sprintf(log_buffer, "malloc failure for relay state");
+		free(hosts);
+		return -1;
+	}
+	CLEAR_HEAD(pr->ir_recs);
+	pr->ir_stream = stream;
+	pr->ir_event = event;
+	if (++relay_gen == TM_NULL_EVENT)
+		++relay_gen;
+	pr->ir_gen = relay_gen;
+	pjob->ji_relay = pr;
+
+	/* my own usage goes first, as a direct POLL reply would carry */
+	rec = relay_rec_add(pr, pjob->ji_nodeid, 0);
+	if (rec != NULL) {
+		rec->rr_exitval = (pjob->ji_qs.ji_svrflags &
+			(JOB_SVFLG_OVERLMT1|JOB_SVFLG_OVERLMT2)) ? 1 : 0;
+		rec->rr_cput = resc_used(pjob, "cput", gettime);
+		rec->rr_mem = resc_used(pjob, "mem", getsize);
+		rec->rr_cpupercent = resc_used(pjob, "cpupercent", gettime);
+		(void)get_resc_used_hook_list(pjob, &rec->rr_used);
+	}
+
+	(void)relay_send(pjob, com, fanout, hosts, count);
+	free(hosts);
+
+	if (pr->ir_pending == 0)
+		relay_reply_send(pjob);
+	return com;
+
+bad:
+	sprintf(log_buffer, bail_format, "RELAY request");
+	free(hosts);
+	return -1;
+}
+
+/**
+ * @brief
+ *	Mother superior has lost a sister during a POLL, either directly
+ *	or as reported by a sister relaying for her.  Handle it as
+ *	node_bailout() and the POLL_JOB error reply do.
+ *
+ * @param[in] pjob - structure handle to job
+ * @param[in] np - host that failed
+ * @param[in] errcode - error reported, SISTER_EOF for lost contact
+ *
+ * @return Void
+ *
+ */
+static void
+relay_host_failed(job *pjob, hnodent *np, int errcode)
+{
+	if (do_tolerate_node_failures(pjob)) {
+		snprintf(log_buffer, sizeof(log_buffer),
+			"ignoring POLL error from failed mom %s as job is tolerant of node failures",
+			np->hn_host ? np->hn_host : "");
+		log_event(PBSEVENT_DEBUG3, PBS_EVENTCLASS_JOB, LOG_DEBUG,
+			pjob->ji_qs.ji_jobid, log_buffer);
+		return;
+	}
+	sprintf(log_buffer, "POLL failed from node %d", np->hn_node);
+	log_joberr(-1, __func__, log_buffer, pjob->ji_qs.ji_jobid);
+	if (errcode != SISTER_EOF)
+		np->hn_sister = errcode;
+	pjob->ji_nodekill = np->hn_node;
+}
+
+/**
+ * @brief
+ *	A child in the fan-out tree failed to answer a relayed POLL,
+ *	with an error reply or by going away.  Mother superior treats it
+ *	like a failed POLL.  A relaying sister records the failure for
+ *	her parent, and replies once no children are left to hear from.
+ *
+ * @param[in] pjob - structure handle to job
+ * @param[in] np - child that failed
+ * @param[in] errcode - error reported, SISTER_EOF for lost contact
+ * @param[in] gen - relay generation saved in the child's event
+ *
+ * @return Void
+ *
+ */
+void
+im_relay_failed(job *pjob, hnodent *np, int errcode, tm_event_t gen)
+{
+	im_relay	*pr;
+
+	if (errcode == 0)
+		errcode = SISTER_BADPOLL;
+	if (pjob->ji_qs.ji_svrflags & JOB_SVFLG_HERE) {
+		relay_host_failed(pjob, np, errcode);
+		return;
+	}
+	pr = pjob->ji_relay;
+	if ((pr == NULL) || (pr->ir_gen != gen))
+		return;		/* left over from an earlier round */
+	(void)relay_rec_add(pr, np - pjob->ji_hosts, errcode);
+	if (--pr->ir_pending <= 0)
+		relay_reply_send(pjob);
+}
+
+/**
+ * @brief
+ *	Read the records of a relayed POLL reply from a child in the
+ *	fan-out tree.  Mother superior tallies them as she would direct
+ *	POLL replies; a relaying sister adds them to her own collection.
+ *
+ * @param[in] stream - stream the reply came in on
+ * @param[in] pjob - structure handle to job
+ * @param[in] gen - relay generation saved in the child's event
+ *
+ * @return int
+ * @retval 0 success
+ * @retval -1 error, with log_buffer set
+ *
+ */
+int
+im_relay_reply(int stream, job *pjob, tm_event_t gen)
+{
+	im_relay	*pr = NULL;
+	im_relay_rec	*rec;
+	im_relay_rec	tmp;
+	int		is_ms;
+	int		count;
+	int		i, ret;
+
+	is_ms = (pjob->ji_qs.ji_svrflags & JOB_SVFLG_HERE) != 0;
+	if (!is_ms && (pjob->ji_relay != NULL) &&
+		(pjob->ji_relay->ir_gen == gen))
+		pr = pjob->ji_relay;
+
+	count = disrsi(stream, &ret);
+	if (ret != DIS_SUCCESS)
+		goto bad;
+	for (i = 0; i < count; i++) {
+		memset(&tmp, 0, sizeof(tmp));
+		CLEAR_HEAD(tmp.rr_used);
+		tmp.rr_host = disrsi(stream, &ret);
+		if (ret != DIS_SUCCESS)
+			goto bad;
+		tmp.rr_status = disrsi(stream, &ret);
+		if (ret != DIS_SUCCESS)
+			goto bad;
+		if ((tmp.rr_host <= 0) || (tmp.rr_host >= pjob->ji_numnodes)) {
+			sprintf(log_buffer, "bad relay host index %d",
+				tmp.rr_host);
+			return -1;
+		}
+
+		if (tmp.rr_status == 0) {
+			tmp.rr_exitval = disrsi(stream, &ret);
+			if (ret != DIS_SUCCESS)
+				goto bad;
+			tmp.rr_cput = disrul(stream, &ret);
+			if (ret != DIS_SUCCESS)
+				goto bad;
+			tmp.rr_mem = disrul(stream, &ret);
+			if (ret != DIS_SUCCESS)
+				goto bad;
+			tmp.rr_cpupercent = disrul(stream, &ret);
+			if (ret != DIS_SUCCESS)
+				goto bad;
+			if (decode_DIS_svrattrl(stream, &tmp.rr_used) != DIS_SUCCESS) {
+				free_attrlist(&tmp.rr_used);
+				goto bad;
+			}
+		}
+
+		if (is_ms) {
+			hnodent	*np = &pjob->ji_hosts[tmp.rr_host];
+
+			if (tmp.rr_status != 0) {
+				relay_host_failed(pjob, np, tmp.rr_status);
+			} else if ((pjob->ji_resources != NULL) &&
+				(tmp.rr_host <= pjob->ji_numrescs)) {
+				noderes	*nr = &pjob->ji_resources[tmp.rr_host - 1];
+
+				nr->nr_cput = tmp.rr_cput;
+				nr->nr_mem = tmp.rr_mem;
+				nr->nr_cpupercent = tmp.rr_cpupercent;
+				if (GET_NEXT(tmp.rr_used) != NULL)
+					(void)set_resc_used_from_list(pjob,
+						tmp.rr_host - 1, &tmp.rr_used);
+				DBPRT(("%s: POLL_JOB %s relayed OKAY kill %d cpu %lu mem %lu\n",
+				       __func__, pjob->ji_qs.ji_jobid, tmp.rr_exitval,
+				       nr->nr_cput, nr->nr_mem))
+			}
+			if (tmp.rr_exitval)
+				pjob->ji_nodekill = np->hn_node;
+			free_attrlist(&tmp.rr_used);
+		} else if (pr != NULL) {
+			rec = relay_rec_add(pr, tmp.rr_host, tmp.rr_status);
+			if (rec == NULL) {
+				free_attrlist(&tmp.rr_used);
+				continue;
+			}
+			rec->rr_exitval = tmp.rr_exitval;
+			rec->rr_cput = tmp.rr_cput;
+			rec->rr_mem = tmp.rr_mem;
+			rec->rr_cpupercent = tmp.rr_cpupercent;
+			list_move(&tmp.rr_used, &rec->rr_used);
+		} else {
+			free_attrlist(&tmp.rr_used);
+		}
+	}
+
+	if ((pr != NULL) && (--pr->ir_pending <= 0))
+		relay_reply_send(pjob);
+	return 0;
+
+bad:
+	sprintf(log_buffer, bail_format, "RELAY reply");
+	return -1;
 }
 
 /**
@@ -2969,6 +3703,7 @@ im_request(int stream, int version)
 	int			nodeidx =0;
 	int			resc_idx = 0;
 	int			reply;
+	int			relayed = 0;
 	int			exitval;
 	tm_node_id		pvnodeid;
 	tm_node_id		tvnodeid;
@@ -3541,6 +4276,36 @@ join_err:
 		free(ep);
 	}
 
+	if (command == IM_RELAY) {
+		/*
+		 ** Sender is mom superior, or the sister above me in the
+		 ** fan-out tree, passing down a command for a job I am part
+		 ** of.  Pass it on to the hosts below me, then act on it.
+		 ** The reply to a POLL is sent once the hosts below me have
+		 ** all answered.
+		 **
+		 ** auxiliary info (
+		 **	parent		int;
+		 **	command		int;
+		 **	fanout		int;
+		 **	count		int;
+		 **	host		int; (count of them)
+		 ** )
+		 */
+		i = disrsi(stream, &ret);
+		BAIL("RELAY parent")
+		if (check_relay(stream, pjob, i))
+			goto fini;
+		command = im_relay_request(stream, pjob, event);
+		if (command == -1)
+			goto err;
+		if (command == IM_POLL_JOB) {
+			reply = 0;
+			goto done;
+		}
+		relayed = 1;
+	}
+
 	switch (command) {
 
 		case	IM_KILL_JOB:
@@ -3617,7 +4382,7 @@ join_err:
 			 */
 			DBPRT(("%s: %s for %s\n", __func__, command==IM_DELETE_JOB?"DELETE_JOB":"DELETE_JOB_REPLY", pjob->ji_qs.ji_jobid));
 
-			if (check_ms(stream, pjob))
+			if (!relayed && check_ms(stream, pjob))
 				goto fini;
 
  			if ((command == IM_DELETE_JOB) || (command == IM_DELETE_JOB_REPLY))
@@ -4873,6 +5638,20 @@ join_err:
 						pjob->ji_nodekill = np->hn_node;
 					break;
 
+				case	IM_RELAY:
+					/*
+					 ** Sender is a child in the fan-out tree
+					 ** answering a relayed POLL for itself and
+					 ** the hosts below it.
+					 **
+					 ** auxiliary info (
+					 **	see relay_reply_send();
+					 ** )
+					 */
+					if (im_relay_reply(stream, pjob, event_client) != 0)
+						goto err;
+					break;
+
 #ifdef PMIX
 				case	IM_PMIX:
 					/*
@@ -5292,6 +6071,16 @@ join_err:
 					pjob->ji_nodekill = np->hn_node;
 					break;
 
+				case	IM_RELAY:
+					/*
+					 ** A child in the fan-out tree could not
+					 ** take a relayed POLL.
+					 */
+					DBPRT(("%s: RELAY %s returned ERROR %d\n",
+						__func__, jobid, errcode))
+					im_relay_failed(pjob, np, errcode, event_client);
+					break;
+
 #ifdef PMIX
 				case	IM_PMIX:
 					/*
@@ -124,6 +124,7 @@
 #include	"mom_mach.h"
 #endif	/* MOM_CSA or MOM_ALPS */
 #include	"pbs_reliable.h"
+#include	"pbs_idcache.h"
 #ifdef PMIX
 #include	"mom_pmix.h"
 #endif /* PMIX */
@@ -193,6 +194,10 @@ int		alien_kill = 0;			/* kill alien procs */
 int		lockfds;
 float		max_load_val   = -1.0;
 int		max_poll_downtime_val = PBS_MAX_POLL_DOWNTIME;
+int		sister_fanout = 0;	/* 0 means MS talks to every sister */
+int		proc_tracking = PROC_TRACK_SCAN;
+int		resc_used_delta = -1;	/* -1 sends all usage every update */
+int		stage_parallel = 1;	/* remote file copies run at once */
 char	       *mom_domain;
 char           *mom_home;
 char		mom_host[PBS_MAXHOSTNAME+1];
@@ -508,6 +513,10 @@ static handler_ret_t	set_reject_root_scripts(char *);
 static handler_ret_t	set_report_hook_checksums(char *);
 static handler_ret_t	setmaxload(char *);
 static handler_ret_t	set_max_poll_downtime(char *);
+static handler_ret_t	set_sister_fanout(char *);
+static handler_ret_t	set_proc_tracking(char *);
+static handler_ret_t	set_resc_used_delta(char *);
+static handler_ret_t	set_stage_parallel(char *);
 #if	MOM_BGL
 static handler_ret_t	set_bgl_reserve_partitions(char *);
 #endif	/* MOM_BGL */
@@ -570,9 +579,13 @@ static struct	specials {
 	{ "nrun_factor",		set_nrun_factor },
 #endif
 	{ "port",			set_momport },
+	{ "proc_tracking",		set_proc_tracking },
 	{ "prologalarm",		prologalarm },
+	{ "sister_fanout",		set_sister_fanout },
 	{ "sister_join_job_alarm",	set_joinjob_alarm },
+	{ "stage_parallel",		set_stage_parallel },
 	{ "job_launch_delay",		set_job_launch_delay },
+	{ "resc_used_delta",		set_resc_used_delta },
 	{ "restart_background",		set_restart_background },
 	{ "restart_transmogrify",	set_restart_transmogrify },
 	{ "restrict_user",		set_restrict_user },
@@ -3521,6 +3534,96 @@ set_max_poll_downtime(char *value)
 	return HANDLER_SUCCESS;
 }
 
+/**
+ * process $sister_fanout directive in config file:
+ *	$sister_fanout 32
+ * Mother superior sends polls and deletes of a job to at most this
+ * many sisters, each of which relays them on to its own share of the
+ * rest.  0 turns this off.
+ */
+static handler_ret_t
+set_sister_fanout(char *value)
+{
+	char *ebuf;
+	long  val;
+
+	log_event(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER,
+		LOG_INFO, "sister_fanout", value);
+	val = strtol(value, &ebuf, 10);
+	if ((ebuf == value) || (*ebuf != '\0') || (val < 0) || (val == 1) ||
+		(val > INT_MAX))
+		return HANDLER_FAIL;	/* error */
+	sister_fanout = (int)val;
+
+	return HANDLER_SUCCESS;
+}
+
+/**
+ * process $proc_tracking directive in config file:
+ *	$proc_tracking scan|job
+ * "scan" reads every process in the system on each poll, "job" reads
+ * only the processes that belong to jobs running on this mom.
+ */
+static handler_ret_t
+set_proc_tracking(char *value)
+{
+	log_event(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER,
+		LOG_INFO, "proc_tracking", value);
+	if (strcasecmp(value, "scan") == 0)
+		proc_tracking = PROC_TRACK_SCAN;
+	else if (strcasecmp(value, "job") == 0)
+		proc_tracking = PROC_TRACK_JOB;
+	else
+		return HANDLER_FAIL;	/* error */
+
+	return HANDLER_SUCCESS;
+}
+
+/**
+ * process $resc_used_delta directive in config file:
+ *	$resc_used_delta 5
+ * The periodic resources_used update to the server carries only the
+ * values that changed by more than this percent since they were last
+ * sent.  0 sends every value that changed at all.
+ */
+static handler_ret_t
+set_resc_used_delta(char *value)
+{
+	char *ebuf;
+	long  val;
+
+	log_event(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER,
+		LOG_INFO, "resc_used_delta", value);
+	val = strtol(value, &ebuf, 10);
+	if ((ebuf == value) || (*ebuf != '\0') || (val < 0) || (val > 100))
+		return HANDLER_FAIL;	/* error */
+	resc_used_delta = (int)val;
+
+	return HANDLER_SUCCESS;
+}
+
+/**
+ * process $stage_parallel directive in config file:
+ *	$stage_parallel 4
+ * Up to this many remote file copies of one stage in or stage out
+ * request are run at the same time.
+ */
+static handler_ret_t
+set_stage_parallel(char *value)
+{
+	char *ebuf;
+	long  val;
+
+	log_event(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER,
+		LOG_INFO, "stage_parallel", value);
+	val = strtol(value, &ebuf, 10);
+	if ((ebuf == value) || (*ebuf != '\0') || (val < 1) || (val > 64))
+		return HANDLER_FAIL;	/* error */
+	stage_parallel = (int)val;
+
+	return HANDLER_SUCCESS;
+}
+
 /**
  * @brief
  *	process $kbd_idle directive in config file:
@@ -4894,6 +4997,10 @@ read_config(char *file)
 	vnode_additive       = 1;	/* keep vnodes on HUP */
 	joinjob_alarm_time   = -1;
 	job_launch_delay     = -1;
+	proc_tracking        = PROC_TRACK_SCAN;
+	resc_used_delta      = -1;
+	stage_parallel       = 1;
+	sister_fanout        = 0;
 #ifdef NAS /* localmod 015 */
 	spoolsize            = 0; /* unlimited by default */
 #endif /* localmod 015 */
@@ -8071,6 +8178,23 @@ time_delta_hellosvr(int mode)
 	return delta;
 }
 
+/**
+ * @brief
+ *	Timed work task to refresh the user and group lookup cache, and
+ *	queue the next one.
+ *
+ * @param[in] ptask - the work task
+ *
+ * @return void
+ */
+static void
+idcache_refresh_task(struct work_task *ptask)
+{
+	idcache_refresh();
+	(void)set_task(WORK_Timed, time_now + PBS_IDCACHE_REFRESH,
+		idcache_refresh_task, NULL);
+}
+
 #ifdef	WIN32
 /**
  * @brief
@@ -9108,7 +9232,7 @@ main(int argc, char *argv[])
 
 	/* initialize variables */
 
-	if ((jobs_idx = pbs_idx_create(0, 0)) == NULL) {
+	if ((jobs_idx = pbs_idx_create(PBS_IDX_HASH, 0)) == NULL) {
 		log_err(-1, __func__, "Creating jobs index failed!");
 		fprintf(stderr, "Creating jobs index failed!\n");
 		return (-1);
@@ -9268,6 +9392,13 @@ main(int argc, char *argv[])
 		return (3);
 	}
 
+	/*
+	 * cache user and group lookups, now that the daemon has forked;
+	 * refresh them from the main loop, a refresher thread could be
+	 * inside the name service when a job child is forked
+	 */
+	idcache_init(PBS_IDCACHE_TTL, PBS_IDCACHE_NEG_TTL, 0);
+
 	tpp_set_app_net_handler(net_down_handler, net_restore_handler);
 
 	if ((tppfd = tpp_init(&tpp_conf)) == -1) {
@@ -9451,6 +9582,9 @@ main(int argc, char *argv[])
 	cleanup_hooks_workdir(0);
 	cleanup_hooks_in_path_spool(0);
 
+	(void)set_task(WORK_Timed, time_now + PBS_IDCACHE_REFRESH,
+		idcache_refresh_task, NULL);
+
 #ifdef PYTHON
 	set_py_progname();
 	Py_NoSiteFlag = 1;
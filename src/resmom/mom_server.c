@@ -662,6 +662,47 @@ err:
 
 }
 
+/**
+ * @brief
+ *	Send the server one checksum of all the hooks known to the current
+ *	mom, if the configuration flag 'report_hook_checksums' is TRUE.  The
+ *	server asks for the checksum of each hook (IS_HOOK_CHECKSUMS) only
+ *	if it does not match its own.
+ *
+ * @return	int
+ * @retval	DIS_SUCCESS	- for successful operation
+ * @retval	!= DIS_SUCCESS	- for failure encountered
+ *
+ */
+static int
+send_hook_bundle(void)
+{
+	int	ret;
+
+	if (!report_hook_checksums)
+		return DIS_SUCCESS;
+
+	if (server_stream == -1) {
+		/* no stream to server...ok */
+		return DIS_SUCCESS;
+	}
+
+	if ((ret = is_compose(server_stream, IS_HOOK_BUNDLE)) != DIS_SUCCESS)
+		goto err;
+
+	ret = diswul(server_stream, hook_bundle_checksum(hooks_rescdef_checksum));
+	if (ret != DIS_SUCCESS)
+		goto err;
+
+	(void)dis_flush(server_stream);
+
+	return DIS_SUCCESS;
+
+err:
+	log_err(errno, __func__, (char *)dis_emsg[ret]);
+	return (ret);
+}
+
 /**
  * @brief
  *	This function will process the rpp values from the server stream.
@@ -846,6 +887,7 @@ is_request(int stream, int version)
 			 /* return a IS_REGISTERMOM followed by an UPDATE or UPDATE2 */
 
 			next_sample_time = min_check_poll;
+			reset_resc_used_sent();
 			if ((ret = is_compose(stream, IS_REGISTERMOM)) != DIS_SUCCESS)
 				goto err;
 			if ((ret = registermom(stream, 1)) != 0)
@@ -864,7 +906,7 @@ is_request(int stream, int version)
 					msg_daemonname, log_buffer);
 			dis_flush(server_stream);
 
-			if (send_hook_checksums() != DIS_SUCCESS)
+			if (send_hook_bundle() != DIS_SUCCESS)
 				goto err;
 			/* send any unacknowledged hook job and vnl action requests */
 			send_hook_job_action(NULL);
@@ -1022,6 +1064,12 @@ is_request(int stream, int version)
 			process_IS_CMD(stream);
 			break;
 
+		case IS_HOOK_CHECKSUMS:
+			/* our hooks differ from the server's, report each one */
+			if ((ret = send_hook_checksums()) != DIS_SUCCESS)
+				goto err;
+			break;
+
 		case IS_HOOK_ACTION_ACK:
 			/* the Server is sending an acknowledgement that it received */
 			/* and processed an IS_HOOK_JOB_ACTION request for a job.    */
@@ -87,6 +87,7 @@
 #include "work_task.h"
 #include "placementsets.h"
 #include "pbs_internal.h"
+#include "pbs_idcache.h"
 
 #if defined(PBS_SECURITY) && (PBS_SECURITY == KRB5)
 #include "renew_creds.h"
@@ -237,7 +238,7 @@ fork_to_user(struct batch_request *preq, job *pjob)
 	}
 
 	if (pjob)
-		pwdp = getpwnam(pjob->ji_wattr[(int) JOB_ATR_euser].at_val.at_str);
+		pwdp = idcache_getpwnam(pjob->ji_wattr[(int) JOB_ATR_euser].at_val.at_str);
 
 	/* we're trying to reuse old pw_userlogin since a mapped UNC */
 	/* path maybe hanging off it. With pbs_mom running under     */
@@ -358,7 +359,7 @@ fork_to_user(struct batch_request *preq, job *pjob)
 		/* Account ID used to be set her for Cray via acctid(). */
 	} else {
 		/* Need to look up the uid, gid, and home directory */
-		if ((pwdp = getpwnam(rqcpf->rq_user)) == NULL)
+		if ((pwdp = idcache_getpwnam(rqcpf->rq_user)) == NULL)
 			frk_err(PBSE_BADUSER, preq); /* no return */
 		useruid = pwdp->pw_uid;
 		user_rgid = pwdp->pw_gid;
@@ -366,7 +367,7 @@ fork_to_user(struct batch_request *preq, job *pjob)
 		if (rqcpf->rq_group[0] == '\0')
 			usergid = pwdp->pw_gid; /* default to login group */
 		else {
-			if ((grpp = getgrnam(rqcpf->rq_group)) == NULL)
+			if ((grpp = idcache_getgrnam(rqcpf->rq_group)) == NULL)
 				frk_err(PBSE_BADUSER, preq); /* no return */
 			usergid = grpp->gr_gid;
 		}
@@ -2746,7 +2747,7 @@ req_cpyfile(struct batch_request *preq)
 		 * no homedir can be cached in job's gc_homedir/altid
 		 * attribute, so we call map_unc_path to get it now
 		 */
-		if ((pw=getpwnam(preq->rq_ind.rq_cpyfile.rq_user)) != NULL) {
+		if ((pw=idcache_getpwnam(preq->rq_ind.rq_cpyfile.rq_user)) != NULL) {
 			strncpy(actual_homedir,
 				map_unc_path(pw->pw_dir, pw), sizeof(actual_homedir));
 			pbs_jobdir = jobdirname(rqcpf->rq_jobid, actual_homedir);
@@ -3165,7 +3166,7 @@ req_cpyfile(struct batch_request *preq)
 	stage_inout.sandbox_private = (rqcpf->rq_dir & STAGE_JOBDIR)? TRUE : FALSE;
 
 	/* Call getpwnam for user info */
-	pwdp = getpwnam(rqcpf->rq_user);
+	pwdp = idcache_getpwnam(rqcpf->rq_user);
 	if (pwdp != NULL) {
 		pbs_jobdir = jobdirname(rqcpf->rq_jobid, pwdp->pw_dir);
 	} else {
@@ -3186,7 +3187,7 @@ req_cpyfile(struct batch_request *preq)
 		if (rqcpf->rq_group[0] == '\0') {
 			usergid = pwdp->pw_gid;	/* default to login group */
 		} else {
-			if ((grpp = getgrnam(rqcpf->rq_group)) == NULL) {
+			if ((grpp = idcache_getgrnam(rqcpf->rq_group)) == NULL) {
 				req_reject(PBSE_BADUSER, 0, preq);
 				return;
 			}
@@ -3298,6 +3299,8 @@ req_cpyfile(struct batch_request *preq)
 		if (rc != 0)
 			break;
 	}
+	/* wait for remote copies still running under $stage_parallel */
+	(void)stage_file_finish(&stage_inout);
 	copy_stop = time(0);
 
 	/* If there was a stage in failure, remove the job directory.
@@ -3599,13 +3602,13 @@ mom_checkpoint_job(job *pjob, int abort)
 		if ((pjob->ji_wattr[(int)JOB_ATR_sandbox].at_flags & ATR_VFLAG_SET) &&
 			(strcasecmp(pjob->ji_wattr[JOB_ATR_sandbox].at_val.at_str, "PRIVATE") ==0)) {
 			/* "sandbox=PRIVATE" mode is enabled, so restart job in PBS_JOBDIR */
-			pwdp = getpwnam(pjob->ji_wattr[(int)JOB_ATR_euser].at_val.at_str);
+			pwdp = idcache_getpwnam(pjob->ji_wattr[(int)JOB_ATR_euser].at_val.at_str);
 			if (pwdp != NULL) {
 				(void)chdir(jobdirname(pjob->ji_qs.ji_jobid,
 					save_actual_homedir(pwdp, pjob)));
 			}
 		} else {
-			pwdp = getpwnam(pjob->ji_wattr[(int)JOB_ATR_euser].
+			pwdp = idcache_getpwnam(pjob->ji_wattr[(int)JOB_ATR_euser].
 				at_val.at_str);
 			if (pwdp != NULL)
 				(void)chdir(save_actual_homedir(pwdp, pjob));
@@ -3616,12 +3619,12 @@ mom_checkpoint_job(job *pjob, int abort)
 		if ((pjob->ji_wattr[(int)JOB_ATR_sandbox].at_flags & ATR_VFLAG_SET) &&
 			(strcasecmp(pjob->ji_wattr[JOB_ATR_sandbox].at_val.at_str, "PRIVATE") == 0)) {
 			/* "sandbox=PRIVATE" mode is enabled, so restart job in PBS_JOBDIR */
-			pwdp = getpwnam(pjob->ji_wattr[(int)JOB_ATR_euser].at_val.at_str);
+			pwdp = idcache_getpwnam(pjob->ji_wattr[(int)JOB_ATR_euser].at_val.at_str);
 			if (pwdp != NULL) {
 				(void)chdir(jobdirname(pjob->ji_qs.ji_jobid, pwdp->pw_dir));
 			}
 		} else {
-			pwdp = getpwnam(pjob->ji_wattr[(int)JOB_ATR_euser].
+			pwdp = idcache_getpwnam(pjob->ji_wattr[(int)JOB_ATR_euser].
 				at_val.at_str);
 			if (pwdp != NULL)
 				chdir(pwdp->pw_dir);
@@ -4188,13 +4191,13 @@ mom_restart_job(job *pjob)
 		if ((pjob->ji_wattr[(int)JOB_ATR_sandbox].at_flags & ATR_VFLAG_SET) &&
 			(strcasecmp(pjob->ji_wattr[JOB_ATR_sandbox].at_val.at_str, "PRIVATE") == 0)) {
 			/* "sandbox=PRIVATE" mode is enabled, so restart job in PBS_JOBDIR */
-			pwdp = getpwnam(pjob->ji_wattr[(int)JOB_ATR_euser].at_val.at_str);
+			pwdp = idcache_getpwnam(pjob->ji_wattr[(int)JOB_ATR_euser].at_val.at_str);
 			if (pwdp != NULL) {
 				(void)chdir(jobdirname(pjob->ji_qs.ji_jobid,
 					save_actual_homedir(pwdp, pjob)));
 			}
 		} else {
-			pwdp = getpwnam(pjob->ji_wattr[(int)JOB_ATR_euser].
+			pwdp = idcache_getpwnam(pjob->ji_wattr[(int)JOB_ATR_euser].
 				at_val.at_str);
 			if (pwdp != NULL)
 				chdir(save_actual_homedir(pwdp, pjob));
@@ -4205,11 +4208,11 @@ mom_restart_job(job *pjob)
 		if ((pjob->ji_wattr[(int)JOB_ATR_sandbox].at_flags & ATR_VFLAG_SET) &&
 			(strcasecmp(pjob->ji_wattr[JOB_ATR_sandbox].at_val.at_str, "PRIVATE") == 0)) {
 			/* "sandbox=PRIVATE" mode is enabled, so restart job in PBS_JOBDIR */
-			pwdp = getpwnam(pjob->ji_wattr[(int)JOB_ATR_euser].at_val.at_str);
+			pwdp = idcache_getpwnam(pjob->ji_wattr[(int)JOB_ATR_euser].at_val.at_str);
 			if (pwdp != NULL)
 				(void)chdir(jobdirname(pjob->ji_qs.ji_jobid, pwdp->pw_dir));
 		} else {
-			pwdp = getpwnam(pjob->ji_wattr[(int)JOB_ATR_euser].
+			pwdp = idcache_getpwnam(pjob->ji_wattr[(int)JOB_ATR_euser].
 				at_val.at_str);
 			if (pwdp != NULL)
 				chdir(pwdp->pw_dir);
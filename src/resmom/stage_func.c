@@ -55,7 +55,13 @@
 #include "win.h"
 #else
 #include <sys/wait.h>
+#include <sys/time.h>
 #include <dirent.h>
+#include <stdarg.h>
+#include <unistd.h>
+#ifdef HAVE_SYS_SENDFILE_H
+#include <sys/sendfile.h>
+#endif
 #include "tpp.h"
 #endif
 #include "pbs_ifl.h"
@@ -67,6 +73,7 @@
 #include "batch_request.h"
 #include "pbs_nodes.h"
 #include "mom_func.h"
+#include "pbs_idcache.h"
 
 /**
  * @file	stage_func.c
@@ -90,6 +97,29 @@ extern char mom_host[PBS_MAXHOSTNAME+1];	/* MoM host name */
 
 int stage_file(int, int, char *, struct rqfpair *, int, cpy_files *, char *);
 static int sys_copy(int, int, char *, char *, struct rqfpair *, int, char *);
+static int copy_file_done(int, char *, char *, struct rqfpair *, cpy_files *, int, int);
+static void stage_file_cleanup(cpy_files *);
+#ifndef WIN32
+static int stage_copy_start(int, int, char *, char *, char *, struct rqfpair *, int, cpy_files *, char *);
+static int stage_copy_reap(cpy_files *);
+
+/*
+ * A remote copy handed to a child process when $stage_parallel allows
+ * more than one transfer at a time.  The copy is finished by
+ * copy_file_done() once the child is reaped.
+ */
+struct stage_copy {
+	pid_t		sc_pid;			/* child running sys_copy() */
+	int		sc_dir;			/* STAGE_DIR_IN or STAGE_DIR_OUT */
+	int		sc_from_spool;		/* stage_inout->from_spool at start */
+	struct rqfpair	*sc_pair;		/* file pair being copied */
+	time_t		sc_start;		/* when the copy was started */
+	char		sc_src[MAXPATHLEN+1];	/* source as given to copy_file() */
+	char		sc_dest[MAXPATHLEN+1];	/* stage in destination */
+};
+static struct stage_copy *stage_copies = NULL;	/* copies in flight */
+static int stage_copies_num = 0;		/* entries used in stage_copies */
+#endif
 
 /**
  * A path in windows is not case sensitive so do a define
@@ -774,12 +804,9 @@ pbs_glob(char *filen, char *pat)
 int
 copy_file(int dir, int rmtflag, char *owner, char *src, struct rqfpair *pair, int conn, cpy_files *stage_inout, char *prmt)
 {
-	int rc = 0;
 	int ret = 0;
-	int len = 0;
 	struct stat buf = {0};
 	char dest[MAXPATHLEN+1] = {'\0'};
-	char src_file[MAXPATHLEN+1] = {'\0'};
 
 	/*
 	 ** The destination is calcluated for a stagein so it can
@@ -803,8 +830,47 @@ copy_file(int dir, int rmtflag, char *owner, char *src, struct rqfpair *pair, in
 			strcpy(dest, pair->fp_local);
 	}
 
+#ifndef WIN32
+	/* remote copies may run side by side, see stage_copy_start() */
+	if ((rmtflag != 0) && (stage_parallel > 1) && (cred_pipe == -1))
+		return (stage_copy_start(dir, rmtflag, owner, src, dest,
+			pair, conn, stage_inout, prmt));
+#endif
+
 	ret = sys_copy(dir, rmtflag, owner, src, pair, conn, prmt);
 
+	return (copy_file_done(dir, src, dest, pair, stage_inout,
+		stage_inout->from_spool, ret));
+}
+
+/**
+ * @brief
+ *	copy_file_done - Finish a single staging file copy once sys_copy()
+ *	has returned: remove a staged out file, remember a staged in file
+ *	or record the failure in the bad list.
+ *
+ * @param[in]		dir		-	direction of copy
+ * @param[in]		src		-	path to source is stageout else local file name
+ * @param[in]		dest		-	local destination of a stage in
+ * @param[in]		pair		-	file pair being copied
+ * @param[in/out]	stage_inout	-	pointer to cpy_files struct
+ * @param[in]		from_spool	-	source is in the spool directory
+ * @param[in]		ret		-	status returned by sys_copy()
+ *
+ * @return	int
+ * @retval	0 - all OK
+ * @retval	!0 - error
+ *
+ * @note	The error output of the copy is taken from the file named by
+ *		the global rcperr, which is removed before returning.
+ */
+static int
+copy_file_done(int dir, char *src, char *dest, struct rqfpair *pair, cpy_files *stage_inout, int from_spool, int ret)
+{
+	int rc = 0;
+	int len = 0;
+	char src_file[MAXPATHLEN+1] = {'\0'};
+
 	if (ret == 0) {
 		/*
 		 ** Copy worked.  If old behavior is used, a stageout file
@@ -923,7 +989,7 @@ copy_file(int dir, int rmtflag, char *owner, char *src, struct rqfpair *pair, in
 			rc = -1;
 		else {
 #ifndef NO_SPOOL_OUTPUT
-			if (stage_inout->from_spool == 1) {	/* copy out of spool */
+			if (from_spool == 1) {	/* copy out of spool */
 				char	undelname[MAXPATHLEN+1];
 
 				len = strlen(path_spool);
@@ -953,6 +1019,200 @@ copy_file(int dir, int rmtflag, char *owner, char *src, struct rqfpair *pair, in
 	return rc;
 }
 
+#ifndef WIN32
+/**
+ * @brief
+ *	stage_copy_start - Start a remote copy in a child process so that up
+ *	to $stage_parallel transfers, each with its own retries, run at once.
+ *	When the pool is full the oldest finished copy is collected first.
+ *
+ * @param[in]		dir		-	direction of copy
+ * @param[in]		rmtflag		-	is remote file copy
+ * @param[in]		owner		-	username for owner of copy request
+ * @param[in]		src		-	path to source is stageout else local file name
+ * @param[in]		dest		-	local destination of a stage in
+ * @param[in]		pair		-	file pair being copied
+ * @param[in]		conn		-	socket on which request is received
+ * @param[in/out]	stage_inout	-	pointer to cpy_files struct
+ * @param[in]		prmt		-	path to destination if stageout else source path
+ *
+ * @return	int
+ * @retval	0 - copy started, no earlier copy failed
+ * @retval	!0 - an earlier stage in failed, this copy was not started
+ *
+ */
+static int
+stage_copy_start(int dir, int rmtflag, char *owner, char *src, char *dest, struct rqfpair *pair, int conn, cpy_files *stage_inout, char *prmt)
+{
+	int rc = 0;
+	int ret = 0;
+	pid_t pid;
+	struct stage_copy *psc;
+
+	if (stage_copies == NULL) {
+		stage_copies = calloc(stage_parallel, sizeof(struct stage_copy));
+		if (stage_copies == NULL) {
+			log_err(ENOMEM, __func__, "Out of Memory!");
+			ret = sys_copy(dir, rmtflag, owner, src, pair, conn, prmt);
+			return (copy_file_done(dir, src, dest, pair, stage_inout,
+				stage_inout->from_spool, ret));
+		}
+	}
+
+	while (stage_copies_num >= stage_parallel)
+		rc |= stage_copy_reap(stage_inout);
+	if (rc != 0)
+		return rc;	/* a stage in failed, stop here */
+
+	pid = fork();
+	if (pid == 0) {
+		/* child: rcperr is named after this process */
+		ret = sys_copy(dir, rmtflag, owner, src, pair, conn, prmt);
+		if (ret > 255)
+			log_eventf(PBSEVENT_DEBUG, PBS_EVENTCLASS_FILE, LOG_DEBUG,
+				__func__, "sys_copy of %s failed with status=%d",
+				src, ret);
+		exit((ret > 255) ? 255 : ret);
+	} else if (pid < 0) {
+		log_err(errno, __func__, "fork");
+		ret = sys_copy(dir, rmtflag, owner, src, pair, conn, prmt);
+		return (copy_file_done(dir, src, dest, pair, stage_inout,
+			stage_inout->from_spool, ret));
+	}
+
+	psc = &stage_copies[stage_copies_num++];
+	psc->sc_pid = pid;
+	psc->sc_dir = dir;
+	psc->sc_from_spool = stage_inout->from_spool;
+	psc->sc_pair = pair;
+	psc->sc_start = time(NULL);
+	snprintf(psc->sc_src, sizeof(psc->sc_src), "%s", src);
+	snprintf(psc->sc_dest, sizeof(psc->sc_dest), "%s", dest);
+	log_eventf(PBSEVENT_DEBUG3, PBS_EVENTCLASS_FILE, LOG_DEBUG, __func__,
+		"started copy of %s to %s, pid %d, %d in progress",
+		(dir == STAGE_DIR_IN) ? prmt : src,
+		(dir == STAGE_DIR_IN) ? dest : prmt,
+		(int)pid, stage_copies_num);
+	return 0;
+}
+
+/**
+ * @brief
+ *	stage_copy_reap - Wait for one of the copies started by
+ *	stage_copy_start() and finish it with copy_file_done().
+ *
+ * @param[in/out]	stage_inout	-	pointer to cpy_files struct
+ *
+ * @return	int
+ * @retval	0 - copy finished, or the reaped child was not a copy
+ * @retval	!0 - a stage in failed
+ *
+ */
+static int
+stage_copy_reap(cpy_files *stage_inout)
+{
+	int i;
+	int rc = 0;
+	int ret = 0;
+	int status = 0;
+	pid_t pid;
+	struct stage_copy sc;
+
+	while (((pid = waitpid(-1, &status, 0)) == -1) && (errno == EINTR))
+		;
+	if (pid == -1) {
+		/* the children are gone, fail whatever is left */
+		ret = 20000 + errno;	/* 200xx is error on wait */
+		while (stage_copies_num > 0) {
+			sc = stage_copies[--stage_copies_num];
+			sprintf(rcperr, "%srcperr.%d", path_spool, (int)sc.sc_pid);
+			rc |= copy_file_done(sc.sc_dir, sc.sc_src, sc.sc_dest,
+				sc.sc_pair, stage_inout, sc.sc_from_spool, ret);
+		}
+		return rc;
+	}
+
+	for (i = 0; i < stage_copies_num; i++) {
+		if (stage_copies[i].sc_pid == pid)
+			break;
+	}
+	if (i == stage_copies_num)
+		return 0;
+	sc = stage_copies[i];
+	stage_copies[i] = stage_copies[--stage_copies_num];
+
+	if (WIFEXITED(status))
+		ret = WEXITSTATUS(status);
+	else if (WIFSIGNALED(status))
+		ret = 40000 + WTERMSIG(status);	/* 400xx is signaled */
+	else
+		ret = 30000;
+
+	log_eventf(PBSEVENT_DEBUG3, PBS_EVENTCLASS_FILE, LOG_DEBUG, __func__,
+		"copy of %s for %s finished, pid %d, status=%d, %ld seconds",
+		sc.sc_src, sc.sc_pair->fp_local, (int)pid, ret,
+		(long)(time(NULL) - sc.sc_start));
+
+	sprintf(rcperr, "%srcperr.%d", path_spool, (int)pid);
+	return (copy_file_done(sc.sc_dir, sc.sc_src, sc.sc_dest, sc.sc_pair,
+		stage_inout, sc.sc_from_spool, ret));
+}
+#endif
+
+/**
+ * @brief
+ *	stage_file_finish - Collect the remote copies still running after
+ *	the last stage_file() of a request.  If one of them was a failed
+ *	stage in, the files already staged in are removed.
+ *
+ * @param[in/out]	stage_inout	-	pointer to cpy_files struct
+ *
+ * @return	int
+ * @retval	0 - all OK
+ * @retval	!0 - a stage in failed
+ *
+ */
+int
+stage_file_finish(cpy_files *stage_inout)
+{
+	int rc = 0;
+
+#ifndef WIN32
+	while (stage_copies_num > 0)
+		rc |= stage_copy_reap(stage_inout);
+	if (rc != 0)
+		stage_file_cleanup(stage_inout);
+#endif
+	return rc;
+}
+
+/**
+ * @brief
+ *	stage_file_cleanup - Remove the files already staged in after
+ *	a stage in failed.
+ *
+ * @param[in/out]	stage_inout	-	pointer to cpy_files struct
+ *
+ * @return void
+ *
+ */
+static void
+stage_file_cleanup(cpy_files *stage_inout)
+{
+	int i;
+
+	for (i=0; i<stage_inout->file_num; i++) {
+		DBPRT(("%s: delete %s\n", __func__, stage_inout->file_list[i]))
+		if (remtree(stage_inout->file_list[i]) != 0 && errno != ENOENT) {
+			char	temp[80 + MAXPATHLEN];
+
+			sprintf(temp, msg_err_unlink, "stage in", stage_inout->file_list[i]);
+			log_err(errno, "req_cpyfile", temp);
+			add_bad_list(&(stage_inout->bad_list), temp, 2);
+		}
+	}
+}
+
 /**
  * @brief
  *	stage_file - Handle file stage pair. The source could have a wildcard
@@ -977,7 +1237,6 @@ int
 stage_file(int dir, int	rmtflag, char *owner, struct rqfpair *pair, int conn, cpy_files *stage_inout, char *prmt)
 {
 	char *ps = NULL;
-	int i = 0;
 	int rc = 0;
 	int len = 0;
 	char dname[MAXPATHLEN+1] = {'\0'};
@@ -1161,17 +1420,9 @@ stage_file(int dir, int	rmtflag, char *owner, struct rqfpair *pair, int conn, cp
 	return 0;
 
 error:
-	/* delete all the files in the list */
-	for (i=0; i<stage_inout->file_num; i++) {
-		DBPRT(("%s: delete %s\n", __func__, stage_inout->file_list[i]))
-		if (remtree(stage_inout->file_list[i]) != 0 && errno != ENOENT) {
-			char	temp[80 + MAXPATHLEN];
-
-			sprintf(temp, msg_err_unlink, "stage in", stage_inout->file_list[i]);
-			log_err(errno, "req_cpyfile", temp);
-			add_bad_list(&(stage_inout->bad_list), temp, 2);
-		}
-	}
+	/* let copies still running finish, then delete all the files in the list */
+	if (stage_file_finish(stage_inout) == 0)
+		stage_file_cleanup(stage_inout);
 	return rc;
 }
 
@@ -1403,6 +1654,406 @@ is_pbs_rcp_path(void)
 	return (0);
 }
 #endif
+#ifndef WIN32
+/*
+ * State of one in-process local copy, see local_copy().
+ */
+struct local_copy {
+	int		lc_errfd;	/* rcperr file, -1 if it could not be opened */
+	int		lc_topset;	/* lc_topdev/lc_topino are set */
+	dev_t		lc_topdev;	/* first directory created by the copy */
+	ino_t		lc_topino;
+	long		lc_files;	/* number of files copied */
+	long long	lc_bytes;	/* number of bytes copied */
+};
+
+/**
+ * @brief
+ *	local_copy_err - Write a message in the style of cp(1) to the rcperr
+ *	file so copy_file() passes it on to the user as it did for /bin/cp.
+ *
+ * @param[in]	plc	-	local copy state
+ * @param[in]	err	-	errno to append, 0 for none
+ * @param[in]	fmt	-	printf style format of the message
+ *
+ * @return	int
+ * @retval	1 - always, the copy failed
+ *
+ */
+static int
+local_copy_err(struct local_copy *plc, int err, const char *fmt, ...)
+{
+	char buf[2 * MAXPATHLEN + 128];
+	va_list args;
+	int len;
+
+	if (plc->lc_errfd == -1)
+		return 1;
+	len = snprintf(buf, sizeof(buf), "cp: ");
+	va_start(args, fmt);
+	len += vsnprintf(buf + len, sizeof(buf) - len, fmt, args);
+	va_end(args);
+	if (len > (int)sizeof(buf) - 64)
+		len = sizeof(buf) - 64;
+	if (err != 0)
+		len += snprintf(buf + len, sizeof(buf) - len, ": %s", strerror(err));
+	buf[len++] = '\n';
+	if (write(plc->lc_errfd, buf, len) != len)
+		log_err(errno, __func__, "write");
+	return 1;
+}
+
+/**
+ * @brief
+ *	local_copy_data - Copy the content of one open file to another.
+ *	The copy is done in the kernel with copy_file_range(2) or sendfile(2)
+ *	where the file systems allow it, otherwise through a buffer.
+ *
+ * @param[in]	ifd	-	file to read
+ * @param[in]	ofd	-	file to write
+ * @param[in]	size	-	expected size of the input
+ * @param[out]	copied	-	number of bytes copied
+ *
+ * @return	int
+ * @retval	0 - success
+ * @retval	-1 - failure, errno is set
+ *
+ */
+static int
+local_copy_data(int ifd, int ofd, off_t size, long long *copied)
+{
+	static char buf[64 * 1024];
+	ssize_t n;
+	ssize_t w;
+	ssize_t off;
+	off_t left = size;
+
+	*copied = 0;
+#ifdef HAVE_COPY_FILE_RANGE
+	while (left > 0) {
+		n = copy_file_range(ifd, NULL, ofd, NULL, left, 0);
+		if (n > 0) {
+			left -= n;
+			*copied += n;
+		} else if (n == 0) {
+			break;
+		} else if (errno != EINTR) {
+			if ((errno == EXDEV) || (errno == ENOSYS) ||
+				(errno == EINVAL) || (errno == EOPNOTSUPP))
+				break;	/* not here, try the next way */
+			return -1;
+		}
+	}
+#endif
+#ifdef HAVE_SENDFILE
+	while (left > 0) {
+		n = sendfile(ofd, ifd, NULL, left);
+		if (n > 0) {
+			left -= n;
+			*copied += n;
+		} else if (n == 0) {
+			break;
+		} else if (errno != EINTR) {
+			if ((errno == ENOSYS) || (errno == EINVAL))
+				break;	/* not here, try the next way */
+			return -1;
+		}
+	}
+#endif
+	/* whatever is left, including data past the expected size */
+	for (;;) {
+		n = read(ifd, buf, sizeof(buf));
+		if (n == 0)
+			break;
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			return -1;
+		}
+		for (off = 0; off < n; off += w) {
+			w = write(ofd, buf + off, n - off);
+			if (w < 0) {
+				if (errno == EINTR) {
+					w = 0;
+					continue;
+				}
+				return -1;
+			}
+		}
+		*copied += n;
+	}
+	return 0;
+}
+
+/**
+ * @brief
+ *	local_copy_attrs - Give a copy the mode, owner and times of its
+ *	source as "cp -p" does.  Failing to set the owner is not an error,
+ *	the set-id bits are dropped instead.
+ *
+ * @param[in]	plc	-	local copy state
+ * @param[in]	fd	-	open copy, or -1 to use the path
+ * @param[in]	to	-	path of the copy
+ * @param[in]	psb	-	stat of the source
+ *
+ * @return	int
+ * @retval	0 - success
+ * @retval	1 - failure, reported in rcperr
+ *
+ */
+static int
+local_copy_attrs(struct local_copy *plc, int fd, char *to, struct stat *psb)
+{
+	struct timespec	times[2];
+	mode_t mode = psb->st_mode & 07777;
+	int rc;
+
+	if (fd != -1)
+		rc = fchown(fd, psb->st_uid, psb->st_gid);
+	else
+		rc = chown(to, psb->st_uid, psb->st_gid);
+	if (rc == -1)
+		mode &= ~(S_ISUID | S_ISGID);
+
+	if (((fd != -1) ? fchmod(fd, mode) : chmod(to, mode)) == -1)
+		return (local_copy_err(plc, errno, "preserving permissions for '%s'", to));
+
+	times[0] = psb->st_atim;
+	times[1] = psb->st_mtim;
+	if (((fd != -1) ? futimens(fd, times) : utimensat(AT_FDCWD, to, times, 0)) == -1)
+		return (local_copy_err(plc, errno, "preserving times for '%s'", to));
+	return 0;
+}
+
+static int local_copy_tree(struct local_copy *, char *, char *);
+
+/**
+ * @brief
+ *	local_copy_dir - Copy a directory and everything below it.  Like
+ *	cp, the copy goes on after an error and reports failure at the end.
+ *
+ * @param[in]	plc	-	local copy state
+ * @param[in]	from	-	source directory
+ * @param[in]	to	-	destination directory, need not exist
+ * @param[in]	psb	-	stat of the source
+ * @param[in]	pdb	-	stat of the destination, NULL if there is none
+ *
+ * @return	int
+ * @retval	0 - success
+ * @retval	1 - failure, reported in rcperr
+ *
+ */
+static int
+local_copy_dir(struct local_copy *plc, char *from, char *to, struct stat *psb, struct stat *pdb)
+{
+	DIR *dirp;
+	struct dirent *pdirent;
+	struct stat sb;
+	char sub_from[MAXPATHLEN+1];
+	char sub_to[MAXPATHLEN+1];
+	int rc = 0;
+
+	if (pdb == NULL) {
+		if (mkdir(to, S_IRWXU) == -1)
+			return (local_copy_err(plc, errno, "cannot create directory '%s'", to));
+		if ((plc->lc_topset == 0) && (stat(to, &sb) == 0)) {
+			plc->lc_topset = 1;
+			plc->lc_topdev = sb.st_dev;
+			plc->lc_topino = sb.st_ino;
+		}
+	} else if (!S_ISDIR(pdb->st_mode)) {
+		return (local_copy_err(plc, 0,
+			"cannot overwrite non-directory '%s' with directory '%s'", to, from));
+	}
+
+	if ((dirp = opendir(from)) == NULL)
+		return (local_copy_err(plc, errno, "cannot access '%s'", from));
+	while (errno = 0, (pdirent = readdir(dirp)) != NULL) {
+		if ((strcmp(pdirent->d_name, ".") == 0) ||
+			(strcmp(pdirent->d_name, "..") == 0))
+			continue;
+		if ((snprintf(sub_from, sizeof(sub_from), "%s/%s", from, pdirent->d_name) >= (int)sizeof(sub_from)) ||
+			(snprintf(sub_to, sizeof(sub_to), "%s/%s", to, pdirent->d_name) >= (int)sizeof(sub_to))) {
+			rc |= local_copy_err(plc, ENAMETOOLONG, "cannot copy '%s/%s'", from, pdirent->d_name);
+			continue;
+		}
+		rc |= local_copy_tree(plc, sub_from, sub_to);
+	}
+	if (errno != 0)
+		rc |= local_copy_err(plc, errno, "cannot read directory '%s'", from);
+	(void)closedir(dirp);
+
+	rc |= local_copy_attrs(plc, -1, to, psb);
+	return rc;
+}
+
+/**
+ * @brief
+ *	local_copy_reg - Copy a regular file.
+ *
+ * @param[in]	plc	-	local copy state
+ * @param[in]	from	-	source file
+ * @param[in]	to	-	destination file
+ * @param[in]	psb	-	stat of the source
+ *
+ * @return	int
+ * @retval	0 - success
+ * @retval	1 - failure, reported in rcperr
+ *
+ */
+static int
+local_copy_reg(struct local_copy *plc, char *from, char *to, struct stat *psb)
+{
+	int ifd;
+	int ofd;
+	int rc = 0;
+	long long copied = 0;
+
+	if ((ifd = open(from, O_RDONLY)) == -1)
+		return (local_copy_err(plc, errno, "cannot open '%s' for reading", from));
+	if ((ofd = open(to, O_WRONLY | O_CREAT | O_TRUNC, psb->st_mode & 0777)) == -1) {
+		rc = local_copy_err(plc, errno, "cannot create regular file '%s'", to);
+		(void)close(ifd);
+		return rc;
+	}
+
+	if (local_copy_data(ifd, ofd, psb->st_size, &copied) == -1)
+		rc = local_copy_err(plc, errno, "error copying '%s' to '%s'", from, to);
+	else
+		rc = local_copy_attrs(plc, ofd, to, psb);
+	(void)close(ifd);
+	if (close(ofd) == -1)
+		rc = local_copy_err(plc, errno, "error writing '%s'", to);
+
+	plc->lc_files++;
+	plc->lc_bytes += copied;
+	log_eventf(PBSEVENT_DEBUG4, PBS_EVENTCLASS_FILE, LOG_DEBUG, __func__,
+		"%s to %s: %lld bytes%s", from, to, copied, rc ? ", failed" : "");
+	return rc;
+}
+
+/**
+ * @brief
+ *	local_copy_tree - Copy one file system object, recursing into
+ *	directories.  Symbolic links are copied as links, as "cp -r" does.
+ *
+ * @param[in]	plc	-	local copy state
+ * @param[in]	from	-	source path
+ * @param[in]	to	-	destination path
+ *
+ * @return	int
+ * @retval	0 - success
+ * @retval	1 - failure, reported in rcperr
+ *
+ */
+static int
+local_copy_tree(struct local_copy *plc, char *from, char *to)
+{
+	struct stat sb;
+	struct stat db;
+	struct timespec	times[2];
+	char link[MAXPATHLEN+1];
+	ssize_t len;
+	int have_dest;
+
+	if (lstat(from, &sb) == -1)
+		return (local_copy_err(plc, errno, "cannot stat '%s'", from));
+	have_dest = (lstat(to, &db) == 0);
+	if (have_dest && (sb.st_dev == db.st_dev) && (sb.st_ino == db.st_ino))
+		return (local_copy_err(plc, 0, "'%s' and '%s' are the same file", from, to));
+
+	if (S_ISDIR(sb.st_mode)) {
+		if (plc->lc_topset && (sb.st_dev == plc->lc_topdev) &&
+			(sb.st_ino == plc->lc_topino))
+			return (local_copy_err(plc, 0,
+				"cannot copy a directory, '%s', into itself", from));
+		return (local_copy_dir(plc, from, to, &sb, have_dest ? &db : NULL));
+	}
+	if (have_dest && S_ISDIR(db.st_mode))
+		return (local_copy_err(plc, 0,
+			"cannot overwrite directory '%s' with non-directory", to));
+	if (S_ISREG(sb.st_mode))
+		return (local_copy_reg(plc, from, to, &sb));
+
+	if (S_ISLNK(sb.st_mode)) {
+		if ((len = readlink(from, link, sizeof(link) - 1)) == -1)
+			return (local_copy_err(plc, errno, "cannot read symbolic link '%s'", from));
+		link[len] = '\0';
+		if (have_dest)
+			(void)unlink(to);
+		if (symlink(link, to) == -1)
+			return (local_copy_err(plc, errno, "cannot create symbolic link '%s'", to));
+		times[0] = sb.st_atim;
+		times[1] = sb.st_mtim;
+		(void)utimensat(AT_FDCWD, to, times, AT_SYMLINK_NOFOLLOW);
+		return 0;
+	}
+	if (S_ISFIFO(sb.st_mode)) {
+		if (have_dest)
+			(void)unlink(to);
+		if (mkfifo(to, sb.st_mode & 0777) == -1)
+			return (local_copy_err(plc, errno, "cannot create fifo '%s'", to));
+		return (local_copy_attrs(plc, -1, to, &sb));
+	}
+	return (local_copy_err(plc, 0, "cannot copy special file '%s'", from));
+}
+
+/**
+ * @brief
+ *	local_copy - Do the work of "cp -rp from to" in this process.
+ *	Errors are written to the rcperr file as cp would have written them.
+ *
+ * @param[in]	from	-	source path
+ * @param[in]	to	-	destination path, when it is an existing
+ *				directory the copy is made inside it
+ *
+ * @return	int
+ * @retval	0 - success
+ * @retval	1 - failure
+ *
+ */
+static int
+local_copy(char *from, char *to)
+{
+	struct local_copy lc = {0};
+	struct stat sb;
+	struct timeval start;
+	struct timeval stop;
+	char name[MAXPATHLEN+1];
+	char target[MAXPATHLEN+1];
+	char *base;
+	int rc = 0;
+
+	(void)gettimeofday(&start, NULL);
+	lc.lc_errfd = open(rcperr, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+	snprintf(target, sizeof(target), "%s", to);
+	if ((stat(to, &sb) == 0) && S_ISDIR(sb.st_mode)) {
+		/* put the copy inside the directory under the source's name */
+		snprintf(name, sizeof(name), "%s", from);
+		for (base = name + strlen(name) - 1; (base > name) && (*base == '/'); base--)
+			*base = '\0';
+		base = strrchr(name, '/');
+		base = (base != NULL) ? base + 1 : name;
+		if (snprintf(target, sizeof(target), "%s/%s", to, base) >= (int)sizeof(target))
+			rc = local_copy_err(&lc, ENAMETOOLONG, "cannot copy '%s' to '%s'", from, to);
+	}
+	if (rc == 0)
+		rc = local_copy_tree(&lc, from, target);
+
+	if (lc.lc_errfd != -1)
+		(void)close(lc.lc_errfd);
+
+	(void)gettimeofday(&stop, NULL);
+	log_eventf(PBSEVENT_DEBUG3, PBS_EVENTCLASS_FILE, LOG_DEBUG, __func__,
+		"%s to %s: %ld files, %lld bytes in %ld ms, status=%d",
+		from, target, lc.lc_files, lc.lc_bytes,
+		(long)((stop.tv_sec - start.tv_sec) * 1000 +
+		(stop.tv_usec - start.tv_usec) / 1000), rc);
+	return rc;
+}
+#endif
+
 /**
  * @brief
  *	sys_copy
@@ -1413,7 +2064,8 @@ is_pbs_rcp_path(void)
  *	for local copy and "pbs_rcp" for remote copy.
  *	If there is an error in the copy and pbs_rcp is used, it will try with scp.
  *
- *	In *nix, use "cp" for local copy and "scp"/"rcp" for remote copy.
+ *	In *nix, local copies are made in this process by local_copy(), which
+ *	does what "cp -rp" would, and "scp"/"rcp" is used for remote copy.
  *	If there is an error in the copy and scp is used, it will try with rcp.
  *
  *	If there is an error, the copy will be retried 3 additional times.
@@ -1476,6 +2128,7 @@ sys_copy(int dir, int rmtflg, char *owner, char *src, struct rqfpair *pair, int
 #else
 	int		i;
 	ssize_t		len;
+	pid_t		pid;
 #endif
 
 	DBPRT(("%s: %s %s copy %s of %s\n", __func__, owner,
@@ -1497,7 +2150,7 @@ sys_copy(int dir, int rmtflg, char *owner, char *src, struct rqfpair *pair, int
 	si.cb = sizeof(si);
 	si.lpDesktop = PBS_DESKTOP_NAME;
 
-	if ((pw = getpwnam(owner)) == NULL) {
+	if ((pw = idcache_getpwnam(owner)) == NULL) {
 		log_errf(-1, __func__, "Failed to get %s password", owner);
 		rc = PBSE_BADUSER;
 		goto sys_copy_end;
@@ -1659,7 +2312,13 @@ sys_copy(int dir, int rmtflg, char *owner, char *src, struct rqfpair *pair, int
 
 		DBPRT(("%s: %s %s %s %s\n", __func__, ag0, ag1, ag2, ag3))
 
-		if ((rc = fork()) > 0) {
+		if (rmtflg == 0) {
+
+			/* local copy, no need for a cp process */
+			if ((rc = local_copy(ag2, ag3)) == 0)
+				return (0);
+
+		} else if ((rc = pid = fork()) > 0) {
 
 			/* Parent */
 			if (cred_pipe != -1) {
@@ -1668,8 +2327,8 @@ sys_copy(int dir, int rmtflg, char *owner, char *src, struct rqfpair *pair, int
 				}
 			}
 
-			/* wait for copy to complete */
-			while (((i = wait(&rc)) < 0) && (errno == EINTR)) ;
+			/* wait for copy to complete, other copies may be running */
+			while (((i = waitpid(pid, &rc, 0)) < 0) && (errno == EINTR)) ;
 			if (i == -1) {
 				rc = (20000+errno);	/* 200xx is error on wait */
 			} else if (WIFEXITED(rc)) {
@@ -94,6 +94,7 @@
 #include "placementsets.h"
 #include "pbs_internal.h"
 #include "pbs_reliable.h"
+#include "pbs_idcache.h"
 
 #include "renew_creds.h"
 
@@ -275,7 +276,7 @@ check_pwd(job *pjob)
 	struct group		*grpp;
 	struct stat		sb;
 
-	pwdp = getpwnam(pjob->ji_wattr[(int)JOB_ATR_euser].at_val.at_str);
+	pwdp = idcache_getpwnam(pjob->ji_wattr[(int)JOB_ATR_euser].at_val.at_str);
 	if (pwdp == NULL) {
 		(void)sprintf(log_buffer, "No Password Entry for User %s",
 			pjob->ji_wattr[(int)JOB_ATR_euser].at_val.at_str);
@@ -311,7 +312,7 @@ check_pwd(job *pjob)
 
 		/* execution group specified - not defaulting to login group */
 
-		grpp = getgrnam(pjob->ji_wattr[(int)JOB_ATR_egroup].
+		grpp = idcache_getgrnam(pjob->ji_wattr[(int)JOB_ATR_egroup].
 			at_val.at_str);
 		if (grpp == NULL) {
 			(void)sprintf(log_buffer, "No Group Entry for Group %s",
@@ -909,7 +910,7 @@ impersonate_user(uid_t uid, gid_t gid)
 		return -1;
 
 	if ((geteuid() != uid) &&
-		(initgroups(pwd->pw_name, gid) == -1)) {
+		(idcache_initgroups(pwd->pw_name, gid) == -1)) {
 		return -1;
 	}
 
@@ -1160,7 +1161,7 @@ becomeuser_args(char *eusrname, uid_t euid, gid_t egid, gid_t rgid)
 	if (maxgroups == 0)
 		maxgroups = (int)sysconf(_SC_NGROUPS_MAX);
 
-	if (initgroups(eusrname, egid) != -1) {
+	if (idcache_initgroups(eusrname, egid) != -1) {
 		int numsup;
 		int i;
 
@@ -5294,6 +5295,8 @@ nodes_free(job *pj)
 		free(pj->ji_hosts);
 		pj->ji_hosts = NULL;
 	}
+
+	im_relay_free(pj);
 }
 
 /**
@@ -187,6 +187,8 @@
 #define NUM_PPRIO 20
 #define NUM_PEERS 50
 #define MAX_DEF_REPLY 5
+#define MAX_RUNJOB_LIST 512	/* run requests sent to the server in one list */
+#define MAX_ATTR_UPDATE_LIST 512	/* jobs' attribute updates sent in one list */
 #define MAX_PTIME_SIZE 64
 
 /* resource names for sorting special cases */
@@ -66,6 +66,7 @@
  * 	find_susp_job()
  * 	scheduler_simulation_task()
  * 	next_job()
+ * 	flush_run_jobs()
  */
 #include <pbs_config.h>
 
@@ -83,6 +84,7 @@
 #include <libutil.h>
 #include <pbs_error.h>
 #include <pbs_ifl.h>
+#include "libpbs.h"
 #include <sched_cmds.h>
 #include <time.h>
 #include <log.h>
@@ -129,6 +131,14 @@
 static prev_job_info *last_running = NULL;
 static int last_running_size = 0;
 
+/* run requests not yet sent to the server, see send_run_job() */
+static struct {
+	int sd;
+	int count;
+	char *jobids[MAX_RUNJOB_LIST];
+	char *execvnodes[MAX_RUNJOB_LIST];
+} run_list = {-1, 0};
+
 extern int	second_connection;
 extern int	get_sched_cmd_noblk(int sock, int *val, char **jobid);
 
@@ -740,6 +750,10 @@ scheduling_cycle(int sd, char *jobid)
 	if (error == 0)
 		rc = main_sched_loop(policy, sd, sinfo, &err);
 
+	/* the jobs must be running before the server hears back about a qrun */
+	flush_attr_updates(NULL);
+	flush_run_jobs(NULL);
+
 	if (jobid != NULL) {
 		int def_rc = -1;
 		int i;
@@ -1173,6 +1187,9 @@ end_cycle_tasks(server_info *sinfo)
 {
 	int i;
 
+	flush_attr_updates(NULL);
+	flush_run_jobs(NULL);
+
 	/* keep track of update used resources for fairshare */
 	if (sinfo != NULL && sinfo->policy->fair_share)
 		update_last_running(sinfo);
@@ -1304,12 +1321,93 @@ update_job_can_not_run(int pbs_sd, resource_resv *job, schd_error *err)
 static int
 send_run_job(int pbs_sd, int has_runjob_hook, char *jobid, char *execvnode)
 {
+	char *jid;
+	char *evnode;
+
+	/* updates made to the job before it was run go first */
+	flush_attr_updates(jobid);
+
 	if (sc_attrs.runjob_mode == RJ_EXECJOB_HOOK)
 		return pbs_runjob(pbs_sd, jobid, execvnode, NULL);
 	else if ((sc_attrs.runjob_mode == RJ_RUNJOB_HOOK) && has_runjob_hook)
 		return pbs_asyrunjob_ack(pbs_sd, jobid, execvnode, NULL);
-	else
+
+	/* nothing waits on this run's result, so queue it up to go with the others */
+	if (run_list.count > 0 && run_list.sd != pbs_sd)
+		flush_run_jobs(NULL);
+
+	jid = strdup(jobid);
+	evnode = strdup(execvnode);
+	if (jid == NULL || evnode == NULL) {
+		free(jid);
+		free(evnode);
 		return pbs_asyrunjob(pbs_sd, jobid, execvnode, NULL);
+	}
+	run_list.sd = pbs_sd;
+	run_list.jobids[run_list.count] = jid;
+	run_list.execvnodes[run_list.count] = evnode;
+	run_list.count++;
+
+	if (run_list.count == MAX_RUNJOB_LIST)
+		flush_run_jobs(NULL);
+
+	return 0;
+}
+
+/**
+ * @brief	Send the queued up job_run_wait=none runs to the server as one list
+ *
+ * @par
+ *	Called before anything else is sent to the server that should see
+ *	those jobs running, and at the end of the cycle.  This waits for the
+ *	server's reply, one result code per job, but not for the jobs to
+ *	start on their moms.  A job the server would not run is logged, it
+ *	is picked up again next cycle.
+ *
+ * @param[in]	jobid	-	only send if this job is queued up, NULL to always send
+ *
+ * @return	void
+ */
+void
+flush_run_jobs(char *jobid)
+{
+	int i;
+	int *codes;
+
+	if (run_list.count == 0)
+		return;
+
+	if (jobid != NULL) {
+		for (i = 0; i < run_list.count; i++)
+			if (strcmp(run_list.jobids[i], jobid) == 0)
+				break;
+		if (i == run_list.count)
+			return;
+	}
+
+	codes = malloc(run_list.count * sizeof(int));
+	if (codes == NULL) {
+		log_err(errno, __func__, MEM_ERR_MSG);
+		/* still have the jobs run, one request at a time */
+		for (i = 0; i < run_list.count; i++)
+			pbs_asyrunjob(run_list.sd, run_list.jobids[i], run_list.execvnodes[i], NULL);
+	} else {
+		PBSD_runjob_list(run_list.sd, run_list.count, run_list.jobids,
+			run_list.execvnodes, codes);
+		for (i = 0; i < run_list.count; i++) {
+			if (codes[i] != PBSE_NONE)
+				log_eventf(PBSEVENT_SCHED, PBS_EVENTCLASS_JOB, LOG_WARNING,
+					run_list.jobids[i], "Server could not run job: %s",
+					pbse_to_txt(codes[i]));
+		}
+	}
+
+	for (i = 0; i < run_list.count; i++) {
+		free(run_list.jobids[i]);
+		free(run_list.execvnodes[i]);
+	}
+	free(codes);
+	run_list.count = 0;
 }
 
 /**
@@ -1508,6 +1606,7 @@ run_update_resresv(status *policy, int pbs_sd, server_info *sinfo,
 	pbs_errno = PBSE_NONE;
 	if (resresv->is_job && resresv->job->is_suspended) {
 		if (pbs_sd != SIMULATE_SD) {
+			flush_run_jobs(NULL);
 			pbsrc = pbs_sigjob(pbs_sd, resresv->name, "resume", NULL);
 			if (!pbsrc)
 				ret = 1;
@@ -183,6 +183,12 @@ int add_job_to_calendar(int pbs_sd, status *policy, server_info *sinfo, resource
  */
 int run_job(int pbs_sd, resource_resv *rjob, char *execvnode, int had_runjob_hook, schd_error *err);
 
+/*
+ *	flush_run_jobs - send the queued up job_run_wait=none runs to the server
+ *			 jobid: only send if this job is queued up, NULL to always send
+ */
+void flush_run_jobs(char *jobid);
+
 /*
  *	should_backfill_with_job - should we call add_job_to_calendar() with job
  *	returns 1: we should backfill 0: we should not
@@ -52,6 +52,8 @@
  * 	update_job_attr()
  * 	send_job_updates()
  * 	send_attr_updates()
+ * 	queue_attr_updates()
+ * 	flush_attr_updates()
  * 	unset_job_attr()
  * 	update_job_comment()
  * 	update_jobs_cant_run()
@@ -100,6 +102,7 @@
 #include <sys/types.h>
 #include <math.h>
 #include <pbs_ifl.h>
+#include <libpbs.h>
 #include <log.h>
 #include <libutil.h>
 #include <pbs_share.h>
@@ -134,6 +137,16 @@
 
 extern char *pbse_to_txt(int err);
 
+/* attribute updates not yet sent to the server, see send_job_updates() */
+static struct {
+	int sd;
+	int count;
+	char *jobids[MAX_ATTR_UPDATE_LIST];
+	struct attrl *attrs[MAX_ATTR_UPDATE_LIST];
+} update_list = {-1, 0};
+
+static int queue_attr_updates(int pbs_sd, char *job_name, struct attrl *pattr);
+
 /**
  *	This table contains job comment and information messages that correspond
  *	to the sched_error enums in "constant.h".  The order of the strings in
@@ -1807,6 +1820,11 @@ int send_job_updates(int pbs_sd, resource_resv *job)
 			return 0;
 	}
 
+	if (queue_attr_updates(pbs_sd, job->name, job->job->attr_updates)) {
+		job->job->attr_updates = NULL;
+		return 1;
+	}
+
 	rc = send_attr_updates(pbs_sd, job->name, job->job->attr_updates);
 
 	free_attrl_list(job->job->attr_updates);
@@ -1814,6 +1832,97 @@ int send_job_updates(int pbs_sd, resource_resv *job)
 	return rc;
 }
 
+/**
+ * @brief
+ * 		queue up a job's attribute updates to be sent to the server
+ *		with those of other jobs by flush_attr_updates()
+ *
+ * @param[in]	pbs_sd	-	server connection descriptor
+ * @param[in]	job_name	-	name of the job
+ * @param[in]	pattr	-	attrl list to update on the server
+ *
+ * @return	int
+ * @retval	1	the updates were queued, the list now belongs to the queue
+ * @retval	0	the updates were not queued, caller has to send them
+ */
+static int
+queue_attr_updates(int pbs_sd, char *job_name, struct attrl *pattr)
+{
+	char *jid;
+
+	if (job_name == NULL || pattr == NULL || pbs_sd == SIMULATE_SD)
+		return 0;
+
+	if (update_list.count > 0 && update_list.sd != pbs_sd)
+		flush_attr_updates(NULL);
+
+	if ((jid = strdup(job_name)) == NULL) {
+		log_err(errno, __func__, MEM_ERR_MSG);
+		return 0;
+	}
+	update_list.sd = pbs_sd;
+	update_list.jobids[update_list.count] = jid;
+	update_list.attrs[update_list.count] = pattr;
+	update_list.count++;
+
+	if (update_list.count == MAX_ATTR_UPDATE_LIST)
+		flush_attr_updates(NULL);
+
+	return 1;
+}
+
+/**
+ * @brief
+ * 		send the queued up attribute updates to the server as one list
+ *
+ * @par
+ *		The queued up runs are sent first so no job is altered before it
+ *		is run.  The server does not reply to the list, it applies each
+ *		job's updates on its own like an async alterjob.
+ *
+ * @param[in]	jobid	-	only send if this job is queued up, NULL to always send
+ *
+ * @return	void
+ */
+void
+flush_attr_updates(char *jobid)
+{
+	int i;
+
+	if (update_list.count == 0)
+		return;
+
+	if (jobid != NULL) {
+		for (i = 0; i < update_list.count; i++)
+			if (strcmp(update_list.jobids[i], jobid) == 0)
+				break;
+		if (i == update_list.count)
+			return;
+	}
+
+	flush_run_jobs(NULL);
+
+	if (PBSD_modifyjob_list(update_list.sd, update_list.count,
+			update_list.jobids, update_list.attrs) == 0)
+		last_attr_updates = time(NULL);
+	else {
+		char *errbuf;
+
+		errbuf = pbs_geterrmsg(update_list.sd);
+		if (errbuf == NULL)
+			errbuf = "";
+		log_eventf(PBSEVENT_SCHED, PBS_EVENTCLASS_SCHED, LOG_WARNING, __func__,
+			"Failed to update attributes of %d jobs: %s (%d)",
+			update_list.count, errbuf, pbs_errno);
+	}
+
+	for (i = 0; i < update_list.count; i++) {
+		free(update_list.jobids[i]);
+		free_attrl_list(update_list.attrs[i]);
+	}
+	update_list.count = 0;
+}
+
 
 /**
  * @brief
@@ -1842,6 +1951,10 @@ send_attr_updates(int pbs_sd, char *job_name, struct attrl *pattr)
 	if (pattr->next == NULL)
 		one_attr = 1;
 
+	/* the job has to run before it is altered, and take earlier updates first */
+	flush_run_jobs(job_name);
+	flush_attr_updates(job_name);
+
 	if (pbs_asyalterjob(pbs_sd, job_name, pattr, NULL) == 0) {
 		last_attr_updates = time(NULL);
 		return 1;
@@ -3083,6 +3196,7 @@ find_and_preempt_jobs(status *policy, int pbs_sd, resource_resv *hjob, server_in
 			}
 		}
 
+		flush_run_jobs(NULL);
 		if ((preempt_jobs_reply = pbs_preempt_jobs(pbs_sd, preempt_jobs_list)) == NULL) {
 			free_string_array(preempt_jobs_list);
 			free(preempted_list);
@@ -92,6 +92,9 @@ int send_job_updates(int pbs_sd, resource_resv *job);
 /* send delayed attributes to the server for a job */
 int send_attr_updates(int pbs_sd, char *job_name, struct attrl *pattr);
 
+/* send the queued up job attribute updates to the server as one list */
+void flush_attr_updates(char *jobid);
+
 
 /*
  *
@@ -94,7 +94,6 @@
 
 /* External data */
 extern char *msg_job_end_stat;
-extern int   resc_access_perm;
 
 /*
  * list of job attributes to copy from the parent Array job
@@ -160,6 +159,38 @@ static enum job_atr attrs_to_copy[] = {
 	JOB_ATR_LAST /* This MUST be LAST	*/
 };
 
+/*
+ * Attributes from the list above that a subjob keeps exactly as the parent
+ * has them.  They are not written to the database with the subjob; when the
+ * subjob is recovered they are copied again from the parent.
+ */
+static enum job_atr attrs_from_parent[] = {
+	JOB_ATR_jobname,
+	JOB_ATR_job_owner,
+	JOB_ATR_account,
+	JOB_ATR_grouplst,
+	JOB_ATR_join,
+	JOB_ATR_keep,
+	JOB_ATR_mailpnts,
+	JOB_ATR_mailuser,
+	JOB_ATR_remove,
+	JOB_ATR_rerunable,
+	JOB_ATR_shell,
+	JOB_ATR_sandbox,
+	JOB_ATR_stagein,
+	JOB_ATR_stageout,
+	JOB_ATR_userlst,
+	JOB_ATR_variables,
+	JOB_ATR_euser,
+	JOB_ATR_egroup,
+	JOB_ATR_umask,
+	JOB_ATR_executable,
+	JOB_ATR_Arglist,
+	JOB_ATR_project,
+	JOB_ATR_submit_host,
+	JOB_ATR_LAST /* This MUST be LAST	*/
+};
+
 /**
  * @brief
  * 			is_job_array - determines if the job id indicates
@@ -832,7 +863,6 @@ fixup_arrayindicies(attribute *pattr, void *pobj, int mode)
 job *
 create_subjob(job *parent, char *newjid, int *rc)
 {
-	pbs_list_head  attrl;
 	int	   i;
 	int	   j;
 	int	   indx;
@@ -840,7 +870,6 @@ create_subjob(job *parent, char *newjid, int *rc)
 	attribute_def *pdef;
 	attribute *ppar;
 	attribute *psub;
-	svrattrl  *psatl;
 	job 	  *subj;
 	long	   eligibletime;
 	long	    time_msec;
@@ -888,32 +917,32 @@ create_subjob(job *parent, char *newjid, int *rc)
 	subj->ji_subjindx = indx;
 
 	/*
-	 * now that is all done, copy the required attributes by
-	 * encoding and then decoding into the new array.  Then add the
-	 * subjob specific attributes.
+	 * now that is all done, copy the required attributes straight from
+	 * the parent.  Then add the subjob specific attributes.
 	 */
 
-	resc_access_perm = ATR_DFLAG_ACCESS;
-	CLEAR_HEAD(attrl);
 	for (i = 0; attrs_to_copy[i] != JOB_ATR_LAST; i++) {
 		j    = (int)attrs_to_copy[i];
 		ppar = &parent->ji_wattr[j];
 		psub = &subj->ji_wattr[j];
 		pdef = &job_attr_def[j];
 
-		if (pdef->at_encode(ppar, &attrl, pdef->at_name, NULL,
-			ATR_ENCODE_MOM, &psatl) > 0) {
-			for (psatl = (svrattrl *)GET_NEXT(attrl); psatl;
-				psatl = ((svrattrl *)GET_NEXT(psatl->al_link))) {
-				pdef->at_decode(psub, psatl->al_name, psatl->al_resc,
-					psatl->al_value);
-			}
-			/* carry forward the default bit if set */
-			psub->at_flags |= (ppar->at_flags & ATR_VFLAG_DEFLT);
-			free_attrlist(&attrl);
+		if ((ppar->at_flags & ATR_VFLAG_SET) == 0)
+			continue;
+		if (pdef->at_set(psub, ppar, SET) != 0) {
+			job_free(subj);
+			parent->ji_ajtrk->tkm_tbl[indx].trk_psubjob = NULL;
+			*rc = PBSE_SYSTEM;
+			return NULL;
 		}
+		/* carry forward the default bit if set */
+		psub->at_flags |= (ppar->at_flags & ATR_VFLAG_DEFLT);
 	}
 
+	/* the parent already has these saved, do not save them again */
+	for (i = 0; attrs_from_parent[i] != JOB_ATR_LAST; i++)
+		subj->ji_wattr[(int)attrs_from_parent[i]].at_flags &= ~ATR_VFLAG_MODIFY;
+
 	psub = &subj->ji_wattr[(int)JOB_ATR_array_id];
 	job_attr_def[(int)JOB_ATR_array_id].at_decode(psub, NULL, NULL,
 		parent->ji_qs.ji_jobid);
@@ -970,6 +999,74 @@ create_subjob(job *parent, char *newjid, int *rc)
 	return subj;
 }
 
+/**
+ * @brief
+ * 		subjob_inherit_attrs - on recovery, give a subjob the attributes
+ *		it shares with its parent Array Job, which are not saved with
+ *		the subjob itself.  See attrs_from_parent[].
+ *
+ * @param[in,out]	subj - the recovered subjob, ji_parentaj already set
+ *
+ * @return	void
+ */
+void
+subjob_inherit_attrs(job *subj)
+{
+	int	   i;
+	int	   j;
+	attribute *ppar;
+	attribute *psub;
+	job	  *parent = subj->ji_parentaj;
+
+	if (parent == NULL)
+		return;
+
+	for (i = 0; attrs_from_parent[i] != JOB_ATR_LAST; i++) {
+		j    = (int)attrs_from_parent[i];
+		ppar = &parent->ji_wattr[j];
+		psub = &subj->ji_wattr[j];
+
+		/*
+		 * a subjob saved before it shared these, or after it left the
+		 * queued state, has its own copy
+		 */
+		if ((psub->at_flags & ATR_VFLAG_SET) ||
+			((ppar->at_flags & ATR_VFLAG_SET) == 0))
+			continue;
+		if (job_attr_def[j].at_set(psub, ppar, SET) != 0) {
+			log_joberr(PBSE_SYSTEM, __func__, "unable to copy attribute from parent",
+				subj->ji_qs.ji_jobid);
+			continue;
+		}
+		psub->at_flags |= (ppar->at_flags & ATR_VFLAG_DEFLT);
+		psub->at_flags &= ~ATR_VFLAG_MODIFY;
+	}
+}
+
+/**
+ * @brief
+ * 		subjob_keep_attrs - a subjob is leaving the queued state, so have
+ *		its next save write the attributes it shares with its parent.
+ *		Recovery then keeps the values it ran with, rather than giving it
+ *		what the parent has by then.  See subjob_inherit_attrs().
+ *
+ * @param[in,out]	subj - the subjob
+ *
+ * @return	void
+ */
+void
+subjob_keep_attrs(job *subj)
+{
+	int	   i;
+	attribute *psub;
+
+	for (i = 0; attrs_from_parent[i] != JOB_ATR_LAST; i++) {
+		psub = &subj->ji_wattr[(int)attrs_from_parent[i]];
+		if (psub->at_flags & ATR_VFLAG_SET)
+			psub->at_flags |= ATR_VFLAG_MODIFY;
+	}
+}
+
 /**
  * @brief
  *	 	Duplicate the existing batch request for a running subjob
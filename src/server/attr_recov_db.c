@@ -178,15 +178,75 @@ encode_attr_db(struct attribute_def *padef, struct attribute *pattr, int numattr
  */
 int
 decode_attr_db(void *parent, pbs_db_attr_list_t *db_attr_list, void *padef_idx, struct attribute_def *padef, struct attribute *pattr, int limit, int unknown)
+{
+	return (decode_attr_db_part(parent, db_attr_list, padef_idx, padef, pattr,
+		limit, unknown, ATTR_DB_DECODE_ALL));
+}
+
+/**
+ * @brief
+ *	Can an attribute value be decoded on a worker thread?  Most decode
+ *	functions only parse the string and allocate memory, the exceptions
+ *	are listed here.
+ *
+ * @param[in]	padef - the attribute definition
+ *
+ * @return	int
+ * @retval	1 - safe to decode off the main thread
+ * @retval	0 - must be decoded on the main thread
+ */
+static int
+decode_attr_db_mt_safe(struct attribute_def *padef)
+{
+	/* entity limits are combined with at_set() as they are decoded */
+	if (padef->at_type == ATR_TYPE_ENTITY)
+		return 0;
+	/* build_depend() may look up host names */
+	if (padef->at_decode == decode_depend)
+		return 0;
+	return 1;
+}
+
+/**
+ * @brief
+ *	Decode the list of attributes from the database in steps, so that
+ *	the bulk of the decoding can be spread over threads at recovery.
+ *
+ *	ATTR_DB_DECODE_ALL is the single step done by decode_attr_db().
+ *	ATTR_DB_DECODE_MT decodes the values decode_attr_db_mt_safe() allows
+ *	and runs no action functions, several objects may be done at once
+ *	on different threads.  The caller sets resc_access_perm beforehand.
+ *	ATTR_DB_DECODE_REST must then be done on the main thread for the
+ *	same list to decode the other values and run the recovery actions.
+ *
+ * @param[in]	  parent - pointer to parent object
+ * @param[in]	  db_attr_list - Information about the database attributes
+ * @param[in]     padef_idx - Search index of this attribute array
+ * @param[in]	  padef - Address of parent's attribute definition array
+ * @param[in/out] pattr - Address of the parent objects attribute array
+ * @param[in]	  limit - Number of attributes in the list
+ * @param[in]	  unknown	- The index of the unknown attribute if any
+ * @param[in]	  part - ATTR_DB_DECODE_ALL, ATTR_DB_DECODE_MT or ATTR_DB_DECODE_REST
+ *
+ * @return      Error code
+ * @retval	 0  - Success
+ * @retval	-1  - Failure
+ *
+ */
+int
+decode_attr_db_part(void *parent, pbs_db_attr_list_t *db_attr_list, void *padef_idx, struct attribute_def *padef, struct attribute *pattr, int limit, int unknown, int part)
 {
 	int index;
+	int mt_safe;
+	int decode_here;
 	svrattrl *pal = (svrattrl *)0;
 	svrattrl *tmp_pal = (svrattrl *)0;
 	void **palarray = NULL;
 	pbs_list_head *attr_list;
 
 	if ((palarray = calloc(limit, sizeof(void *))) == NULL) {
-		log_err(-1, __func__, "Out of memory");
+		if (part != ATTR_DB_DECODE_MT)
+			log_err(-1, __func__, "Out of memory");
 		return -1;
 	}
 
@@ -194,12 +254,14 @@ decode_attr_db(void *parent, pbs_db_attr_list_t *db_attr_list, void *padef_idx,
 	/* This is a special (kludge) flag for the recovery case, see	*/
 	/* decode_resc() in lib/Libattr/attr_fn_resc.c			*/
 
-	resc_access_perm = ATR_DFLAG_ACCESS;
+	if (part != ATTR_DB_DECODE_MT)
+		resc_access_perm = ATR_DFLAG_ACCESS;
 
 	attr_list = &db_attr_list->attrs;
 
 	for (pal = (svrattrl *) GET_NEXT(*attr_list); pal != NULL; pal = (svrattrl *) GET_NEXT(pal->al_link)) {
 		/* find the attribute definition based on the name */
+		pal->al_sister = NULL;	/* the list may be sorted a second time */
 		index = find_attr(padef_idx, padef, pal->al_name);
 		if (index < 0) {
 
@@ -213,6 +275,8 @@ decode_attr_db(void *parent, pbs_db_attr_list_t *db_attr_list, void *padef_idx,
 			*/
 			if (unknown > 0) {
 				index = unknown;
+			} else if (part == ATTR_DB_DECODE_MT) {
+				continue;	/* discarded by ATTR_DB_DECODE_REST */
 			} else {
 				snprintf(log_buffer,LOG_BUF_SIZE, "unknown attribute \"%s\" discarded", pal->al_name);
 				log_err(-1, __func__, log_buffer);
@@ -253,6 +317,12 @@ decode_attr_db(void *parent, pbs_db_attr_list_t *db_attr_list, void *padef_idx,
 		 * the flag has ATR_VFLAG_SET
 		 *
 		 */
+		mt_safe = decode_attr_db_mt_safe(&padef[index]);
+		if ((part == ATTR_DB_DECODE_MT) && !mt_safe)
+			continue;	/* left for ATTR_DB_DECODE_REST */
+		decode_here = (part == ATTR_DB_DECODE_ALL) ||
+			((part == ATTR_DB_DECODE_MT) == mt_safe);
+
 		pal = palarray[index];
 		while (pal) {
 			if ((padef[index].at_type == ATR_TYPE_ENTITY) && (pattr[index].at_flags & ATR_VFLAG_SET)) {
@@ -267,8 +337,9 @@ decode_attr_db(void *parent, pbs_db_attr_list_t *db_attr_list, void *padef_idx,
 			} else {
 				if (padef[index].at_decode) {
 					int act_rc = 0;
-					padef[index].at_decode(&pattr[index], pal->al_name, pal->al_resc, pal->al_value);
-					if (padef[index].at_action)
+					if (decode_here)
+						padef[index].at_decode(&pattr[index], pal->al_name, pal->al_resc, pal->al_value);
+					if (padef[index].at_action && (part != ATTR_DB_DECODE_MT))
 						if ((act_rc = (padef[index].at_action(&pattr[index], parent, ATR_ACTION_RECOV)))) {
 							log_errf(act_rc, __func__, "Action function failed for %s attr, errn %d", (padef+index)->at_name, act_rc);
 							for ( index++; index <= limit; index++) {
@@ -491,7 +491,7 @@ dis_request_read(int sfds, struct batch_request *request)
 		return PBSE_DISPROTO;
 	}
 
-	if (proto_ver > PBS_BATCH_PROT_VER)
+	if (proto_ver > PBS_BATCH_PROT_VER_ASYNC)
 		return PBSE_DISPROTO;
 
 	/* Decode the Request Body based on the type */
@@ -537,6 +537,14 @@ dis_request_read(int sfds, struct batch_request *request)
 			rc = decode_DIS_Manage(sfds, request);
 			break;
 
+		case PBS_BATCH_ManagerList:
+			rc = decode_DIS_ManageList(sfds, request);
+			break;
+
+		case PBS_BATCH_ModifyJobList_Async:
+			rc = decode_DIS_ModifyList(sfds, request);
+			break;
+
 		case PBS_BATCH_MessJob:
 			rc = decode_DIS_MessageJob(sfds, request);
 			break;
@@ -589,6 +597,15 @@ dis_request_read(int sfds, struct batch_request *request)
 			rc = decode_DIS_Run(sfds, request);
 			break;
 
+		case PBS_BATCH_RunJobList:
+			rc = decode_DIS_RunList(sfds, request);
+			break;
+
+		case PBS_BATCH_DeleteJobList:
+		case PBS_BATCH_SignalJobList:
+			rc = decode_DIS_JobList(sfds, request);
+			break;
+
 		case PBS_BATCH_DefSchReply:
 			request->rq_ind.rq_defrpy.rq_cmd = disrsi(sfds, &rc);
 			if (rc) break;
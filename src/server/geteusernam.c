@@ -66,6 +66,7 @@
 #include "pbs_error.h"
 #include "pbs_nodes.h"
 #include "svrfunc.h"
+#include "pbs_idcache.h"
 
 /* External Data */
 
@@ -310,7 +311,7 @@ set_objexid(void *pobj, int objtype, attribute *attrry)
 	if ((puser = determine_euser(pobj, objtype, pattr, &isowner)) == NULL)
 		return (bad_euser);
 
-	pwent = getpwnam(puser);
+	pwent = idcache_getpwnam(puser);
 	if (pwent == NULL) {
 		if (!server.sv_attr[(int)SVR_ATR_FlatUID].at_val.at_long)
 			return (bad_euser);
@@ -359,7 +360,7 @@ set_objexid(void *pobj, int objtype, attribute *attrry)
 			/* user specified a group, group must exists and either	   */
 			/* must be user's primary group	 or the user must be in it */
 
-			gpent = getgrnam(pgrpn);
+			gpent = idcache_getgrnam(pgrpn);
 			if (gpent == NULL) {
 				if (pwent != NULL)	/* no such group is allowed */
 					return (bad_egrp);	/* only when no user (flatuid)*/
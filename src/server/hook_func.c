@@ -3793,6 +3793,12 @@ process_hooks(struct batch_request *preq, char *hook_msg, size_t msg_len,
 	int			num_run = 0;
 	int			rc = 1;
 	int			event_initialized = 0;
+	int			rq_type = preq->rq_type;
+
+	/* a job run from a run job list is an async run nobody waits on */
+	if ((preq->rq_parentbr != NULL) &&
+		(preq->rq_parentbr->rq_type == PBS_BATCH_RunJobList))
+		rq_type = PBS_BATCH_AsyrunJob;
 
 	if (!svr_interp_data.interp_started) {
 		log_event(PBSEVENT_DEBUG3, PBS_EVENTCLASS_HOOK,
@@ -3841,7 +3847,7 @@ process_hooks(struct batch_request *preq, char *hook_msg, size_t msg_len,
 				"Did not find a job tied to runjob request!");
 			return (-1);
 		}
-	} else if (preq->rq_type == PBS_BATCH_Manager) {
+	} else if (preq->rq_type == PBS_BATCH_Manager || preq->rq_type == PBS_BATCH_ManagerList) {
 		hook_event = HOOK_EVENT_MANAGEMENT;
 		preq->rq_ind.rq_management.rq_reply = &preq->rq_reply;
 		preq->rq_ind.rq_management.rq_time = preq->rq_time;
@@ -3879,7 +3885,7 @@ process_hooks(struct batch_request *preq, char *hook_msg, size_t msg_len,
 		} else if (preq->rq_type == PBS_BATCH_RunJob || preq->rq_type == PBS_BATCH_AsyrunJob ||
 				preq->rq_type == PBS_BATCH_AsyrunJob_ack) {
 			phook_next = (hook *)GET_NEXT(phook->hi_runjob_hooks);
-		} else if (preq->rq_type == PBS_BATCH_Manager) {
+		} else if (preq->rq_type == PBS_BATCH_Manager || preq->rq_type == PBS_BATCH_ManagerList) {
 			phook_next = (hook *)GET_NEXT(phook->hi_management_hooks);
 		} else if (preq->rq_type == PBS_BATCH_HookPeriodic) {
 			phook_next = (hook *)GET_NEXT(phook->hi_periodic_hooks);
@@ -3908,7 +3914,7 @@ process_hooks(struct batch_request *preq, char *hook_msg, size_t msg_len,
 			num_run++;
 			continue;
 		}
-		rc = server_process_hooks(preq->rq_type, preq->rq_user, preq->rq_host, phook,
+		rc = server_process_hooks(rq_type, preq->rq_user, preq->rq_host, phook,
 				hook_event, pjob, &req_ptr, hook_msg, msg_len, pyinter_func,
 				&num_run, &event_initialized);
 		if ((rc == 0) || (rc == -1))
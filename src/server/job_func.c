@@ -95,6 +95,7 @@
 #include "credential.h"
 #include "net_connect.h"
 #include "pbs_reliable.h"
+#include "pbs_idcache.h"
 
 #if defined(PBS_MOM) && defined(PBS_SECURITY) && (PBS_SECURITY == KRB5)
 #include "renew_creds.h"
@@ -340,6 +341,9 @@ job_alloc(void)
 	pj->ji_postevent = TM_NULL_EVENT;
 	pj->ji_preq = NULL;
 	pj->ji_nodekill = TM_ERROR_NODE;
+	pj->ji_relay = NULL;
+	CLEAR_HEAD(pj->ji_rused_sent);
+	pj->ji_rused_sent_time = 0;
 	pj->ji_flags = 0;
 	pj->ji_jsmpipe = -1;
 	pj->ji_mjspipe = -1;
@@ -366,6 +370,8 @@ job_alloc(void)
 	pj->ji_prunreq = NULL;
 	pj->ji_pmt_preq = NULL;
 	CLEAR_HEAD(pj->ji_svrtask);
+	CLEAR_LINK(pj->ji_rusedsave);
+	CLEAR_LINK(pj->ji_histjobs);
 	CLEAR_HEAD(pj->ji_rejectdest);
 	pj->ji_terminated = 0;
 	pj->ji_deletehistory = 0;
@@ -477,7 +483,7 @@ job_free(job *pj)
 			struct passwd *pwdp = NULL;
 
 			if ((pj->ji_wattr[JOB_ATR_euser].at_val.at_str) &&
-				(pwdp = getpwnam(pj->ji_wattr[JOB_ATR_euser].at_val.at_str))) {
+				(pwdp = idcache_getpwnam(pj->ji_wattr[JOB_ATR_euser].at_val.at_str))) {
 				if (pwdp->pw_userlogin != INVALID_HANDLE_VALUE) {
 					if (impersonate_user(pwdp->pw_userlogin) == 0) {
 						sprintf(log_buffer, "Failed to ImpersonateLoggedOnUser user: %s", pwdp->pw_name);
@@ -507,6 +513,8 @@ job_free(job *pj)
 		badplace		*bp;
 
 		free_job_work_tasks(pj);
+		delete_link(&pj->ji_rusedsave);
+		delete_link(&pj->ji_histjobs);
 
 		/* free any bad destination structs */
 
@@ -563,6 +571,7 @@ job_free(job *pj)
 
 	reliable_job_node_free(&pj->ji_failed_node_list);
 	reliable_job_node_free(&pj->ji_node_list);
+	free_attrlist(&pj->ji_rused_sent);
 
 	if (pj->ji_bg_hook_task) {
 		mom_process_hooks_params_t *php;
@@ -783,6 +792,109 @@ del_chkpt_files(job *pjob)
 }
 #endif
 
+#ifndef PBS_MOM
+/* job rows to delete from the database together, see job_purge_batch() */
+static int purge_batch_open = 0;
+static char **purge_batch_ids = NULL;
+static int purge_batch_ct = 0;
+static int purge_batch_sz = 0;
+
+/**
+ * @brief
+ * 		job_purge_batch - start or end a batch of job purges whose
+ *		database deletes are done together
+ *
+ * @par
+ *		While a batch is open job_purge() only remembers the jobs it
+ *		purges.  Ending the batch deletes their rows in one transaction
+ *		holding nothing but those deletes, so many jobs purged in a row
+ *		cost one commit.  All other database writes made while the batch
+ *		is open are done and committed on their own as usual.  If the
+ *		transaction fails, the rows are deleted again one by one.
+ *
+ * @param[in]	begin - 1 to start a batch, 0 to end it
+ *
+ * @return	void
+ */
+void
+job_purge_batch(int begin)
+{
+	extern char *msg_err_purgejob_db;
+	pbs_db_obj_info_t obj;
+	pbs_db_job_info_t dbjob;
+	int i;
+	int rc;
+
+	if (begin) {
+		purge_batch_open = 1;
+		return;
+	}
+
+	if (!purge_batch_open)
+		return;
+	purge_batch_open = 0;
+	if (purge_batch_ct == 0)
+		return;
+
+	obj.pbs_db_obj_type = PBS_DB_JOB;
+	obj.pbs_db_un.pbs_db_job = &dbjob;
+
+	if ((rc = pbs_db_begin_trx(svr_db_conn)) == 0) {
+		for (i = 0; (rc == 0) && (i < purge_batch_ct); i++) {
+			strcpy(dbjob.ji_jobid, purge_batch_ids[i]);
+			if (pbs_db_delete_obj(svr_db_conn, &obj) == -1)
+				rc = -1;
+		}
+		if (rc == 0)
+			rc = pbs_db_end_trx(svr_db_conn, 1);
+		else
+			(void)pbs_db_end_trx(svr_db_conn, 0);
+	}
+
+	if (rc != 0) {
+		log_err(-1, __func__, "batched job delete failed, deleting jobs one by one");
+		for (i = 0; i < purge_batch_ct; i++) {
+			strcpy(dbjob.ji_jobid, purge_batch_ids[i]);
+			if (pbs_db_delete_obj(svr_db_conn, &obj) == -1)
+				log_joberr(-1, __func__, msg_err_purgejob_db,
+					purge_batch_ids[i]);
+		}
+	}
+	for (i = 0; i < purge_batch_ct; i++)
+		free(purge_batch_ids[i]);
+	purge_batch_ct = 0;
+}
+
+/**
+ * @brief
+ * 		remember the id of a job whose row is deleted when the open
+ *		batch ends, see job_purge_batch()
+ *
+ * @param[in]	jobid - job id
+ *
+ * @return	int
+ * @retval	0	- the delete is queued
+ * @retval	-1	- out of memory, delete the row now
+ */
+static int
+job_purge_batch_add(char *jobid)
+{
+	char **tmp;
+
+	if (purge_batch_ct == purge_batch_sz) {
+		tmp = realloc(purge_batch_ids, (purge_batch_sz + 256) * sizeof(char *));
+		if (tmp == NULL)
+			return -1;
+		purge_batch_ids = tmp;
+		purge_batch_sz += 256;
+	}
+	if ((purge_batch_ids[purge_batch_ct] = strdup(jobid)) == NULL)
+		return -1;
+	purge_batch_ct++;
+	return 0;
+}
+#endif	/* PBS_MOM */
+
 /**
  * @brief
  * 		job_purge - purge job from system
@@ -995,9 +1107,11 @@ job_purge(job *pjob)
 	obj.pbs_db_obj_type = PBS_DB_JOB;
 	obj.pbs_db_un.pbs_db_job = &dbjob;
 	strcpy(dbjob.ji_jobid, pjob->ji_qs.ji_jobid);
-	if (pbs_db_delete_obj(conn, &obj) == -1) {
-		log_joberr(-1, __func__, msg_err_purgejob_db,
-			pjob->ji_qs.ji_jobid);
+	if (!purge_batch_open || (job_purge_batch_add(pjob->ji_qs.ji_jobid) != 0)) {
+		if (pbs_db_delete_obj(conn, &obj) == -1) {
+			log_joberr(-1, __func__, msg_err_purgejob_db,
+				pjob->ji_qs.ji_jobid);
+		}
 	}
 
 	if (pjob->ji_qs.ji_svrflags & JOB_SVFLG_HasNodes) {
@@ -53,6 +53,8 @@
 #include <time.h>
 
 #include <unistd.h>
+#include <pthread.h>
+#include <sys/time.h>
 #include "server_limits.h"
 #include "list_link.h"
 #include "attribute.h"
@@ -77,8 +79,10 @@ void print_backtrace(char *);
 
 /* global data items */
 extern time_t time_now;
+extern int resc_access_perm;
+extern char *msg_daemonname;
 
-job *recov_job_cb(pbs_db_obj_info_t *dbobj, int *refreshed);
+void recov_job_cb(pbs_db_obj_info_t *dbobj, int *refreshed);
 resc_resv *recov_resv_cb(pbs_db_obj_info_t *dbobj, int *refreshed);
 
 /**
@@ -150,19 +154,16 @@ job_to_db(job *pjob, pbs_db_job_info_t *dbjob)
 
 /**
  * @brief
- *		convert from database to job structure
- *
- * @see
- * 		job_recov_db
+ *		copy the fixed (quick save) part of a database job to the
+ *		job structure
  *
  * @param[out]	pjob - Address of the job in the server
  * @param[in]	dbjob - Address of the database job object
  *
- * @retval   !=0  Failure
- * @retval   0    Success
+ * @return void
  */
-static int
-db_to_job(job *pjob,  pbs_db_job_info_t *dbjob)
+static void
+db_to_job_qs(job *pjob,  pbs_db_job_info_t *dbjob)
 {
 	/* Variables assigned constant values are not stored in the DB */
 	pjob->ji_qs.ji_jsversion = JSVERSION;
@@ -206,6 +207,25 @@ db_to_job(job *pjob,  pbs_db_job_info_t *dbjob)
 	strcpy(pjob->ji_extended.ji_ext.ji_4ash, dbjob->ji_4ash);
 #endif
 	pjob->ji_extended.ji_ext.ji_credtype = dbjob->ji_credtype;
+}
+
+/**
+ * @brief
+ *		convert from database to job structure
+ *
+ * @see
+ * 		job_recov_db
+ *
+ * @param[out]	pjob - Address of the job in the server
+ * @param[in]	dbjob - Address of the database job object
+ *
+ * @retval   !=0  Failure
+ * @retval   0    Success
+ */
+static int
+db_to_job(job *pjob,  pbs_db_job_info_t *dbjob)
+{
+	db_to_job_qs(pjob, dbjob);
 
 	if ((decode_attr_db(pjob, &dbjob->db_attr_list, job_attr_idx, job_attr_def, pjob->ji_wattr, JOB_ATR_LAST, JOB_ATR_UNKN)) != 0)
 		return -1;
@@ -563,49 +583,303 @@ resv_recov_db(char *resvid, resc_resv *presv)
 	return presv;
 }
 
+/*
+ * Jobs are recovered in batches: the attributes of one batch are
+ * decoded on worker threads while the main thread reads the next batch
+ * of rows.  Everything after the decoding, the action functions,
+ * pbsd_init_job() and so putting the job in its queue and the job
+ * index, is done on the main thread in the order the rows were read.
+ */
+#define RECOV_JOB_BATCH		2048	/* jobs in a batch */
+#define RECOV_JOB_MAXTHREADS	8	/* decode threads at most */
+
+struct recov_job_ent {
+	job			*rj_job;	/* job allocated for the row */
+	pbs_db_attr_list_t	rj_attrs;	/* attributes read for the job */
+	int			rj_rc;		/* result of decoding */
+};
+
+struct recov_job_batch {
+	struct recov_job_ent	*rb_ents;
+	int			rb_num;		/* entries filled */
+	int			rb_next;	/* next entry for a thread */
+	pthread_mutex_t		rb_lock;	/* protects rb_next */
+	pthread_t		rb_threads[RECOV_JOB_MAXTHREADS];
+	int			rb_nthreads;	/* threads decoding the batch */
+};
+
+static struct recov_job_batch recov_batches[2];
+static struct recov_job_batch *recov_filling;	/* batch being read */
+static struct recov_job_batch *recov_decoding;	/* batch on the threads */
+static int recov_nthreads = -1;	/* decode threads, 0 decodes inline */
+static int recov_numjobs;	/* jobs recovered */
+static double recov_wait_secs;	/* main thread waiting for decoding */
+static double recov_init_secs;	/* actions and pbsd_init_job() */
+
 /**
  * @brief
- *	Refresh/retrieve job from database and add it into AVL tree if not present
+ *	Return the seconds elapsed since a time of day, and optionally
+ *	reset that time to now.
  *
- *	@param[in]  dbobj     - The pointer to the wrapper job object of type pbs_db_job_info_t
- * 	@param[out]  refreshed - To check if job is refreshed
+ * @param[in,out]	since - start time
+ * @param[in]		reset - 1 to set since to now
  *
- * @return	The recovered job
- * @retval	NULL - Failure
- * @retval	!NULL - Success, pointer to job structure recovered
+ * @return	double
+ */
+double
+recov_elapsed(struct timeval *since, int reset)
+{
+	struct timeval now;
+	double secs;
+
+	gettimeofday(&now, NULL);
+	secs = (double)(now.tv_sec - since->tv_sec) +
+		(double)(now.tv_usec - since->tv_usec) / 1000000.0;
+	if (reset)
+		*since = now;
+	return secs;
+}
+
+/**
+ * @brief
+ *	Thread body decoding the attributes of the jobs in a batch, taking
+ *	one job at a time until the batch is done.
+ *
+ * @param[in]	arg - the batch
  *
+ * @return	NULL
  */
-job *
+static void *
+recov_job_decoder(void *arg)
+{
+	struct recov_job_batch *pb = arg;
+	struct recov_job_ent *pe;
+	int i;
+
+	for (;;) {
+		pthread_mutex_lock(&pb->rb_lock);
+		i = pb->rb_next++;
+		pthread_mutex_unlock(&pb->rb_lock);
+		if (i >= pb->rb_num)
+			break;
+		pe = &pb->rb_ents[i];
+		pe->rj_rc = decode_attr_db_part(pe->rj_job, &pe->rj_attrs,
+			job_attr_idx, job_attr_def, pe->rj_job->ji_wattr,
+			JOB_ATR_LAST, JOB_ATR_UNKN, ATTR_DB_DECODE_MT);
+	}
+	return NULL;
+}
+
+/**
+ * @brief
+ *	Start decoding a full batch.  Without threads it is decoded here.
+ *
+ * @param[in]	pb - the batch
+ *
+ * @return void
+ */
+static void
+recov_job_decode(struct recov_job_batch *pb)
+{
+	int i;
+
+	/* decode_resc() checks this, the threads only read it */
+	resc_access_perm = ATR_DFLAG_ACCESS;
+
+	pb->rb_next = 0;
+	pb->rb_nthreads = 0;
+	for (i = 0; i < recov_nthreads; i++) {
+		if (pthread_create(&pb->rb_threads[i], NULL, recov_job_decoder, pb) != 0) {
+			log_err(errno, __func__, "pthread_create");
+			break;
+		}
+		pb->rb_nthreads++;
+	}
+	if (pb->rb_nthreads == 0)
+		(void)recov_job_decoder(pb);
+}
+
+/**
+ * @brief
+ *	Wait for a batch to be decoded, then finish its jobs in order on
+ *	the main thread.
+ *
+ * @param[in]	pb - the batch
+ *
+ * @return void
+ */
+static void
+recov_job_finish(struct recov_job_batch *pb)
+{
+	struct recov_job_ent *pe;
+	struct timeval tv;
+	pbs_db_job_info_t dbjob;
+	pbs_db_obj_info_t obj;
+	job *pj;
+	int i;
+
+	gettimeofday(&tv, NULL);
+	for (i = 0; i < pb->rb_nthreads; i++)
+		pthread_join(pb->rb_threads[i], NULL);
+	pb->rb_nthreads = 0;
+	recov_wait_secs += recov_elapsed(&tv, 1);
+
+	for (i = 0; i < pb->rb_num; i++) {
+		pe = &pb->rb_ents[i];
+		pj = pe->rj_job;
+		if (pe->rj_rc == 0)
+			pe->rj_rc = decode_attr_db_part(pj, &pe->rj_attrs,
+				job_attr_idx, job_attr_def, pj->ji_wattr,
+				JOB_ATR_LAST, JOB_ATR_UNKN, ATTR_DB_DECODE_REST);
+		free_db_attr_list(&pe->rj_attrs);
+
+		if (pe->rj_rc != 0) {
+			log_errf(PBSE_INTERNAL, __func__, "Failed to decode job %s", pj->ji_qs.ji_jobid);
+			if ((server_init_type == RECOV_COLD) || (server_init_type == RECOV_CREATE)) {
+				/* remove the loaded job from db */
+				memset(&dbjob, 0, sizeof(dbjob));
+				strcpy(dbjob.ji_jobid, pj->ji_qs.ji_jobid);
+				obj.pbs_db_obj_type = PBS_DB_JOB;
+				obj.pbs_db_un.pbs_db_job = &dbjob;
+				if (pbs_db_delete_obj(svr_db_conn, &obj) != 0)
+					log_errf(PBSE_SYSTEM, __func__, "job %s not purged", dbjob.ji_jobid);
+			}
+			log_errf(PBSE_SYSTEM, __func__, "Failed to recover job %s", pj->ji_qs.ji_jobid);
+			job_free(pj);
+			continue;
+		}
+
+		compare_obj_hash(&pj->ji_qs, sizeof(pj->ji_qs), pj->qs_hash);
+		pj->newobj = 0;
+		pbsd_init_job(pj, server_init_type);
+
+		if ((++recov_numjobs % 20) == 0) {
+			/* periodically touch the file so the  */
+			/* world knows we are alive and active */
+			update_svrlive();
+		}
+	}
+	log_eventf(PBSEVENT_DEBUG, PBS_EVENTCLASS_SERVER, LOG_DEBUG, msg_daemonname,
+		"Recovered a batch of %d jobs", pb->rb_num);
+	pb->rb_num = 0;
+	recov_init_secs += recov_elapsed(&tv, 0);
+}
+
+/**
+ * @brief
+ *	Callback for pbs_db_search() recovering jobs at server start.  The
+ *	row is added to the batch being read; a full batch is handed to the
+ *	decode threads once the previous one has been finished.  The last
+ *	jobs are recovered by recov_job_cb_end().
+ *
+ * @param[in]	dbobj     - The pointer to the wrapper job object of type pbs_db_job_info_t
+ * @param[out]	refreshed - set to 1 if the row was taken
+ *
+ * @return void
+ */
+void
 recov_job_cb(pbs_db_obj_info_t *dbobj, int *refreshed)
 {
-	job *pj = NULL;
 	pbs_db_job_info_t *dbjob = dbobj->pbs_db_un.pbs_db_job;
-	static int numjobs = 0;
+	struct recov_job_batch *pb;
+	struct recov_job_ent *pe;
+	job *pj;
+	long ncpus;
+	int i;
 
 	*refreshed = 0;
-	if ((pj = job_recov_db_spl(dbjob, NULL)) == NULL) {
-		if ((server_init_type == RECOV_COLD) || (server_init_type == RECOV_CREATE)) {
-			/* remove the loaded job from db */
-			if (pbs_db_delete_obj(svr_db_conn, dbobj) != 0)
-				log_errf(PBSE_SYSTEM, __func__, "job %s not purged", dbjob->ji_jobid);
+	if (recov_nthreads == -1) {
+		ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+		recov_nthreads = (ncpus > RECOV_JOB_MAXTHREADS) ? RECOV_JOB_MAXTHREADS : (int) ncpus;
+		if (recov_nthreads < 2)
+			recov_nthreads = 0;
+		for (i = 0; i < 2; i++) {
+			recov_batches[i].rb_ents = calloc(RECOV_JOB_BATCH, sizeof(struct recov_job_ent));
+			pthread_mutex_init(&recov_batches[i].rb_lock, NULL);
 		}
-		goto err;
+		if (recov_batches[0].rb_ents == NULL || recov_batches[1].rb_ents == NULL) {
+			log_err(ENOMEM, __func__, "Out of memory");
+			for (i = 0; i < 2; i++) {
+				free(recov_batches[i].rb_ents);
+				recov_batches[i].rb_ents = NULL;
+				pthread_mutex_destroy(&recov_batches[i].rb_lock);
+			}
+			recov_nthreads = -1;
+			free_db_attr_list(&dbjob->db_attr_list);
+			return;
+		}
+		recov_filling = &recov_batches[0];
+		recov_numjobs = 0;
+		recov_wait_secs = 0;
+		recov_init_secs = 0;
 	}
 
-	pbsd_init_job(pj, server_init_type);
+	if ((pj = job_alloc()) == NULL) {
+		log_errf(PBSE_SYSTEM, __func__, "Failed to recover job %s", dbjob->ji_jobid);
+		free_db_attr_list(&dbjob->db_attr_list);
+		return;
+	}
+	db_to_job_qs(pj, dbjob);
+
+	pb = recov_filling;
+	pe = &pb->rb_ents[pb->rb_num++];
+	pe->rj_job = pj;
+	pe->rj_rc = 0;
+	pe->rj_attrs.attr_count = dbjob->db_attr_list.attr_count;
+	CLEAR_HEAD(pe->rj_attrs.attrs);
+	list_move(&dbjob->db_attr_list.attrs, &pe->rj_attrs.attrs);
 	*refreshed = 1;
 
-	if ((++numjobs % 20) == 0) {
-		/* periodically touch the file so the  */
-		/* world knows we are alive and active */
-		update_svrlive();
-	}
+	if (pb->rb_num < RECOV_JOB_BATCH)
+		return;
 
-err:
-	free_db_attr_list(&dbjob->db_attr_list);
-	if (pj == NULL)
-		log_errf(PBSE_SYSTEM, __func__, "Failed to recover job %s", dbjob->ji_jobid);
-	return pj;
+	/* the batch is full, the previous one must be done before it starts */
+	if (recov_decoding != NULL)
+		recov_job_finish(recov_decoding);
+	recov_decoding = pb;
+	recov_filling = (pb == &recov_batches[0]) ? &recov_batches[1] : &recov_batches[0];
+	recov_job_decode(pb);
+}
+
+/**
+ * @brief
+ *	Recover the jobs still held in batches by recov_job_cb() and log
+ *	how the time spent recovering jobs was divided.
+ *
+ * @param[in]	start - when pbs_db_search() was called for the jobs
+ *
+ * @return void
+ */
+void
+recov_job_cb_end(struct timeval *start)
+{
+	double total;
+	int i;
+
+	if (recov_nthreads == -1)
+		return;		/* no jobs */
+
+	if (recov_decoding != NULL)
+		recov_job_finish(recov_decoding);
+	recov_decoding = NULL;
+	if (recov_filling->rb_num > 0) {
+		recov_job_decode(recov_filling);
+		recov_job_finish(recov_filling);
+	}
+	recov_filling = NULL;
+
+	total = recov_elapsed(start, 0);
+	log_eventf(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, LOG_INFO, msg_daemonname,
+		"Recovered %d jobs in %.2f seconds: %.2f reading, %.2f waiting on %d decode threads, %.2f queueing",
+		recov_numjobs, total, total - recov_wait_secs - recov_init_secs,
+		recov_wait_secs, recov_nthreads, recov_init_secs);
+
+	for (i = 0; i < 2; i++) {
+		free(recov_batches[i].rb_ents);
+		recov_batches[i].rb_ents = NULL;
+		pthread_mutex_destroy(&recov_batches[i].rb_lock);
+	}
+	recov_nthreads = -1;
 }
 
 /**
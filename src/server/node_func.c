@@ -308,6 +308,8 @@ initialize_pbsnode(struct pbsnode *pnode, char *pname, int ntype)
 	pnode->device.nnodes = 0;
 	pnode->device.nsockets = 0;
 	pnode->newobj = 1;
+	memset(pnode->nd_savehash, 0, DIGEST_LENGTH);
+	CLEAR_LINK(pnode->nd_savelink);
 	pnode->nd_moms    = (struct mominfo **)calloc(1, sizeof(struct mominfo *));
 	if (pnode->nd_moms == NULL)
 		return (PBSE_SYSTEM);
@@ -504,6 +506,7 @@ void
 free_pnode(struct pbsnode *pnode)
 {
 	if (pnode) {
+		delete_link(&pnode->nd_savelink);
 		(void)free(pnode->nd_name);
 		(void)free(pnode->nd_hostname);
 		(void)free(pnode->nd_moms);
@@ -1853,6 +1853,81 @@ find_vnode_in_execvnode(char *big, char *little)
 	return 0;
 }
 
+/*
+ * Jobs whose resources_used changed in an update from Mom, but which
+ * have not been saved to the database since.  Saving is put off for up
+ * to RUSED_SAVE_DELAY seconds so that one save covers many updates.
+ */
+#define RUSED_SAVE_DELAY	60
+static pbs_list_head	rused_unsaved;
+static int		rused_save_pending = 0;
+
+/**
+ * @brief
+ *		Save every job on the rused_unsaved list.
+ *
+ * @param[in]	ptask	-	work task, unused; NULL when called directly
+ *
+ * @return	void
+ */
+static void
+save_rused_jobs(struct work_task *ptask)
+{
+	job	*pjob;
+	int	 nsaved = 0;
+
+	rused_save_pending = 0;
+	if (rused_unsaved.ll_next == NULL)
+		return;
+	while ((pjob = (job *)GET_NEXT(rused_unsaved)) != NULL) {
+		delete_link(&pjob->ji_rusedsave);
+		job_save_db(pjob);
+		nsaved++;
+	}
+	log_eventf(PBSEVENT_DEBUG3, PBS_EVENTCLASS_SERVER, LOG_DEBUG,
+		__func__, "saved usage of %d jobs", nsaved);
+}
+
+/**
+ * @brief
+ *		Save at once the jobs whose resources_used updates were put off,
+ *		e.g. before the server shuts down.
+ *
+ * @return	void
+ */
+void
+flush_rused_saves(void)
+{
+	save_rused_jobs(NULL);
+}
+
+/**
+ * @brief
+ *		Put off saving a job whose only change is its usage.
+ *
+ * @param[in]	pjob	-	job updated from Mom
+ *
+ * @return	void
+ */
+static void
+defer_rused_save(job *pjob)
+{
+	if (rused_unsaved.ll_next == NULL)
+		CLEAR_HEAD(rused_unsaved);
+	if (is_linked(&rused_unsaved, &pjob->ji_rusedsave))
+		return;
+	append_link(&rused_unsaved, &pjob->ji_rusedsave, pjob);
+	if (!rused_save_pending) {
+		if (set_task(WORK_Timed, time_now + RUSED_SAVE_DELAY,
+			save_rused_jobs, NULL) == NULL) {
+			/* cannot wait, save now */
+			save_rused_jobs(NULL);
+			return;
+		}
+		rused_save_pending = 1;
+	}
+}
+
 /**
  * @brief
  * 		decode_stat_update - decodes body of status update request from MOM
@@ -1913,7 +1988,9 @@ decode_stat_update(int stream, struct resc_used_update *prused)
  *		need to be recorded,  the most inportant of which is the job's
  *		session id.  When the session id is modified, the job's substate is
  *		changed from PRERUN to RUNNING; this also saves the job to the database,
- *		otherwise it is saved explicitly.
+ *		otherwise it is saved explicitly.  Only an update that changes
+ *		nothing but resources_used has its save put off, see
+ *		defer_rused_save().
  * @see
  * 		is_request
  *
@@ -1932,7 +2009,12 @@ stat_update(int stream)
 	struct resc_used_update	 rused = {0};
 	svrattrl		*sattrl;
 	mominfo_t		*mp;
+	int			 nupdates = 0;
+	int			 nsaved = 0;
+	int			 ndeferred = 0;
+	clock_t			 cpu_start;
 
+	cpu_start = clock();
 	njobs = disrui(stream, &rc);	/* number of jobs in update */
 	if (rc)
 		return;
@@ -1952,6 +2034,7 @@ stat_update(int stream)
 			break;
 		}
 		DBPRT(("stat_update: update for %s\n", rused.ru_pjobid))
+		nupdates++;
 
 		if (((pjob = find_job(rused.ru_pjobid)) != NULL)     &&
 			((pjob->ji_qs.ji_state == JOB_STATE_RUNNING) ||
@@ -1959,6 +2042,7 @@ stat_update(int stream)
 			(pjob->ji_wattr[(int)JOB_ATR_run_version].at_val.at_long == rused.ru_hop)) {
 
 			long old_sid = 0;  /* used to save prior sid of job */
+			int		usage_only = 1;	/* only usage in this update */
 			svrattrl	*execvnode_entry = NULL;
 			svrattrl	*schedselect_entry = NULL;
 			char		*cur_execvnode = NULL;
@@ -1974,6 +2058,15 @@ stat_update(int stream)
 			execvnode_entry = find_svrattrl_list_entry(&rused.ru_attr, ATTR_execvnode, NULL);
 			schedselect_entry = find_svrattrl_list_entry(&rused.ru_attr, ATTR_SchedSelect, NULL);
 
+			for (sattrl = (svrattrl *)GET_NEXT(rused.ru_attr); sattrl != NULL;
+				sattrl = (svrattrl *)GET_NEXT(sattrl->al_link)) {
+				if ((strcmp(sattrl->al_name, ATTR_used) != 0) &&
+					(strcmp(sattrl->al_name, ATTR_session) != 0)) {
+					usage_only = 0;
+					break;
+				}
+			}
+
 			if ((execvnode_entry != NULL) &&
 			    (execvnode_entry->al_value != NULL) &&
 			    (schedselect_entry != NULL) &&
@@ -2090,7 +2183,11 @@ stat_update(int stream)
 					if (pjob->ji_wattr[(int)JOB_ATR_depend].at_flags & ATR_VFLAG_SET) {
 						(void)depend_on_exec(pjob);
 					}
+				} else {
+					/* a new session id is never put off */
+					job_save_db(pjob);
 				}
+				nsaved++;
 			} else if ((pjob->ji_wattr[(int)JOB_ATR_session_id].at_flags & ATR_VFLAG_SET) == 0) {
 				/* this has been downgraded to DEBUG3  */
 				/* level (from DEBUG2)		       */
@@ -2107,7 +2204,14 @@ stat_update(int stream)
 				/* or resources_used was modified         */
 
 				pjob->ji_wattr[(int)JOB_ATR_session_id].at_flags &= ~ATR_VFLAG_MODIFY;
-				job_save_db(pjob); /* job_save will save only if modified */
+				if (usage_only) {
+					/* saved along with other jobs later */
+					defer_rused_save(pjob);
+					ndeferred++;
+				} else {
+					job_save_db(pjob); /* job_save will save only if modified */
+					nsaved++;
+				}
 			}
 		}
 		(void)free(rused.ru_comment);
@@ -2116,6 +2220,15 @@ stat_update(int stream)
 		rused.ru_pjobid = NULL;
 		free_attrlist(&rused.ru_attr);
 	}
+
+	if (will_log_event(PBSEVENT_DEBUG4)) {
+		mp = tfind2((u_long)stream, 0, &streams);
+		log_eventf(PBSEVENT_DEBUG4, PBS_EVENTCLASS_NODE, LOG_DEBUG,
+			mp ? mp->mi_host : __func__,
+			"stat_update: %d jobs, %d saved, %d deferred, %ld usec cpu",
+			nupdates, nsaved, ndeferred,
+			(long)((clock() - cpu_start) * (1000000.0 / CLOCKS_PER_SEC)));
+	}
 }
 
 
@@ -4186,6 +4299,8 @@ is_request(int stream, int version)
 	char			*hname = NULL;
 	unsigned long		hook_rescdef_checksum;
 	unsigned long		chksum_rescdef;
+	unsigned long		hook_bundle;
+	unsigned long		chksum_bundle;
 	static int		reply_send_tm = 0;
 
 	CLEAR_HEAD(reported_hooks);
@@ -5151,6 +5266,34 @@ found:
 
 			break;
 
+		case IS_HOOK_BUNDLE:
+			/* one checksum for all of the mom's hooks */
+			chksum_bundle = disrul(stream, &ret);
+			if (ret != DIS_SUCCESS)
+				goto err;
+
+			hook_bundle = hook_bundle_checksum(get_hook_rescdef_checksum());
+			if (chksum_bundle != hook_bundle) {
+				/* ask for the checksum of each hook to find what to resend */
+				log_eventf(PBSEVENT_DEBUG3, PBS_EVENTCLASS_HOOK, LOG_INFO, pmom->mi_host,
+					"hooks mismatched checksums: server: %lu mom: %lu...asking for each hook",
+					hook_bundle, chksum_bundle);
+				if ((ret = is_compose(stream, IS_HOOK_CHECKSUMS)) != DIS_SUCCESS)
+					goto err;
+				if ((ret = dis_flush(stream)) != DIS_SUCCESS)
+					goto err;
+				break;
+			}
+
+			log_event(PBSEVENT_DEBUG4, PBS_EVENTCLASS_HOOK, LOG_INFO, pmom->mi_host,
+				"hooks match the server's");
+			np = psvrmom->msr_children[0];
+			if (np->nd_state & INUSE_PROV) {
+				DBPRT(("%s: calling [is_vnode_prov_done] from is_request\n", __func__))
+				is_vnode_prov_done(np->nd_name);
+			}
+			break;
+
 
 		default:
 			sprintf(log_buffer, "unknown command %d sent from %s",
@@ -7774,6 +7917,96 @@ degrade_downed_nodes_reservations(void)
 	}
 }
 
+/*
+ * Vnodes with a change, such as a new last_used_time, that has not been
+ * saved to the database yet.  Saving is put off for up to NODE_SAVE_DELAY
+ * seconds so that one save covers the jobs ending on a vnode meanwhile.
+ */
+#define NODE_SAVE_DELAY	60
+static pbs_list_head	nodes_unsaved;
+static int		node_save_pending = 0;
+
+/**
+ * @brief
+ *		Save every vnode on the nodes_unsaved list, in one transaction.
+ *
+ * @param[in]	ptask	-	work task, unused; NULL when called directly
+ *
+ * @return	void
+ */
+static void
+save_deferred_nodes(struct work_task *ptask)
+{
+	struct pbsnode	*pnode;
+	int		 nsaved = 0;
+	int		 in_trx;
+	int		 rc = 0;
+
+	node_save_pending = 0;
+	if (nodes_unsaved.ll_next == NULL)
+		return;
+	if (GET_NEXT(nodes_unsaved) == NULL)
+		return;
+
+	/* without a transaction each save is committed on its own */
+	in_trx = (pbs_db_begin_trx(svr_db_conn) == 0);
+	while ((pnode = (struct pbsnode *)GET_NEXT(nodes_unsaved)) != NULL) {
+		/* node_save_db() takes the node off the list */
+		if (node_save_db(pnode) != 0) {
+			delete_link(&pnode->nd_savelink);
+			rc = -1;
+		}
+		nsaved++;
+	}
+	if (in_trx && (pbs_db_end_trx(svr_db_conn, (rc == 0)) != 0)) {
+		log_err(PBSE_INTERNAL, __func__, "Failed to commit vnode saves");
+		panic_stop_db();
+	}
+	log_eventf(PBSEVENT_DEBUG3, PBS_EVENTCLASS_SERVER, LOG_DEBUG,
+		__func__, "saved %d vnodes", nsaved);
+}
+
+/**
+ * @brief
+ *		Save at once the vnodes whose saves were put off, e.g. before
+ *		the server shuts down.
+ *
+ * @return	void
+ */
+void
+flush_node_saves(void)
+{
+	save_deferred_nodes(NULL);
+}
+
+/**
+ * @brief
+ *		Put off saving a vnode whose change need not be in the database
+ *		right away.
+ *
+ * @param[in]	pnode	-	vnode changed
+ *
+ * @return	void
+ */
+void
+node_save_db_defer(struct pbsnode *pnode)
+{
+	if (nodes_unsaved.ll_next == NULL)
+		CLEAR_HEAD(nodes_unsaved);
+	if (is_linked(&nodes_unsaved, &pnode->nd_savelink))
+		return;
+	append_link(&nodes_unsaved, &pnode->nd_savelink, pnode);
+	if (!node_save_pending) {
+		if (set_task(WORK_Timed, time_now + NODE_SAVE_DELAY,
+			save_deferred_nodes, NULL) == NULL) {
+			/* cannot wait, save now */
+			save_deferred_nodes(NULL);
+			return;
+		}
+		node_save_pending = 1;
+	}
+}
+
 /**
  * @brief	Set last_used_time for job's exec_vnodes or reservation's resv_nodes.
  *		Finds the vnodes by name and sets ND_ATR_last_used_time to time_now.
@@ -7828,8 +8061,9 @@ set_last_used_time_node(void *pobj, int type)
 				snprintf(str_val, sizeof(str_val), "%d", time_int_val);
 				set_attr_svr(&(pnode->nd_attr[(int)ND_ATR_last_used_time]),
 						&node_attr_def[(int) ND_ATR_last_used_time], str_val);
+				/* saved with other vnodes later */
+				node_save_db_defer(pnode);
 			}
-			node_save_db(pnode);
 		}
 		last_pn = pn;
 		pn = parse_plus_spec(NULL, &rc);
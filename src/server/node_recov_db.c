@@ -80,6 +80,7 @@
 #include "queue.h"
 #include "svrfunc.h"
 #include <memory.h>
+#include <stddef.h>
 #include "libutil.h"
 #include "pbs_db.h"
 
@@ -309,6 +310,68 @@ node_to_db(struct pbsnode *pnode, pbs_db_node_info_t *pdbnd)
 	return savetype;
 }
 
+/**
+ * @brief
+ *	Check whether a node has changed since it was last saved.
+ *
+ * @par
+ *	node_to_db() encodes only the attributes flagged ATR_VFLAG_MODIFY, so
+ *	any such attribute means a change.  The fixed fields have no such
+ *	flag, so a signature of them, and of the cpu count written as pcpus,
+ *	is compared with the one kept in the node.
+ *
+ * @param[in,out]	pnode - the node, its signature is updated
+ * @param[in]		pdbnd - the fixed fields as they would be saved
+ * @param[in]		modified - whether an attribute to save is modified
+ *
+ * @return	int
+ * @retval	0 - same as last saved
+ * @retval	1 - changed
+ *
+ */
+static int
+node_db_changed(struct pbsnode *pnode, pbs_db_node_info_t *pdbnd, int modified)
+{
+	char buf[offsetof(pbs_db_node_info_t, db_attr_list) + sizeof(long)];
+	size_t len;
+
+	/* the fixed part, up to the attribute list, is cleared before use */
+	len = offsetof(pbs_db_node_info_t, db_attr_list);
+	memcpy(buf, pdbnd, len);
+	memcpy(buf + len, &pnode->nd_nsn, sizeof(long));
+	len += sizeof(long);
+
+	/* always keep the signature of the fixed part current */
+	if (compare_obj_hash(buf, len, pnode->nd_savehash) != 0)
+		return 1;
+	return modified;
+}
+
+/**
+ * @brief
+ *	Check whether a node has an attribute to save that was modified
+ *	since the last save.
+ *
+ * @param[in]	pnode - the node
+ *
+ * @return	int
+ * @retval	0 - no modified attribute
+ * @retval	1 - at least one
+ *
+ */
+static int
+node_attrs_modified(struct pbsnode *pnode)
+{
+	int i;
+
+	for (i = 0; i < ND_ATR_LAST; i++) {
+		if ((pnode->nd_attr[i].at_flags & ATR_VFLAG_MODIFY) &&
+			((node_attr_def[i].at_flags & ATR_DFLAG_NOSAVM) == 0))
+			return 1;
+	}
+	return 0;
+}
+
 /**
  * @brief
  *	Save a node to the database. When we save a node to the database, delete
@@ -316,6 +379,9 @@ node_to_db(struct pbsnode *pnode, pbs_db_node_info_t *pdbnd)
  *	any deleted attributes of the node are removed, and only the new ones are
  *	updated to the database.
  *
+ *	Nothing is written if the node is the same as when it was last saved,
+ *	so saving every node after a change to a few of them writes only those.
+ *
  * @param[in]	pnode - Pointer to the node to save
  *
  * @return      Error code
@@ -326,16 +392,29 @@ node_to_db(struct pbsnode *pnode, pbs_db_node_info_t *pdbnd)
 int
 node_save_db(struct pbsnode *pnode)
 {
-	pbs_db_node_info_t dbnode = {{0}};
+	pbs_db_node_info_t dbnode;
 	pbs_db_obj_info_t obj;
 	void *conn = (void *) svr_db_conn;
 	char *conn_db_err = NULL;
 	int savetype;
+	int modified;
 	int rc = -1;
 
+	/* saved now, whether or not it was waiting */
+	delete_link(&pnode->nd_savelink);
+
+	/* node_to_db() clears the modify flags */
+	modified = node_attrs_modified(pnode);
+
+	memset(&dbnode, 0, sizeof(dbnode));
 	if ((savetype = node_to_db(pnode, &dbnode))  == -1)
 		goto done;
 
+	if (node_db_changed(pnode, &dbnode, modified) == 0 && pnode->newobj == 0) {
+		rc = 0;
+		goto done;
+	}
+
 	obj.pbs_db_obj_type = PBS_DB_NODE;
 	obj.pbs_db_un.pbs_db_node = &dbnode;
 
@@ -346,6 +425,8 @@ node_save_db(struct pbsnode *pnode)
 
 	if (rc == 0)
 		pnode->newobj = 0;
+	else
+		memset(pnode->nd_savehash, 0, DIGEST_LENGTH); /* write next time */
 
 done:
 	free_db_attr_list(&dbnode.db_attr_list);
@@ -167,7 +167,9 @@ extern void offline_all_provisioning_vnodes(void);
 extern void stop_db();
 extern job *job_recov_db_spl(pbs_db_job_info_t *dbjob, job *pjob);
 extern pbs_sched *sched_alloc(char *sched_name);
-extern job *recov_job_cb(pbs_db_obj_info_t *, int *);
+extern void recov_job_cb(pbs_db_obj_info_t *, int *);
+extern void recov_job_cb_end(struct timeval *);
+extern double recov_elapsed(struct timeval *, int);
 extern resc_resv *recov_resv_cb(pbs_db_obj_info_t *, int *);
 extern pbs_queue *recov_queue_cb(pbs_db_obj_info_t *, int *);
 extern pbs_sched *recov_sched_cb(pbs_db_obj_info_t *, int *);
@@ -333,6 +335,7 @@ pbsd_init(int type)
 	void	*conn = (void *) svr_db_conn;
 	char *buf = NULL;
 	int buf_len = 0;
+	struct timeval phase_start;
 
 #ifdef  RLIMIT_CORE
 	int      char_in_cname = 0;
@@ -668,7 +671,7 @@ pbsd_init(int type)
 	 * 8A. If not a "create" initialization, recover queues.
 	 *    If a create, remove any queues that might be there.
 	 */
-	if ((queues_idx = pbs_idx_create(0, 0)) == NULL) {
+	if ((queues_idx = pbs_idx_create(PBS_IDX_HASH, 0)) == NULL) {
 		log_err(-1, __func__, "Creating queue index failed!");
 		return (-1);
 	}
@@ -679,6 +682,7 @@ pbsd_init(int type)
 	obj.pbs_db_obj_type = PBS_DB_QUEUE;
 	obj.pbs_db_un.pbs_db_que = &dbque;
 
+	gettimeofday(&phase_start, NULL);
 	rc = pbs_db_search(conn, &obj, NULL, (query_cb_t)&recov_queue_cb);
 	if (rc == -1) {
 		pbs_db_get_errmsg(PBS_DB_ERR, &conn_db_err);
@@ -688,6 +692,8 @@ pbsd_init(int type)
 		}
 		return (-1);
 	}
+	log_eventf(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, LOG_INFO, msg_daemonname,
+		"Recovered %d queues in %.2f seconds", rc, recov_elapsed(&phase_start, 1));
 
 	/* Open and read in node list if one exists */
 	if ((rc = setup_nodes()) == -1) {
@@ -695,6 +701,8 @@ pbsd_init(int type)
 		log_errf(-1, __func__, log_buffer);
 		return (-1);
 	}
+	log_eventf(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, LOG_INFO, msg_daemonname,
+		"Recovered %d nodes in %.2f seconds", svr_totnodes, recov_elapsed(&phase_start, 1));
 	mark_which_queues_have_nodes();
 	(void) license_sanity_check();
 
@@ -711,13 +719,14 @@ pbsd_init(int type)
 	set_ical_zoneinfo(zone_dir);
 
 	/* load reservations */
-	if ((resvs_idx = pbs_idx_create(0, 0)) == NULL) {
+	if ((resvs_idx = pbs_idx_create(PBS_IDX_HASH, 0)) == NULL) {
 		log_err(-1, __func__, "Creating reservations index failed!");
 		return (-1);
 	}
 	obj.pbs_db_obj_type = PBS_DB_RESV;
 	obj.pbs_db_un.pbs_db_resv = &dbresv;
 
+	gettimeofday(&phase_start, NULL);
 	rc = pbs_db_search(conn, &obj, NULL, (query_cb_t)&recov_resv_cb);
 	if (rc == -1) {
 		pbs_db_get_errmsg(PBS_DB_ERR, &conn_db_err);
@@ -727,13 +736,15 @@ pbsd_init(int type)
 		}
 		return (-1);
 	}
+	log_eventf(PBSEVENT_SYSTEM, PBS_EVENTCLASS_SERVER, LOG_INFO, msg_daemonname,
+		"Recovered %d reservations in %.2f seconds", rc, recov_elapsed(&phase_start, 1));
 
 	/*
 	 * 9. If not "create" or "clean" recovery, recover the jobs.
 	 *    If a create or clean recovery, delete any jobs.
 	 *    Before job creation/recovery, create the jobs index.
 	 */
-	if ((jobs_idx = pbs_idx_create(0, 0)) == NULL) {
+	if ((jobs_idx = pbs_idx_create(PBS_IDX_HASH, 0)) == NULL) {
 		log_err(-1, __func__, "Creating jobs index failed!");
 		return (-1);
 	}
@@ -743,7 +754,10 @@ pbsd_init(int type)
 	/* get jobs from DB */
 	obj.pbs_db_obj_type = PBS_DB_JOB;
 	obj.pbs_db_un.pbs_db_job = &dbjob;
+	gettimeofday(&phase_start, NULL);
 	rc = pbs_db_search(conn, &obj, NULL, (query_cb_t)&recov_job_cb);
+	/* finish the jobs still waiting in a batch */
+	recov_job_cb_end(&phase_start);
 	if (rc == -1) {
 		pbs_db_get_errmsg(PBS_DB_ERR, &conn_db_err);
 		if (conn_db_err != NULL) {
@@ -1344,6 +1358,7 @@ pbsd_init_job(job *pjob, int type)
 
 			pjob->ji_subjindx = subjob_index_to_offset(pjob->ji_parentaj, get_index_from_jid(pjob->ji_qs.ji_jobid));
 			pjob->ji_parentaj->ji_ajtrk->tkm_tbl[pjob->ji_subjindx].trk_psubjob = pjob;
+			subjob_inherit_attrs(pjob);
 			/* update the tracking table */
 			set_subjob_tblstate(pjob->ji_parentaj, pjob->ji_subjindx, pjob->ji_qs.ji_state);
 		}
@@ -1481,6 +1496,7 @@ pbsd_init_job(job *pjob, int type)
 			case JOB_SUBSTATE_TERMINATED:
 				if (pbsd_init_reque(pjob, KEEP_STATE) == -1)
 					return -1;
+				svr_histjob_link(pjob);
 				break;
 
 			case JOB_SUBSTATE_RERUN:
@@ -86,6 +86,7 @@
 #include "credential.h"
 #include "batch_request.h"
 #include "pbs_idx.h"
+#include "pbs_idcache.h"
 #include "pbs_nodes.h"
 #include "svrfunc.h"
 #include "tracking.h"
@@ -1337,6 +1338,9 @@ main(int argc, char **argv)
 		return (3);
 	}
 
+	/* cache user and group lookups, now that the daemon has forked */
+	idcache_init(PBS_IDCACHE_TTL, PBS_IDCACHE_NEG_TTL, 1);
+
 	tpp_set_app_net_handler(net_down_handler, net_restore_handler);
 	tpp_conf.node_type = TPP_LEAF_NODE_LISTEN; /* server needs to know about all CTL LEAVE messages */
 
@@ -1536,7 +1540,7 @@ main(int argc, char **argv)
 					psched->svr_do_schedule = SCH_SCHEDULE_NULL;
 				} else if (((svr_unsent_qrun_req) || ((psched->svr_do_schedule != SCH_SCHEDULE_NULL) &&
 					psched->sch_attr[(int)SCHED_ATR_scheduling].at_val.at_long))
-					&& can_schedule()) {
+					&& can_schedule() && (sched_trigger_wait(psched) == 0)) {
 					/*
 					 * If svr_unsent_qrun_req is set to one there are pending qrun
 					 * request, then do schedule_jobs irrespective of the server scheduling
@@ -1786,10 +1790,19 @@ next_task()
 			set_scheduler_flag(SCH_SCHEDULE_TIME, psched);
 		else if (delay < tilwhen)
 			tilwhen = delay;
+
+		/* a held trigger starts its cycle once the spacing has passed */
+		if ((psched->svr_do_schedule != SCH_SCHEDULE_NULL) &&
+			((delay = sched_trigger_wait(psched)) > 0) && (delay < tilwhen))
+			tilwhen = delay;
 	}
 
 	next_sync_mom_hookfiles();
 
+	/* a delete/signal job list still has jobs, come right back for it */
+	if (joblist_next())
+		tilwhen = 0;
+
 	return (tilwhen);
 }
 
@@ -58,6 +58,8 @@
  *	process_request()
  *	set_to_non_blocking()
  *	clear_non_blocking()
+ *	post_stat_child()
+ *	stat_in_child()
  *	dispatch_request()
  *	close_client()
  *	alloc_br()
@@ -80,8 +82,10 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <time.h>
+#include <signal.h>
 #include <sys/types.h>
 #include <sys/time.h>
+#include <sys/wait.h>
 #include <netinet/in.h>
 #include <memory.h>
 #include <assert.h>
@@ -111,6 +115,7 @@
 #include "svrfunc.h"
 #include "pbs_sched.h"
 #include "auth.h"
+#include "work_task.h"
 
 /* global data items */
 
@@ -357,6 +362,9 @@ process_request(int sfds)
 	}
 
 #ifndef PBS_MOM
+	/* a client pipelining requests may have more in flight from now on */
+	if (request->rq_reqid != 0)
+		conn->cn_authen |= PBS_NET_CONN_ASYNC;
 	strcpy(conn->cn_physhost, request->rq_host);
 	if (conn->cn_username[0] == '\0')
 		strcpy(conn->cn_username, request->rq_user);
@@ -547,6 +555,7 @@ process_request(int sfds)
 		switch (request->rq_type) {
 			case PBS_BATCH_AsyrunJob:
 			case PBS_BATCH_AsyrunJob_ack:
+			case PBS_BATCH_RunJobList:
 			case PBS_BATCH_JobCred:
 			case PBS_BATCH_UserCred:
 			case PBS_BATCH_MoveJob:
@@ -654,6 +663,143 @@ clear_non_blocking(conn_t *conn)
 		conn->cn_sockflgs = 0;
 	}
 }
+
+#define STAT_CHILD_MAX		8	/* status children running at most */
+#define STAT_CHILD_TIMEOUT	600	/* seconds a status child may take */
+
+static int stat_children = 0;	/* status children now running */
+
+/**
+ * @brief
+ *		Work task run when a status child has exited.
+ *
+ * @param[in] ptask - the deferred child work task, wt_aux holds the exit status
+ */
+static void
+post_stat_child(struct work_task *ptask)
+{
+	if (stat_children > 0)
+		stat_children--;
+	if (!WIFEXITED(ptask->wt_aux) || (WEXITSTATUS(ptask->wt_aux) != 0))
+		log_eventf(PBSEVENT_DEBUG, PBS_EVENTCLASS_REQUEST, LOG_DEBUG, __func__,
+			"status child %ld ended with status 0x%x",
+			ptask->wt_event, ptask->wt_aux);
+}
+
+/**
+ * @brief
+ *		Service a status or select request in a forked child.
+ *
+ * @par
+ *		The child sees the copy-on-write image of the server taken at the
+ *		fork, a consistent snapshot of the jobs and nodes, so a large
+ *		status reply is built and written out while the main loop goes on
+ *		with job starts, obits and Mom traffic.  The client waits for the
+ *		reply before sending anything else on the connection, so the main
+ *		loop keeps the connection and reads the next request as usual.
+ * @par
+ *		This is done only for requests covering all jobs of the server or
+ *		a queue, all nodes, or a job selection, when the server attribute
+ *		stat_snapshot_threshold is set and the server holds at least that
+ *		many jobs (nodes), and fewer than STAT_CHILD_MAX children are
+ *		running.
+ *		Requests on encrypted channels are never forked, as the child would
+ *		advance an encryption context the main loop still uses.  Neither
+ *		are requests on a connection which has carried a request id,
+ *		even a plain request sent after it: the client may have more
+ *		requests in flight and would see the replies of both processes
+ *		interleave on the connection.
+ *
+ * @param[in] conn - the connection the request came in on
+ * @param[in] request - the request
+ * @param[in] func - the function servicing the request
+ *
+ * @return	int
+ * @retval	1	- a child services the request, it has been freed
+ * @retval	0	- the caller must service the request
+ */
+static int
+stat_in_child(conn_t *conn, struct batch_request *request,
+	void (*func)(struct batch_request *))
+{
+	attribute *pattr = &server.sv_attr[(int)SVR_ATR_stat_snapshot_threshold];
+	char *id;
+	struct work_task *ptask;
+	struct sigaction act;
+	long nobjs;
+	pid_t pid;
+
+	if ((conn == NULL) || (request->prot != PROT_TCP) ||
+		(conn->cn_authen & PBS_NET_CONN_ASYNC))
+		return 0;
+
+	switch (request->rq_type) {
+		case PBS_BATCH_StatusJob:
+			/* a list of job ids is cheap to status in line */
+			id = request->rq_ind.rq_status.rq_id;
+			if (isdigit((int)*id))
+				return 0;
+			nobjs = server.sv_qs.sv_numjobs;
+			break;
+		case PBS_BATCH_StatusNode:
+			id = request->rq_ind.rq_status.rq_id;
+			if ((*id != '\0') && (*id != '@'))
+				return 0;
+			nobjs = svr_totnodes;
+			break;
+		default:
+			nobjs = server.sv_qs.sv_numjobs;
+			break;
+	}
+	if (((pattr->at_flags & ATR_VFLAG_SET) == 0) ||
+		(pattr->at_val.at_long <= 0) || (nobjs < pattr->at_val.at_long))
+		return 0;
+	if (stat_children >= STAT_CHILD_MAX)
+		return 0;
+	if (transport_chan_get_authdef(conn->cn_sock, FOR_ENCRYPT) != NULL)
+		return 0;
+
+	pid = fork();
+	if (pid == -1) {
+		log_err(errno, __func__, "fork failed");
+		return 0;
+	}
+
+	if (pid == 0) {
+		/* the child: answer from the snapshot and go away */
+		sigemptyset(&act.sa_mask);
+		act.sa_flags = 0;
+		act.sa_handler = SIG_DFL;
+		(void)sigaction(SIGCHLD, &act, NULL);
+		(void)sigaction(SIGHUP, &act, NULL);
+		(void)sigaction(SIGINT, &act, NULL);
+		(void)sigaction(SIGTERM, &act, NULL);
+		(void)sigaction(SIGALRM, &act, NULL);
+		(void)sigprocmask(SIG_SETMASK, &act.sa_mask, NULL);
+
+		tpp_terminate();
+		net_close(conn->cn_sock);
+		daemon_protect(0, PBS_DAEMON_PROTECT_OFF);
+
+		/* a client that stops reading must not keep us around */
+		alarm(STAT_CHILD_TIMEOUT);
+		func(request);
+		/* skip exit handlers and stdio buffers belonging to the server */
+		_exit(0);
+	}
+
+	/* the parent */
+	ptask = set_task(WORK_Deferred_Child, pid, post_stat_child, NULL);
+	if (ptask == NULL)
+		log_err(errno, __func__, msg_err_malloc);
+	else
+		stat_children++;
+	log_eventf(PBSEVENT_DEBUG2, PBS_EVENTCLASS_REQUEST, LOG_DEBUG, __func__,
+		"request type %d on socket %d handed to child %d",
+		request->rq_type, conn->cn_sock, (int)pid);
+	free_br(request);
+	return 1;
+}
 #endif	/* !PBS_MOM */
 
 /**
@@ -785,6 +931,7 @@ dispatch_request(int sfds, struct batch_request *request)
 			break;
 
 		case PBS_BATCH_Manager:
+		case PBS_BATCH_ManagerList:
 			req_manager(request);
 			break;
 
@@ -808,6 +955,12 @@ dispatch_request(int sfds, struct batch_request *request)
 			req_modifyjob(request);
 			break;
 
+#ifndef PBS_MOM
+		case PBS_BATCH_ModifyJobList_Async:
+			req_modifyjoblist(request);
+			break;
+#endif
+
 		case PBS_BATCH_Rerun:
 			req_rerunjob(request);
 			break;
@@ -844,6 +997,17 @@ dispatch_request(int sfds, struct batch_request *request)
 			req_runjob(request);
 			break;
 
+		case PBS_BATCH_RunJobList:
+			req_runjoblist(request);
+			break;
+
+		case PBS_BATCH_DeleteJobList:
+		case PBS_BATCH_SignalJobList:
+			if (sfds != PBS_LOCAL_CONNECTION && prot == PROT_TCP)
+				conn->cn_authen |= PBS_NET_CONN_NOTIMEOUT;
+			req_joblist(request);
+			break;
+
 		case PBS_BATCH_DefSchReply:
 			req_defschedreply(request);
 			break;
@@ -854,6 +1018,8 @@ dispatch_request(int sfds, struct batch_request *request)
 
 		case PBS_BATCH_SelectJobs:
 		case PBS_BATCH_SelStat:
+			if (stat_in_child(conn, request, req_selectjobs))
+				break;
 			req_selectjobs(request);
 			break;
 
@@ -877,6 +1043,8 @@ dispatch_request(int sfds, struct batch_request *request)
 #ifndef PBS_MOM		/* Server Only Functions */
 
 		case PBS_BATCH_StatusJob:
+			if (stat_in_child(conn, request, req_stat_job))
+				break;
 			if (set_to_non_blocking(conn) == -1) {
 				req_reject(PBSE_SYSTEM, 0, request);
 				close_client(sfds);
@@ -897,6 +1065,8 @@ dispatch_request(int sfds, struct batch_request *request)
 			break;
 
 		case PBS_BATCH_StatusNode:
+			if (stat_in_child(conn, request, req_stat_node))
+				break;
 			if (set_to_non_blocking(conn) == -1) {
 				req_reject(PBSE_SYSTEM, 0, request);
 				close_client(sfds);
@@ -1430,6 +1600,10 @@ free_br(struct batch_request *preq)
 		case PBS_BATCH_Manager:
 			freebr_manage(&preq->rq_ind.rq_manager);
 			break;
+		case PBS_BATCH_ManagerList:
+			freebr_manage(&preq->rq_ind.rq_manager);
+			free(preq->rq_ind.rq_management.rq_objlist);
+			break;
 		case PBS_BATCH_ReleaseJob:
 			freebr_manage(&preq->rq_ind.rq_release);
 			break;
@@ -1451,6 +1625,32 @@ free_br(struct batch_request *preq)
 			free(preq->rq_ind.rq_preempt.ppj_list);
 			free(preq->rq_reply.brp_un.brp_preempt_jobs.ppj_list);
 			break;
+		case PBS_BATCH_RunJobList: {
+			int i;
+
+			for (i = 0; i < preq->rq_ind.rq_runlist.rq_count; i++)
+				free(preq->rq_ind.rq_runlist.rq_jobs[i].rq_destin);
+			free(preq->rq_ind.rq_runlist.rq_jobs);
+			break;
+		}
+		case PBS_BATCH_ModifyJobList_Async: {
+			int i;
+
+			for (i = 0; i < preq->rq_ind.rq_modifylist.rq_count; i++)
+				free_attrlist(&preq->rq_ind.rq_modifylist.rq_jobs[i].rq_attr);
+			free(preq->rq_ind.rq_modifylist.rq_jobs);
+			break;
+		}
+		case PBS_BATCH_DeleteJobList:
+		case PBS_BATCH_SignalJobList: {
+			int i;
+
+			for (i = 0; i < preq->rq_ind.rq_joblist.rq_count; i++)
+				free(preq->rq_ind.rq_joblist.rq_jobids[i]);
+			free(preq->rq_ind.rq_joblist.rq_jobids);
+			free_attrlist(&preq->rq_ind.rq_joblist.rq_filter);
+			break;
+		}
 #endif /* PBS_MOM */
 	}
 	if (preq->tppcmd_msgid)
@@ -222,6 +222,7 @@ dis_reply_write(int sfds, struct batch_request *preq)
 		pbs_tcp_errno = 0;
 		DIS_tcp_funcs();		/* setup for DIS over tcp */
 
+		preply->brp_reqid = preq->rq_reqid;
 		rc = encode_DIS_reply(sfds, preply);
 	}
 
@@ -282,6 +283,7 @@ reply_send(struct batch_request *request)
 	int		    sfds = request->rq_conn;		/* socket */
 
 	if (request && (request->rq_type == PBS_BATCH_ModifyJob_Async ||
+			request->rq_type == PBS_BATCH_ModifyJobList_Async ||
 			request->rq_type == PBS_BATCH_AsyrunJob)) {
 		free_br(request);
 		return 0;
@@ -290,7 +292,19 @@ reply_send(struct batch_request *request)
 
 	/* if this is a child request, just move the error to the parent */
 	if (request->rq_parentbr) {
-		if ((request->rq_parentbr->rq_reply.brp_choice == BATCH_REPLY_CHOICE_NULL) && (request->rq_parentbr->rq_reply.brp_code == 0)) {
+		if (request->rq_parentbr->rq_type == PBS_BATCH_RunJobList) {
+			/* one job of a run job list, its code goes in the list's reply */
+			struct batch_request *plist = request->rq_parentbr;
+
+			plist->rq_reply.brp_un.brp_runjobs.brp_codes[plist->rq_ind.rq_runlist.rq_cur] =
+				request->rq_reply.brp_code;
+#ifndef PBS_MOM
+		} else if ((request->rq_parentbr->rq_type == PBS_BATCH_DeleteJobList) ||
+			(request->rq_parentbr->rq_type == PBS_BATCH_SignalJobList)) {
+			/* one job of a delete/signal job list, counted in the list's reply */
+			joblist_child_reply(request->rq_parentbr, request);
+#endif	/* PBS_MOM */
+		} else if ((request->rq_parentbr->rq_reply.brp_choice == BATCH_REPLY_CHOICE_NULL) && (request->rq_parentbr->rq_reply.brp_code == 0)) {
 			request->rq_parentbr->rq_reply.brp_code = request->rq_reply.brp_code;
 			request->rq_parentbr->rq_reply.brp_auxcode = request->rq_reply.brp_auxcode;
 			if (request->rq_reply.brp_choice == BATCH_REPLY_CHOICE_Text) {
@@ -370,7 +384,8 @@ reply_ack(struct batch_request *preq)
 	if (preq == NULL)
 		return;
 
-	if (preq->rq_type == PBS_BATCH_ModifyJob_Async || preq->rq_type == PBS_BATCH_AsyrunJob) {
+	if (preq->rq_type == PBS_BATCH_ModifyJob_Async || preq->rq_type == PBS_BATCH_ModifyJobList_Async ||
+		preq->rq_type == PBS_BATCH_AsyrunJob) {
 		free_br(preq);
 		return;
 	}
@@ -432,6 +447,12 @@ reply_free(struct batch_reply *prep)
 		(void)free(prep->brp_un.brp_rescq.brq_alloc);
 		(void)free(prep->brp_un.brp_rescq.brq_resvd);
 		(void)free(prep->brp_un.brp_rescq.brq_down);
+	} else if (prep->brp_choice == BATCH_REPLY_CHOICE_RunJobs) {
+		free(prep->brp_un.brp_runjobs.brp_codes);
+		prep->brp_un.brp_runjobs.brp_codes = NULL;
+	} else if (prep->brp_choice == BATCH_REPLY_CHOICE_JobList) {
+		free(prep->brp_un.brp_joblist.brp_errs);
+		prep->brp_un.brp_joblist.brp_errs = NULL;
 	}
 	prep->brp_choice = BATCH_REPLY_CHOICE_NULL;
 }
@@ -457,7 +478,8 @@ req_reject(int code, int aux, struct batch_request *preq)
 	if (preq == NULL)
 		return;
 
-	if (preq->rq_type == PBS_BATCH_ModifyJob_Async || preq->rq_type == PBS_BATCH_AsyrunJob) {
+	if (preq->rq_type == PBS_BATCH_ModifyJob_Async || preq->rq_type == PBS_BATCH_ModifyJobList_Async ||
+		preq->rq_type == PBS_BATCH_AsyrunJob) {
 		free_br(preq);
 		return;
 	}
@@ -514,7 +536,7 @@ reply_badattr(int code, int aux, svrattrl *pal,
 	if (preq == NULL)
 		return;
 
-	if (preq->rq_type == PBS_BATCH_ModifyJob_Async) {
+	if (preq->rq_type == PBS_BATCH_ModifyJob_Async || preq->rq_type == PBS_BATCH_ModifyJobList_Async) {
 		free_br(preq);
 		return;
 	}
@@ -572,7 +594,7 @@ reply_text(struct batch_request *preq, int code, char *text)
 	if (preq == NULL)
 		return 0;
 
-	if (preq->rq_type == PBS_BATCH_ModifyJob_Async) {
+	if (preq->rq_type == PBS_BATCH_ModifyJob_Async || preq->rq_type == PBS_BATCH_ModifyJobList_Async) {
 		free_br(preq);
 		return 0;
 	}
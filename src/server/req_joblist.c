@@ -0,0 +1,457 @@
+/*
+ * Copyright (C) 1994-2020 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+/**
+ * @file	req_joblist.c
+ *
+ * Functions relating to the Delete Job List and Signal Job List Batch
+ * Requests, which delete or signal many jobs with one request.
+ *
+ * Included funtions are:
+ *	req_joblist()
+ *	joblist_child_reply()
+ *	joblist_next()
+ *
+ */
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/time.h>
+#include "libpbs.h"
+#include "server_limits.h"
+#include "list_link.h"
+#include "work_task.h"
+#include "attribute.h"
+#include "server.h"
+#include "credential.h"
+#include "batch_request.h"
+#include "job.h"
+#include "pbs_error.h"
+#include "log.h"
+#include "svrfunc.h"
+
+/* jobs handed out per slice, the time a slice may take and the number of */
+/* failed jobs listed in the reply					   */
+#define JOBLIST_SLICE_MAX	500
+#define JOBLIST_SLICE_USEC	100000
+#define JOBLIST_ERRS_MAX	1000
+
+/* Global Data Items: */
+
+extern char *msg_err_malloc;
+extern char statechars[];
+extern struct server server;
+
+/* a list request with jobs still to hand out */
+struct joblist_work {
+	pbs_list_link jw_link;
+	struct batch_request *jw_preq;
+	char **jw_ids;		/* jobs picked by the filter, else NULL */
+	int jw_count;		/* number of jobs */
+	int jw_next;		/* next job to hand out */
+};
+
+/* Private Functions in this file */
+
+static void joblist_add_err(struct batch_request *, char *, int);
+
+/* Private Data Items */
+
+static pbs_list_head joblist_active;
+static int joblist_active_init = 0;
+
+/**
+ * @brief
+ * 		joblist_match - does a job match the filter of a list request
+ *
+ * @param[in]	preq	- Delete/Signal Job List Request
+ * @param[in]	pjob	- job
+ *
+ * @return	int
+ * @retval	1	- the job matches
+ * @retval	0	- it does not
+ */
+static int
+joblist_match(struct batch_request *preq, job *pjob)
+{
+	svrattrl *pal;
+	char *owner;
+	char *at;
+	char state;
+	size_t len;
+	int states_given = 0;
+
+	state = statechars[pjob->ji_qs.ji_state];
+	for (pal = (svrattrl *)GET_NEXT(preq->rq_ind.rq_joblist.rq_filter);
+		pal != NULL; pal = (svrattrl *)GET_NEXT(pal->al_link)) {
+		if (strcmp(pal->al_name, ATTR_owner) == 0) {
+			owner = pjob->ji_wattr[(int)JOB_ATR_job_owner].at_val.at_str;
+			if (owner == NULL)
+				return 0;
+			if (strchr(pal->al_value, '@') != NULL) {
+				if (strcmp(owner, pal->al_value) != 0)
+					return 0;
+			} else {
+				at = strchr(owner, '@');
+				len = at ? (size_t)(at - owner) : strlen(owner);
+				if ((strlen(pal->al_value) != len) ||
+					(strncmp(owner, pal->al_value, len) != 0))
+					return 0;
+			}
+		} else if (strcmp(pal->al_name, ATTR_state) == 0) {
+			states_given = 1;
+			if (strchr(pal->al_value, state) == NULL)
+				return 0;
+		} else if (strcmp(pal->al_name, ATTR_queue) == 0) {
+			if (strcmp(pjob->ji_qs.ji_queue, pal->al_value) != 0)
+				return 0;
+		}
+	}
+
+	/* finished jobs are only picked when asked for by state */
+	if (!states_given && ((pjob->ji_qs.ji_state == JOB_STATE_FINISHED) ||
+		(pjob->ji_qs.ji_state == JOB_STATE_MOVED)))
+		return 0;
+	return 1;
+}
+
+/**
+ * @brief
+ * 		joblist_slice - hand out the next jobs of a list request
+ *
+ * @par
+ *		Each job gets a Delete Job or Signal Job request of its own, a
+ *		child of the list request, serviced by req_deletejob() or
+ *		req_signaljob() as if it came from the client.  Jobs are handed
+ *		out until JOBLIST_SLICE_MAX jobs or JOBLIST_SLICE_USEC have gone
+ *		by, so the main loop goes on with other requests between slices.
+ *		The job rows purged in a slice are deleted from the database
+ *		together when the slice ends.
+ *
+ * @param[in]	pw	- the list request's work
+ *
+ * @return	int
+ * @retval	1	- jobs are left for another slice
+ * @retval	0	- all jobs handed out, pw is freed
+ */
+static int
+joblist_slice(struct joblist_work *pw)
+{
+	struct batch_request *preq = pw->jw_preq;
+	struct batch_request *nreq;
+	struct timeval start;
+	struct timeval now;
+	char *jid;
+	int n;
+
+	gettimeofday(&start, NULL);
+	job_purge_batch(1);
+
+	for (n = 0; (n < JOBLIST_SLICE_MAX) && (pw->jw_next < pw->jw_count); n++) {
+		if (pw->jw_ids)
+			jid = pw->jw_ids[pw->jw_next];
+		else
+			jid = preq->rq_ind.rq_joblist.rq_jobids[pw->jw_next];
+		pw->jw_next++;
+
+		if ((nreq = alloc_br(preq->rq_type == PBS_BATCH_DeleteJobList ?
+			PBS_BATCH_DeleteJob : PBS_BATCH_SignalJob)) == NULL) {
+			joblist_add_err(preq, jid, PBSE_SYSTEM);
+			continue;
+		}
+		nreq->rq_perm    = preq->rq_perm;
+		nreq->rq_fromsvr = preq->rq_fromsvr;
+		nreq->rq_conn    = preq->rq_conn;
+		nreq->rq_orgconn = preq->rq_orgconn;
+		nreq->rq_time    = preq->rq_time;
+		nreq->prot       = preq->prot;
+		strcpy(nreq->rq_user, preq->rq_user);
+		strcpy(nreq->rq_host, preq->rq_host);
+		nreq->rq_extend  = preq->rq_extend;	/* stays owned by the list */
+		nreq->rq_parentbr = preq;
+		++preq->rq_refct;
+
+		if (preq->rq_type == PBS_BATCH_DeleteJobList) {
+			nreq->rq_ind.rq_delete.rq_cmd = MGR_CMD_DELETE;
+			nreq->rq_ind.rq_delete.rq_objtype = MGR_OBJ_JOB;
+			snprintf(nreq->rq_ind.rq_delete.rq_objname,
+				sizeof(nreq->rq_ind.rq_delete.rq_objname), "%s", jid);
+			CLEAR_HEAD(nreq->rq_ind.rq_delete.rq_attr);
+			req_deletejob(nreq);
+		} else {
+			snprintf(nreq->rq_ind.rq_signal.rq_jid,
+				sizeof(nreq->rq_ind.rq_signal.rq_jid), "%s", jid);
+			strcpy(nreq->rq_ind.rq_signal.rq_signame,
+				preq->rq_ind.rq_joblist.rq_signame);
+			req_signaljob(nreq);
+		}
+
+		if ((n % 32) == 31) {
+			gettimeofday(&now, NULL);
+			if ((now.tv_sec - start.tv_sec) * 1000000L +
+				(now.tv_usec - start.tv_usec) >= JOBLIST_SLICE_USEC)
+				break;
+		}
+	}
+
+	job_purge_batch(0);
+
+	if (pw->jw_next < pw->jw_count)
+		return 1;
+
+	delete_link(&pw->jw_link);
+	if (pw->jw_ids) {
+		for (n = 0; n < pw->jw_count; n++)
+			free(pw->jw_ids[n]);
+		free(pw->jw_ids);
+	}
+	free(pw);
+
+	/* drop the hold of req_joblist(), reply if no job is outstanding */
+	if (--preq->rq_refct == 0)
+		reply_send(preq);
+	return 0;
+}
+
+/**
+ * @brief
+ * 		joblist_add_err - count a job a list request failed on
+ *
+ * @param[in,out]	preq	- Delete/Signal Job List Request
+ * @param[in]	jid	- job id
+ * @param[in]	code	- error
+ *
+ * @return	void
+ */
+static void
+joblist_add_err(struct batch_request *preq, char *jid, int code)
+{
+	struct brp_joblist *prep = &preq->rq_reply.brp_un.brp_joblist;
+	struct brp_joberr *tmp;
+
+	prep->brp_nfail++;
+	if (prep->brp_nerr >= JOBLIST_ERRS_MAX)
+		return;
+	if ((prep->brp_nerr % 64) == 0) {
+		tmp = realloc(prep->brp_errs, (prep->brp_nerr + 64) * sizeof(struct brp_joberr));
+		if (tmp == NULL) {
+			log_err(errno, __func__, msg_err_malloc);
+			return;
+		}
+		prep->brp_errs = tmp;
+	}
+	snprintf(prep->brp_errs[prep->brp_nerr].brp_jobid,
+		sizeof(prep->brp_errs[prep->brp_nerr].brp_jobid), "%s", jid);
+	prep->brp_errs[prep->brp_nerr].brp_code = code;
+	prep->brp_nerr++;
+}
+
+/**
+ * @brief
+ * 		joblist_child_reply - account for the reply to one job of a list
+ *		request, called by reply_send() for a child of the list
+ *
+ * @param[in,out]	preq	- Delete/Signal Job List Request
+ * @param[in]	child	- the job's Delete Job or Signal Job request
+ *
+ * @return	void
+ */
+void
+joblist_child_reply(struct batch_request *preq, struct batch_request *child)
+{
+	int code = child->rq_reply.brp_code;
+
+	if ((code == PBSE_NONE) || (code == PBSE_HISTJOBDELETED))
+		preq->rq_reply.brp_un.brp_joblist.brp_ndone++;
+	else if (child->rq_type == PBS_BATCH_DeleteJob)
+		joblist_add_err(preq, child->rq_ind.rq_delete.rq_objname, code);
+	else
+		joblist_add_err(preq, child->rq_ind.rq_signal.rq_jid, code);
+}
+
+/**
+ * @brief
+ * 		req_joblist - service the Delete Job List and Signal Job List
+ *		Requests
+ *
+ * @par
+ *		The jobs are those named in the request, which may be array jobs
+ *		or ranges of subjobs, or, when a filter of owner, job_state and
+ *		queue is given instead, the jobs of the server matching all of it.
+ *		Subjobs are not picked by a filter, they go with their array job.
+ *		A filter picks only the requester's own jobs unless the requester
+ *		is a manager or operator.
+ * @par
+ *		The jobs are handed out in slices from the main loop, see
+ *		joblist_next(), and one reply is sent once all of them are done,
+ *		giving the number of jobs handled and those that failed.
+ *
+ * @param[in]	preq	- Delete/Signal Job List Request
+ *
+ * @return	void
+ */
+void
+req_joblist(struct batch_request *preq)
+{
+	struct rq_joblist *plist = &preq->rq_ind.rq_joblist;
+	struct joblist_work *pw;
+	svrattrl *pal;
+	job *pjob;
+	char **ids = NULL;
+	char **tmp;
+	int count = 0;
+	int size = 0;
+	int privileged;
+
+	if ((preq->rq_type == PBS_BATCH_SignalJobList) && (plist->rq_signame[0] == '\0')) {
+		req_reject(PBSE_IVALREQ, 0, preq);
+		return;
+	}
+
+	pal = (svrattrl *)GET_NEXT(plist->rq_filter);
+	if (((plist->rq_count == 0) && (pal == NULL)) ||
+		((plist->rq_count != 0) && (pal != NULL))) {
+		req_reject(PBSE_IVALREQ, 0, preq);
+		return;
+	}
+	for (; pal != NULL; pal = (svrattrl *)GET_NEXT(pal->al_link)) {
+		if ((strcmp(pal->al_name, ATTR_owner) != 0) &&
+			(strcmp(pal->al_name, ATTR_state) != 0) &&
+			(strcmp(pal->al_name, ATTR_queue) != 0)) {
+			reply_badattr(PBSE_NOATTR, 1, pal, preq);
+			return;
+		}
+		if ((pal->al_value == NULL) || (*pal->al_value == '\0')) {
+			reply_badattr(PBSE_BADATVAL, 1, pal, preq);
+			return;
+		}
+	}
+
+	if (plist->rq_count == 0) {
+		privileged = preq->rq_perm & (ATR_DFLAG_MGWR | ATR_DFLAG_OPWR);
+		for (pjob = (job *)GET_NEXT(svr_alljobs); pjob != NULL;
+			pjob = (job *)GET_NEXT(pjob->ji_alljobs)) {
+			if (pjob->ji_qs.ji_svrflags & JOB_SVFLG_SubJob)
+				continue;
+			if (!privileged && (svr_chk_owner(preq, pjob) != 0))
+				continue;
+			if (!joblist_match(preq, pjob))
+				continue;
+			if (count == size) {
+				size = size ? size * 2 : 256;
+				if ((tmp = realloc(ids, size * sizeof(char *))) == NULL)
+					break;
+				ids = tmp;
+			}
+			if ((ids[count] = strdup(pjob->ji_qs.ji_jobid)) == NULL)
+				break;
+			count++;
+		}
+		if (pjob != NULL) {
+			log_err(errno, __func__, msg_err_malloc);
+			while (count > 0)
+				free(ids[--count]);
+			free(ids);
+			req_reject(PBSE_SYSTEM, 0, preq);
+			return;
+		}
+	} else
+		count = plist->rq_count;
+
+	if ((pw = calloc(1, sizeof(struct joblist_work))) == NULL) {
+		log_err(errno, __func__, msg_err_malloc);
+		while (count > 0 && ids != NULL)
+			free(ids[--count]);
+		free(ids);
+		req_reject(PBSE_SYSTEM, 0, preq);
+		return;
+	}
+	pw->jw_preq = preq;
+	pw->jw_ids = ids;
+	pw->jw_count = count;
+	CLEAR_LINK(pw->jw_link);
+
+	preq->rq_reply.brp_choice = BATCH_REPLY_CHOICE_JobList;
+	memset(&preq->rq_reply.brp_un.brp_joblist, 0, sizeof(struct brp_joblist));
+
+	log_eventf(PBSEVENT_DEBUG, PBS_EVENTCLASS_REQUEST, LOG_INFO, preq->rq_user,
+		"%s of %d jobs requested by %s@%s",
+		preq->rq_type == PBS_BATCH_DeleteJobList ? "delete" : "signal",
+		count, preq->rq_user, preq->rq_host);
+
+	if (!joblist_active_init) {
+		CLEAR_HEAD(joblist_active);
+		joblist_active_init = 1;
+	}
+	append_link(&joblist_active, &pw->jw_link, pw);
+
+	/* hold the list until all jobs have been handed out */
+	++preq->rq_refct;
+	(void)joblist_slice(pw);
+}
+
+/**
+ * @brief
+ * 		joblist_next - hand out the next slice of jobs of every list
+ *		request in progress, called once per pass of the main loop
+ *
+ * @return	int
+ * @retval	1	- jobs are left, the main loop should not sleep
+ * @retval	0	- no list request in progress
+ */
+int
+joblist_next(void)
+{
+	struct joblist_work *pw;
+	struct joblist_work *nxt;
+	int left = 0;
+
+	if (!joblist_active_init)
+		return 0;
+
+	for (pw = (struct joblist_work *)GET_NEXT(joblist_active); pw != NULL; pw = nxt) {
+		nxt = (struct joblist_work *)GET_NEXT(pw->jw_link);
+		left |= joblist_slice(pw);
+	}
+	return left;
+}
@@ -1915,6 +1915,68 @@ mgr_queue_unset(struct batch_request *preq)
 	reply_ack(preq);
 }
 
+/**
+ * @brief
+ *		Resolve the object list of a PBS_BATCH_ManagerList request
+ *		into vnodes
+ *
+ *		Every name must be a known vnode; if one is not, the request is
+ *		rejected naming it so nothing is applied to part of the list.
+ *
+ * @param[in]	preq	- Pointer to a batch request structure
+ * @param[out]	pnum	- number of vnodes returned
+ *
+ * @return	struct pbsnode **
+ * @retval	malloc'ed array of vnodes, free with free()
+ * @retval	NULL	- the request has been rejected
+ *
+ * @par MT-safe: No
+ */
+static struct pbsnode **
+mgr_node_list(struct batch_request *preq, int *pnum)
+{
+	char *list = preq->rq_ind.rq_management.rq_objlist;
+	char *name;
+	char *end;
+	int num = 1;
+	struct pbsnode *pnode;
+	struct pbsnode **nodes;
+
+	*pnum = 0;
+	if ((list == NULL) || (*list == '\0')) {
+		req_reject(PBSE_UNKNODE, 0, preq);
+		return NULL;
+	}
+	for (name = list; *name; name++) {
+		if (*name == ',')
+			num++;
+	}
+	nodes = (struct pbsnode **)malloc(num * sizeof(struct pbsnode *));
+	if (nodes == NULL) {
+		log_err(ENOMEM, __func__, "out of memory");
+		req_reject(PBSE_SYSTEM, 0, preq);
+		return NULL;
+	}
+
+	for (name = list; name != NULL; name = end) {
+		if ((end = strchr(name, ',')) != NULL)
+			*end = '\0';
+		pnode = find_nodebyname(name);
+		if (pnode == NULL) {
+			snprintf(log_buffer, LOG_BUF_SIZE, "%s %s", pbse_to_txt(PBSE_UNKNODE), name);
+			if (end != NULL)
+				*end = ',';
+			reply_text(preq, PBSE_UNKNODE, log_buffer);
+			free(nodes);
+			return NULL;
+		}
+		if (end != NULL)
+			*end++ = ',';
+		nodes[(*pnum)++] = pnode;
+	}
+	return nodes;
+}
+
 /**
  * @brief
  *		Set vnode attributes
@@ -1957,10 +2019,16 @@ mgr_node_set(struct batch_request *preq)
 	struct pbsnode **warn_nodes = NULL;
 	int warn_idx = 0;
 	int replied = 0; /* boolean */
+	struct pbsnode **list = NULL;
 
 	nodename = preq->rq_ind.rq_manager.rq_objname;
 
-	if (((*preq->rq_ind.rq_manager.rq_objname == '\0') ||
+	if (preq->rq_type == PBS_BATCH_ManagerList) {
+		/* Operating on the vnodes named in the request's list */
+		if ((list = mgr_node_list(preq, &numnodes)) == NULL)
+			return;
+		pnode = list[0];
+	} else if (((*preq->rq_ind.rq_manager.rq_objname == '\0') ||
 		(*preq->rq_ind.rq_manager.rq_objname == '@')) &&
 		(preq->rq_ind.rq_manager.rq_objtype != MGR_OBJ_HOST)) {
 
@@ -2033,12 +2101,18 @@ mgr_node_set(struct batch_request *preq)
 	}
 
 	/* set writtable attributes of node (nodes if numnodes > 1) */
-	log_eventf(PBSEVENT_ADMIN, PBS_EVENTCLASS_NODE, LOG_INFO, nodename, msg_manager, msg_man_set, preq->rq_user, preq->rq_host);
+	if (list != NULL) {
+		/* one record per vnode, as if each were set on its own */
+		for (i = 0; i < numnodes; i++)
+			log_eventf(PBSEVENT_ADMIN, PBS_EVENTCLASS_NODE, LOG_INFO, list[i]->nd_name, msg_manager, msg_man_set, preq->rq_user, preq->rq_host);
+	} else
+		log_eventf(PBSEVENT_ADMIN, PBS_EVENTCLASS_NODE, LOG_INFO, nodename, msg_manager, msg_man_set, preq->rq_user, preq->rq_host);
 
 	if (numnodes > 1) {
 		problem_nodes = (struct pbsnode **)malloc(numnodes * sizeof(struct pbsnode *));
 		if (problem_nodes == NULL) {
 			log_err(ENOMEM, __func__, "out of memory");
+			free(list);
 			return;
 		}
 		problem_cnt = 0;
@@ -2049,6 +2123,7 @@ mgr_node_set(struct batch_request *preq)
 	if (warn_nodes == NULL) {
 		log_err(ENOMEM, __func__, "out of memory");
 		free(problem_nodes);
+		free(list);
 		return;
 	}
 	warnings_update(WARN_ngrp_init, warn_nodes, &warn_idx, pnode);
@@ -2071,7 +2146,7 @@ mgr_node_set(struct batch_request *preq)
 					if (numnodes > 1) {
 						if (problem_nodes) {
 							/*we have an array in which to save*/
-							if (problem_nodes[problem_cnt - 1] != pnode) {
+							if ((problem_cnt == 0) || (problem_nodes[problem_cnt - 1] != pnode)) {
 								/* and this node was not saved already */
 								problem_nodes[ problem_cnt ] = pnode;
 								++problem_cnt;
@@ -2108,6 +2183,7 @@ mgr_node_set(struct batch_request *preq)
 								req_reject(rc, 0, preq);
 						}
 						free(warn_nodes);
+						free(list);
 						free_attrlist(&unsetlist);
 						free_attrlist(&setlist);
 						return;
@@ -2153,6 +2229,10 @@ mgr_node_set(struct batch_request *preq)
 			if (update_mom_only) {
 				break;	/* all done */
 			}
+		} else if (list != NULL) {
+			if (++i == numnodes)
+				break;	/* all done */
+			pnode = list[i];	/* next vnode in the list */
 		} else {
 			if (++i == svr_totnodes)
 				break;	/* all done */
@@ -2213,7 +2293,7 @@ mgr_node_set(struct batch_request *preq)
 
 	free(problem_nodes);
 	free(warn_nodes);
-
+	free(list);
 }
 
 
@@ -2262,10 +2342,16 @@ mgr_node_unset(struct batch_request *preq)
 	static	char *astate = ATTR_NODE_state;
 	static  char *antype = ATTR_NODE_ntype;
 	static  char *ra     = ATTR_rescavail;
+	struct pbsnode  **list = NULL;
 
 	nodename = preq->rq_ind.rq_manager.rq_objname;
 
-	if (preq->rq_ind.rq_manager.rq_objtype == MGR_OBJ_HOST) {
+	if (preq->rq_type == PBS_BATCH_ManagerList) {
+		/* Operating on the vnodes named in the request's list */
+		if ((list = mgr_node_list(preq, &numnodes)) == NULL)
+			return;
+		pnode = list[0];
+	} else if (preq->rq_ind.rq_manager.rq_objtype == MGR_OBJ_HOST) {
 		/* Operating on all vnodes on a named host          */
 		/* find the mom and get the first vnode in her list */
 		char          *pc;
@@ -2332,6 +2418,7 @@ mgr_node_unset(struct batch_request *preq)
 			((plist->al_resc == NULL) ||
 			(strcasecmp(plist->al_resc, "host") == 0)))) {
 			reply_badattr(PBSE_BADNDATVAL, bad, plist, preq);
+			free(list);
 			return;
 		}
 
@@ -2345,14 +2432,22 @@ mgr_node_unset(struct batch_request *preq)
 
 	/* unset writtable attributes of node (nodes if numnodes > 1) */
 
-	log_eventf(PBSEVENT_ADMIN, PBS_EVENTCLASS_NODE, LOG_INFO,
-		nodename, msg_manager, msg_man_uns,
-		preq->rq_user, preq->rq_host);
+	if (list != NULL) {
+		/* one record per vnode, as if each were unset on its own */
+		for (i = 0; i < numnodes; i++)
+			log_eventf(PBSEVENT_ADMIN, PBS_EVENTCLASS_NODE, LOG_INFO,
+				list[i]->nd_name, msg_manager, msg_man_uns,
+				preq->rq_user, preq->rq_host);
+	} else
+		log_eventf(PBSEVENT_ADMIN, PBS_EVENTCLASS_NODE, LOG_INFO,
+			nodename, msg_manager, msg_man_uns,
+			preq->rq_user, preq->rq_host);
 
 	if (numnodes > 1) {
 		problem_nodes = (struct pbsnode **)malloc(numnodes * sizeof(struct pbsnode *));
 		if (problem_nodes == NULL) {
 			log_err(ENOMEM, __func__, "out of memory");
+			free(list);
 			return;
 		}
 		problem_cnt = 0;
@@ -2363,6 +2458,7 @@ mgr_node_unset(struct batch_request *preq)
 	if (warn_nodes == NULL) {
 		log_err(ENOMEM, __func__, "out of memory");
 		free(problem_nodes);
+		free(list);
 		return;
 	}
 	warnings_update(WARN_ngrp_init, warn_nodes, &warn_idx, pnode);
@@ -2410,6 +2506,7 @@ mgr_node_unset(struct batch_request *preq)
 							req_reject(rc, 0, preq);
 					}
 					free(warn_nodes);
+					free(list);
 					return;
 				}
 
@@ -2461,6 +2558,10 @@ mgr_node_unset(struct batch_request *preq)
 			if (++momidx >= psvrmom->msr_numvnds)
 				break;
 			pnode = psvrmom->msr_children[momidx];
+		} else if (list != NULL) {
+			if (++i == numnodes)
+				break;
+			pnode = list[i];
 		} else {
 			if (++i == svr_totnodes)
 				break;
@@ -2518,6 +2619,7 @@ mgr_node_unset(struct batch_request *preq)
 
 	free(problem_nodes);
 	free(warn_nodes);
+	free(list);
 }
 
 /**
@@ -2780,7 +2882,7 @@ create_pbs_node2(char *objname, svrattrl *plist, int perms, int *bad, struct pbs
 
 		/* create node index if not already done */
 		if (node_idx == NULL) {
-			if ((node_idx = pbs_idx_create(0, 0)) == NULL) {
+			if ((node_idx = pbs_idx_create(PBS_IDX_HASH, 0)) == NULL) {
 				svr_totnodes--;
 				free_pnode(pnode);
 				free(pname);
@@ -4403,6 +4505,42 @@ mgr_resource_unset(struct batch_request *preq)
 	return;
 }
 
+/**
+ * @brief
+ * 		mgr_list_process_hooks - run the management hooks for a
+ *		PBS_BATCH_ManagerList request once per object in its list, so
+ *		hooks see the same events as for one request per object.
+ *
+ * @param[in]	preq	- the ManagerList request
+ * @param[out]	hook_msg - buffer for the hook message
+ * @param[in]	msg_len	- size of hook_msg
+ *
+ * @return void
+ */
+static void
+mgr_list_process_hooks(struct batch_request *preq, char *hook_msg, size_t msg_len)
+{
+	char *name;
+	char *end;
+	char *objname = preq->rq_ind.rq_manager.rq_objname;
+
+	name = preq->rq_ind.rq_management.rq_objlist;
+	if (name == NULL) {
+		process_hooks(preq, hook_msg, msg_len, pbs_python_set_interrupt);
+		return;
+	}
+	for (; name != NULL; name = end) {
+		if ((end = strchr(name, ',')) != NULL)
+			*end = '\0';
+		strncpy(objname, name, PBS_MAXSVRJOBID);
+		objname[PBS_MAXSVRJOBID] = '\0';
+		if (end != NULL)
+			*end++ = ',';
+		process_hooks(preq, hook_msg, msg_len, pbs_python_set_interrupt);
+	}
+	objname[0] = '\0';
+}
+
 /**
  * @brief
  * 		req_manager - the dispatch routine for a series of functions which
@@ -4438,6 +4576,16 @@ req_manager(struct batch_request *preq)
 
 	obj_name_len = strlen(preq->rq_ind.rq_manager.rq_objname);
 
+	if (preq->rq_type == PBS_BATCH_ManagerList) {
+		/* a list of objects is only taken for setting and unsetting vnodes */
+		if ((preq->rq_ind.rq_manager.rq_objtype != MGR_OBJ_NODE) ||
+			((preq->rq_ind.rq_manager.rq_cmd != MGR_CMD_SET) &&
+			(preq->rq_ind.rq_manager.rq_cmd != MGR_CMD_UNSET))) {
+			req_reject(PBSE_IVALREQ, 0, preq);
+			goto req_manager_exit;
+		}
+	}
+
 	switch (preq->rq_ind.rq_manager.rq_cmd) {
 
 		case MGR_CMD_CREATE:
@@ -4667,7 +4815,10 @@ req_manager(struct batch_request *preq)
 req_manager_exit:
 	{
 		char hook_msg[HOOK_MSG_SIZE];
-		process_hooks(preq, hook_msg, sizeof(hook_msg), pbs_python_set_interrupt);
+		if (preq->rq_type == PBS_BATCH_ManagerList)
+			mgr_list_process_hooks(preq, hook_msg, sizeof(hook_msg));
+		else
+			process_hooks(preq, hook_msg, sizeof(hook_msg), pbs_python_set_interrupt);
 	}
 	if (--preq->rq_refct == 0) {
 		reply_send(preq);
@@ -46,6 +46,7 @@
 #include <pbs_config.h>   /* the master config generated by configure */
 
 #include <stdio.h>
+#include <string.h>
 #include <sys/types.h>
 #include "libpbs.h"
 #include <signal.h>
@@ -158,6 +159,7 @@ req_modifyjob(struct batch_request *preq)
 	int		 sendmom = 0;
 	char		hook_msg[HOOK_MSG_SIZE];
 	int		mod_project = 0;
+	int		savejob = 0;
 	pbs_sched	*psched;
 
 	switch (process_hooks(preq, hook_msg, sizeof(hook_msg),
@@ -253,6 +255,10 @@ req_modifyjob(struct batch_request *preq)
 			reply_badattr(PBSE_NOATTR, 1, plist, preq);
 			return;
 		}
+
+		/* only attributes which are saved on modify need a save */
+		if ((job_attr_def[i].at_flags & ATR_DFLAG_NOSAVM) == 0)
+			savejob = 1;
 		if ((running == 1) &&
 			((job_attr_def[i].at_flags & ATR_DFLAG_ALTRUN) == 0)) {
 
@@ -383,7 +389,8 @@ req_modifyjob(struct batch_request *preq)
 		(void)svr_setjobstate(pjob, newstate, newsubstate);
 	}
 
-	job_save_db(pjob); /* we must save the updates anyway, if any */
+	if (savejob)
+		job_save_db(pjob); /* we must save the updates anyway, if any */
 
 	log_eventf(PBSEVENT_JOB, PBS_EVENTCLASS_JOB, LOG_INFO, pjob->ji_qs.ji_jobid, msg_manager, msg_jobmod, preq->rq_user, preq->rq_host);
 
@@ -398,6 +405,53 @@ req_modifyjob(struct batch_request *preq)
 	reply_ack(preq);
 }
 
+/**
+ * @brief
+ * 		req_modifyjoblist - service the Modify Job List Request
+ *
+ * @par	Functionality:
+ *		The scheduler sends the attribute updates (comments, estimates,
+ *		accrue type, ...) of many jobs in one request.  Each job's updates
+ *		are applied as a Modify Job Async request of their own, so the
+ *		same checks and hooks apply.  Like those, nothing is replied.
+ *
+ * @param[in] preq - pointer to batch request from client
+ */
+
+void
+req_modifyjoblist(struct batch_request *preq)
+{
+	int			i;
+	struct rq_manage	*pmod;
+	struct batch_request	*nreq;
+
+	for (i = 0; i < preq->rq_ind.rq_modifylist.rq_count; i++) {
+		pmod = &preq->rq_ind.rq_modifylist.rq_jobs[i];
+
+		nreq = alloc_br(PBS_BATCH_ModifyJob_Async);
+		if (nreq == NULL)
+			break;
+		nreq->rq_perm    = preq->rq_perm;
+		nreq->rq_fromsvr = preq->rq_fromsvr;
+		nreq->rq_conn    = preq->rq_conn;
+		nreq->rq_orgconn = preq->rq_orgconn;
+		nreq->rq_time    = preq->rq_time;
+		nreq->prot       = preq->prot;
+		strcpy(nreq->rq_user, preq->rq_user);
+		strcpy(nreq->rq_host, preq->rq_host);
+		nreq->rq_ind.rq_modify.rq_cmd = pmod->rq_cmd;
+		nreq->rq_ind.rq_modify.rq_objtype = pmod->rq_objtype;
+		strcpy(nreq->rq_ind.rq_modify.rq_objname, pmod->rq_objname);
+		/* the new request owns the attributes from here on */
+		CLEAR_HEAD(nreq->rq_ind.rq_modify.rq_attr);
+		list_move(&pmod->rq_attr, &nreq->rq_ind.rq_modify.rq_attr);
+
+		req_modifyjob(nreq);
+	}
+
+	reply_ack(preq);
+}
+
 /**
  * @brief
  * 		Returns the svrattrl entry matching attribute 'name', or NULL if not found.
@@ -94,6 +94,7 @@
 #include "hook.h"
 #include "pbs_internal.h"
 #include "pbs_sched.h"
+#include "pbs_idcache.h"
 #ifndef PBS_MOM
 #include "pbs_db.h"
 #define SEQ_WIN_INCR 1000 /*save jobid number to database in this increment*/
@@ -1105,7 +1106,7 @@ req_quejob(struct batch_request *preq)
 #else
 		struct passwd		*pwdp;
 
-		pwdp = getpwnam(pj->ji_wattr[(int)JOB_ATR_euser].at_val.at_str);
+		pwdp = idcache_getpwnam(pj->ji_wattr[(int)JOB_ATR_euser].at_val.at_str);
 		if ((pwdp != NULL) && (pwdp->pw_uid == 0))
 #endif
 		{
@@ -1367,7 +1368,7 @@ req_jobscript(struct batch_request *preq)
 #else
 			struct passwd		*pwdp;
 
-			pwdp = getpwnam(pj->ji_wattr[(int)JOB_ATR_euser].\
+			pwdp = idcache_getpwnam(pj->ji_wattr[(int)JOB_ATR_euser].\
 								at_val.at_str);
 			if ((pwdp != NULL) && (pwdp->pw_uid == 0))
 #endif
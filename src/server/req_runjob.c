@@ -47,6 +47,7 @@
  *	check_and_provision_job()
  *	clear_from_defr()
  *	req_runjob()
+ *	req_runjoblist()
  *	req_runjob2()
  *	clear_exec_on_run_fail()
  *	req_stagein()
@@ -633,6 +634,81 @@ req_runjob(struct batch_request *preq)
 		reply_send(preq);
 	return;
 }
+
+/**
+ * @brief
+ * 		req_runjoblist - service the Run Job List Request
+ * @par
+ *		The scheduler sends the run requests of a cycle in one list.  Each
+ *		entry is run as an asynchronous (ack) run of its own through
+ *		req_runjob() and the code each one replies with is saved in the
+ *		reply to the list, in the same order as the jobs were sent.
+ *		Ranges of subjobs are not allowed in a list.
+ *
+ * @param[in]	preq	-	Run Job List Request
+ */
+
+void
+req_runjoblist(struct batch_request *preq)
+{
+	int			i;
+	int			count;
+	int			*codes;
+	struct rq_runjob	*prun;
+	struct batch_request	*nreq;
+
+	if ((preq->rq_perm & (ATR_DFLAG_MGWR | ATR_DFLAG_OPWR)) == 0) {
+		req_reject(PBSE_PERM, 0, preq);
+		return;
+	}
+
+	count = preq->rq_ind.rq_runlist.rq_count;
+	codes = calloc(count ? count : 1, sizeof(int));
+	if (codes == NULL) {
+		req_reject(PBSE_SYSTEM, 0, preq);
+		return;
+	}
+	preq->rq_reply.brp_choice = BATCH_REPLY_CHOICE_RunJobs;
+	preq->rq_reply.brp_un.brp_runjobs.brp_count = count;
+	preq->rq_reply.brp_un.brp_runjobs.brp_codes = codes;
+
+	/* hold the list until every job in it has been handled */
+	++preq->rq_refct;
+
+	for (i = 0; i < count; i++) {
+		prun = &preq->rq_ind.rq_runlist.rq_jobs[i];
+		if ((is_job_array(prun->rq_jid) == IS_ARRAY_Range) ||
+			(prun->rq_destin == NULL) || (*prun->rq_destin == '\0')) {
+			codes[i] = PBSE_IVALREQ;
+			continue;
+		}
+
+		nreq = alloc_br(PBS_BATCH_AsyrunJob_ack);
+		if (nreq == NULL) {
+			codes[i] = PBSE_SYSTEM;
+			continue;
+		}
+		nreq->rq_perm    = preq->rq_perm;
+		nreq->rq_fromsvr = preq->rq_fromsvr;
+		nreq->rq_conn    = preq->rq_conn;
+		nreq->rq_orgconn = preq->rq_orgconn;
+		nreq->rq_time    = preq->rq_time;
+		nreq->prot       = preq->prot;
+		strcpy(nreq->rq_user, preq->rq_user);
+		strcpy(nreq->rq_host, preq->rq_host);
+		nreq->rq_extend  = preq->rq_extend;
+		nreq->rq_ind.rq_run = *prun;	/* the destination stays owned by the list */
+
+		nreq->rq_parentbr = preq;
+		++preq->rq_refct;
+		/* an ack run replies before returning, see req_runjob2() */
+		preq->rq_ind.rq_runlist.rq_cur = i;
+		req_runjob(nreq);
+	}
+
+	if (--preq->rq_refct == 0)
+		reply_send(preq);
+}
 /**
  * @brief
  * 		req_runjob - service the Run Job and Asyc Run Job Requests
@@ -193,6 +193,9 @@ svr_shutdown(int type)
 	if (wait_for_secondary)
 		*state |= SV_STATE_PRIMDLY; /* wait for reply from Secondary */
 
+	flush_rused_saves();
+	flush_node_saves();
+
 	if (type == SHUT_QUICK) /* quick, leave jobs as are */
 		return;
 	svr_save_db(&server);
@@ -805,6 +805,12 @@ status_sched(pbs_sched *psched, struct batch_request *preq, pbs_list_head *pstat
 	if (pstat == NULL)
 		return (PBSE_SYSTEM);
 
+	/* update the trigger and cycle counters */
+	psched->sch_attr[(int)SCHED_ATR_triggers].at_val.at_long = psched->sch_triggers;
+	psched->sch_attr[(int)SCHED_ATR_triggers].at_flags |= ATR_SET_MOD_MCACHE;
+	psched->sch_attr[(int)SCHED_ATR_cycles].at_val.at_long = psched->sch_cycles;
+	psched->sch_attr[(int)SCHED_ATR_cycles].at_flags |= ATR_SET_MOD_MCACHE;
+
 	pstat->brp_objtype = MGR_OBJ_SCHED;
 	(void)strncpy(pstat->brp_objname, psched->sc_name, (PBS_MAXSVRJOBID > PBS_MAXDEST ?
 			PBS_MAXSVRJOBID : PBS_MAXDEST) -1);
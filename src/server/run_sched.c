@@ -91,6 +91,7 @@ int scheduler_sock = -1;	/* socket open to scheduler during a cycle */
 int scheduler_sock2 = -1;
 int scheduler_jobs_stat = 0;	/* set to 1 once scheduler queried jobs in a cycle*/
 extern int svr_unsent_qrun_req;
+extern time_t time_now;
 #define PRIORITY_CONNECTION 1
 
 /**
@@ -442,8 +443,11 @@ schedule_jobs(pbs_sched *psched)
 			set_attr_svr(&(psched->sch_attr[(int) SCHED_ATR_sched_state]), &sched_attr_def[(int) SCHED_ATR_sched_state], SC_DOWN);
 			return (-1);
 		}
-		else if (pdefr != NULL)
+		else if (pdefr != NULL) {
 			pdefr->dr_sent = 1;   /* mark entry as sent to sched */
+			psched->sch_triggers++;
+		}
+		psched->sch_cycles++;
 		set_sched_sock(s, psched);
 		if (psched->scheduler_sock2 == -1) {
 			if ((s = contact_sched(SCH_SCHEDULE_NULL, NULL, psched->pbs_scheduler_addr, psched->pbs_scheduler_port)) >= 0)
@@ -510,6 +514,7 @@ scheduler_close(int sock)
 	}
 
 	set_sched_sock(-1, psched);
+	psched->sch_cycle_end = time_now;
 
 	/* clear list of jobs which were altered/modified during cycle */
 	am_jobs.am_used = 0;
@@ -586,6 +591,31 @@ was_job_alteredmoved(job *pjob)
 	return 0;
 }
 
+/**
+ * @brief
+ * 		sched_trigger_priority - is a scheduler command in the priority lane,
+ *		which starts a cycle without waiting for sched_cycle_min_interval
+ *
+ * @param[in]	cmd	-	scheduler command
+ *
+ * @return	int
+ * @retval	1	- qrun, reservation, operator command or first cycle
+ * @retval	0	- an ordinary trigger such as a job queued or ended
+ */
+static int
+sched_trigger_priority(int cmd)
+{
+	switch (cmd) {
+		case SCH_SCHEDULE_AJOB:
+		case SCH_SCHEDULE_JOBRESV:
+		case SCH_SCHEDULE_RESV_RECONFIRM:
+		case SCH_SCHEDULE_CMD:
+		case SCH_SCHEDULE_FIRST:
+			return 1;
+	}
+	return 0;
+}
+
 /**
  * @brief
  * 		set_scheduler_flag - set the flag to call the Scheduler
@@ -617,11 +647,50 @@ set_scheduler_flag(int flag, pbs_sched *psched)
 				return; /* keep only SCH_QUIT */
 
 			psched->svr_do_sched_high = flag;
+		} else {
+			/* the time trigger is raised on every pass until a cycle starts */
+			if ((flag != SCH_SCHEDULE_TIME) || (psched->svr_do_schedule != SCH_SCHEDULE_TIME))
+				psched->sch_triggers++;
+
+			/* an ordinary trigger must not push a pending priority one out of its lane */
+			if (sched_trigger_priority(flag) ||
+				!sched_trigger_priority(psched->svr_do_schedule))
+				psched->svr_do_schedule = flag;
 		}
-		else
-			psched->svr_do_schedule = flag;
 		if (single_sched)
 			break;
 	}
 
 }
+
+/**
+ * @brief
+ * 		sched_trigger_wait - how long a triggered scheduling cycle has to wait
+ *		so that cycles are at least sched_cycle_min_interval seconds apart
+ *
+ * @par
+ *		Triggers arriving while a cycle waits are coalesced into that one
+ *		cycle.  Qrun requests and the priority commands, see
+ *		sched_trigger_priority(), do not wait.
+ *
+ * @param[in]	psched	-	scheduler with a pending trigger
+ *
+ * @return	int
+ * @retval	0	- the cycle may start now
+ * @retval	>0	- seconds left to wait
+ */
+int
+sched_trigger_wait(pbs_sched *psched)
+{
+	long interval;
+	long left;
+
+	if (svr_unsent_qrun_req || sched_trigger_priority(psched->svr_do_schedule))
+		return 0;
+	if ((psched->sch_attr[(int)SCHED_ATR_cycle_min_interval].at_flags & ATR_VFLAG_SET) == 0)
+		return 0;
+
+	interval = psched->sch_attr[(int)SCHED_ATR_cycle_min_interval].at_val.at_long;
+	left = (long)(psched->sch_cycle_end + interval - time_now);
+	return (left > 0 ? (int)left : 0);
+}
@@ -596,6 +596,8 @@ svr_setjobstate(job *pjob, int newstate, int newsubstate)
 			/* if subjob, update parent Array Job */
 			if (pjob->ji_qs.ji_svrflags & JOB_SVFLG_SubJob) {
 				update_subjob_state(pjob, newstate);
+				if (oldstate == JOB_STATE_QUEUED)
+					subjob_keep_attrs(pjob);
 			}
 		}
 	}
@@ -4718,6 +4720,92 @@ svr_saveorpurge_finjobhist(job *pjob)
 	}
 	set_idle_delete_task(presv);
 }
+/*
+ * History jobs that can be purged once job_history_duration has passed,
+ * kept in order of their history_timestamp so that the periodic clean up
+ * only needs to look at the oldest ones instead of every job in the server.
+ */
+static pbs_list_head svr_histjobs;
+
+/**
+ * @brief
+ *		Return whether a job is in a history state from which it is
+ *		purged after job_history_duration.
+ *
+ * @param[in]	pjob	-	job to check
+ *
+ * @return	int
+ * @retval	1	: job is a purgeable history job
+ * @retval	0	: otherwise
+ */
+static int
+is_purgeable_histjob(job *pjob)
+{
+	return ((pjob->ji_qs.ji_state == JOB_STATE_MOVED && pjob->ji_qs.ji_substate == JOB_SUBSTATE_FINISHED) ||
+		(pjob->ji_qs.ji_state == JOB_STATE_FINISHED) ||
+		(pjob->ji_qs.ji_state == JOB_STATE_EXPIRED));
+}
+
+/**
+ * @brief
+ *		Add a history job to the list of history jobs waiting to be
+ *		purged, keeping the list ordered by history_timestamp.  A job
+ *		recovered without a history_timestamp gets one here, derived from
+ *		its start time and walltime used.  A job that is not (or no longer)
+ *		a purgeable history job is taken off the list.
+ *
+ * @param[in,out]	pjob	-	history job
+ *
+ * @return	void
+ */
+void
+svr_histjob_link(job *pjob)
+{
+	job	*prior;
+	long	 stamp;
+	int	 walltime_used;
+
+	if (svr_histjobs.ll_next == NULL)
+		CLEAR_HEAD(svr_histjobs);
+
+	if (!is_purgeable_histjob(pjob)) {
+		delete_link(&pjob->ji_histjobs);
+		return;
+	}
+	if (pjob->ji_histjobs.ll_next != &pjob->ji_histjobs)
+		return;		/* already on the list */
+
+	if (!(pjob->ji_wattr[(int) JOB_ATR_history_timestamp].at_flags & ATR_VFLAG_SET)) {
+		if (pjob->ji_qs.ji_state == JOB_STATE_MOVED)
+			pjob->ji_wattr[(int) JOB_ATR_history_timestamp].at_val.at_long = time_now;
+		else {
+			if (((walltime_used = get_used_wall(pjob)) == -1) ||
+				!(pjob->ji_wattr[(int) JOB_ATR_stime].at_flags & ATR_VFLAG_SET)) {
+				log_joberr(-1, __func__,
+					"Finished job missing start-time/walltime used, cannot clean history",
+					pjob->ji_qs.ji_jobid);
+				return;
+			}
+			pjob->ji_wattr[(int) JOB_ATR_history_timestamp].at_val.at_long =
+				pjob->ji_wattr[(int) JOB_ATR_stime].at_val.at_long + walltime_used;
+		}
+		pjob->ji_wattr[(int) JOB_ATR_history_timestamp].at_flags |= ATR_SET_MOD_MCACHE;
+		job_save_db(pjob);
+	}
+	stamp = pjob->ji_wattr[(int) JOB_ATR_history_timestamp].at_val.at_long;
+
+	/* jobs mostly enter history in time order, so search from the newest */
+	prior = (job *) GET_PRIOR(svr_histjobs);
+	while (prior != NULL &&
+		prior->ji_wattr[(int) JOB_ATR_history_timestamp].at_val.at_long > stamp)
+		prior = (job *) GET_PRIOR(prior->ji_histjobs);
+
+	if (prior == NULL)
+		insert_link(&svr_histjobs, &pjob->ji_histjobs, pjob, LINK_INSET_AFTER);
+	else
+		insert_link(&prior->ji_histjobs, &pjob->ji_histjobs, pjob, LINK_INSET_AFTER);
+}
+
 /**
  * @brief
  *		Function name: svr_clean_job_history
@@ -4725,7 +4813,8 @@ svr_saveorpurge_finjobhist(job *pjob)
  *		 purge the history jobs whose history duration exceeds the
  *		 configured job_history_duration server attribute.
  * @par Functionality: It is a work_task and reschedule itself after 2 mins if
- *		 and only if job_history_enable is set.
+ *		 and only if job_history_enable is set.  History jobs are walked
+ *		 oldest first, stopping at the first one not yet due.
  *		Output: None
  *
  * @param[in]	pwt	-	work_task structure
@@ -4734,8 +4823,6 @@ void
 svr_clean_job_history(struct work_task *pwt)
 {
 	job 	*pjob;
-	job 	*nxpjob = NULL;
-	int 	walltime_used = 0;
 
 	/*
 	 * Keep track of time spent purging jobs, interrupts purge if necessary.
@@ -4754,47 +4841,23 @@ svr_clean_job_history(struct work_task *pwt)
 	/* Initialize end_time, in case we do not get into the while loop */
 	end_time = begin_time;
 
+	if (svr_histjobs.ll_next == NULL)
+		CLEAR_HEAD(svr_histjobs);
+
 	/*
-	 * Traverse through the SERVER job list and find the history
-	 * jobs (job with state JOB_STATE_MOVED and JOB_STATE_FINISHED)
-	 * which exceed the configured job_history_duration value and
-	 * purge them immediately.
+	 * Purge the history jobs (job with state JOB_STATE_MOVED and
+	 * JOB_STATE_FINISHED) which exceed the configured job_history_duration
+	 * value, oldest first.
 	 */
-	pjob = (job *)GET_NEXT(svr_alljobs);
-
-	while (pjob != NULL) {
-		/* save the next job */
-		nxpjob = (job *)GET_NEXT(pjob->ji_alljobs);
-
-		if ((pjob->ji_qs.ji_state == JOB_STATE_MOVED && pjob->ji_qs.ji_substate == JOB_SUBSTATE_FINISHED) ||
-			(pjob->ji_qs.ji_state == JOB_STATE_FINISHED) ||
-			(pjob->ji_qs.ji_state == JOB_STATE_EXPIRED)) {
-
-			if (!(pjob->ji_wattr[(int) JOB_ATR_history_timestamp].at_flags & ATR_VFLAG_SET)) {
-				if (pjob->ji_qs.ji_state == JOB_STATE_MOVED)
-					pjob->ji_wattr[(int) JOB_ATR_history_timestamp].at_val.at_long = time_now;
-				else {
-					if (((walltime_used = get_used_wall(pjob)) == -1) ||
-						!(pjob->ji_wattr[(int) JOB_ATR_stime].at_flags & ATR_VFLAG_SET)) {
-						log_err(-1, "svr_clean_job_history",
-							"Finished job missing start-time/walltime used, cannot clean history");
-						pjob = nxpjob;
-						continue;
-					}
-					pjob->ji_wattr[(int) JOB_ATR_history_timestamp].at_val.at_long =
-						pjob->ji_wattr[(int) JOB_ATR_stime].at_val.at_long + walltime_used;
-				}
-				pjob->ji_wattr[(int) JOB_ATR_history_timestamp].at_flags |= ATR_SET_MOD_MCACHE;
-				job_save_db(pjob);
-			}
-
-			if (time_now >= (pjob->ji_wattr[(int) JOB_ATR_history_timestamp].at_val.at_long + svr_history_duration)) {
-				job_purge(pjob);
-				pjob = NULL;
-			}
+	while ((pjob = (job *)GET_NEXT(svr_histjobs)) != NULL) {
+		if (!is_purgeable_histjob(pjob)) {
+			delete_link(&pjob->ji_histjobs);
+			continue;
 		}
-		/* restore the saved next in pjob */
-		pjob = nxpjob;
+		if (time_now < (pjob->ji_wattr[(int) JOB_ATR_history_timestamp].at_val.at_long + svr_history_duration))
+			break;
+
+		job_purge(pjob);
 
 		/* check if we spent too long hogging the pbs_server process here */
 		end_time = time(NULL);
@@ -4915,6 +4978,8 @@ svr_histjob_update(job * pjob, int newstate, int newsubstate)
 	pjob->ji_wattr[(int)JOB_ATR_substate].at_flags |= ATR_MOD_MCACHE;
 
 	job_save_db(pjob);
+
+	svr_histjob_link(pjob);
 }
 
 /**
@@ -5150,7 +5215,8 @@ svr_setjob_histinfo(job *pjob, histjob_type type)
 				pjob->ji_etlimit_decr_queued ? ETLIM_ACC_ALL_MAX : ETLIM_ACC_ALL);
 	}
 
-	/* set the history timestamp */
+	/* set the history timestamp, which moves the job to the newest end of the history list */
+	delete_link(&pjob->ji_histjobs);
 	pjob->ji_wattr[(int) JOB_ATR_history_timestamp].at_val.at_long = time_now;
 	pjob->ji_wattr[(int) JOB_ATR_history_timestamp].at_flags |= ATR_SET_MOD_MCACHE;
 	/* update the history job state and substate */
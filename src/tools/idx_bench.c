@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 1994-2020 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+/**
+ * @file    idx_bench.c
+ *
+ * @brief
+ * 		idx_bench.c - Compare the AVL tree and hash table backends of
+ *		pbs_idx on job id keys.
+ *
+ *	Inserts, finds and deletes the same set of job ids in an index of
+ *	each kind and prints the time taken per operation.  Not installed,
+ *	build it with "make idx_bench" in src/tools.
+ *
+ * Functions included are:
+ * 	main()
+ */
+
+#include <pbs_config.h>   /* the master config generated by configure */
+
+#include <sys/time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "pbs_idx.h"
+
+#define DFLT_NJOBS	1000000
+
+/**
+ * @brief
+ * 		return the time now in seconds
+ */
+static double
+now_secs(void)
+{
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+	return (tv.tv_sec + tv.tv_usec / 1e6);
+}
+
+/**
+ * @brief
+ * 		time insert, find and delete of all keys in one kind of index
+ *
+ * @param[in]	name	-	name of the backend, for the report
+ * @param[in]	flags	-	flags for pbs_idx_create()
+ * @param[in]	keys	-	the keys
+ * @param[in]	n	-	number of keys
+ *
+ * @return	int
+ * @retval	0	: success
+ * @retval	1	: an index operation failed
+ */
+static int
+run(char *name, int flags, char **keys, int n)
+{
+	void *idx;
+	void *data;
+	void *key;
+	double t0, t1, t2, t3;
+	int i;
+
+	if ((idx = pbs_idx_create(flags, 0)) == NULL) {
+		fprintf(stderr, "%s: cannot create index\n", name);
+		return 1;
+	}
+
+	t0 = now_secs();
+	for (i = 0; i < n; i++) {
+		if (pbs_idx_insert(idx, keys[i], keys[i]) != PBS_IDX_RET_OK) {
+			fprintf(stderr, "%s: insert of %s failed\n", name, keys[i]);
+			return 1;
+		}
+	}
+	t1 = now_secs();
+	/* look the keys up in a different order from the inserts */
+	for (i = 0; i < n; i++) {
+		key = keys[(i * 7919L) % n];
+		if (pbs_idx_find(idx, &key, &data, NULL) != PBS_IDX_RET_OK ||
+			data != key) {
+			fprintf(stderr, "%s: find of %s failed\n", name, (char *) key);
+			return 1;
+		}
+	}
+	t2 = now_secs();
+	for (i = 0; i < n; i++)
+		pbs_idx_delete(idx, keys[i]);
+	t3 = now_secs();
+
+	printf("%-6s insert %7.3f us  find %7.3f us  delete %7.3f us\n", name,
+		(t1 - t0) * 1e6 / n, (t2 - t1) * 1e6 / n, (t3 - t2) * 1e6 / n);
+	pbs_idx_destroy(idx);
+	return 0;
+}
+
+/**
+ * @brief
+ * 		main	-	The main function of idx_bench
+ *
+ * @param[in]	argc	-	argument count
+ * @param[in]	argv	-	argument variables.
+ *
+ * @return	int
+ * @retval	0	: success
+ * @retval	!=0	: some error.
+ */
+int
+main(int argc, char *argv[])
+{
+	int n = DFLT_NJOBS;
+	char **keys;
+	int i;
+	int rc;
+
+	if (argc > 2 || (argc == 2 && (n = atoi(argv[1])) <= 0)) {
+		fprintf(stderr, "Usage: %s [number_of_jobs]\n", argv[0]);
+		return 1;
+	}
+
+	if ((keys = malloc(n * sizeof(char *))) == NULL) {
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+	for (i = 0; i < n; i++) {
+		char buf[64];
+
+		snprintf(buf, sizeof(buf), "%d.pbsserver.example.com", i);
+		if ((keys[i] = strdup(buf)) == NULL) {
+			fprintf(stderr, "Out of memory\n");
+			return 1;
+		}
+	}
+
+	printf("%d job ids\n", n);
+	rc = run("avl", 0, keys, n);
+	rc |= run("hash", PBS_IDX_HASH, keys, n);
+
+	for (i = 0; i < n; i++)
+		free(keys[i]);
+	free(keys);
+	return rc;
+}
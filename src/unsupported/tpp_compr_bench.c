@@ -0,0 +1,250 @@
+/*
+ * Copyright (C) 1994-2020 Altair Engineering, Inc.
+ * For more information, contact Altair at www.altair.com.
+ *
+ * This file is part of both the OpenPBS software ("OpenPBS")
+ * and the PBS Professional ("PBS Pro") software.
+ *
+ * Open Source License Information:
+ *
+ * OpenPBS is free software. You can redistribute it and/or modify it under
+ * the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or (at your
+ * option) any later version.
+ *
+ * OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+ * License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Commercial License Information:
+ *
+ * PBS Pro is commercially licensed software that shares a common core with
+ * the OpenPBS software.  For a copy of the commercial license terms and
+ * conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+ * Altair Legal Department.
+ *
+ * Altair's dual-license business model allows companies, individuals, and
+ * organizations to create proprietary derivative works of OpenPBS and
+ * distribute them - whether embedded or bundled with other software -
+ * under a commercial license agreement.
+ *
+ * Use of Altair's trademarks, including but not limited to "PBS™",
+ * "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+ * subject to Altair's trademark licensing policies.
+ */
+
+/**
+ * @file	tpp_compr_bench.c
+ *
+ * @brief
+ *	Benchmark the TPP compression codecs against a recorded message corpus.
+ *
+ *	Each corpus file holds the payload of one TPP message (for example an
+ *	IS_UPDATE or a resources_used status update). Every compiled in codec
+ *	compresses and inflates each message the given number of times and the
+ *	overall ratio and throughput are reported, optionally using a shared
+ *	dictionary as set with PBS_COMPRESSION_DICT.
+ *
+ *	usage: tpp_compr_bench [-n iterations] [-D dictionary] file...
+ */
+
+#include <pbs_config.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include "tpp.h"
+#include "tpp_internal.h"
+
+struct corpus_msg {
+	void *data;
+	unsigned int len;
+};
+
+static void
+log_tppmsg(int level, const char *objname, char *mess)
+{
+	if (level <= LOG_ERR)
+		fprintf(stderr, "tpp error: %s\n", mess);
+}
+
+static double
+elapsed(struct timeval *start)
+{
+	struct timeval now;
+
+	gettimeofday(&now, NULL);
+	return (now.tv_sec - start->tv_sec) + (now.tv_usec - start->tv_usec) / 1000000.0;
+}
+
+/**
+ * @brief
+ *	Read a corpus file into memory
+ *
+ * @param[in]  path - path of the file
+ * @param[out] msg  - the message read
+ *
+ * @return - Error code
+ * @retval -1 - Failure
+ * @retval  0 - Success
+ */
+static int
+read_msg(char *path, struct corpus_msg *msg)
+{
+	int fd;
+	struct stat sb;
+
+	if ((fd = open(path, O_RDONLY)) == -1 || fstat(fd, &sb) == -1) {
+		perror(path);
+		if (fd != -1)
+			close(fd);
+		return -1;
+	}
+	msg->len = sb.st_size;
+	if (msg->len == 0 || (msg->data = malloc(msg->len)) == NULL) {
+		fprintf(stderr, "%s: empty file or out of memory\n", path);
+		close(fd);
+		return -1;
+	}
+	if (read(fd, msg->data, msg->len) != msg->len) {
+		perror(path);
+		close(fd);
+		return -1;
+	}
+	close(fd);
+	return 0;
+}
+
+/**
+ * @brief
+ *	Run one codec over the whole corpus and print the results
+ *
+ * @param[in] codec - the codec to benchmark
+ * @param[in] msgs  - the corpus
+ * @param[in] nmsgs - number of messages in the corpus
+ * @param[in] iters - number of times each message is processed
+ *
+ * @return - Error code
+ * @retval -1 - a message failed to round trip
+ * @retval  0 - Success
+ */
+static int
+bench_codec(int codec, struct corpus_msg *msgs, int nmsgs, int iters)
+{
+	int i;
+	int j;
+	unsigned long long in_bytes = 0;
+	unsigned long long out_bytes = 0;
+	double t_deflate = 0;
+	double t_inflate = 0;
+	struct timeval start;
+	unsigned int outlen;
+	void *cbuf;
+	void *ubuf;
+
+	/* skip codecs that are not compiled in */
+	if (tpp_compr_codec(tpp_compr_name(codec)) == -1)
+		return 0;
+	tpp_compr_init(codec, NULL);
+
+	for (i = 0; i < nmsgs; i++) {
+		for (j = 0; j < iters; j++) {
+			gettimeofday(&start, NULL);
+			cbuf = tpp_deflate_codec(codec, msgs[i].data, msgs[i].len, &outlen);
+			t_deflate += elapsed(&start);
+			if (cbuf == NULL)
+				return -1;
+
+			gettimeofday(&start, NULL);
+			ubuf = tpp_inflate(cbuf, outlen, msgs[i].len);
+			t_inflate += elapsed(&start);
+			if (ubuf == NULL || memcmp(ubuf, msgs[i].data, msgs[i].len) != 0) {
+				fprintf(stderr, "%s: message %d failed to round trip\n", tpp_compr_name(codec), i);
+				free(cbuf);
+				free(ubuf);
+				return -1;
+			}
+			free(cbuf);
+			free(ubuf);
+			in_bytes += msgs[i].len;
+			out_bytes += outlen;
+		}
+	}
+
+	printf("%-6s %12llu %12llu %7.3f %12.1f %12.1f\n", tpp_compr_name(codec),
+		in_bytes, out_bytes, (double) in_bytes / (out_bytes ? out_bytes : 1),
+		in_bytes / (t_deflate > 0 ? t_deflate : 1) / (1024 * 1024),
+		in_bytes / (t_inflate > 0 ? t_inflate : 1) / (1024 * 1024));
+	return 0;
+}
+
+int
+main(int argc, char *argv[])
+{
+	int c;
+	int i;
+	int iters = 100;
+	int nmsgs;
+	int rc = 0;
+	char *dict = NULL;
+	struct corpus_msg *msgs;
+	int codecs[] = {TPP_COMPR_ZLIB, TPP_COMPR_LZ4, TPP_COMPR_ZSTD};
+
+	while ((c = getopt(argc, argv, "n:D:")) != EOF) {
+		switch (c) {
+			case 'n':
+				iters = atoi(optarg);
+				break;
+			case 'D':
+				dict = optarg;
+				break;
+			default:
+				fprintf(stderr, "Bad option: %c\n", c);
+				return 1;
+		}
+	}
+
+	if (optind == argc || iters <= 0) {
+		fprintf(stderr, "Error in usage: tpp_compr_bench [-n iterations] [-D dictionary] file...\n");
+		return 1;
+	}
+
+	tpp_log_func = log_tppmsg;
+	if (tpp_init_tls_key() != 0) {
+		fprintf(stderr, "Failed to initialize tls key\n");
+		return 1;
+	}
+
+	nmsgs = argc - optind;
+	if ((msgs = calloc(nmsgs, sizeof(struct corpus_msg))) == NULL) {
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+	for (i = 0; i < nmsgs; i++) {
+		if (read_msg(argv[optind + i], &msgs[i]) != 0)
+			return 1;
+	}
+
+	/* the dictionary is loaded once and shared by all the codecs that use it */
+	if (dict != NULL && tpp_compr_init(TPP_COMPR_ZLIB, dict) != 0)
+		return 1;
+
+	printf("%-6s %12s %12s %7s %12s %12s\n", "codec", "in_bytes", "out_bytes", "ratio", "deflate_MB/s", "inflate_MB/s");
+	for (i = 0; i < sizeof(codecs) / sizeof(codecs[0]); i++) {
+		if (bench_codec(codecs[i], msgs, nmsgs, iters) != 0)
+			rc = 1;
+	}
+
+	for (i = 0; i < nmsgs; i++)
+		free(msgs[i].data);
+	free(msgs);
+	return rc;
+}
@@ -4146,6 +4146,39 @@ sleep 300
         self.server.delete(id=jid, wait=True)
         self.assertFalse(self.is_dir(ehjd1, ehost1), "job cpuset dir found")
 
+    def test_cgroup_topology_cache_and_ledger(self):
+        """
+        Test that the hook caches the node topology and keeps the
+        assignment ledger in step with the jobs running on the node
+        """
+        if not self.paths['cpuset']:
+            self.skipTest('Test requires cpuset subsystem mounted')
+        self.load_default_config()
+        host = self.hosts_list[0]
+        pbs_home = self.mom.pbs_conf['PBS_HOME']
+        hook_data = os.path.join(pbs_home, 'mom_priv', 'hooks', 'hook_data')
+        topo_f = os.path.join(hook_data, 'topology_cache')
+        ledger_f = os.path.join(hook_data, 'assigned_ledger')
+        # exechost_startup always rediscovers the topology
+        self.assertTrue(self.du.isfile(hostname=host, path=topo_f,
+                                       sudo=True),
+                        'Topology cache not written at startup')
+        a = {'Resource_List.select': '1:ncpus=1:host=%s' % host}
+        j = Job(TEST_USER, attrs=a)
+        j.create_script(self.sleep15_job)
+        now = time.time()
+        jid = self.server.submit(j)
+        self.server.expect(JOB, {'job_state': 'R'}, jid)
+        ledger = self.wait_and_read_file(host, ledger_f)
+        self.assertIn(jid, ''.join(ledger), 'Job missing from ledger')
+        # Later events for the job reuse the topology found at begin
+        self.mom.log_match('Using cached topology', starttime=now,
+                           max_attempts=10, interval=1)
+        self.server.delete(id=jid, wait=True)
+        ledger = self.du.cat(hostname=host, filename=ledger_f, sudo=True)
+        self.assertNotIn(jid, ''.join(ledger['out']),
+                         'Job still in ledger after it ended')
+
     def tearDown(self):
         TestFunctional.tearDown(self)
         mom_checks = True
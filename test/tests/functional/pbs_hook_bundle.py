@@ -0,0 +1,94 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2020 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+from tests.functional import *
+
+
+class TestHookBundle(TestFunctional):
+
+    """
+    Test that a mom reports one checksum for all of its hooks and that
+    the server asks for each hook only when that checksum differs.
+    """
+
+    hook_body = """
+import pbs
+pbs.event().accept()
+"""
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.server.manager(MGR_CMD_SET, SERVER, {'log_events': 2047})
+        a = {'event': 'execjob_begin', 'enabled': 'True'}
+        self.server.create_import_hook('bundle_hk', a, self.hook_body)
+        self.mom.log_match("bundle_hk.PY;copy hook-related file "
+                           "request received", regexp=True)
+
+    def test_bundle_match(self):
+        """
+        A mom restarted with the same hooks as the server is not asked
+        for the checksum of each hook.
+        """
+        start = time.time()
+        self.mom.restart()
+        self.server.log_match("%s;hooks match the server's" %
+                              self.mom.shortname, starttime=start)
+        self.server.log_match("hooks mismatched checksums",
+                              starttime=start, existence=False,
+                              max_attempts=5)
+
+    def test_bundle_mismatch(self):
+        """
+        A mom whose hook script changed behind the server's back is
+        asked for each hook and gets the script again.
+        """
+        self.mom.stop()
+        path = os.path.join(self.mom.pbs_conf['PBS_HOME'], 'mom_priv',
+                            'hooks', 'bundle_hk.PY')
+        self.du.run_cmd(self.mom.hostname, ['sh', '-c',
+                                            'echo "# changed" >> ' + path],
+                        sudo=True)
+        start = time.time()
+        self.mom.start()
+        self.server.log_match("hooks mismatched checksums",
+                              starttime=start)
+        self.server.log_match("hook script mismatched checksums",
+                              starttime=start)
+        self.server.log_match("successfully sent hook file .*bundle_hk.PY",
+                              regexp=True, starttime=start)
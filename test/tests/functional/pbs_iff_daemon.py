@@ -0,0 +1,119 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2020 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+from tests.functional import *
+import socket
+
+
+class TestIffDaemon(TestFunctional):
+    """
+    Test authenticating client connections through pbs_iff -d
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.iff = os.path.join(self.server.pbs_conf['PBS_EXEC'],
+                                'sbin', 'pbs_iff')
+        tmpdir = self.server.pbs_conf.get('PBS_TMPDIR', '/var/tmp')
+        self.sock = os.path.join(tmpdir, 'pbs_iff.sock')
+        self.iff_mode = None
+
+    def tearDown(self):
+        if self.iff_mode is not None:
+            self.du.run_cmd(cmd=['chmod', self.iff_mode, self.iff],
+                            sudo=True)
+        self.du.run_cmd(cmd=['pkill', '-f', self.iff + ' -d'], sudo=True)
+        self.du.rm(path=self.sock, sudo=True, force=True)
+        TestFunctional.tearDown(self)
+
+    def test_submit_through_daemon(self):
+        """
+        With the daemon running a user's commands are authenticated by
+        it even when the user cannot run pbs_iff, and once it is stopped
+        they need pbs_iff again
+        """
+        rv = self.du.run_cmd(cmd=[self.iff, '-d'], sudo=True)
+        self.assertEqual(rv['rc'], 0)
+        rv = self.du.run_cmd(cmd=['test', '-S', self.sock], sudo=True)
+        self.assertEqual(rv['rc'], 0)
+
+        # only the daemon can authenticate a user who cannot run pbs_iff
+        rv = self.du.run_cmd(cmd=['stat', '-c', '%a', self.iff], sudo=True)
+        self.assertEqual(rv['rc'], 0)
+        self.iff_mode = rv['out'][0].strip()
+        rv = self.du.run_cmd(cmd=['chmod', '700', self.iff], sudo=True)
+        self.assertEqual(rv['rc'], 0)
+
+        qstat = os.path.join(self.server.pbs_conf['PBS_EXEC'], 'bin',
+                             'qstat')
+        rv = self.du.run_cmd(cmd=[qstat, '-B'], runas=TEST_USER)
+        self.assertEqual(rv['rc'], 0)
+        j = Job(TEST_USER)
+        jid = self.server.submit(j)
+        self.server.expect(JOB, 'queue', id=jid, op=SET)
+        self.server.delete(jid, wait=True)
+
+        self.du.run_cmd(cmd=['pkill', '-f', self.iff + ' -d'], sudo=True)
+        rv = self.du.run_cmd(cmd=[qstat, '-B'], runas=TEST_USER)
+        self.assertNotEqual(rv['rc'], 0)
+
+        self.du.run_cmd(cmd=['chmod', self.iff_mode, self.iff], sudo=True)
+        self.iff_mode = None
+        j = Job(TEST_USER)
+        jid = self.server.submit(j)
+        self.server.expect(JOB, 'queue', id=jid, op=SET)
+
+    def test_stalled_client(self):
+        """
+        A client that connects to the daemon and sends nothing must not
+        hold up the commands of other clients
+        """
+        rv = self.du.run_cmd(cmd=[self.iff, '-d'], sudo=True)
+        self.assertEqual(rv['rc'], 0)
+        stalled = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        stalled.connect(self.sock)
+        try:
+            qstat = os.path.join(self.server.pbs_conf['PBS_EXEC'],
+                                 'bin', 'qstat')
+            t = time.time()
+            rv = self.du.run_cmd(cmd=[qstat, '-B'], runas=TEST_USER)
+            self.assertEqual(rv['rc'], 0)
+            self.assertLess(time.time() - t, 10)
+        finally:
+            stalled.close()
@@ -138,6 +138,56 @@ class TestJobArray(TestFunctional):
         self.server.manager(MGR_CMD_SET, SERVER, attr)
         self.test_running_subjob_survive_restart()
 
+    @skipOnCpuSet
+    def test_running_subjob_parent_attrs_survive_restart(self):
+        """
+        Test that a running subjob still has the attributes it shares
+        with its parent array job after a pbs_server restart
+        """
+        a = {'resources_available.ncpus': 1}
+        self.server.manager(MGR_CMD_SET, NODE, a, self.mom.shortname)
+        j = Job(TEST_USER, attrs={
+            ATTR_J: '1-2', ATTR_N: 'arrname', ATTR_v: 'ARRVAR=xyz',
+            'Resource_List.select': 'ncpus=1'})
+        j.set_sleep_time(60)
+        j_id = self.server.submit(j)
+        subjid_1 = j.create_subjob_id(j_id, 1)
+        self.server.expect(JOB, {'job_state': 'R'}, subjid_1)
+
+        self.kill_and_restart_svr()
+
+        self.server.expect(JOB, {'job_state': 'R', ATTR_N: 'arrname',
+                                 ATTR_euser: str(TEST_USER)},
+                           subjid_1, max_attempts=1)
+        jstat = self.server.status(JOB, ATTR_v, id=subjid_1)
+        self.assertIn('ARRVAR=xyz', jstat[0][ATTR_v])
+
+    @skipOnCpuSet
+    def test_running_subjob_keeps_attrs_after_parent_alter(self):
+        """
+        Test that a running subjob keeps the attributes it started with,
+        not the parent array job's altered values, after a pbs_server
+        restart
+        """
+        a = {'resources_available.ncpus': 1}
+        self.server.manager(MGR_CMD_SET, NODE, a, self.mom.shortname)
+        j = Job(TEST_USER, attrs={
+            ATTR_J: '1-2', ATTR_N: 'arrname',
+            'Resource_List.select': 'ncpus=1'})
+        j.set_sleep_time(60)
+        j_id = self.server.submit(j)
+        subjid_1 = j.create_subjob_id(j_id, 1)
+        self.server.expect(JOB, {'job_state': 'R'}, subjid_1)
+
+        self.server.alterjob(j_id, {ATTR_N: 'newname'})
+        self.server.expect(JOB, {ATTR_N: 'newname'}, j_id)
+
+        self.kill_and_restart_svr()
+
+        self.server.expect(JOB, {'job_state': 'R', ATTR_N: 'arrname'},
+                           subjid_1, max_attempts=1)
+        self.server.expect(JOB, {ATTR_N: 'newname'}, j_id, max_attempts=1)
+
     @skipOnCpuSet
     def test_suspended_subjob_survive_restart(self):
         """
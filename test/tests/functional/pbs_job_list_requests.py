@@ -0,0 +1,135 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2020 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+
+
+
+from tests.functional import *
+
+
+class TestJobListRequests(TestFunctional):
+    """
+    Tests for deleting and signaling many jobs with one Delete Job List
+    or Signal Job List request
+    """
+
+    def test_qdel_by_filter(self):
+        """
+        Delete the queued jobs of a user with qdel -u -s and check that
+        the running job and the other user's jobs are left alone
+        """
+        a = {'resources_available.ncpus': 1}
+        self.server.manager(MGR_CMD_SET, NODE, a, self.mom.shortname)
+        j = Job(TEST_USER)
+        j.set_sleep_time(1000)
+        rjid = self.server.submit(j)
+        self.server.expect(JOB, {'job_state': 'R'}, id=rjid)
+        qjids = []
+        for _ in range(20):
+            qjids.append(self.server.submit(Job(TEST_USER)))
+        ojid = self.server.submit(Job(TEST_USER1))
+
+        t = time.time()
+        qdel = os.path.join(self.server.pbs_conf['PBS_EXEC'], 'bin', 'qdel')
+        ret = self.du.run_cmd(self.server.hostname,
+                              [qdel, '-u', str(TEST_USER), '-s', 'Q'],
+                              runas=TEST_USER)
+        self.assertEqual(ret['rc'], 0)
+        for jid in qjids:
+            self.server.expect(JOB, 'queue', id=jid, op=UNSET)
+        self.server.expect(JOB, {'job_state': 'R'}, id=rjid)
+        self.server.expect(JOB, {'job_state': 'Q'}, id=ojid)
+        self.server.log_match('delete of 20 jobs requested by %s'
+                              % str(TEST_USER), starttime=t)
+
+    def test_qdel_by_filter_many(self):
+        """
+        Delete by filter more jobs than the server handles in one slice
+        (500), then restart the server and check that none of them is
+        recovered from the database
+        """
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        njobs = 650
+        for _ in range(njobs):
+            self.server.submit(Job(TEST_USER))
+        self.server.expect(SERVER, {'total_jobs': njobs})
+
+        t = time.time()
+        qdel = os.path.join(self.server.pbs_conf['PBS_EXEC'], 'bin', 'qdel')
+        ret = self.du.run_cmd(self.server.hostname,
+                              [qdel, '-u', str(TEST_USER), '-s', 'Q'],
+                              runas=TEST_USER)
+        self.assertEqual(ret['rc'], 0)
+        self.server.log_match('delete of %d jobs requested by %s'
+                              % (njobs, str(TEST_USER)), starttime=t)
+        self.server.expect(SERVER, {'total_jobs': 0})
+
+        self.server.restart()
+        self.server.expect(SERVER, {'total_jobs': 0})
+        self.assertEqual(len(self.server.status(JOB)), 0)
+
+    def test_qsig_job_list(self):
+        """
+        Signal several jobs with one qsig call, with an unknown job among
+        them, and check that one Signal Job List request carried them
+        """
+        a = {'resources_available.ncpus': 4}
+        self.server.manager(MGR_CMD_SET, NODE, a, self.mom.shortname)
+        jids = []
+        for _ in range(3):
+            j = Job(TEST_USER)
+            j.set_sleep_time(1000)
+            jids.append(self.server.submit(j))
+        for jid in jids:
+            self.server.expect(JOB, {'job_state': 'R'}, id=jid)
+        bad = '999999.' + self.server.hostname
+
+        t = time.time()
+        qsig = os.path.join(self.server.pbs_conf['PBS_EXEC'], 'bin', 'qsig')
+        ret = self.du.run_cmd(self.server.hostname,
+                              [qsig, '-s', 'suspend'] + jids + [bad],
+                              runas=ROOT_USER)
+        self.assertNotEqual(ret['rc'], 0)
+        self.assertIn('Unknown Job Id ' + bad, '\n'.join(ret['err']))
+        for jid in jids:
+            self.server.expect(JOB, {'job_state': 'S'}, id=jid)
+        self.server.log_match('signal of 4 jobs requested by',
+                              starttime=t)
+        self.server.log_match('Type 102 request received', starttime=t)
@@ -0,0 +1,70 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2020 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+from tests.functional import *
+
+
+class TestProcTracking(TestFunctional):
+
+    """
+    Test that with $proc_tracking set to job, mom reads only the processes
+    of its jobs on each poll and still accounts for all of them.
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        c = {'$proc_tracking': 'job', '$logevent': '0xffffffff',
+             '$min_check_poll': 5, '$max_check_poll': 10}
+        self.mom.add_config(c)
+
+    def test_job_procs_sampled(self):
+        """
+        cput of a process forked into the background by the job script
+        is counted when only job processes are read.
+        """
+        j = Job(TEST_USER)
+        j.create_script('(while true; do :; done) &\n'
+                        'sleep 20\n'
+                        'kill %1\n')
+        jid = self.server.submit(j)
+        self.server.expect(JOB, {'job_state': 'R'}, id=jid)
+        self.mom.log_match("proc_tracking;job")
+        self.mom.log_match("sample_job_procs;jobs:  1", max_attempts=30)
+        self.server.expect(JOB, {'resources_used.cput': '00:00:00'},
+                           op=NE, id=jid, offset=10)
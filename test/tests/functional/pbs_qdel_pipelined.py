@@ -0,0 +1,78 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2020 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+
+
+
+from tests.functional import *
+
+
+class TestQdelPipelined(TestFunctional):
+    """
+    Tests for qdel sending the deletes of many jobs on one connection
+    without waiting for each reply
+    """
+
+    def test_qdel_many_jobs_pipelined(self):
+        """
+        Delete more jobs than qdel keeps in flight in one qdel call, with
+        an unknown job in the middle, and check that every job is gone,
+        that the unknown job is reported and that all deletes came in on
+        the same connection
+        """
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        jids = []
+        for _ in range(100):
+            jids.append(self.server.submit(Job(TEST_USER)))
+        bad = '999999.' + self.server.hostname
+
+        t = time.time()
+        qdel = os.path.join(self.server.pbs_conf['PBS_EXEC'], 'bin', 'qdel')
+        ret = self.du.run_cmd(self.server.hostname,
+                              [qdel] + jids[:50] + [bad] + jids[50:],
+                              runas=TEST_USER)
+        self.assertNotEqual(ret['rc'], 0)
+        self.assertIn('Unknown Job Id ' + bad, '\n'.join(ret['err']))
+        self.server.expect(SERVER, {'total_jobs': 0})
+
+        lines = self.server.log_match('Type 6 request received',
+                                      starttime=t, allmatch=True)
+        self.assertEqual(len(lines), 101)
+        socks = set(l[1].split('sock=')[1] for l in lines)
+        self.assertEqual(len(socks), 1)
@@ -417,3 +417,60 @@ class TestQmgr(TestFunctional):
                     if rv:
                         self.delete_resource_helper(None, resc_flag,
                                                     ctrl_flag, k, v)
+
+    def qmgr_node_cmd(self, cmd):
+        """
+        Run qmgr -c cmd on the server host and return the run_cmd result
+        """
+        qmgr_path = os.path.join(self.server.pbs_conf["PBS_EXEC"], "bin",
+                                 "qmgr")
+        if not self.du.is_localhost(self.server.hostname):
+            cmd = "\'" + cmd + "\'"
+        return self.du.run_cmd(self.server.hostname, [qmgr_path, "-c", cmd],
+                               sudo=True)
+
+    def test_set_unset_node_list(self):
+        """
+        Check that qmgr sends a set or unset of several vnodes to the
+        server as one list request and that it applies to every vnode
+        """
+        attrs = {ATTR_rescavail + ".ncpus": 2}
+        self.server.create_vnodes("vn", attrs, 3, self.mom)
+        self.server.manager(MGR_CMD_SET, SERVER, {'log_events': 2047})
+        names = ["vn[0]", "vn[1]", "vn[2]"]
+
+        t = time.time()
+        ret = self.qmgr_node_cmd("set node " + ",".join(names) +
+                                 " comment=bulk")
+        self.assertEqual(ret['rc'], 0)
+        for n in names:
+            self.server.expect(VNODE, {ATTR_comment: 'bulk'}, id=n)
+        self.server.log_match("Type 98 request received", starttime=t)
+        self.server.log_match("Type 9 request received", starttime=t,
+                              existence=False, max_attempts=2)
+        # the audit record names each vnode
+        for n in names:
+            self.server.log_match("Node;%s;attributes set: at request of"
+                                  % n, starttime=t)
+
+        t = time.time()
+        ret = self.qmgr_node_cmd("unset node " + ",".join(names) +
+                                 " comment")
+        self.assertEqual(ret['rc'], 0)
+        for n in names:
+            self.server.expect(VNODE, ATTR_comment, op=UNSET, id=n)
+            self.server.log_match("Node;%s;attributes unset: at request of"
+                                  % n, starttime=t)
+
+    def test_set_node_list_unknown(self):
+        """
+        Check that a list naming an unknown vnode is rejected as a whole
+        """
+        attrs = {ATTR_rescavail + ".ncpus": 2}
+        self.server.create_vnodes("vn", attrs, 2, self.mom)
+        ret = self.qmgr_node_cmd("set node vn[0],nosuchnode,vn[1]"
+                                 " comment=bulk")
+        self.assertNotEqual(ret['rc'], 0)
+        self.assertIn("nosuchnode", "\n".join(ret['err']))
+        for n in ["vn[0]", "vn[1]"]:
+            self.server.expect(VNODE, ATTR_comment, op=UNSET, id=n)
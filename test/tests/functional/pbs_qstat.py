@@ -155,3 +155,61 @@ class TestQstat(TestFunctional):
                             % re.escape(self.mom.shortname),
                             qstat_out), None, "The exec host does not"
                             " contain the task slot number")
+
+    def test_qstat_from_snapshot_child(self):
+        """
+        Test that with stat_snapshot_threshold set, status and select
+        requests for all jobs and nodes are answered by a server child
+        and return the same information, while single job status is
+        still answered by the server itself
+        """
+        self.server.manager(MGR_CMD_SET, SERVER,
+                            {'scheduling': 'False'})
+        jids = []
+        for _ in range(5):
+            j = Job(TEST_USER)
+            jids.append(self.server.submit(j))
+        self.server.manager(MGR_CMD_SET, SERVER,
+                            {'stat_snapshot_threshold': 5})
+        qstat_cmd = os.path.join(self.server.pbs_conf['PBS_EXEC'],
+                                 'bin', 'qstat')
+        qselect_cmd = os.path.join(self.server.pbs_conf['PBS_EXEC'],
+                                   'bin', 'qselect')
+        pbsnodes_cmd = os.path.join(self.server.pbs_conf['PBS_EXEC'],
+                                    'bin', 'pbsnodes')
+        # batch request types as logged by the server
+        stat_job = '(19|51)'
+        select_jobs = '(16|51)'
+        stat_node = '58'
+        start = time.time()
+        ret = self.du.run_cmd(self.server.hostname, cmd=[qstat_cmd])
+        self.assertEqual(ret['rc'], 0,
+                         'Qstat returned with non-zero exit status')
+        qstat_out = '\n'.join(ret['out'])
+        for jid in jids:
+            self.assertIn(jid.split('.')[0], qstat_out)
+        ret = self.du.run_cmd(self.server.hostname, cmd=[qselect_cmd])
+        self.assertEqual(ret['rc'], 0,
+                         'Qselect returned with non-zero exit status')
+        self.assertEqual(sorted(ret['out']), sorted(jids))
+        self.server.log_match('request type %s on socket' % stat_job,
+                              regexp=True, starttime=start)
+        self.server.log_match('request type %s on socket' % select_jobs,
+                              regexp=True, starttime=start)
+        # there is only one node, below the threshold
+        ret = self.du.run_cmd(self.server.hostname, cmd=[pbsnodes_cmd,
+                                                          '-a'])
+        self.assertEqual(ret['rc'], 0,
+                         'Pbsnodes returned with non-zero exit status')
+        self.server.log_match('request type %s on socket' % stat_node,
+                              regexp=True, starttime=start,
+                              existence=False, max_attempts=2)
+        start = time.time()
+        self.server.status(JOB, id=jids[0])
+        self.server.log_match('request type %s on socket' % stat_job,
+                              regexp=True, starttime=start,
+                              existence=False, max_attempts=2)
+        # more jobs can still be queued and seen after the children exit
+        jids.append(self.server.submit(Job(TEST_USER)))
+        ret = self.du.run_cmd(self.server.hostname, cmd=[qselect_cmd])
+        self.assertEqual(sorted(ret['out']), sorted(jids))
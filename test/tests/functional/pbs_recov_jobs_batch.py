@@ -0,0 +1,93 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2020 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+from tests.functional import *
+
+
+class TestRecovJobsBatch(TestFunctional):
+
+    """
+    Test recovering jobs at server start in batches whose attributes
+    are decoded on threads.
+    """
+
+    def test_recover_jobs(self):
+        """
+        Jobs are recovered with their attributes and the time spent on
+        each part of the recovery is logged.
+        """
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        jids = []
+        for _ in range(10):
+            j = Job(TEST_USER, {ATTR_N: 'recov',
+                                'Resource_List.walltime': '1:00:00'})
+            if jids:
+                j.set_attributes({ATTR_depend: 'afterok:' + jids[0]})
+            jids.append(self.server.submit(j))
+        self.server.restart()
+        self.server.log_match("Recovered 10 jobs in .* seconds",
+                              regexp=True)
+        self.server.log_match("Recovered .* queues in .* seconds",
+                              regexp=True)
+        self.server.expect(JOB, {'job_state': 'Q', ATTR_N: 'recov',
+                                 'Resource_List.walltime': '01:00:00'},
+                           id=jids[0])
+        for jid in jids[1:]:
+            self.server.expect(JOB, {'job_state': 'H'}, id=jid)
+
+    def test_recover_jobs_in_batches(self):
+        """
+        More jobs than fit in one batch are recovered in two batches,
+        a full one and the rest.
+        """
+        self.server.manager(MGR_CMD_SET, SERVER, {'scheduling': 'False'})
+        njobs = 2100
+        for _ in range(njobs):
+            self.server.submit(Job(TEST_USER))
+        t = time.time()
+        self.server.restart()
+        self.server.log_match("Recovered %d jobs in .* seconds" % njobs,
+                              regexp=True, starttime=t)
+        batches = self.server.log_match("Recovered a batch of",
+                                        starttime=t, allmatch=True)
+        self.assertEqual(len(batches), 2)
+        self.server.log_match("Recovered a batch of 2048 jobs", starttime=t)
+        self.server.log_match("Recovered a batch of %d jobs" % (njobs - 2048),
+                              starttime=t)
+        self.server.expect(SERVER, {'total_jobs': njobs})
@@ -0,0 +1,97 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2020 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+from tests.functional import *
+
+
+class TestRescUsedDelta(TestFunctional):
+
+    """
+    Test that with $resc_used_delta set, Mom sends only changed usage and
+    the server puts off saving jobs whose only change is their usage.
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        c = {'$resc_used_delta': 10, '$min_check_poll': 5,
+             '$max_check_poll': 10}
+        self.mom.add_config(c)
+        self.server.manager(MGR_CMD_SET, SERVER, {'log_events': 4095})
+
+    def test_delta_updates(self):
+        """
+        resources_used still reaches the server, and updates that only
+        carry usage are saved later instead of one job at a time.
+        """
+        j = Job(TEST_USER)
+        j.create_script('(while true; do :; done) &\n'
+                        'sleep 30\n'
+                        'kill %1\n')
+        jid = self.server.submit(j)
+        self.server.expect(JOB, {'job_state': 'R'}, id=jid)
+        self.mom.log_match("resc_used_delta;10")
+        self.server.expect(JOB, 'resources_used.walltime', op=SET, id=jid)
+        self.server.expect(JOB, {'resources_used.cput': '00:00:00'},
+                           op=NE, id=jid, offset=10)
+        self.server.log_match("stat_update: 1 jobs, 0 saved, 1 deferred",
+                              max_attempts=30)
+
+    def test_session_id_saved_at_once(self):
+        """
+        The session id and the change to running are saved as soon as
+        Mom reports them, so a server killed before the deferred save
+        still recovers them.
+        """
+        j = Job(TEST_USER)
+        j.set_sleep_time(300)
+        jid = self.server.submit(j)
+        self.server.expect(JOB, {'job_state': 'R', 'substate': 42}, id=jid)
+        self.server.expect(JOB, 'session_id', op=SET, id=jid)
+        sid = self.server.status(JOB, 'session_id',
+                                 id=jid)[0]['session_id']
+
+        # Mom must not report the session id again before it is checked
+        self.mom.signal('-STOP')
+        try:
+            self.server.stop('-KILL')
+            self.server.start()
+            self.server.expect(JOB, {'job_state': 'R', 'substate': 42,
+                                     'session_id': sid}, id=jid)
+        finally:
+            self.mom.signal('-CONT')
@@ -80,7 +80,7 @@ class TestSchedAttrUpdates(TestFunctional):
         # Verify that scheduler didn't send attr updates for new jobs
         self.server.expect(JOB, "comment", op=UNSET, id=jid5)
         self.server.expect(JOB, "comment", op=UNSET, id=jid6)
-        self.server.log_match("Type 96 request received", existence=False,
+        self.server.log_match("Type 100 request received", existence=False,
                               starttime=t, max_attempts=5)
 
         self.logger.info("Sleep for 45s for the attr_update_period to pass")
@@ -94,7 +94,32 @@ class TestSchedAttrUpdates(TestFunctional):
         # Verify that scheduler sent attr updates for all new jobs
         self.server.expect(JOB, "comment", op=SET, id=jid7)
         self.server.expect(JOB, "comment", op=SET, id=jid8)
-        self.server.log_match("Type 96 request received", starttime=t)
+        self.server.log_match("Type 100 request received", starttime=t)
+
+    @skipOnCpuSet
+    def test_updates_sent_in_one_list(self):
+        """
+        Test that the comments the scheduler sets on jobs in a cycle are
+        sent to the server in one modify job list request
+        """
+        self.server.manager(MGR_CMD_SET, NODE,
+                            {"resources_available.ncpus": 1},
+                            id=self.mom.shortname)
+        self.server.manager(MGR_CMD_SET, SERVER, {'log_events': 2047})
+        self.server.manager(MGR_CMD_SET, SCHED, {"scheduling": "False"},
+                            id="default")
+
+        jids = [self.server.submit(Job()) for _ in range(5)]
+
+        t = time.time()
+        self.scheduler.run_scheduling_cycle()
+        self.server.expect(JOB, {"job_state": "R"}, id=jids[0])
+        for jid in jids[1:]:
+            self.server.expect(JOB, "comment", op=SET, id=jid)
+
+        self.server.log_match("Type 100 request received", starttime=t)
+        self.server.log_match("Type 96 request received", existence=False,
+                              starttime=t, max_attempts=5)
 
     @skipOnCpuSet
     def test_accrue_type(self):
@@ -139,3 +164,46 @@ class TestSchedAttrUpdates(TestFunctional):
         self.server.expect(JOB, "comment", op=SET, id=jid3, max_attempts=1)
         self.server.expect(JOB, {"accrue_type": "1"}, id=jid3, max_attempts=1)
         self.server.expect(JOB, {"accrue_type": "1"}, id=jid2, max_attempts=1)
+
+    def sched_counters(self):
+        """
+        Return the sched_triggers and sched_cycles counters of the
+        default scheduler
+        """
+        s = self.server.status(SCHED, id="default")[0]
+        return int(s['sched_triggers']), int(s['sched_cycles'])
+
+    @skipOnCpuSet
+    def test_cycle_min_interval(self):
+        """
+        Test that sched_cycle_min_interval holds back the cycle of a job
+        submission and coalesces the submissions into one cycle, while
+        qrun still goes straight to the scheduler
+        """
+        self.server.manager(MGR_CMD_SET, NODE,
+                            {"resources_available.ncpus": 10},
+                            id=self.mom.shortname)
+        self.server.expect(SCHED, {"state": "idle"}, id="default")
+        a = {"sched_cycle_min_interval": 600}
+        self.server.manager(MGR_CMD_SET, SCHED, a, id="default")
+        triggers, cycles = self.sched_counters()
+
+        jids = [self.server.submit(Job()) for _ in range(5)]
+        for jid in jids:
+            self.server.expect(JOB, {"job_state": "Q"}, id=jid,
+                               offset=2, max_attempts=1)
+        t2, c2 = self.sched_counters()
+        self.assertGreaterEqual(t2 - triggers, 5)
+        self.assertEqual(c2, cycles)
+
+        # qrun takes the priority lane
+        self.server.runjob(jids[0])
+        self.server.expect(JOB, {"job_state": "R"}, id=jids[0])
+
+        # without the spacing the held trigger runs the other jobs
+        self.server.manager(MGR_CMD_UNSET, SCHED,
+                            "sched_cycle_min_interval", id="default")
+        self.server.manager(MGR_CMD_SET, SCHED, {"scheduling": "True"},
+                            id="default")
+        for jid in jids[1:]:
+            self.server.expect(JOB, {"job_state": "R"}, id=jid)
@@ -250,8 +250,10 @@ pbs.event().accept()
         t = time.time()
         self.scheduler.run_scheduling_cycle()
 
-        # Check that server received PBS_BATCH_AsyrunJob, truly async request
-        logmsg = "Type 23 request received"
+        # Check that server received PBS_BATCH_RunJobList request, which
+        # carries the job_run_wait=none runs; the scheduler still waits for
+        # its reply, one result code per job
+        logmsg = "Type 99 request received"
         self.server.log_match(logmsg, starttime=t)
 
     def test_with_runjob_hook(self):
@@ -295,8 +297,8 @@ pbs.event().accept()
         self.scheduler.run_scheduling_cycle()
         self.server.expect(JOB, {"job_state": "R"}, id=jid)
 
-        # Check that server received PBS_BATCH_AsyrunJob request
-        self.server.log_match("Type 23 request received", starttime=t)
+        # Check that server received PBS_BATCH_RunJobList request
+        self.server.log_match("Type 99 request received", starttime=t)
 
         self.server.cleanup_jobs()
 
@@ -365,7 +367,7 @@ e.accept()"""
         self.server.expect(JOB, {"job_state": "Q"}, id=jid4)
         a = {"comment": (MATCH_RE, "no walltime specified")}
         self.server.expect(JOB, a, id=jid4)
-        self.server.log_match("Type 96 request", starttime=t1, max_attempts=5)
+        self.server.log_match("Type 100 request", starttime=t1, max_attempts=5)
 
     def test_runhook_reject_comment_server(self):
         """
@@ -391,5 +393,43 @@ e.accept()"""
         self.server.expect(JOB, {"job_state": "Q"}, id=jid)
         a = {"comment": (MATCH_RE, "no walltime specified")}
         self.server.expect(JOB, a, id=jid)
-        self.server.log_match("Type 96 request", starttime=t1, max_attempts=5,
+        self.server.log_match("Type 100 request", starttime=t1, max_attempts=5,
                               existence=False)
+
+    def test_none_runs_jobs_in_one_list(self):
+        """
+        Test that with job_run_wait set to "none" the jobs run in a cycle
+        are sent to the server in one run job list request, and that a job
+        the server would not run is logged by the scheduler
+        """
+        self.server.manager(MGR_CMD_SET, NODE,
+                            {"resources_available.ncpus": 4},
+                            id=self.mom.shortname)
+        a = {"scheduling": "False", "job_run_wait": "none"}
+        self.server.manager(MGR_CMD_SET, SCHED, a, id="default")
+        self.server.manager(MGR_CMD_SET, SERVER, {'log_events': 2047})
+
+        jids = [self.server.submit(Job()) for _ in range(4)]
+        hook_txt = """
+import pbs
+
+if pbs.event().job.id == '%s':
+    pbs.event().reject("rejecting last job")
+pbs.event().accept()
+"""
+        hk_attrs = {'event': 'runjob', 'enabled': 'True'}
+        self.server.create_import_hook('rj', hk_attrs, hook_txt % jids[3])
+
+        t = time.time()
+        self.scheduler.run_scheduling_cycle()
+        for jid in jids[:3]:
+            self.server.expect(JOB, {"job_state": "R"}, id=jid)
+        self.server.expect(JOB, {"job_state": "Q"}, id=jids[3])
+        a = {"comment": (MATCH_RE, "rejecting last job")}
+        self.server.expect(JOB, a, id=jids[3])
+
+        self.server.log_match("Type 99 request received", starttime=t)
+        self.server.log_match("Type 23 request received", starttime=t,
+                              max_attempts=5, existence=False)
+        self.scheduler.log_match(jids[3] + ";Server could not run job",
+                                 starttime=t)
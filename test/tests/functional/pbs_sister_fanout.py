@@ -0,0 +1,145 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2020 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+from tests.functional import *
+
+
+@requirements(num_moms=4)
+class TestSisterFanout(TestFunctional):
+
+    """
+    Test that with $sister_fanout set, mother superior polls and deletes
+    a multinode job through a tree of sister moms.
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        if len(self.moms) != 4:
+            self.skip_test('test requires 4 MoMs as input, ' +
+                           'use -p moms=<m1>:<m2>:<m3>:<m4>')
+        self.momlist = list(self.moms.values())
+        c = {'$sister_fanout': 2, '$logevent': '0xffffffff',
+             '$min_check_poll': 5, '$max_check_poll': 10}
+        for mom in self.momlist:
+            mom.add_config(c)
+        self.hosts = [mom.shortname for mom in self.momlist]
+
+    def test_poll_and_delete_relayed(self):
+        """
+        With three sisters and a fanout of 2, one sister relays POLL and
+        DELETE_JOB for mother superior, and resources_used is still
+        gathered from every host.
+        """
+        sel = '+'.join(['1:ncpus=1:host=%s' % h for h in self.hosts])
+        j = Job(TEST_USER, attrs={'Resource_List.select': sel,
+                                  'Resource_List.place': 'scatter'})
+        j.create_script('pbsdsh -- sleep 30\nsleep 30\n')
+        jid = self.server.submit(j)
+        self.server.expect(JOB, {'job_state': 'R'}, id=jid)
+
+        # Sisters are split into runs of one and two hosts, the first
+        # host of the second run answers for itself and the last host.
+        self.momlist[0].log_match("sister_fanout;2")
+        self.momlist[1].log_match(
+            "%s;relayed POLL reply for 1 hosts" % jid, max_attempts=20)
+        self.momlist[2].log_match(
+            "%s;relayed POLL reply for 2 hosts" % jid, max_attempts=20)
+        self.momlist[3].log_match(
+            "%s;relayed POLL reply for 1 hosts" % jid, max_attempts=20)
+
+        self.server.expect(JOB, 'resources_used.cput', op=SET, id=jid)
+        self.server.delete(jid)
+        for mom in self.momlist[1:]:
+            mom.log_match("%s;DELETE_JOB received" % jid)
+        self.server.expect(JOB, 'queue', op=UNSET, id=jid)
+
+    def test_poll_relayed_two_levels(self):
+        """
+        With a fanout of 1 each sister relays to the next, so POLL goes
+        three levels down.  The job must keep running through several
+        poll intervals, with every level sending its reply up each time.
+        """
+        c = {'$sister_fanout': 1}
+        for mom in self.momlist:
+            mom.add_config(c)
+        sel = '+'.join(['1:ncpus=1:host=%s' % h for h in self.hosts])
+        j = Job(TEST_USER, attrs={'Resource_List.select': sel,
+                                  'Resource_List.place': 'scatter'})
+        j.create_script('pbsdsh -- sleep 60\nsleep 60\n')
+        jid = self.server.submit(j)
+        self.server.expect(JOB, {'job_state': 'R'}, id=jid)
+
+        # Each sister answers for herself and every host below her.
+        for i in range(1, 4):
+            msg = "%s;relayed POLL reply for %d hosts" % (jid, 4 - i)
+            self.momlist[i].log_match(msg, max_attempts=20)
+        stime = time.time()
+        time.sleep(35)
+        for i in range(1, 4):
+            msg = "%s;relayed POLL reply for %d hosts" % (jid, 4 - i)
+            lines = self.momlist[i].log_match(msg, starttime=stime,
+                                              allmatch=True)
+            self.assertGreaterEqual(len(lines), 2)
+        for msg in ["node EOF", "requested job die"]:
+            self.momlist[0].log_match("%s;%s" % (jid, msg), starttime=stime,
+                                      existence=False, max_attempts=1)
+        self.server.expect(JOB, {'job_state': 'R'}, id=jid)
+        self.server.expect(JOB, 'resources_used.cput', op=SET, id=jid)
+
+    def test_fanout_removed_on_hup(self):
+        """
+        Removing $sister_fanout from the config and sending HUP turns
+        relaying off again.
+        """
+        sel = '+'.join(['1:ncpus=1:host=%s' % h for h in self.hosts])
+        j = Job(TEST_USER, attrs={'Resource_List.select': sel,
+                                  'Resource_List.place': 'scatter'})
+        j.create_script('pbsdsh -- sleep 60\nsleep 60\n')
+        jid = self.server.submit(j)
+        self.server.expect(JOB, {'job_state': 'R'}, id=jid)
+        self.momlist[2].log_match(
+            "%s;relayed POLL reply for 2 hosts" % jid, max_attempts=20)
+
+        self.momlist[0].unset_mom_config('$sister_fanout')
+        stime = time.time()
+        time.sleep(25)
+        for mom in self.momlist[1:]:
+            mom.log_match("%s;relayed POLL reply" % jid, starttime=stime,
+                          existence=False, max_attempts=1)
+        self.server.expect(JOB, {'job_state': 'R'}, id=jid)
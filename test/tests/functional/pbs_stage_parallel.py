@@ -0,0 +1,85 @@
+# coding: utf-8
+
+# Copyright (C) 1994-2020 Altair Engineering, Inc.
+# For more information, contact Altair at www.altair.com.
+#
+# This file is part of both the OpenPBS software ("OpenPBS")
+# and the PBS Professional ("PBS Pro") software.
+#
+# Open Source License Information:
+#
+# OpenPBS is free software. You can redistribute it and/or modify it under
+# the terms of the GNU Affero General Public License as published by the
+# Free Software Foundation, either version 3 of the License, or (at your
+# option) any later version.
+#
+# OpenPBS is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+# FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Affero General Public
+# License for more details.
+#
+# You should have received a copy of the GNU Affero General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Commercial License Information:
+#
+# PBS Pro is commercially licensed software that shares a common core with
+# the OpenPBS software.  For a copy of the commercial license terms and
+# conditions, go to: (http://www.pbspro.com/agreement.html) or contact the
+# Altair Legal Department.
+#
+# Altair's dual-license business model allows companies, individuals, and
+# organizations to create proprietary derivative works of OpenPBS and
+# distribute them - whether embedded or bundled with other software -
+# under a commercial license agreement.
+#
+# Use of Altair's trademarks, including but not limited to "PBS™",
+# "OpenPBS®", "PBS Professional®", and "PBS Pro™" and Altair's logos is
+# subject to Altair's trademark licensing policies.
+
+from tests.functional import *
+
+
+class TestStageParallel(TestFunctional):
+
+    """
+    Test file staging with local copies made inside Mom and remote
+    copies run side by side under $stage_parallel.
+    """
+
+    def setUp(self):
+        TestFunctional.setUp(self)
+        self.mom.add_config({'$stage_parallel': 4,
+                             '$logevent': '0xffffffff'})
+        self.mom.log_match("stage_parallel;4")
+
+    def test_local_stagein_tree(self):
+        """
+        A directory staged in from this host is copied whole, without
+        running cp, and the job starts.
+        """
+        src = self.du.create_temp_dir(hostname=self.mom.shortname,
+                                      asuser=TEST_USER)
+        for _ in range(3):
+            self.du.create_temp_file(hostname=self.mom.shortname,
+                                     dirname=src, asuser=TEST_USER,
+                                     body='staged data\n')
+        a = {ATTR_stagein: 'indir@%s:%s' % (self.mom.shortname, src)}
+        j = Job(TEST_USER, a)
+        j.set_sleep_time(10)
+        jid = self.server.submit(j)
+        self.server.expect(JOB, {'job_state': 'R'}, id=jid)
+        self.mom.log_match("%s to .*indir: 3 files, 36 bytes in .* ms, "
+                           "status=0" % src, regexp=True)
+
+    def test_local_stagein_missing(self):
+        """
+        A failed local stage in still reports the copy error and puts
+        the job on hold.
+        """
+        a = {ATTR_stagein: 'nofile@%s:/noDir/nofile' % self.mom.shortname}
+        j = Job(TEST_USER, a)
+        jid = self.server.submit(j)
+        self.server.expect(JOB, {'job_state': 'W'}, id=jid,
+                           offset=30, interval=2)
+        self.mom.log_match("cp: cannot stat '/noDir/nofile'")
@@ -265,6 +265,89 @@ class TestTPP(TestFunctional):
         self.common_steps(job=True, interactive=True, resv=True,
                           resv_job=True)
 
+    def test_compression_codec(self):
+        """
+        This test verifies that the TPP compression codec is taken
+        from PBS_COMPRESSION_TYPE, and that an unknown codec falls back
+        to zlib without breaking communication
+        Configuration:
+        Node 1 : Server, Mom, Sched, Comm
+        """
+        self.node_list.append(self.server.shortname)
+        a = {'PBS_COMPRESSION_TYPE': 'zlib'}
+        self.set_pbs_conf(host_name=self.server.shortname, conf_param=a)
+        self.server.log_match("TPP compression codec = zlib")
+        self.comm.log_match("TPP compression codec = zlib")
+        a = {'PBS_COMPRESSION_TYPE': 'bogus'}
+        self.set_pbs_conf(host_name=self.server.shortname, conf_param=a)
+        msg = "TPP compression codec bogus not available, using zlib"
+        self.server.log_match(msg)
+        self.mom.log_match(msg)
+        jid = self.submit_job(sleep=10)
+        self.server.expect(JOB, {'job_state': 'R'}, id=jid)
+
+    def common_steps_for_codec_traffic(self, codec):
+        """
+        Run a job whose script is large enough to be compressed on its
+        way from the server to the mom, with both ends set to the given
+        codec, and check that the mom ran the script it was sent
+        :param codec: Value of PBS_COMPRESSION_TYPE
+        :type codec: String
+        """
+        self.node_list.append(self.server.shortname)
+        start = time.time()
+        a = {'PBS_COMPRESSION_TYPE': codec}
+        self.set_pbs_conf(host_name=self.server.shortname, conf_param=a)
+        try:
+            self.server.log_match("TPP compression codec = %s" % codec,
+                                  starttime=start, max_attempts=5)
+        except PtlLogMatchError:
+            self.skipTest("PBS is not built with %s support" % codec)
+        self.mom.log_match("TPP compression codec = %s" % codec,
+                           starttime=start)
+        # the server compresses with the codec only once the mom has
+        # advertised it, which the mom does when it reports in
+        self.server.expect(NODE, {'state': 'free'}, id=self.mom.shortname)
+        self.server.manager(MGR_CMD_SET, SERVER,
+                            {'job_history_enable': 'True'})
+        nlines = 2000
+        script = ['echo line%d %s' % (i, 'x' * 64) for i in range(nlines)]
+        j = Job(TEST_USER, attrs={ATTR_S: '/bin/bash'})
+        j.create_script(body=script)
+        jid = self.server.submit(j)
+        self.server.expect(JOB, {'job_state': 'F', 'Exit_status': 0},
+                           id=jid, extend='x')
+        job_status = self.server.status(JOB, id=jid, extend='x')
+        job_output_file = job_status[0]['Output_Path'].split(':')[1]
+        ret = self.du.cat(hostname=self.mom.shortname,
+                          filename=job_output_file, sudo=True)
+        out = [l for l in ret['out'] if l.startswith('line')]
+        self.assertEqual(len(out), nlines,
+                         "Job output does not match the script sent")
+        msg = "Decompression"
+        self.server.log_match(msg, existence=False, starttime=start,
+                              max_attempts=2)
+        self.mom.log_match(msg, existence=False, starttime=start,
+                           max_attempts=2)
+
+    def test_compression_codec_lz4(self):
+        """
+        This test verifies that job data moves between the server and
+        the mom through pbs_comm when both use the lz4 codec
+        Configuration:
+        Node 1 : Server, Mom, Sched, Comm
+        """
+        self.common_steps_for_codec_traffic('lz4')
+
+    def test_compression_codec_zstd(self):
+        """
+        This test verifies that job data moves between the server and
+        the mom through pbs_comm when both use the zstd codec
+        Configuration:
+        Node 1 : Server, Mom, Sched, Comm
+        """
+        self.common_steps_for_codec_traffic('zstd')
+
     @skip(reason="Run this through cmd-line by removing this decorator")
     @requirements(num_moms=2, num_clients=1)
     def test_client_with_mom(self):
@@ -1007,7 +1090,8 @@ class TestTPP(TestFunctional):
         os.environ['PBS_CONF_FILE'] = self.pbs_conf_path
         self.logger.info("Successfully exported PBS_CONF_FILE variable")
         conf_param = ['PBS_LEAF_ROUTERS', 'PBS_COMM_ROUTERS',
-                      'PBS_COMM_THREADS', 'PBS_COMM_LOG_EVENTS']
+                      'PBS_COMM_THREADS', 'PBS_COMM_LOG_EVENTS',
+                      'PBS_COMPRESSION_TYPE']
         for host in self.node_list:
             self.unset_pbs_conf(host, conf_param)
         self.node_list.clear()